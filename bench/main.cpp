@@ -0,0 +1,556 @@
+// ---------------------------------------------------------------------------
+// bench — headless simulation benchmark
+//
+// Runs the full Pre-Update / Logic / Physics pipeline without a window. Input
+// and rendering are stubbed: BenchInput scripts the player's PlayerInput and
+// the MainCamera resource is created directly (RenderModule is not installed).
+//
+// Usage:
+//   bench [--scene <path>] [--ticks <n>] [--warmup <n>] [--threads <n>] [--csv <path>] [--static]
+//         [--generate <bodies>] [--platforms <n>] [--characters <n>] [--stack <n>]
+//         [--spheres <0..1>] [--pool <n>] [--plant-every <ticks>] [--seed <n>]
+//   bench --sweep-bodies <n,n,...> [--sweep-threads <n,n,...>] [generator flags]
+//   bench --write-scene <path> [generator flags]
+//   bench --replay <file.pinp> [--scene <path>]
+//
+// With no --scene, a StressScene (stress_scene.hpp, RFC-0058) is generated:
+// --generate dynamic bodies in stacks of --stack (--spheres of the stacks
+// are spheres), --platforms static platforms and --characters characters,
+// the first of them the player. BenchInput walks every character and plants
+// a builder platform every --plant-every ticks (0: never) into a pool of
+// --pool; the builder's cooldown allows one every 15 ticks at most.
+// --threads sets PhysicsConfig::worker_threads (default: the scene's).
+//
+// --sweep-bodies / --sweep-threads run one measurement per combination,
+// each in a fresh World on a freshly generated scene, and print a table of
+// ticks/s, body counts and the growth in resident memory over the run (the
+// resident set while the World is alive, minus the one before it was built).
+// --csv writes the same rows (or
+// a single run's row) to a file, so results can be diffed between commits.
+// --write-scene saves the generated scene as JSON and exits.
+//
+// --static runs the same systems through a StaticPipeline (BenchPipeline
+// below, RFC-0060): one direct call per system instead of a std::function
+// each, so the two runs' "update" rows differ by the dispatch cost. Not with
+// --replay, whose systems differ.
+//
+// --replay plays back an input recording made with demo --record (RFC-0039).
+// It runs the real PlayerInput and Camera systems over the recorded
+// InputRecords and dts, as fast as it can, with no warmup. Every frame it
+// compares InputReplay::checksum with the recorded value, and it reports the
+// first frame that diverged. Plain R presses restore the load snapshot, as
+// in the demo. The scene defaults to the demo's.
+//
+// Every measured tick also counts heap allocations made through operator
+// new (replaced below). The target is zero in steady state (RFC-0051).
+// Jolt allocates through its own hooks (malloc), which are not counted.
+// ---------------------------------------------------------------------------
+
+#include "modules/builder_module.hpp"
+#include "modules/camera_module.hpp"
+#include "modules/character_module.hpp"
+#include "modules/event_bus_module.hpp"
+#include "modules/physics_module.hpp"
+#include "components.hpp"
+#include "fixed_time.hpp"
+#include "frame_arena.hpp"
+#include "frame_profiler.hpp"
+#include "input_replay.hpp"
+#include "physics_config.hpp"
+#include "physics_context.hpp"
+#include "process_memory.hpp"
+#include "scene.hpp"
+#include "static_pipeline.hpp"
+#include "stress_scene.hpp"
+#include "systems/player_input.hpp"
+#include <ecs/ecs.hpp>
+#include <nlohmann/json.hpp>
+#include <raylib.h> // key codes only; bench does not link Raylib
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+std::atomic<uint64_t> g_heap_allocs{0};
+
+} // namespace
+
+// Counting replacements for the global allocation functions. The array,
+// nothrow and sized forms all route through these in the standard library.
+void* operator new(size_t n) {
+    g_heap_allocs.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+
+namespace {
+
+struct BenchOptions {
+    std::string         scene_path;        // empty → generated scene
+    StressScene::Params scene;             // the generated scene
+    int                 ticks  = 600;      // measured ticks
+    int                 warmup = 60;       // unmeasured ticks before measurement
+    int                 threads = -1;      // -1: the scene's worker_threads
+    int                 plant_every = 30;  // ticks between builder plants; 0 = never
+    std::string         replay_path;       // non-empty → play back this input recording
+    std::string         csv_path;          // non-empty → write result rows here
+    std::string         write_scene;       // non-empty → save the generated scene and exit
+    std::vector<int>    sweep_bodies;      // non-empty (either) → sweep
+    std::vector<int>    sweep_threads;
+    bool                static_dispatch = false; // run BenchPipeline instead of the Pipeline
+};
+
+const char* k_demo_scene = "resources/scenes/default.json";
+
+// Scripted stand-in for InputGatherSystem + PlayerInputSystem. Walks the
+// player in a circle, jumps every 45 ticks and plants a platform every
+// `plant_every`. Other characters get a CharacterIntent directly (the
+// player's own is rewritten by CharacterInput): circles out of phase, a jump
+// every 90 ticks.
+struct BenchInput {
+    static void Update(ecs::World& world, int tick, int plant_every) {
+        const float a = static_cast<float>(tick) * 0.02f;
+        world.each<PlayerTag, PlayerInput>([&](ecs::Entity, PlayerTag&, PlayerInput& in) {
+            in.move_input     = {std::cos(a), std::sin(a)};
+            in.look_input     = {0, 0};
+            in.jump           = (tick % 45) == 0;
+            in.plant_platform = plant_every > 0 && (tick % plant_every) == 0;
+            in.trigger_val    = in.plant_platform ? 1.0f : 0.0f;
+        });
+        world.each<CharacterIntent>([&](ecs::Entity e, CharacterIntent& intent) {
+            const float phase = static_cast<float>(e.index) * 0.7f;
+            intent.move_dir       = {std::cos(a + phase), 0.0f, std::sin(a + phase)};
+            intent.look_dir       = intent.move_dir;
+            intent.jump_requested = ((tick + static_cast<int>(e.index)) % 90) == 0;
+        });
+    }
+};
+
+struct Stats {
+    double p50 = 0, p99 = 0, mean = 0, max = 0;
+};
+
+Stats summarize(std::vector<double> samples) {
+    Stats s;
+    if (samples.empty()) return s;
+    std::sort(samples.begin(), samples.end());
+    auto pct = [&](double p) {
+        size_t i = static_cast<size_t>(p * static_cast<double>(samples.size() - 1) + 0.5);
+        return samples[std::min(i, samples.size() - 1)];
+    };
+    s.p50 = pct(0.50);
+    s.p99 = pct(0.99);
+    s.max = samples.back();
+    for (double v : samples) s.mean += v;
+    s.mean /= static_cast<double>(samples.size());
+    return s;
+}
+
+void print_row(const char* name, const Stats& s) {
+    std::printf("  %-12s %9.3f %9.3f %9.3f %9.3f\n", name, s.p50, s.p99, s.mean, s.max);
+}
+
+// "500,1000,2000" → {500, 1000, 2000}. False on an empty list or a bad entry.
+bool parse_list(const char* v, std::vector<int>& out) {
+    out.clear();
+    while (*v) {
+        char* end = nullptr;
+        const long n = std::strtol(v, &end, 10);
+        if (end == v) return false;
+        out.push_back(static_cast<int>(n));
+        v = *end == ',' ? end + 1 : end;
+        if (*end && *end != ',') return false;
+    }
+    return !out.empty();
+}
+
+bool parse_args(int argc, char** argv, BenchOptions& opt) {
+    bool ok = true;
+    for (int i = 1; i < argc && ok; ++i) {
+        auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+        const char* a = argv[i];
+        const char* v = nullptr;
+        if      (!std::strcmp(a, "--scene")         && (v = next())) opt.scene_path = v;
+        else if (!std::strcmp(a, "--generate")      && (v = next())) opt.scene.bodies = std::atoi(v);
+        else if (!std::strcmp(a, "--platforms")     && (v = next())) opt.scene.platforms = std::atoi(v);
+        else if (!std::strcmp(a, "--characters")    && (v = next())) opt.scene.characters = std::atoi(v);
+        else if (!std::strcmp(a, "--stack")         && (v = next())) opt.scene.stack_height = std::atoi(v);
+        else if (!std::strcmp(a, "--spheres")       && (v = next())) opt.scene.sphere_share = static_cast<float>(std::atof(v));
+        else if (!std::strcmp(a, "--pool")          && (v = next())) opt.scene.builder_pool = static_cast<size_t>(std::max(0, std::atoi(v)));
+        else if (!std::strcmp(a, "--seed")          && (v = next())) opt.scene.seed = static_cast<uint32_t>(std::strtoul(v, nullptr, 10));
+        else if (!std::strcmp(a, "--plant-every")   && (v = next())) opt.plant_every = std::atoi(v);
+        else if (!std::strcmp(a, "--ticks")         && (v = next())) opt.ticks  = std::atoi(v);
+        else if (!std::strcmp(a, "--warmup")        && (v = next())) opt.warmup = std::atoi(v);
+        else if (!std::strcmp(a, "--threads")       && (v = next())) opt.threads = std::max(0, std::atoi(v));
+        else if (!std::strcmp(a, "--csv")           && (v = next())) opt.csv_path = v;
+        else if (!std::strcmp(a, "--write-scene")   && (v = next())) opt.write_scene = v;
+        else if (!std::strcmp(a, "--sweep-bodies")  && (v = next())) ok = parse_list(v, opt.sweep_bodies);
+        else if (!std::strcmp(a, "--sweep-threads") && (v = next())) ok = parse_list(v, opt.sweep_threads);
+        else if (!std::strcmp(a, "--replay")        && (v = next())) opt.replay_path = v;
+        else if (!std::strcmp(a, "--static"))                        opt.static_dispatch = true;
+        else ok = false;
+    }
+    const bool sweeping = !opt.sweep_bodies.empty() || !opt.sweep_threads.empty();
+    if (sweeping && (!opt.scene_path.empty() || !opt.replay_path.empty())) ok = false; // sweeps generate
+    if (opt.static_dispatch && !opt.replay_path.empty()) ok = false;
+    if (!ok) {
+        std::fprintf(stderr,
+            "usage: bench [--scene <path>] [--ticks <n>] [--warmup <n>] [--threads <n>] [--csv <path>] [--static]\n"
+            "             [--generate <bodies>] [--platforms <n>] [--characters <n>] [--stack <n>]\n"
+            "             [--spheres <0..1>] [--pool <n>] [--plant-every <ticks>] [--seed <n>]\n"
+            "       bench --sweep-bodies <n,n,...> [--sweep-threads <n,n,...>] [generator flags]\n"
+            "       bench --write-scene <path> [generator flags]\n"
+            "       bench --replay <file.pinp> [--scene <path>]\n");
+        return false;
+    }
+    if (!opt.replay_path.empty()) {
+        if (opt.scene_path.empty()) opt.scene_path = k_demo_scene;
+        opt.warmup = 0;
+    }
+    return true;
+}
+
+// Same install order as main.cpp, minus the window-dependent modules. Loads
+// the scene and commits its bodies; false if the scene does not load.
+bool build_world(ecs::World& world, ecs::Pipeline& pipeline, const std::string& scene_json,
+                 const PhysicsConfig& physics_cfg, size_t pool, bool replaying) {
+    EventBusModule::install(world, pipeline);
+    PhysicsModule::install(world, pipeline, physics_cfg);
+    world.set_resource(MainCamera{});
+    if (replaying) {
+        // InputModule without InputGather: the recording is the hardware.
+        world.set_resource(InputRecord{});
+        pipeline.add_pre_update("PlayerInput", ecs::Access{}.read<InputRecord>().write<PlayerInput>(),
+                                [](ecs::World& w, float) { PlayerInputSystem::Update(w); });
+        CameraModule::install(world, pipeline);
+    }
+
+    CharacterModule::install(world, pipeline);
+    BuilderModule::install(world, pipeline, pool);
+    PhysicsModule::install_queries(world, pipeline);
+    CharacterModule::install_motor(world, pipeline);
+
+    // Per-system timings; reset after warmup so the table covers measured ticks.
+    world.set_resource(FrameProfiler{});
+
+    if (!SceneLoader::load_from_string(world, scene_json)) return false;
+    BuilderModule::fill_pool(world);     // parked platforms, as in main.cpp
+    PhysicsModule::commit_bodies(world);
+    if (replaying) PhysicsModule::save_snapshot(world); // what R restores, as in main.cpp
+    return true;
+}
+
+// build_world's systems without --replay, in install order, as a
+// StaticPipeline. The modules still install into the Pipeline (resources,
+// hooks); Ticker checks that this list mirrors it.
+using BenchPipeline = ecs::StaticPipeline<
+    EventBusModule::FlushStep,
+    CharacterModule::InputStep, CharacterModule::StateStep, BuilderModule::Step, PhysicsModule::QueryStep,
+    CharacterModule::MotorStep,
+    PhysicsModule::KinematicStep, PhysicsModule::Step,
+    PhysicsModule::PropagateStep>;
+
+// A tick through the Pipeline, or through BenchPipeline with --static.
+struct Ticker {
+    ecs::Pipeline& pipeline;
+    BenchPipeline  compiled{};
+    bool           use_static = false;
+
+    // False, logging why, if --static was asked for and BenchPipeline no
+    // longer matches what the modules installed.
+    bool init(bool static_dispatch) {
+        use_static = static_dispatch;
+        if (use_static && !BenchPipeline::mirrors(pipeline)) {
+            std::fprintf(stderr, "bench: BenchPipeline no longer matches the installed systems\n");
+            return false;
+        }
+        return true;
+    }
+    void update(ecs::World& world, float dt) {
+        if (use_static) compiled.update(world, dt);
+        else            pipeline.update(world, dt);
+    }
+    void step_and_render(ecs::World& world, float dt) {
+        if (use_static) { compiled.step_fixed(world, dt); compiled.render(world); }
+        else            { pipeline.step_fixed(world, dt); pipeline.render(world); }
+    }
+};
+
+PhysicsConfig physics_config_for(const std::string& scene_json, int threads) {
+    PhysicsConfig cfg;
+    SceneLoader::physics_config_from_string(scene_json, cfg);
+    cfg.async_step = false; // nothing to overlap without a renderer; time the step itself
+    if (threads >= 0) cfg.worker_threads = threads;
+    return cfg;
+}
+
+// One result row: the table printed by a sweep, and a line of --csv. Entity
+// counts are read from the World, so a --scene run fills them in too.
+struct Row {
+    size_t   static_bodies = 0, moving_bodies = 0, characters = 0;
+    int      threads = 0;
+    uint32_t jolt_bodies = 0, active_bodies = 0, failed_creates = 0;
+    size_t   ticks = 0;
+    Stats    frame;
+    double   ticks_per_sec = 0, rss_delta_mb = 0, temp_peak_mb = 0;
+};
+
+// `rss_before` is ProcessMemory::resident_bytes() from before the World was
+// built. The resident set rarely shrinks once a sweep's earlier, larger
+// World is freed, so the absolute figure would be that run's, not this one's.
+Row make_row(ecs::World& world, const std::vector<double>& frame_ms, size_t rss_before) {
+    const auto& ctx = *world.resource<std::shared_ptr<PhysicsContext>>();
+    Row r;
+    world.each<RigidBodyConfig>([&](ecs::Entity, RigidBodyConfig& rb) {
+        ++(rb.type == BodyType::Static ? r.static_bodies : r.moving_bodies);
+    });
+    r.characters     = world.count<CharacterControllerConfig>();
+    r.threads        = ctx.config.resolved_worker_threads(std::thread::hardware_concurrency());
+    r.jolt_bodies    = ctx.physics_system->GetNumBodies();
+    r.active_bodies  = ctx.physics_system->GetNumActiveBodies(JPH::EBodyType::RigidBody);
+    r.failed_creates = ctx.failed_body_creates;
+    r.ticks          = frame_ms.size();
+    r.frame          = summarize(frame_ms);
+    r.ticks_per_sec  = r.frame.mean > 0 ? 1000.0 / r.frame.mean : 0;
+    r.rss_delta_mb   = (static_cast<double>(ProcessMemory::resident_bytes()) - static_cast<double>(rss_before))
+                     / (1024.0 * 1024.0);
+    r.temp_peak_mb   = ctx.temp_allocator->peak() / (1024.0 * 1024.0);
+    return r;
+}
+
+bool write_csv(const std::string& path, const std::vector<Row>& rows) {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) {
+        std::fprintf(stderr, "bench: cannot write %s\n", path.c_str());
+        return false;
+    }
+    std::fprintf(f, "static_bodies,moving_bodies,characters,threads,jolt_bodies,active_bodies,failed_creates,"
+                    "ticks,mean_ms,p50_ms,p99_ms,max_ms,ticks_per_sec,rss_delta_mb,temp_peak_mb\n");
+    for (const Row& r : rows)
+        std::fprintf(f, "%zu,%zu,%zu,%d,%u,%u,%u,%zu,%.4f,%.4f,%.4f,%.4f,%.1f,%.1f,%.2f\n", r.static_bodies,
+                     r.moving_bodies, r.characters, r.threads, r.jolt_bodies, r.active_bodies, r.failed_creates, r.ticks,
+                     r.frame.mean, r.frame.p50, r.frame.p99, r.frame.max, r.ticks_per_sec, r.rss_delta_mb,
+                     r.temp_peak_mb);
+    std::fclose(f);
+    return true;
+}
+
+// --sweep-bodies × --sweep-threads: a fresh World, scene and PhysicsContext
+// per combination, timed over whole ticks (update + fixed step + render).
+int run_sweep(const BenchOptions& opt) {
+    const std::vector<int> bodies  = opt.sweep_bodies.empty()  ? std::vector<int>{opt.scene.bodies} : opt.sweep_bodies;
+    const std::vector<int> threads = opt.sweep_threads.empty() ? std::vector<int>{opt.threads}      : opt.sweep_threads;
+    using clock = std::chrono::steady_clock;
+
+    std::vector<Row> rows;
+    for (int n : bodies) {
+        StressScene::Params params = opt.scene;
+        params.bodies = n;
+        const std::string scene_json = StressScene::generate(params);
+        for (int t : threads) {
+            const size_t  rss_before = ProcessMemory::resident_bytes();
+            ecs::World    world;
+            ecs::Pipeline pipeline;
+            if (!build_world(world, pipeline, scene_json, physics_config_for(scene_json, t),
+                             params.builder_pool, false)) {
+                std::fprintf(stderr, "bench: failed to load the generated scene (%d bodies)\n", n);
+                return 1;
+            }
+            Ticker ticker{pipeline};
+            if (!ticker.init(opt.static_dispatch)) return 1;
+            const float fixed_dt = world.resource<FixedTime>().fixed_dt;
+            std::vector<double> frame_ms;
+            frame_ms.reserve(opt.ticks);
+            for (int tick = 0; tick < opt.warmup + opt.ticks; ++tick) {
+                BenchInput::Update(world, tick, opt.plant_every);
+                const auto t0 = clock::now();
+                ticker.update(world, fixed_dt);
+                ticker.step_and_render(world, fixed_dt);
+                const auto t1 = clock::now();
+                if (tick >= opt.warmup) frame_ms.push_back(std::chrono::duration<double, std::milli>(t1 - t0).count());
+            }
+            rows.push_back(make_row(world, frame_ms, rss_before));
+            SceneLoader::unload(world); // bodies go while their PhysicsContext is still up
+        }
+    }
+
+    std::printf("bench: sweep, %d platforms, %d characters, %d ticks (+%d warmup) per run%s\n",
+                opt.scene.platforms, opt.scene.characters, opt.ticks, opt.warmup,
+                opt.static_dispatch ? ", static dispatch" : "");
+    std::printf("  %7s %7s %7s %7s %9s %9s %9s %8s %8s\n", "moving", "threads", "jolt", "active", "mean ms",
+                "p99 ms", "ticks/s", "+RSS MB", "temp MB");
+    for (const Row& r : rows)
+        std::printf("  %7zu %7d %7u %7u %9.3f %9.3f %9.1f %+8.1f %8.2f\n", r.moving_bodies, r.threads,
+                    r.jolt_bodies, r.active_bodies, r.frame.mean, r.frame.p99, r.ticks_per_sec, r.rss_delta_mb,
+                    r.temp_peak_mb);
+    if (!opt.csv_path.empty() && !write_csv(opt.csv_path, rows)) return 1;
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    BenchOptions opt;
+    if (!parse_args(argc, argv, opt)) return 1;
+
+    if (!opt.write_scene.empty()) {
+        std::ofstream out(opt.write_scene, std::ios::trunc);
+        out << StressScene::generate(opt.scene);
+        if (!out.good()) {
+            std::fprintf(stderr, "bench: cannot write %s\n", opt.write_scene.c_str());
+            return 1;
+        }
+        return 0;
+    }
+    if (!opt.sweep_bodies.empty() || !opt.sweep_threads.empty()) return run_sweep(opt);
+
+    const size_t  rss_before = ProcessMemory::resident_bytes();
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+
+    const bool          replaying = !opt.replay_path.empty();
+    InputReplay::Player replay;
+    if (replaying) {
+        std::string error;
+        if (!replay.load(opt.replay_path, &error)) {
+            std::fprintf(stderr, "bench: %s\n", error.c_str());
+            return 1;
+        }
+    }
+
+    std::string scene_json;
+    if (opt.scene_path.empty()) {
+        scene_json = StressScene::generate(opt.scene);
+    } else {
+        std::ifstream file(opt.scene_path);
+        if (!file.is_open()) {
+            std::fprintf(stderr, "bench: cannot open %s\n", opt.scene_path.c_str());
+            return 1;
+        }
+        scene_json.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>{});
+    }
+
+    // A loaded scene's pool is the default; the generated scene's is --pool.
+    const size_t pool = opt.scene_path.empty() ? opt.scene.builder_pool : PlatformPool::DEFAULT_CAPACITY;
+    if (!build_world(world, pipeline, scene_json, physics_config_for(scene_json, opt.threads), pool, replaying)) {
+        std::fprintf(stderr, "bench: failed to load scene\n");
+        return 1;
+    }
+    Ticker ticker{pipeline};
+    if (!ticker.init(opt.static_dispatch)) return 1;
+
+    using clock = std::chrono::steady_clock;
+    auto ms_since = [](clock::time_point t0, clock::time_point t1) {
+        return std::chrono::duration<double, std::milli>(t1 - t0).count();
+    };
+
+    // One fixed step per tick at the configured rate (PhysicsConfig::fixed_hz).
+    const float fixed_dt = world.resource<FixedTime>().fixed_dt;
+    std::vector<double> update_ms, physics_ms, frame_ms, allocs;
+    update_ms.reserve(opt.ticks);
+    physics_ms.reserve(opt.ticks);
+    frame_ms.reserve(opt.ticks);
+    allocs.reserve(opt.ticks);
+
+    // Replay: frames that diverged from the recording, the first of them,
+    // and Ctrl+R / Shift+R reloads the bench cannot reproduce.
+    size_t diverged = 0, first_divergence = 0, skipped_reloads = 0;
+    InputReplay::Frame frame;
+
+    const int total_ticks = replaying ? std::numeric_limits<int>::max() : opt.warmup + opt.ticks;
+    for (int tick = 0; tick < total_ticks; ++tick) {
+        float dt = fixed_dt;
+        if (replaying) {
+            if (!replay.next(frame)) break;
+            const auto& keys = frame.input.keys_down;
+            if (frame.input.keys_pressed[KEY_R]) {
+                const bool modified = keys[KEY_LEFT_SHIFT] || keys[KEY_RIGHT_SHIFT]
+                                   || keys[KEY_LEFT_CONTROL] || keys[KEY_RIGHT_CONTROL];
+                if (modified || !PhysicsModule::restore_snapshot(world)) ++skipped_reloads;
+                else BuilderModule::rewind_pool(world);
+            }
+            if (InputReplay::checksum(world) != frame.checksum && diverged++ == 0)
+                first_divergence = replay.frame() - 1;
+            world.resource<InputRecord>() = frame.input;
+            dt = frame.dt;
+        } else {
+            BenchInput::Update(world, tick, opt.plant_every);
+        }
+
+        const uint64_t allocs0 = g_heap_allocs.load(std::memory_order_relaxed);
+        auto t0 = clock::now();
+        ticker.update(world, dt);
+        auto t1 = clock::now();
+        ticker.step_and_render(world, dt); // no renderer: Render is only TransformPropagate
+        auto t2 = clock::now();
+        const uint64_t tick_allocs = g_heap_allocs.load(std::memory_order_relaxed) - allocs0;
+
+        if (tick + 1 == opt.warmup) world.resource<FrameProfiler>().reset();
+        if (tick < opt.warmup) continue;
+        update_ms.push_back(ms_since(t0, t1));
+        physics_ms.push_back(ms_since(t1, t2));
+        frame_ms.push_back(ms_since(t0, t2));
+        allocs.push_back(static_cast<double>(tick_allocs));
+    }
+
+    std::printf("bench: %s, %zu world entities, %zu ticks (+%d warmup)%s\n",
+                opt.scene_path.empty() ? "generated scene" : opt.scene_path.c_str(),
+                static_cast<size_t>(world.count<WorldTag>()), frame_ms.size(), opt.warmup,
+                opt.static_dispatch ? ", static dispatch" : "");
+    if (replaying) {
+        if (replay.failed()) std::printf("  replay: %s is corrupt after frame %zu\n", opt.replay_path.c_str(), replay.frame());
+        if (diverged) std::printf("  replay: DIVERGED at frame %zu (%zu of %zu frames differ)\n",
+                                  first_divergence, diverged, replay.frame());
+        else          std::printf("  replay: %zu frames match the recording\n", replay.frame());
+        if (skipped_reloads) std::printf("  replay: %zu scene reloads in the recording were not replayed\n", skipped_reloads);
+    }
+    std::printf("  %-12s %9s %9s %9s %9s   (ms)\n", "phase", "p50", "p99", "mean", "max");
+    print_row("update",  summarize(update_ms));
+    print_row("physics", summarize(physics_ms));
+    print_row("total",   summarize(frame_ms));
+
+    const auto& ctx = *world.resource<std::shared_ptr<PhysicsContext>>();
+    std::printf("\n  bodies %u / %u (%u active), %u failed creates, temp peak %.2f / %.1f MB\n",
+                ctx.physics_system->GetNumBodies(), ctx.physics_system->GetMaxBodies(),
+                ctx.physics_system->GetNumActiveBodies(JPH::EBodyType::RigidBody),
+                ctx.failed_body_creates,
+                ctx.temp_allocator->peak() / (1024.0 * 1024.0),
+                ctx.temp_allocator->capacity() / (1024.0 * 1024.0));
+    std::printf("  last step: %u islands (largest %u), %u contact pairs, %u bodies fell asleep\n",
+                ctx.stats.islands, ctx.stats.largest_island, ctx.stats.contact_pairs, ctx.stats.fell_asleep);
+    const Row row = make_row(world, frame_ms, rss_before);
+    std::printf("  %.1f ticks/s, %+.1f MB resident over the run\n", row.ticks_per_sec, row.rss_delta_mb);
+
+    const Stats heap = summarize(allocs);
+    const size_t clean = static_cast<size_t>(std::count(allocs.begin(), allocs.end(), 0.0));
+    std::printf("  heap allocs/tick: mean %.2f, p99 %.0f, max %.0f; %zu of %zu ticks allocation-free\n",
+                heap.mean, heap.p99, heap.max, clean, allocs.size());
+    if (const FrameArena* arena = frame_arena(world))
+        std::printf("  frame arena: peak %.1f / %.1f KB, grew %zu times\n",
+                    arena->peak() / 1024.0, arena->capacity() / 1024.0, arena->grows());
+
+    std::printf("\n  %-16s %-11s %9s %9s   (ms)\n", "system", "phase", "mean/call", "calls");
+    for (const auto& s : world.resource<FrameProfiler>().systems()) {
+        if (!s.total_calls) continue;
+        std::printf("  %-16s %-11s %9.4f %9llu\n", s.name.c_str(), FrameProfiler::phase_name(s.phase),
+                    s.total_ms / static_cast<double>(s.total_calls),
+                    static_cast<unsigned long long>(s.total_calls));
+    }
+    if (!opt.csv_path.empty() && !write_csv(opt.csv_path, {row})) return 1;
+    return 0;
+}
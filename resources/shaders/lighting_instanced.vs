@@ -0,0 +1,31 @@
+#version 330
+in vec3 vertexPosition;
+in vec2 vertexTexCoord;
+in vec3 vertexNormal;
+in mat4 instanceTransform;
+
+out vec2 fragTexCoord;
+out vec4 fragColor;
+out vec3 fragNormal;
+out vec3 fragPosition;
+
+uniform mat4 mvp;
+
+void main() {
+    // The bottom row carries the instance colour (see src/instance_batch.hpp).
+    fragColor = vec4(instanceTransform[0][3], instanceTransform[1][3],
+                     instanceTransform[2][3], instanceTransform[3][3]);
+
+    mat4 model = instanceTransform;
+    model[0][3] = 0.0;
+    model[1][3] = 0.0;
+    model[2][3] = 0.0;
+    model[3][3] = 1.0;
+
+    vec4 worldPos = model * vec4(vertexPosition, 1.0);
+
+    fragTexCoord = vertexTexCoord;
+    fragNormal = normalize(vec3(model * vec4(vertexNormal, 0.0)));
+    fragPosition = worldPos.xyz;
+    gl_Position = mvp * worldPos;
+}
@@ -0,0 +1,331 @@
+#include "asset_cache.hpp"
+#include <chrono>
+#include <exception>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+// ---------------------------------------------------------------------------
+// Handle
+// ---------------------------------------------------------------------------
+
+void AssetCache::Handle::retain() {
+    if (id_ == NONE) return;
+    if (auto cache = cache_.lock()) {
+        std::lock_guard<std::mutex> lock(cache->m_);
+        ++cache->entries_[id_].refs;
+    }
+}
+
+void AssetCache::Handle::reset() {
+    if (id_ != NONE) {
+        if (auto cache = cache_.lock()) {
+            std::lock_guard<std::mutex> lock(cache->m_);
+            Entry& e = cache->entries_[id_];
+            if (e.refs > 0) --e.refs;
+        }
+    }
+    cache_.reset();
+    id_ = NONE;
+}
+
+// ---------------------------------------------------------------------------
+// AssetCache
+// ---------------------------------------------------------------------------
+
+AssetCache::AssetCache() { worker_ = std::thread([this] { run(); }); }
+
+AssetCache::~AssetCache() {
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stop_ = true;
+    }
+    work_cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+int AssetCache::add_kind(Kind kind) {
+    std::lock_guard<std::mutex> lock(m_);
+    kinds_.push_back(std::move(kind));
+    return static_cast<int>(kinds_.size() - 1);
+}
+
+std::string AssetCache::key_of(int kind, const std::vector<std::string>& paths) {
+    std::string key = std::to_string(kind);
+    for (const std::string& p : paths) {
+        key += '\n';
+        key += p;
+    }
+    return key;
+}
+
+AssetCache::Handle AssetCache::request(int kind, std::vector<std::string> paths) {
+    if (paths.empty()) return {};
+    const std::string key = key_of(kind, paths);
+    Id id;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        if (kind < 0 || static_cast<size_t>(kind) >= kinds_.size() || stop_) return {};
+        auto it = by_key_.find(key);
+        if (it != by_key_.end()) {
+            ++entries_[it->second].refs;
+            return Handle(weak_from_this(), it->second);
+        }
+        id = static_cast<Id>(entries_.size());
+        Entry& e = entries_.emplace_back();
+        e.kind   = kind;
+        e.paths  = std::move(paths);
+        e.refs   = 1;
+        e.queued = true;
+        by_key_.emplace(key, id);
+        jobs_.push_back(id);
+    }
+    work_cv_.notify_one();
+    return Handle(weak_from_this(), id);
+}
+
+AssetCache::State AssetCache::state(Id id) const {
+    std::lock_guard<std::mutex> lock(m_);
+    return id < entries_.size() ? entries_[id].state : State::Failed;
+}
+
+uint32_t AssetCache::version(Id id) const {
+    std::lock_guard<std::mutex> lock(m_);
+    return id < entries_.size() ? entries_[id].version : 0;
+}
+
+void AssetCache::on_upload(Id id, std::function<void()> fn) {
+    bool now = false;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        if (id >= entries_.size() || entries_[id].dead) return;
+        entries_[id].listeners.push_back(fn);
+        now = entries_[id].version > 0;
+    }
+    if (now) fn();
+}
+
+size_t AssetCache::pump() {
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        finishing_.swap(done_);
+    }
+    size_t uploads = 0;
+    for (Done& d : finishing_) {
+        std::function<bool(Id, Payload&)> upload;
+        bool reload = false;
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            Entry& e = entries_[d.id];
+            e.queued = false;
+            e.mtimes = std::move(d.mtimes);
+            if (e.dead) continue;
+            upload = kinds_[e.kind].upload;
+            reload = e.version > 0;
+        }
+
+        bool ok = d.ok;
+        if (ok && upload) {
+            try {
+                ok = upload(d.id, d.payload);
+            } catch (const std::exception&) {
+                ok = false;
+            }
+        }
+        ++uploads;
+
+        std::vector<std::function<void()>> listeners;
+        std::string                        what;
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            Entry& e = entries_[d.id];
+            if (ok) {
+                ++e.version;
+                e.state = State::Ready;
+                if (reload) ++reloads_;
+                listeners = e.listeners;
+            } else {
+                if (!reload) e.state = State::Failed;
+                ++failed_;
+                what = e.paths.front();
+            }
+        }
+        if (!ok) {
+            std::cerr << "AssetCache: " << (reload ? "reload of " : "failed to load ") << what
+                      << (reload ? " failed, keeping the previous version\n" : "\n");
+        }
+        for (auto& fn : listeners) fn();
+    }
+    finishing_.clear();
+    release(true);
+    return uploads;
+}
+
+bool AssetCache::wait(Id id) {
+    for (;;) {
+        pump();
+        std::unique_lock<std::mutex> lock(m_);
+        if (id >= entries_.size() || entries_[id].dead) return false;
+        if (entries_[id].state != State::Loading) return entries_[id].state == State::Ready;
+        done_cv_.wait(lock, [&] { return !done_.empty() || stop_; });
+        if (stop_) return false;
+    }
+}
+
+void AssetCache::collect() { release(true); }
+
+void AssetCache::release(bool unused_only) {
+    std::vector<std::pair<Id, std::function<void(Id)>>> gone;
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        for (Id id = 0; id < entries_.size(); ++id) {
+            Entry& e = entries_[id];
+            if (e.dead || (unused_only && e.refs > 0)) continue;
+            e.dead = true;
+            e.listeners.clear();
+            by_key_.erase(key_of(e.kind, e.paths));
+            if (e.version > 0) gone.emplace_back(id, kinds_[e.kind].release);
+        }
+    }
+    for (auto& [id, fn] : gone)
+        if (fn) fn(id);
+}
+
+void AssetCache::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        stop_ = true;
+        jobs_.clear();
+    }
+    work_cv_.notify_all();
+    done_cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        done_.clear();
+    }
+    release(false);
+}
+
+void AssetCache::watch(float seconds) {
+    {
+        std::lock_guard<std::mutex> lock(m_);
+        watch_ = seconds;
+    }
+    work_cv_.notify_all();
+}
+
+size_t AssetCache::live() const {
+    std::lock_guard<std::mutex> lock(m_);
+    size_t n = 0;
+    for (const Entry& e : entries_) n += !e.dead && e.refs > 0 ? 1 : 0;
+    return n;
+}
+
+size_t AssetCache::loading() const {
+    std::lock_guard<std::mutex> lock(m_);
+    size_t n = 0;
+    for (const Entry& e : entries_) n += !e.dead && e.queued ? 1 : 0;
+    return n;
+}
+
+// ---------------------------------------------------------------------------
+// Worker
+// ---------------------------------------------------------------------------
+
+void AssetCache::run() {
+    using Steady = std::chrono::steady_clock;
+    std::unique_lock<std::mutex> lock(m_);
+    Steady::time_point next_poll = Steady::now();
+
+    while (!stop_) {
+        const auto ready = [&] { return stop_ || !jobs_.empty(); };
+        if (watch_ > 0.0f) work_cv_.wait_until(lock, next_poll, ready);
+        else work_cv_.wait(lock, [&] { return ready() || watch_ > 0.0f; }); // watch() wakes it
+        if (stop_) break;
+
+        if (jobs_.empty()) {
+            if (watch_ > 0.0f && Steady::now() >= next_poll) {
+                poll_files(lock);
+                next_poll = Steady::now() +
+                            std::chrono::duration_cast<Steady::duration>(std::chrono::duration<float>(watch_));
+            }
+            continue;
+        }
+
+        const Id id = jobs_.front();
+        jobs_.pop_front();
+        Entry& e = entries_[id];
+        if (e.dead) {
+            e.queued = false;
+            continue;
+        }
+        const std::vector<std::string> paths = e.paths;
+        const auto decode = kinds_[e.kind].decode;
+        lock.unlock();
+
+        Done d{id, true, {}, {}};
+        d.payload.paths = paths;
+        for (const std::string& path : paths) {
+            std::error_code ec;
+            d.mtimes.push_back(fs::last_write_time(path, ec));
+            std::ifstream in(path, std::ios::binary);
+            if (!in) {
+                d.ok = false;
+                break;
+            }
+            d.payload.files.emplace_back(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+            bytes_read_.fetch_add(d.payload.files.back().size(), std::memory_order_relaxed);
+        }
+        d.mtimes.resize(paths.size());
+        if (d.ok && decode) {
+            try {
+                d.ok = decode(d.payload);
+            } catch (const std::exception&) {
+                d.ok = false;
+            }
+        }
+
+        lock.lock();
+        done_.push_back(std::move(d));
+        done_cv_.notify_all();
+    }
+}
+
+// Queues a reload of every asset whose files' modification times differ
+// from those of its last read. The stat calls run unlocked.
+void AssetCache::poll_files(std::unique_lock<std::mutex>& lock) {
+    struct Watched {
+        Id                       id;
+        std::vector<std::string> paths;
+        std::vector<Clock>       mtimes;
+    };
+    std::vector<Watched> watched;
+    for (Id id = 0; id < entries_.size(); ++id) {
+        const Entry& e = entries_[id];
+        if (!e.dead && !e.queued) watched.push_back({id, e.paths, e.mtimes});
+    }
+    lock.unlock();
+
+    std::vector<Id> changed;
+    for (const Watched& w : watched) {
+        for (size_t i = 0; i < w.paths.size(); ++i) {
+            std::error_code ec;
+            if (fs::last_write_time(w.paths[i], ec) != w.mtimes[i]) {
+                changed.push_back(w.id);
+                break;
+            }
+        }
+    }
+
+    lock.lock();
+    for (Id id : changed) {
+        Entry& e = entries_[id];
+        if (e.dead || e.queued) continue;
+        e.queued = true;
+        jobs_.push_back(id);
+    }
+}
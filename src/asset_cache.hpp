@@ -0,0 +1,168 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// AssetCache — assets keyed by path, read on a worker thread, finished on
+// the main thread, ref-counted, and reloaded when their files change.
+//
+// A Kind says how one sort of asset is made. decode() runs on the worker
+// after the files are read (a WAV can be decoded there); upload() runs on
+// the main thread in pump() and creates the engine object (GL program,
+// audio buffer), replacing the asset's previous one; release() destroys it.
+// AssetManager (asset_manager.hpp) supplies the Raylib kinds.
+//
+//   request(kind, paths) — a Handle to the asset for these files, shared
+//                          with every other request for the same ones. The
+//                          first request queues the load; nothing blocks.
+//   pump()               — main thread, once a frame: upload() what the
+//                          worker has finished, run on_upload() listeners,
+//                          release() assets no Handle refers to any more.
+//   wait(id)             — pump() until that asset is no longer Loading, for
+//                          the few things a frame can't be drawn without.
+//   watch(seconds)       — the worker compares the files' modification times
+//                          at that interval and reloads any that changed.
+//                          A reload that fails keeps the previous version.
+//
+// Handles are cheap to copy and may outlive the cache (they hold it weakly).
+// request(), pump(), wait() and collect() are main-thread only, since they
+// call the Kind. Call shutdown() while the Kind's engine is still up.
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+class AssetCache : public std::enable_shared_from_this<AssetCache> {
+public:
+    using Id = uint32_t;
+    static constexpr Id NONE = ~0u;
+
+    enum class State : uint8_t { Loading, Ready, Failed };
+
+    // One load's files (paths and contents, in request order) and whatever
+    // decode() made of them (freed with the payload).
+    struct Payload {
+        std::vector<std::string> paths;
+        std::vector<std::string> files;
+        std::shared_ptr<void>    decoded;
+    };
+
+    struct Kind {
+        std::function<bool(Payload&)>     decode;  // worker thread, optional
+        std::function<bool(Id, Payload&)> upload;  // main thread; false keeps the old object
+        std::function<void(Id)>           release; // main thread
+    };
+
+    class Handle {
+    public:
+        Handle() = default;
+        Handle(const Handle& o) : cache_(o.cache_), id_(o.id_) { retain(); }
+        Handle(Handle&& o) noexcept : cache_(std::move(o.cache_)), id_(o.id_) { o.id_ = NONE; }
+        Handle& operator=(Handle o) noexcept {
+            std::swap(cache_, o.cache_);
+            std::swap(id_, o.id_);
+            return *this;
+        }
+        ~Handle() { reset(); }
+
+        void reset();
+        Id   id() const { return id_; }
+        explicit operator bool() const { return id_ != NONE; }
+
+    private:
+        friend class AssetCache;
+        Handle(std::weak_ptr<AssetCache> cache, Id id) : cache_(std::move(cache)), id_(id) {}
+        void retain();
+
+        std::weak_ptr<AssetCache> cache_;
+        Id                        id_ = NONE;
+    };
+
+    // Create with std::make_shared (Handles keep a weak_ptr to it).
+    AssetCache();
+    ~AssetCache();
+
+    AssetCache(const AssetCache&)            = delete;
+    AssetCache& operator=(const AssetCache&) = delete;
+
+    int add_kind(Kind kind);
+
+    // An empty Handle for an unknown kind or no paths.
+    Handle request(int kind, std::vector<std::string> paths);
+
+    State    state(Id id) const;
+    uint32_t version(Id id) const; // successful uploads so far (0 until loaded)
+
+    // fn runs after every successful upload of `id` from pump(), while the
+    // object it replaced is still alive, and at once if `id` is already
+    // loaded.
+    void on_upload(Id id, std::function<void()> fn);
+
+    // Returns the number of uploads attempted.
+    size_t pump();
+    bool   wait(Id id);
+    // Releases every asset no Handle refers to, without waiting for pump().
+    void   collect();
+    // Releases everything and stops the worker. Handles stay safe to drop.
+    void   shutdown();
+
+    void watch(float seconds);
+
+    size_t live()    const; // assets with a Handle
+    size_t loading() const;
+    size_t reloads() const { return reloads_; }
+    size_t failed()  const { return failed_; }
+    size_t bytes_read() const { return bytes_read_.load(std::memory_order_relaxed); }
+
+private:
+    using Clock = std::filesystem::file_time_type;
+
+    struct Entry {
+        int                      kind = -1;
+        std::vector<std::string> paths;
+        std::vector<Clock>       mtimes;      // as of the last read
+        State                    state  = State::Loading;
+        uint32_t                 refs   = 0;
+        uint32_t                 version = 0;
+        bool                     queued  = false; // on jobs_, being read, or on done_
+        bool                     dead    = false; // released; ids are not reused
+        std::vector<std::function<void()>> listeners;
+    };
+    struct Done {
+        Id                 id;
+        bool               ok;
+        Payload            payload;
+        std::vector<Clock> mtimes;
+    };
+
+    mutable std::mutex                     m_;
+    std::condition_variable                work_cv_, done_cv_;
+    std::vector<Kind>                      kinds_;
+    std::vector<Entry>                     entries_;
+    std::unordered_map<std::string, Id>    by_key_;
+    std::deque<Id>                         jobs_;
+    std::vector<Done>                      done_;
+    std::vector<Done>                      finishing_; // pump()'s swap buffer
+    bool                                   stop_  = false;
+    float                                  watch_ = 0.0f;
+    std::thread                            worker_;
+
+    size_t              reloads_ = 0;
+    size_t              failed_  = 0;
+    std::atomic<size_t> bytes_read_{0};
+
+    void run();
+    void poll_files(std::unique_lock<std::mutex>& lock);
+    void release(bool unused_only);
+    static std::string key_of(int kind, const std::vector<std::string>& paths);
+};
@@ -0,0 +1,137 @@
+#pragma once
+#include "asset_cache.hpp"
+#include <raylib.h>
+#include <rlgl.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// AssetManager — shaders and sounds through an AssetCache.
+//
+// The worker reads shader sources and WAV files and decodes the WAVs
+// (LoadWaveFromMemory touches no device); pump() compiles the shaders
+// (LoadShaderFromMemory: GL) and creates the sounds (LoadSoundFromWave:
+// audio device) on the main thread. Until then shader() / sound() return
+// null. A shader that fails to compile counts as failed, so a broken edit
+// leaves the running program in place.
+//
+// On a reload the old object is unloaded after the on_upload() listeners
+// have run, so a listener can still stop aliases of the old Sound or drop
+// locations of the old Shader before it goes.
+//
+// World resource, as std::shared_ptr<AssetManager> (it owns the cache's
+// thread), created by AssetModule. shutdown() before CloseAudioDevice() and
+// CloseWindow().
+// ---------------------------------------------------------------------------
+
+class AssetManager {
+public:
+    using Handle = AssetCache::Handle;
+
+    AssetManager() : cache_(std::make_shared<AssetCache>()) {
+        shader_kind_ = cache_->add_kind({
+            {},
+            [this](AssetCache::Id id, AssetCache::Payload& p) {
+                const Shader s = LoadShaderFromMemory(p.files[0].c_str(), p.files[1].c_str());
+                if (s.id == 0 || s.id == rlGetShaderIdDefault()) return false;
+                replace(shaders_, retired_shaders_, id, s);
+                return true;
+            },
+            [this](AssetCache::Id id) { retire(shaders_, retired_shaders_, id); },
+        });
+        sound_kind_ = cache_->add_kind({
+            [](AssetCache::Payload& p) {
+                const std::string& bytes = p.files[0];
+                Wave wave = LoadWaveFromMemory(GetFileExtension(p.paths[0].c_str()),
+                                               reinterpret_cast<const unsigned char*>(bytes.data()),
+                                               static_cast<int>(bytes.size()));
+                if (!wave.data) return false;
+                p.decoded = std::shared_ptr<Wave>(new Wave(wave), [](Wave* w) { UnloadWave(*w); delete w; });
+                return true;
+            },
+            [this](AssetCache::Id id, AssetCache::Payload& p) {
+                const Sound s = LoadSoundFromWave(*static_cast<Wave*>(p.decoded.get()));
+                if (!s.stream.buffer) return false;
+                replace(sounds_, retired_sounds_, id, s);
+                return true;
+            },
+            [this](AssetCache::Id id) { retire(sounds_, retired_sounds_, id); },
+        });
+    }
+
+    AssetManager(const AssetManager&)            = delete;
+    AssetManager& operator=(const AssetManager&) = delete;
+
+    Handle load_shader(const std::string& vs, const std::string& fs) { return cache_->request(shader_kind_, {vs, fs}); }
+    Handle load_sound(const std::string& path) { return cache_->request(sound_kind_, {path}); }
+
+    // Null until loaded.
+    const Shader* shader(const Handle& h) const { return find(shaders_, h); }
+    const Sound*  sound(const Handle& h) const { return find(sounds_, h); }
+
+    void on_upload(const Handle& h, std::function<void()> fn) { cache_->on_upload(h.id(), std::move(fn)); }
+
+    void pump() {
+        cache_->pump();
+        unload_retired();
+    }
+    bool wait(const Handle& h) {
+        const bool ok = cache_->wait(h.id());
+        unload_retired();
+        return ok;
+    }
+    void collect() {
+        cache_->collect();
+        unload_retired();
+    }
+    void shutdown() {
+        cache_->shutdown();
+        unload_retired();
+    }
+
+    AssetCache&       cache()       { return *cache_; }
+    const AssetCache& cache() const { return *cache_; }
+
+private:
+    std::shared_ptr<AssetCache> cache_;
+    int                         shader_kind_ = -1;
+    int                         sound_kind_  = -1;
+
+    std::unordered_map<AssetCache::Id, Shader> shaders_;
+    std::unordered_map<AssetCache::Id, Sound>  sounds_;
+    std::vector<Shader>                        retired_shaders_;
+    std::vector<Sound>                         retired_sounds_;
+
+    template <typename T>
+    static void replace(std::unordered_map<AssetCache::Id, T>& live, std::vector<T>& retired, AssetCache::Id id,
+                        const T& value) {
+        auto [it, added] = live.try_emplace(id, value);
+        if (!added) {
+            retired.push_back(it->second);
+            it->second = value;
+        }
+    }
+
+    template <typename T>
+    static void retire(std::unordered_map<AssetCache::Id, T>& live, std::vector<T>& retired, AssetCache::Id id) {
+        auto it = live.find(id);
+        if (it == live.end()) return;
+        retired.push_back(it->second);
+        live.erase(it);
+    }
+
+    template <typename T>
+    static const T* find(const std::unordered_map<AssetCache::Id, T>& live, const Handle& h) {
+        auto it = live.find(h.id());
+        return it != live.end() ? &it->second : nullptr;
+    }
+
+    void unload_retired() {
+        for (const Shader& s : retired_shaders_) UnloadShader(s);
+        for (const Sound& s : retired_sounds_) UnloadSound(s);
+        retired_shaders_.clear();
+        retired_sounds_.clear();
+    }
+};
@@ -1,10 +1,24 @@
 #pragma once
+#include "asset_manager.hpp"
+#include "instance_batch.hpp"
+#include "render_state.hpp"
 #include <raylib.h>
 #include <raymath.h>
+#include <rlgl.h>
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
+// Shaders come from the AssetManager (RFC-0056): load() requests them and
+// starts with Raylib's default shader in their place; bind_shaders() takes
+// the compiled programs once they are uploaded, and again after every hot
+// reload (RenderModule registers it with on_upload).
 struct AssetResource {
+    AssetManager::Handle lighting_handle;
+    AssetManager::Handle instanced_handle;
+
     Shader lighting_shader;
-    
+
     // Uniform Locations
     int lightDirLoc;
     int lightColorLoc;
@@ -13,25 +27,193 @@ struct AssetResource {
     int shadowRadiusLoc;
     int shadowIntensityLoc;
 
-    void load() {
-        lighting_shader = LoadShader("resources/shaders/lighting.vs", "resources/shaders/lighting.fs");
-        lightDirLoc = GetShaderLocation(lighting_shader, "lightDir");
-        lightColorLoc = GetShaderLocation(lighting_shader, "lightColor");
-        ambientLoc = GetShaderLocation(lighting_shader, "ambient");
-        playerPosLoc = GetShaderLocation(lighting_shader, "playerPos");
-        shadowRadiusLoc = GetShaderLocation(lighting_shader, "shadowRadius");
-        shadowIntensityLoc = GetShaderLocation(lighting_shader, "shadowIntensity");
+    // Instanced path (RenderSystem): lighting.fs with a per-instance vertex
+    // stage, pre-built unit meshes per ShapeType and RenderLod level. Boxes
+    // have one mesh; spheres and capsules are baked coarser per level.
+    Shader   instanced_shader;
+    Material instanced_material;
+    int      instPlayerPosLoc;
+    int      instShadowRadiusLoc;
+    int      instShadowIntensityLoc;
+
+    Mesh box_mesh;
+    Mesh sphere_mesh[InstanceBatch::LOD_COUNT];
+    Mesh capsule_mesh[InstanceBatch::LOD_COUNT];
+
+    // Per-frame scratch for RenderSystem::Draw, reused so steady-state
+    // frames don't allocate. (The instances themselves live in the
+    // RenderSnapshot.)
+    std::vector<Matrix> upload;
+    DrawQueue           draws;
+
+    // Shadow copies of every uniform set through set_uniform(), and last
+    // frame's draw / state-change counts (render_state.hpp).
+    UniformCache uniforms;
+    RenderStats  stats;
+
+    // Requests the shaders; the meshes are built while the worker reads them.
+    void load(AssetManager& manager) {
+        lighting_handle  = manager.load_shader("resources/shaders/lighting.vs", "resources/shaders/lighting.fs");
+        instanced_handle = manager.load_shader("resources/shaders/lighting_instanced.vs", "resources/shaders/lighting.fs");
+        lighting_shader  = default_shader();
+        instanced_shader = default_shader();
+        lightDirLoc = lightColorLoc = ambientLoc = playerPosLoc = shadowRadiusLoc = shadowIntensityLoc = -1;
+        instPlayerPosLoc = instShadowRadiusLoc = instShadowIntensityLoc = -1;
+
+        instanced_material = LoadMaterialDefault();
+        instanced_material.shader = instanced_shader;
+
+        // Same dimensions as the former DrawCube/DrawSphere/DrawCapsule calls,
+        // so existing scenes render unchanged. Level 0 keeps their
+        // tessellation; levels 1 and 2 are for instances RenderLod judges
+        // small on screen.
+        box_mesh = GenMeshCube(1.0f, 1.0f, 1.0f);
+        static constexpr int SPHERE_RINGS[]   = {16, 10, 6};
+        static constexpr int SPHERE_SLICES[]  = {16, 10, 6};
+        static constexpr int CAPSULE_SLICES[] = {16, 10, 6};
+        static constexpr int CAPSULE_RINGS[]  = {8, 4, 2};
+        for (size_t i = 0; i < InstanceBatch::LOD_COUNT; ++i) {
+            sphere_mesh[i]  = GenMeshSphere(0.5f, SPHERE_RINGS[i], SPHERE_SLICES[i]);
+            capsule_mesh[i] = GenMeshCapsule(0.4f, 1.8f, CAPSULE_SLICES[i], CAPSULE_RINGS[i]);
+        }
+    }
+
+    // Takes the manager's current programs (those not loaded yet keep the
+    // default shader) and looks their uniforms up again.
+    void bind_shaders(const AssetManager& manager) {
+        if (const Shader* s = manager.shader(lighting_handle)) {
+            lighting_shader    = *s;
+            lightDirLoc        = GetShaderLocation(lighting_shader, "lightDir");
+            lightColorLoc      = GetShaderLocation(lighting_shader, "lightColor");
+            ambientLoc         = GetShaderLocation(lighting_shader, "ambient");
+            playerPosLoc       = GetShaderLocation(lighting_shader, "playerPos");
+            shadowRadiusLoc    = GetShaderLocation(lighting_shader, "shadowRadius");
+            shadowIntensityLoc = GetShaderLocation(lighting_shader, "shadowIntensity");
+        }
+        if (const Shader* s = manager.shader(instanced_handle)) {
+            instanced_shader = *s;
+            instanced_shader.locs[SHADER_LOC_MATRIX_MVP]         = GetShaderLocation(instanced_shader, "mvp");
+            instanced_shader.locs[SHADER_LOC_VERTEX_INSTANCE_TX] = GetShaderLocationAttrib(instanced_shader, "instanceTransform");
+            instPlayerPosLoc       = GetShaderLocation(instanced_shader, "playerPos");
+            instShadowRadiusLoc    = GetShaderLocation(instanced_shader, "shadowRadius");
+            instShadowIntensityLoc = GetShaderLocation(instanced_shader, "shadowIntensity");
+        }
+        instanced_material.shader = instanced_shader;
+        // A new program holds none of the cached values.
+        uniforms.clear();
+        set_static_lighting(lighting_shader);
+        set_static_lighting(instanced_shader);
+    }
+
+    // The shaders themselves belong to the manager: drop the handles and
+    // let collect() unload them.
+    void unload(AssetManager& manager) {
+        UnloadMesh(box_mesh);
+        for (size_t i = 0; i < InstanceBatch::LOD_COUNT; ++i) {
+            UnloadMesh(sphere_mesh[i]);
+            UnloadMesh(capsule_mesh[i]);
+        }
+        instanced_material.shader = default_shader(); // UnloadMaterial skips the default shader
+        UnloadMaterial(instanced_material);
+        lighting_handle.reset();
+        instanced_handle.reset();
+        manager.collect();
+    }
 
-        // Set Static Defaults
+    // SetShaderValue, skipped when the program already holds this value.
+    void set_uniform(Shader shader, int loc, const void* value, int type) {
+        if (uniforms.update(shader.id, loc, value, uniform_bytes(type), &stats))
+            SetShaderValue(shader, loc, value, type);
+    }
+
+    const Mesh& mesh_for(ShapeType shape, int lod = 0) const {
+        const size_t i = lod <= 0 ? 0 : std::min(static_cast<size_t>(lod), InstanceBatch::LOD_COUNT - 1);
+        switch (shape) {
+            case ShapeType::Sphere:  return sphere_mesh[i];
+            case ShapeType::Capsule: return capsule_mesh[i];
+            case ShapeType::Box:
+            default:                 return box_mesh;
+        }
+    }
+
+private:
+    static Shader default_shader() { return {rlGetShaderIdDefault(), rlGetShaderLocsDefault()}; }
+
+    void set_static_lighting(Shader shader) {
         Vector3 dir = Vector3Normalize({-0.5f, -1.0f, -0.3f});
-        SetShaderValue(lighting_shader, lightDirLoc, &dir, SHADER_UNIFORM_VEC3);
+        set_uniform(shader, GetShaderLocation(shader, "lightDir"), &dir, SHADER_UNIFORM_VEC3);
         Vector4 color = {1.0f, 1.0f, 0.9f, 1.0f};
-        SetShaderValue(lighting_shader, lightColorLoc, &color, SHADER_UNIFORM_VEC4);
+        set_uniform(shader, GetShaderLocation(shader, "lightColor"), &color, SHADER_UNIFORM_VEC4);
         Vector4 ambient = {0.3f, 0.3f, 0.35f, 1.0f};
-        SetShaderValue(lighting_shader, ambientLoc, &ambient, SHADER_UNIFORM_VEC4);
+        set_uniform(shader, GetShaderLocation(shader, "ambient"), &ambient, SHADER_UNIFORM_VEC4);
+    }
+
+    static size_t uniform_bytes(int type) {
+        switch (type) {
+            case SHADER_UNIFORM_FLOAT: case SHADER_UNIFORM_INT:   case SHADER_UNIFORM_SAMPLER2D: return 4;
+            case SHADER_UNIFORM_VEC2:  case SHADER_UNIFORM_IVEC2: return 8;
+            case SHADER_UNIFORM_VEC3:  case SHADER_UNIFORM_IVEC3: return 12;
+            case SHADER_UNIFORM_VEC4:  case SHADER_UNIFORM_IVEC4: return 16;
+            default:                   return UniformCache::MAX_BYTES + 1; // unknown: never cached
+        }
     }
 
-    void unload() {
-        UnloadShader(lighting_shader);
+    // Raylib has no capsule generator. Hemispheres of `radius` centred at
+    // y = 0 and y = height, joined by a cylinder — matching
+    // DrawCapsule({0,0,0}, {0,height,0}, radius, ...).
+    static Mesh GenMeshCapsule(float radius, float height, int slices, int rings) {
+        const int rows  = 2 * (rings + 1);
+        const int cols  = slices + 1; // duplicated seam column for texcoords
+        const int verts = rows * cols;
+        const int tris  = (rows - 1) * slices * 2;
+
+        Mesh mesh = {};
+        mesh.vertexCount   = verts;
+        mesh.triangleCount = tris;
+        mesh.vertices  = static_cast<float*>(MemAlloc(verts * 3 * sizeof(float)));
+        mesh.normals   = static_cast<float*>(MemAlloc(verts * 3 * sizeof(float)));
+        mesh.texcoords = static_cast<float*>(MemAlloc(verts * 2 * sizeof(float)));
+        mesh.indices   = static_cast<unsigned short*>(MemAlloc(tris * 3 * sizeof(unsigned short)));
+
+        int v = 0;
+        for (int row = 0; row < rows; ++row) {
+            // Bottom hemisphere: -90..0 degrees; top hemisphere: 0..90 degrees.
+            const bool  top    = row > rings;
+            const int   i      = top ? row - (rings + 1) : row;
+            const float a      = (top ? 0.0f : -PI / 2.0f) + (PI / 2.0f) * static_cast<float>(i) / static_cast<float>(rings);
+            const float ring_r = std::cos(a);
+            const float ny     = std::sin(a);
+            const float cy     = top ? height : 0.0f;
+
+            for (int j = 0; j < cols; ++j, ++v) {
+                const float t  = 2.0f * PI * static_cast<float>(j) / static_cast<float>(slices);
+                const float nx = std::cos(t) * ring_r;
+                const float nz = std::sin(t) * ring_r;
+                mesh.vertices[v * 3 + 0] = nx * radius;
+                mesh.vertices[v * 3 + 1] = cy + ny * radius;
+                mesh.vertices[v * 3 + 2] = nz * radius;
+                mesh.normals[v * 3 + 0]  = nx;
+                mesh.normals[v * 3 + 1]  = ny;
+                mesh.normals[v * 3 + 2]  = nz;
+                mesh.texcoords[v * 2 + 0] = static_cast<float>(j) / static_cast<float>(slices);
+                mesh.texcoords[v * 2 + 1] = static_cast<float>(row) / static_cast<float>(rows - 1);
+            }
+        }
+
+        int k = 0;
+        for (int row = 0; row < rows - 1; ++row) {
+            for (int j = 0; j < slices; ++j) {
+                const auto lo0 = static_cast<unsigned short>(row * cols + j);
+                const auto lo1 = static_cast<unsigned short>(lo0 + 1);
+                const auto hi0 = static_cast<unsigned short>(lo0 + cols);
+                const auto hi1 = static_cast<unsigned short>(hi0 + 1);
+                // Counter-clockwise seen from outside.
+                mesh.indices[k++] = lo0; mesh.indices[k++] = hi0; mesh.indices[k++] = lo1;
+                mesh.indices[k++] = hi0; mesh.indices[k++] = hi1; mesh.indices[k++] = lo1;
+            }
+        }
+
+        UploadMesh(&mesh, false);
+        return mesh;
     }
 };
@@ -1,5 +1,9 @@
 #pragma once
+#include "asset_manager.hpp"
+#include "voice_pool.hpp"
 #include <raylib.h>
+#include <array>
+#include <vector>
 
 // ---------------------------------------------------------------------------
 // AudioResource — owns all audio clip and music-stream handles.
@@ -7,26 +11,65 @@
 // Stored as a World resource. Loaded once at startup (after InitAudioDevice),
 // unloaded at shutdown (before CloseAudioDevice).
 //
-// LoadSound() returns a zeroed Sound on missing file; PlaySound() on a zeroed
-// Sound is a no-op, so the system degrades gracefully during development.
+// Each clip is one Sound (the sample data), owned by the AssetManager, plus
+// VoicePool::ALIASES LoadSoundAlias voices that share it, so a clip can
+// overlap itself without reloading. Only the aliases are played; the pool
+// decides which, and how loud. load() only requests the files: bind()
+// creates a clip's aliases once its Sound is uploaded, and recreates them
+// after a hot reload (AudioModule registers it with on_upload), releasing
+// the old aliases with UnloadSoundAlias before their Sound goes.
+//
+// Voices stay zeroed until then, and for a file that is missing;
+// PlaySound() on a zeroed Sound is a no-op, so the system degrades
+// gracefully during development.
 // ---------------------------------------------------------------------------
 
+enum class AudioClip : int {
+    Jump,   // first jump
+    Jump2,  // double jump (higher pitch)
+    Land,   // landing impact
+    Count
+};
+
 struct AudioResource {
-    Sound snd_jump;     // first jump
-    Sound snd_jump2;    // double jump (higher pitch)
-    Sound snd_land;     // landing impact
+    static constexpr size_t CLIPS = static_cast<size_t>(AudioClip::Count);
+
+    std::array<AssetManager::Handle, CLIPS>       clips;
+    std::array<Sound, CLIPS * VoicePool::ALIASES> voices{};
+    VoicePool                                     pool;
+    std::vector<VoicePool::Command>               commands; // reused by AudioSystem
 
     // Music bgm{};    // reserved: background music stream (UpdateMusicStream each frame)
 
-    void load() {
-        snd_jump  = LoadSound("resources/sounds/jump.wav");
-        snd_jump2 = LoadSound("resources/sounds/jump2.wav");
-        snd_land  = LoadSound("resources/sounds/land.wav");
+    void load(AssetManager& manager) {
+        clips[int(AudioClip::Jump)]  = manager.load_sound("resources/sounds/jump.wav");
+        clips[int(AudioClip::Jump2)] = manager.load_sound("resources/sounds/jump2.wav");
+        clips[int(AudioClip::Land)]  = manager.load_sound("resources/sounds/land.wav");
+
+        // Registered in AudioClip order, so a clip's pool id is its value.
+        pool.add_clip({1.0f, 1.0f});  // Jump
+        pool.add_clip({1.0f, 1.0f});  // Jump2
+        pool.add_clip({0.6f, 0.8f});  // Land: frequent, dropped first
+    }
+
+    // Points the clip's voices at the manager's current Sound.
+    void bind(const AssetManager& manager, AudioClip clip) {
+        const Sound* sound = manager.sound(clips[int(clip)]);
+        for (size_t a = 0; a < VoicePool::ALIASES; ++a) {
+            Sound& v = voices[int(clip) * VoicePool::ALIASES + a];
+            if (v.stream.buffer) UnloadSoundAlias(v);
+            v = sound ? LoadSoundAlias(*sound) : Sound{};
+        }
     }
 
-    void unload() {
-        UnloadSound(snd_jump);
-        UnloadSound(snd_jump2);
-        UnloadSound(snd_land);
+    // The Sounds belong to the manager: drop the handles and let collect()
+    // unload them.
+    void unload(AssetManager& manager) {
+        for (Sound& v : voices) {
+            if (v.stream.buffer) UnloadSoundAlias(v);
+            v = Sound{};
+        }
+        for (auto& clip : clips) clip.reset();
+        manager.collect();
     }
 };
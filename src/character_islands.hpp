@@ -0,0 +1,106 @@
+#pragma once
+#include <ecs/ecs.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <numeric>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// CharacterIslands — groups characters that could touch this frame.
+//
+// CharacterMotorSystem updates characters in parallel, but a character
+// colliding with another reads that character's pose, so two characters in
+// reach of each other must be stepped by the same job. build() unions every
+// pair closer than `reach` (transitively) using a grid of reach-sized cells,
+// giving dense group ids 0..group_count()-1. Characters in different groups
+// cannot interact and are safe to step concurrently.
+//
+// The grid is a flat array of (cell key, character) pairs sorted by key; a
+// neighbour cell is a binary search into it. It, the union-find and the
+// group arrays are reused across frames, so once they have grown to the
+// character count build() does not allocate.
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+class CharacterIslands {
+public:
+    // Returns the number of groups. group_of(i) is valid for i < positions.size().
+    size_t build(const std::vector<ecs::Vec3>& positions, float reach) {
+        const size_t n = positions.size();
+        parent_.resize(n);
+        std::iota(parent_.begin(), parent_.end(), 0u);
+        group_.assign(n, 0);
+        groups_ = 0;
+        if (n == 0) return 0;
+
+        const float inv  = reach > 0.0f ? 1.0f / reach : 0.0f;
+        const float r2   = reach * reach;
+        cells_.clear();
+        for (uint32_t i = 0; i < n; ++i)
+            cells_.emplace_back(key(cell(positions[i].x * inv), cell(positions[i].y * inv), cell(positions[i].z * inv)), i);
+        std::sort(cells_.begin(), cells_.end());
+
+        for (uint32_t i = 0; i < n; ++i) {
+            const ecs::Vec3& p = positions[i];
+            const int32_t cx = cell(p.x * inv), cy = cell(p.y * inv), cz = cell(p.z * inv);
+            for (int32_t dx = -1; dx <= 1; ++dx)
+            for (int32_t dy = -1; dy <= 1; ++dy)
+            for (int32_t dz = -1; dz <= 1; ++dz) {
+                const uint64_t k = key(cx + dx, cy + dy, cz + dz);
+                auto it = std::lower_bound(cells_.begin(), cells_.end(), Cell{k, 0});
+                for (; it != cells_.end() && it->first == k; ++it) {
+                    const uint32_t j = it->second;
+                    if (j <= i) continue;
+                    const float ex = positions[j].x - p.x, ey = positions[j].y - p.y, ez = positions[j].z - p.z;
+                    if (ex * ex + ey * ey + ez * ez <= r2) unite(i, j);
+                }
+            }
+        }
+
+        // Dense ids in first-seen order, so the result is deterministic.
+        std::vector<int>& remap = remap_;
+        remap.assign(n, -1);
+        for (uint32_t i = 0; i < n; ++i) {
+            const uint32_t root = find(i);
+            if (remap[root] < 0) remap[root] = static_cast<int>(groups_++);
+            group_[i] = static_cast<uint32_t>(remap[root]);
+        }
+        return groups_;
+    }
+
+    uint32_t group_of(size_t i) const { return group_[i]; }
+    size_t   group_count()      const { return groups_; }
+
+private:
+    std::vector<uint32_t>                                parent_;
+    std::vector<uint32_t>                                group_;
+    std::vector<int>                                     remap_;
+    using Cell = std::pair<uint64_t, uint32_t>;                     // (cell key, character)
+    std::vector<Cell>                                    cells_;     // sorted by key
+    size_t                                               groups_ = 0;
+
+    static int32_t cell(float v) { return static_cast<int32_t>(std::floor(v)); }
+
+    static uint64_t key(int32_t x, int32_t y, int32_t z) {
+        const auto m = [](int32_t v) { return static_cast<uint64_t>(static_cast<uint32_t>(v) & 0x1fffffu); };
+        return (m(x) << 42) | (m(y) << 21) | m(z);
+    }
+
+    uint32_t find(uint32_t i) {
+        while (parent_[i] != i) {
+            parent_[i] = parent_[parent_[i]];
+            i = parent_[i];
+        }
+        return i;
+    }
+
+    void unite(uint32_t a, uint32_t b) {
+        a = find(a);
+        b = find(b);
+        if (a == b) return;
+        if (a < b) parent_[b] = a; else parent_[a] = b;
+    }
+};
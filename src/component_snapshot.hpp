@@ -0,0 +1,69 @@
+#pragma once
+#include <ecs/ecs.hpp>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// ComponentSnapshot<Ts...> — a copy of every Ts component in the world,
+// keyed by entity.
+//
+// capture() walks each type once and stores (entity, value) pairs. restore()
+// writes each value back in place, so no component is added or removed and
+// no hook fires. A value is skipped if its entity has died or no longer has
+// that component, and restore() counts only the values it wrote. The ECS half
+// of PhysicsSnapshot.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+template <typename... Ts>
+class ComponentSnapshot {
+public:
+    void capture(ecs::World& world) {
+        (capture_one<Ts>(world), ...);
+    }
+
+    // Components written back.
+    size_t restore(ecs::World& world) const {
+        size_t written = 0;
+        (restore_one<Ts>(world, written), ...);
+        return written;
+    }
+
+    // Components held, across all types.
+    size_t size() const {
+        return std::apply([](const auto&... col) { return (size_t{0} + ... + col.size()); }, columns_);
+    }
+
+    template <typename T>
+    size_t count() const { return std::get<Column<T>>(columns_).size(); }
+
+    void clear() {
+        std::apply([](auto&... col) { (col.clear(), ...); }, columns_);
+    }
+
+private:
+    template <typename T>
+    using Column = std::vector<std::pair<ecs::Entity, T>>;
+
+    std::tuple<Column<Ts>...> columns_;
+
+    template <typename T>
+    void capture_one(ecs::World& world) {
+        Column<T>& col = std::get<Column<T>>(columns_);
+        col.clear();
+        world.each<T>([&](ecs::Entity e, T& value) { col.emplace_back(e, value); });
+    }
+
+    template <typename T>
+    void restore_one(ecs::World& world, size_t& written) const {
+        for (const auto& [e, value] : std::get<Column<T>>(columns_)) {
+            if (T* live = world.alive(e) ? world.try_get<T>(e) : nullptr) {
+                *live = value;
+                ++written;
+            }
+        }
+    }
+};
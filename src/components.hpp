@@ -1,6 +1,8 @@
 #pragma once
+#include "physics_query.hpp"
 #include <ecs/ecs.hpp>
 #include <ecs/modules/transform.hpp>
+#include <string>
 
 // ---------------------------------------------------------------------------
 // Render types  (no external library dependencies)
@@ -37,6 +39,12 @@ namespace Colors {
 
 enum class BodyType { Static, Kinematic, Dynamic };
 
+// Collision detection for a Dynamic body. LinearCast sweeps it along its
+// motion each step, so a fast small body cannot tunnel through thin
+// geometry; Auto switches between the two by speed against the body's size
+// (PhysicsConfig::ccd_promote / ccd_demote), so only fast bodies pay for it.
+enum class MotionQuality { Discrete, LinearCast, Auto };
+
 struct BoxCollider {
     ecs::Vec3 half_extents = {0.5f, 0.5f, 0.5f};
 };
@@ -45,15 +53,48 @@ struct SphereCollider {
     float radius = 0.5f;
 };
 
+// Named shape asset: a compound, triangle mesh or height field described in
+// <PhysicsConfig::shape_dir>/<shape>.json and cooked offline to .jshape
+// (shape_desc.hpp). Mesh and height-field shapes have no volume, so Jolt only
+// accepts them on Static and Kinematic bodies.
+struct ShapeCollider {
+    std::string shape;
+};
+
 // If present, the PhysicsSystem will try to create a Jolt Body for this entity
 struct RigidBodyConfig {
     BodyType type        = BodyType::Dynamic;
-    float    mass        = 1.0f;
+    float    mass        = 0.0f; // kg; 0 = from the shape's volume (Jolt's 1000 kg/m³)
     float    friction    = 0.5f;
     float    restitution = 0.0f;
     bool     sensor      = false;
+    // Object layer name in PhysicsConfig::layers ("Debris", "Sensor", ...).
+    // Empty: Static for BodyType::Static, else Moving.
+    std::string layer;
+    // Sleeping and damping (Dynamic bodies). A body that starts asleep is
+    // added without activation and wakes when something touches it.
+    bool     allow_sleeping  = true;
+    bool     start_asleep    = false;
+    float    linear_damping  = 0.05f;
+    float    angular_damping = 0.05f;
+    MotionQuality motion_quality = MotionQuality::Discrete;
 };
 
+// Pose of a dynamic body at the start of the most recent physics step.
+// Added by PhysicsSystem to Dynamic bodies and written just before it syncs
+// the new pose into LocalTransform; RenderSystem draws the blend of this and
+// LocalTransform by FixedTime::alpha (fixed_time.hpp).
+struct TransformHistory {
+    ecs::Vec3 position = {0, 0, 0};
+    ecs::Quat rotation = {0, 0, 0, 1};
+};
+
+// One-shot request to move an existing body or character to its current
+// LocalTransform. Added by SceneLoader::reload when an entity's authored
+// transform changed; PhysicsSystem applies and removes it on its next
+// commit, so the Jolt body is moved in place instead of recreated.
+struct PhysicsTeleport {};
+
 struct CharacterControllerConfig {
     float height          = 1.8f;
     float radius          = 0.4f;
@@ -81,6 +122,7 @@ struct PlayerInput {
     ecs::Vec2 move_input     = {0, 0}; // X, Y (WASD / Left Stick)
     ecs::Vec2 look_input     = {0, 0}; // X, Y (Right Stick)
     bool      jump           = false;
+    float     jump_age       = 0.0f;   // s from the jump press to InputGather (event backend; else 0)
     bool      plant_platform = false;
     float     trigger_val    = 0.0f;
 };
@@ -130,6 +172,10 @@ struct CharacterState {
 struct PlayerState {
     float build_cooldown   = 0.0f;
     bool  trigger_was_down = false;
+
+    // Placement probe in flight (PhysicsQuery), and where it was cast from.
+    PhysicsQuery::Id build_probe;
+    ecs::Vec3        build_feet{};
 };
 
 struct PlayerTag {};
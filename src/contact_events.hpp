@@ -0,0 +1,209 @@
+#pragma once
+#include "events.hpp"
+#include <ecs/ecs.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Contact events — from Jolt's worker threads to Events<ContactEvent> and
+// Events<TriggerEvent>.
+//
+// ContactRecorder (physics_context.hpp) is the Jolt ContactListener. Its
+// callbacks run on job threads, so each one appends a ContactRecord to its
+// own thread's slot of a PerThreadBuffer: no locks on the contact path.
+// After each physics_system->Update, PhysicsSystem drains the buffer on the
+// main thread and ContactTracker turns the records into events.
+//
+// Jolt reports per sub-shape pair and, with folded sub-steps, several
+// collision steps per Update in no particular thread order. ContactTracker
+// therefore keeps a reference count per body pair and emits one event per
+// pair per Update:
+//   - Added / Enter when the count leaves zero,
+//   - Removed / Exit when it returns to zero (or an entity dies),
+//   - Persisted for a solid pair that stays in contact.
+// Records are sorted by pair first, so the event order is deterministic.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+// One listener callback. body_a < body_b are Jolt BodyID values; the
+// entities are read from the bodies' user data (null entity for Removed,
+// whose bodies Jolt won't let us touch).
+struct ContactRecord {
+    enum class Type : uint8_t { Added, Persisted, Removed };
+    Type        type        = Type::Added;
+    bool        sensor      = false; // either body is a sensor
+    bool        a_is_sensor = false; // ...and it is body a
+    uint32_t    body_a      = 0;
+    uint32_t    body_b      = 0;
+    ecs::Entity a{};
+    ecs::Entity b{};
+    ecs::Vec3   point{};
+    ecs::Vec3   normal{};
+    float       depth       = 0.0f;
+
+    uint64_t key() const { return (static_cast<uint64_t>(body_a) << 32) | body_b; }
+};
+
+// ---------------------------------------------------------------------------
+// PerThreadBuffer<T> — append from any thread without locking; drain from
+// one thread while nobody appends.
+//
+// Each thread claims a slot the first time it pushes (one atomic increment)
+// and caches it in a thread_local, keyed by the buffer's unique id. Slots
+// are cache-line aligned and keep their capacity across drains, so steady
+// state pushes neither lock nor allocate. Threads beyond `max_threads` share
+// one overflow slot behind a spinlock.
+// ---------------------------------------------------------------------------
+
+template<typename T>
+class PerThreadBuffer {
+public:
+    explicit PerThreadBuffer(size_t max_threads = 32)
+        : slots_(std::make_unique<Slot[]>(max_threads + 1)), max_(max_threads) {}
+
+    PerThreadBuffer(const PerThreadBuffer&)            = delete;
+    PerThreadBuffer& operator=(const PerThreadBuffer&) = delete;
+
+    void push(const T& value) {
+        const size_t s = slot();
+        if (s < max_) { slots_[s].items.push_back(value); return; }
+        while (overflow_lock_.test_and_set(std::memory_order_acquire)) {}
+        slots_[max_].items.push_back(value);
+        overflow_lock_.clear(std::memory_order_release);
+    }
+
+    // Appends every slot's items to `out` (slot order, then push order) and
+    // empties them. No push may run concurrently.
+    void drain(std::vector<T>& out) {
+        for (size_t s = 0; s <= max_; ++s) {
+            auto& items = slots_[s].items;
+            out.insert(out.end(), items.begin(), items.end());
+            items.clear();
+        }
+    }
+
+private:
+    struct alignas(64) Slot {
+        std::vector<T> items;
+    };
+
+    // A few (buffer, slot) pairs per thread, for threads feeding more than
+    // one buffer (e.g. two PhysicsContexts).
+    struct Cached {
+        uint64_t owner = 0;
+        size_t   slot  = 0;
+    };
+    static constexpr size_t CACHE = 4;
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t                  max_;
+    std::atomic<size_t>     next_{0};
+    std::atomic_flag        overflow_lock_ = ATOMIC_FLAG_INIT;
+    const uint64_t          id_ = next_id().fetch_add(1, std::memory_order_relaxed);
+
+    static std::atomic<uint64_t>& next_id() { static std::atomic<uint64_t> id{1}; return id; }
+
+    size_t slot() {
+        thread_local Cached cache[CACHE];
+        thread_local size_t victim = 0;
+        for (const Cached& c : cache)
+            if (c.owner == id_) return c.slot;
+        const size_t s = std::min(next_.fetch_add(1, std::memory_order_relaxed), max_);
+        cache[victim] = {id_, s};
+        victim = (victim + 1) % CACHE;
+        return s;
+    }
+};
+
+// ---------------------------------------------------------------------------
+// ContactTracker — main-thread merge of ContactRecords into events.
+// ---------------------------------------------------------------------------
+
+class ContactTracker {
+public:
+    // Consumes `records` (sorted in place, then cleared). Either queue may be
+    // null. Pairs whose entity has died are closed with Removed / Exit.
+    void merge(ecs::World& world, std::vector<ContactRecord>& records,
+               Events<ContactEvent>* contacts, Events<TriggerEvent>* triggers) {
+        std::sort(records.begin(), records.end(), [](const ContactRecord& l, const ContactRecord& r) {
+            return l.key() < r.key();
+        });
+
+        for (size_t i = 0; i < records.size();) {
+            const uint64_t key = records[i].key();
+            const ContactRecord* first_add = nullptr;
+            const ContactRecord* last_touch = nullptr;
+            uint32_t adds = 0, removes = 0;
+            for (; i < records.size() && records[i].key() == key; ++i) {
+                const ContactRecord& r = records[i];
+                if (r.type == ContactRecord::Type::Removed) { ++removes; continue; }
+                if (r.type == ContactRecord::Type::Added) { ++adds; if (!first_add) first_add = &r; }
+                last_touch = &r;
+            }
+
+            auto it         = pairs_.find(key);
+            const bool open = it != pairs_.end();
+            if (!open && !first_add) continue; // removal of a pair we never saw
+
+            if (!open) {
+                it = pairs_.emplace(key, Pair{first_add->a, first_add->b, first_add->sensor,
+                                              first_add->a_is_sensor, 0}).first;
+                emit_begin(it->second, *first_add, contacts, triggers);
+            }
+            Pair& pair = it->second;
+            const int64_t refs = static_cast<int64_t>(pair.refs) + adds - removes;
+            pair.refs = static_cast<uint32_t>(std::max<int64_t>(0, refs));
+
+            if (pair.refs == 0) {
+                emit_end(pair, contacts, triggers);
+                pairs_.erase(it);
+            } else if (open && last_touch && !pair.sensor && contacts) {
+                contacts->send({ContactEvent::Type::Persisted, pair.a, pair.b,
+                                last_touch->point, last_touch->normal, last_touch->depth});
+            }
+        }
+        records.clear();
+
+        for (auto it = pairs_.begin(); it != pairs_.end();) {
+            if (world.alive(it->second.a) && world.alive(it->second.b)) { ++it; continue; }
+            emit_end(it->second, contacts, triggers);
+            it = pairs_.erase(it);
+        }
+    }
+
+    size_t open_pairs() const { return pairs_.size(); }
+    void   clear()            { pairs_.clear(); }
+
+private:
+    struct Pair {
+        ecs::Entity a, b;
+        bool        sensor;
+        bool        a_is_sensor;
+        uint32_t    refs;
+    };
+
+    std::unordered_map<uint64_t, Pair> pairs_;
+
+    static void emit_begin(const Pair& p, const ContactRecord& r,
+                           Events<ContactEvent>* contacts, Events<TriggerEvent>* triggers) {
+        if (p.sensor) {
+            if (triggers) triggers->send({TriggerEvent::Type::Enter, p.a_is_sensor ? p.a : p.b, p.a_is_sensor ? p.b : p.a});
+        } else if (contacts) {
+            contacts->send({ContactEvent::Type::Added, p.a, p.b, r.point, r.normal, r.depth});
+        }
+    }
+
+    static void emit_end(const Pair& p, Events<ContactEvent>* contacts, Events<TriggerEvent>* triggers) {
+        if (p.sensor) {
+            if (triggers) triggers->send({TriggerEvent::Type::Exit, p.a_is_sensor ? p.a : p.b, p.a_is_sensor ? p.b : p.a});
+        } else if (contacts) {
+            contacts->send({ContactEvent::Type::Removed, p.a, p.b, {}, {}, 0.0f});
+        }
+    }
+};
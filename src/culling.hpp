@@ -0,0 +1,283 @@
+#pragma once
+#include "components.hpp"
+#include "kinematic_target.hpp"
+#include <ecs/ecs.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// View-frustum culling for RenderSystem.
+//
+//   Aabb / local_bounds / transform_bounds — world-space bounds of the unit
+//                                            meshes MeshRenderer draws
+//   Frustum                                — six planes built from a look-at
+//                                            camera (MainCamera lerp_pos/target)
+//   StaticGrid                             — uniform XZ grid of static meshes,
+//                                            culled cell-first
+//   RenderCulling                          — World resource: grid, dirty flag,
+//                                            per-frame visible/culled counts
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+struct Aabb {
+    ecs::Vec3 min = { std::numeric_limits<float>::max(),  std::numeric_limits<float>::max(),  std::numeric_limits<float>::max()};
+    ecs::Vec3 max = {-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max()};
+
+    bool empty() const { return min.x > max.x; }
+
+    void expand(const Aabb& o) {
+        min = {std::min(min.x, o.min.x), std::min(min.y, o.min.y), std::min(min.z, o.min.z)};
+        max = {std::max(max.x, o.max.x), std::max(max.y, o.max.y), std::max(max.z, o.max.z)};
+    }
+};
+
+namespace Culling {
+
+// Object-space bounds of the unit mesh for each shape (see AssetResource).
+inline Aabb local_bounds(ShapeType shape) {
+    switch (shape) {
+        case ShapeType::Sphere:  return {{-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}};
+        case ShapeType::Capsule: return {{-0.4f, -0.4f, -0.4f}, {0.4f, 2.2f, 0.4f}};
+        case ShapeType::Box:
+        default:                 return {{-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}};
+    }
+}
+
+// Bounds of `local` under the affine column-major matrix m (Arvo's method:
+// centre transforms as a point, extents by the absolute 3x3 basis).
+inline Aabb transform_bounds(const ecs::Mat4& m, const Aabb& local) {
+    const float c[3] = {(local.min.x + local.max.x) * 0.5f,
+                        (local.min.y + local.max.y) * 0.5f,
+                        (local.min.z + local.max.z) * 0.5f};
+    const float e[3] = {(local.max.x - local.min.x) * 0.5f,
+                        (local.max.y - local.min.y) * 0.5f,
+                        (local.max.z - local.min.z) * 0.5f};
+    float wc[3], we[3];
+    for (int r = 0; r < 3; ++r) {
+        wc[r] = m.m[12 + r];
+        we[r] = 0.0f;
+        for (int k = 0; k < 3; ++k) {
+            wc[r] += m.m[k * 4 + r] * c[k];
+            we[r] += std::fabs(m.m[k * 4 + r]) * e[k];
+        }
+    }
+    return {{wc[0] - we[0], wc[1] - we[1], wc[2] - we[2]},
+            {wc[0] + we[0], wc[1] + we[1], wc[2] + we[2]}};
+}
+
+} // namespace Culling
+
+// ---------------------------------------------------------------------------
+// Frustum
+// ---------------------------------------------------------------------------
+
+struct Frustum {
+    // Inside when nx*x + ny*y + nz*z + d >= 0.
+    struct Plane { float nx = 0, ny = 0, nz = 0, d = 0; };
+
+    std::array<Plane, 6>     planes{};   // near, far, left, right, bottom, top
+    std::array<ecs::Vec3, 8> corners{};  // near quad then far quad
+
+    // Perspective frustum for a look-at camera. fovy is vertical, in degrees.
+    static Frustum look_at(const ecs::Vec3& eye, const ecs::Vec3& target, const ecs::Vec3& up,
+                           float fovy_deg, float aspect, float near_d, float far_d) {
+        V f = normalize(sub(v(target), v(eye)));
+        if (length(f) == 0.0f) f = {0, 0, -1};
+        V r = normalize(cross(f, v(up)));
+        if (length(r) == 0.0f) r = {1, 0, 0}; // looking straight up/down
+        V u = cross(r, f);
+
+        const float th = std::tan(fovy_deg * 0.5f * 3.1415926535f / 180.0f);
+        const float tw = th * aspect;
+        const V e = v(eye);
+
+        Frustum fr;
+        int i = 0;
+        for (float dist : {near_d, far_d}) {
+            const V c = add(e, mul(f, dist));
+            const float h = th * dist, w = tw * dist;
+            for (float sy : {-1.0f, 1.0f})
+                for (float sx : {-1.0f, 1.0f}) {
+                    const V p = add(c, add(mul(r, sx * w), mul(u, sy * h)));
+                    fr.corners[i++] = {p.x, p.y, p.z};
+                }
+        }
+
+        // Side planes pass through the eye; normals point inward.
+        const V fl = add(f, mul(r, -tw)), fr_ = add(f, mul(r, tw));
+        const V fb = add(f, mul(u, -th)), ft  = add(f, mul(u, th));
+        fr.planes[0] = plane(f, add(e, mul(f, near_d)));
+        fr.planes[1] = plane(mul(f, -1.0f), add(e, mul(f, far_d)));
+        fr.planes[2] = plane(cross(fl, u), e);   // left
+        fr.planes[3] = plane(cross(u, fr_), e);  // right
+        fr.planes[4] = plane(cross(r, fb), e);   // bottom
+        fr.planes[5] = plane(cross(ft, r), e);   // top
+        return fr;
+    }
+
+    // Conservative: true if the box is inside or straddles every plane.
+    bool intersects(const Aabb& b) const {
+        for (const Plane& p : planes) {
+            // The box corner furthest along the plane normal.
+            const float x = p.nx >= 0 ? b.max.x : b.min.x;
+            const float y = p.ny >= 0 ? b.max.y : b.min.y;
+            const float z = p.nz >= 0 ? b.max.z : b.min.z;
+            if (p.nx * x + p.ny * y + p.nz * z + p.d < 0) return false;
+        }
+        return true;
+    }
+
+    Aabb bounds() const {
+        Aabb b;
+        for (const auto& c : corners) b.expand({c, c});
+        return b;
+    }
+
+private:
+    struct V { float x, y, z; };
+    static V v(const ecs::Vec3& a)         { return {a.x, a.y, a.z}; }
+    static V add(V a, V b)                 { return {a.x + b.x, a.y + b.y, a.z + b.z}; }
+    static V sub(V a, V b)                 { return {a.x - b.x, a.y - b.y, a.z - b.z}; }
+    static V mul(V a, float s)             { return {a.x * s, a.y * s, a.z * s}; }
+    static float dot(V a, V b)             { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    static float length(V a)               { return std::sqrt(dot(a, a)); }
+    static V cross(V a, V b) {
+        return {a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+    }
+    static V normalize(V a) {
+        const float l = length(a);
+        return l > 0.0f ? mul(a, 1.0f / l) : V{0, 0, 0};
+    }
+    static Plane plane(V n, V point) {
+        n = normalize(n);
+        return {n.x, n.y, n.z, -dot(n, point)};
+    }
+};
+
+// ---------------------------------------------------------------------------
+// StaticGrid — uniform XZ grid over static meshes.
+//
+// Items are filed by the cell containing their bounds centre; each cell's
+// bounds grow to cover its items, so large items are never lost at cell
+// edges. query() rejects whole cells first, then tests the survivors' items.
+// Items carry the draw data (model, shape, colour) captured at build time,
+// so visible statics go to the InstanceBatch without ECS lookups.
+// ---------------------------------------------------------------------------
+
+class StaticGrid {
+public:
+    struct Item {
+        ecs::Mat4 model;
+        Aabb      bounds;
+        ShapeType shape = ShapeType::Box;
+        Color4    color;
+    };
+
+    explicit StaticGrid(float cell_size = 16.0f) : cell_size_(cell_size) {}
+
+    void clear() {
+        cells_.clear();
+        items_ = 0;
+    }
+
+    void insert(const Item& item) {
+        const float cx = (item.bounds.min.x + item.bounds.max.x) * 0.5f;
+        const float cz = (item.bounds.min.z + item.bounds.max.z) * 0.5f;
+        Cell& cell = cells_[key(cell_coord(cx), cell_coord(cz))];
+        cell.bounds.expand(item.bounds);
+        cell.items.push_back(item);
+        ++items_;
+    }
+
+    // Calls visit(const Item&) for every item whose bounds intersect the
+    // frustum. Returns the number visited.
+    template <typename F>
+    size_t query(const Frustum& frustum, F&& visit) const {
+        size_t n = 0;
+        for (const auto& [k, cell] : cells_) {
+            if (!frustum.intersects(cell.bounds)) continue;
+            for (const Item& item : cell.items) {
+                if (!frustum.intersects(item.bounds)) continue;
+                visit(item);
+                ++n;
+            }
+        }
+        return n;
+    }
+
+    size_t size()       const { return items_; }
+    size_t cell_count() const { return cells_.size(); }
+    float  cell_size()  const { return cell_size_; }
+
+private:
+    struct Cell {
+        Aabb              bounds;
+        std::vector<Item> items;
+    };
+
+    float                              cell_size_;
+    std::unordered_map<int64_t, Cell>  cells_;
+    size_t                             items_ = 0;
+
+    int32_t cell_coord(float v) const { return static_cast<int32_t>(std::floor(v / cell_size_)); }
+
+    static int64_t key(int32_t x, int32_t z) {
+        return (static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(z);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// RenderCulling — World resource owned by RenderModule.
+//
+// Static meshes live in the grid: no TransformHistory (interpolated), no
+// KinematicTarget (moved by gameplay every step), and none of the extra
+// types RenderSystem passes (CharacterHandle, a Jolt type).
+// WorldTag add/remove hooks mark it dirty; RenderSystem rebuilds it once a
+// physics step has run since the change (TransformPropagate has refreshed
+// the new matrices by then), and tests statics directly until then. Dynamic meshes are tested every frame.
+// ---------------------------------------------------------------------------
+
+struct RenderCulling {
+    StaticGrid statics;
+    bool       statics_dirty = true;
+    uint64_t   dirty_step    = 0; // FixedTime::total_steps when marked dirty
+
+    // Last frame's counts (debug panel).
+    uint32_t visible = 0;
+    uint32_t culled  = 0;
+
+    void mark_dirty(uint64_t total_steps) {
+        statics_dirty = true;
+        dirty_step    = total_steps;
+    }
+
+    // True once transforms have been propagated since the last change.
+    bool ready_to_rebuild(bool has_fixed_time, uint64_t total_steps) const {
+        return statics_dirty && (!has_fixed_time || total_steps > dirty_step);
+    }
+
+    // fn(Entity, WorldTransform&, MeshRenderer&) for every mesh the grid holds.
+    template <typename... Moving, typename F>
+    static void each_static(ecs::World& world, F&& fn) {
+        world.each<ecs::WorldTransform, MeshRenderer>(
+            ecs::World::Exclude<TransformHistory, KinematicTarget, Moving...>{}, std::forward<F>(fn));
+    }
+
+    template <typename... Moving>
+    void rebuild(ecs::World& world) {
+        statics.clear();
+        each_static<Moving...>(world, [&](ecs::Entity, ecs::WorldTransform& wt, MeshRenderer& mesh) {
+            statics.insert({wt.matrix, Culling::transform_bounds(wt.matrix, Culling::local_bounds(mesh.shape_type)),
+                            mesh.shape_type, mesh.color});
+        });
+        statics_dirty = false;
+    }
+};
@@ -1,24 +1,78 @@
 #pragma once
+#include <cstdarg>
+#include <cstddef>
+#include <cstdio>
+#include <cstring>
 #include <functional>
 #include <string>
 #include <vector>
 
+// ---------------------------------------------------------------------------
+// DebugText — fixed-size value buffer a DebugPanel provider writes into.
+//
+// format() is vsnprintf into the row's own storage (truncating at
+// CAPACITY - 1 characters), so refreshing a row never allocates.
+// ---------------------------------------------------------------------------
+
+class DebugText {
+public:
+    static constexpr size_t CAPACITY = 64;
+
+#if defined(__GNUC__) || defined(__clang__)
+    __attribute__((format(printf, 2, 3)))
+#endif
+    void format(const char* fmt, ...) {
+        va_list args;
+        va_start(args, fmt);
+        const int n = std::vsnprintf(buf_, CAPACITY, fmt, args);
+        va_end(args);
+        len_ = n < 0 ? 0 : (static_cast<size_t>(n) < CAPACITY ? static_cast<size_t>(n) : CAPACITY - 1);
+    }
+
+    void set(const char* s) {
+        len_ = std::strlen(s);
+        if (len_ >= CAPACITY) len_ = CAPACITY - 1;
+        std::memcpy(buf_, s, len_);
+        buf_[len_] = '\0';
+    }
+
+    void clear() { len_ = 0; buf_[0] = '\0'; }
+
+    const char* c_str() const { return buf_; }
+    size_t      size()  const { return len_; }
+    bool operator==(const char* s) const { return std::strcmp(buf_, s) == 0; }
+
+private:
+    char   buf_[CAPACITY] = {};
+    size_t len_           = 0;
+};
+
 // ---------------------------------------------------------------------------
 // DebugPanel — extensible provider registry for the debug overlay.
 //
 // Stored as a World resource. Call watch(section, label, fn) at startup to
-// register a provider; DebugSystem calls every provider each render frame
-// and draws the results as a sectioned text overlay.
+// register a provider. While the overlay is visible, DebugSystem calls
+// refresh(dt) once per render frame, then draws each row's cached value as a
+// sectioned text overlay.
+//
+// A provider writes its value into the row's DebugText (out.format(...) or
+// out.set(...)). A row watched with `hz` > 0 is only refreshed that often,
+// and shows its cached value in between. Rows are refreshed immediately when
+// the overlay is shown again.
 //
 // Zero engine dependencies — safe to include in any target.
 // ---------------------------------------------------------------------------
 
 struct DebugPanel {
-    using Provider = std::function<std::string()>;
+    using Provider = std::function<void(DebugText&)>;
 
     struct Row {
         std::string label;
         Provider    fn;
+        float       period = 0.0f; // seconds between refreshes; 0 = every frame
+        float       age    = 0.0f; // since the last refresh
+        bool        fresh  = false;
+        DebugText   value;
     };
 
     struct Section {
@@ -26,20 +80,51 @@ struct DebugPanel {
         std::vector<Row> rows;
     };
 
+    // Rate for rows that are read, not watched frame to frame.
+    static constexpr float SLOW_HZ = 4.0f;
+
     bool visible = false;
 
-    // Register a named provider under a section heading.
-    // Creates the section if it does not already exist.
+    // Register a named provider under a section heading, refreshed `hz`
+    // times a second (0 = every frame). Creates the section if it does not
+    // already exist.
     void watch(const std::string& section,
                const std::string& label,
-               Provider fn) {
+               Provider fn,
+               float hz = 0.0f) {
+        Row row;
+        row.label  = label;
+        row.fn     = std::move(fn);
+        row.period = hz > 0.0f ? 1.0f / hz : 0.0f;
         for (auto& s : sections_) {
             if (s.title == section) {
-                s.rows.push_back({label, std::move(fn)});
+                s.rows.push_back(std::move(row));
                 return;
             }
         }
-        sections_.push_back({section, {{label, std::move(fn)}}});
+        sections_.push_back({section, {}});
+        sections_.back().rows.push_back(std::move(row));
+    }
+
+    // Calls the providers that are due. DebugSystem calls this once per
+    // visible frame.
+    void refresh(float dt) {
+        for (auto& s : sections_) {
+            for (auto& row : s.rows) {
+                row.age += dt;
+                if (row.fresh && row.age < row.period) continue;
+                row.value.clear();
+                row.fn(row.value);
+                row.age   = 0.0f;
+                row.fresh = true;
+            }
+        }
+    }
+
+    // Makes every row refresh on the next refresh() call.
+    void invalidate() {
+        for (auto& s : sections_)
+            for (auto& row : s.rows) row.fresh = false;
     }
 
     const std::vector<Section>& sections() const { return sections_; }
@@ -0,0 +1,194 @@
+#pragma once
+#include <ecs/ecs.hpp>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// CommandLane / DeferredCommands — one command buffer per producer, so
+// systems running concurrently can queue structural changes without a lock.
+//
+// world.deferred() is one buffer, so every system writing to it has to
+// declare Access::Deferred and run in turn. Instead, the Pipeline gives
+// each system a CommandLane of its own and points a thread_local at it while
+// the system runs. DeferredCommands::local(world) returns that lane, and
+// only the thread running the system ever touches it.
+//
+// Lanes are keyed by system, not by thread: lane N belongs to the N-th
+// system added to the Pipeline. They are flushed in lane order, so the
+// merge order is install order, the same as a serial run, wherever the
+// work-stealing pool put each system. A system fanning out to jobs (the
+// Jolt job system) calls reserve_jobs(n) before it starts them; job j then
+// queues on job(j), which flushes after its parent, in job order.
+//
+// Lane 0 belongs to code outside any system (main thread only). Each lane
+// counts what it holds, so the Pipeline's two flushes skip lanes with
+// nothing queued, and skip the whole flush when nothing at all is queued.
+// Flushing a lane swaps its two buffers first. Commands queued by hooks
+// during a flush wait for the next flush point.
+//
+// edits() counts every command flushed, plus the direct structural changes
+// reported with note_edits(); a world.deferred() flush that had commands
+// counts once. An add or remove keeps world.count() the same
+// but can create an archetype, so the Pipeline stamps each phase with both
+// and runs it serially when either has moved (pipeline.hpp).
+//
+// A World resource, as std::shared_ptr (lanes must keep their address).
+// The Pipeline creates it on its first run.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+// Skipping an empty world.deferred() flush, and counting a non-empty one in
+// edits() so the threaded Pipeline reschedules, both need to know whether
+// the shared buffer holds anything. There is no guess to fall back on.
+static_assert(requires(const ecs::CommandBuffer& b) { { b.empty() } -> std::convertible_to<bool>; },
+              "DeferredCommands needs ecs::CommandBuffer::empty() (update extern/ecs)");
+
+class CommandLane {
+public:
+    template<typename... Ts> void create_with(Ts&&... components) {
+        active().create_with(std::forward<Ts>(components)...);
+        ++queued_;
+    }
+    template<typename T> void add(ecs::Entity e, T&& component) {
+        active().add(e, std::forward<T>(component));
+        ++queued_;
+    }
+    template<typename T> void remove(ecs::Entity e) {
+        active().remove<T>(e);
+        ++queued_;
+    }
+    void destroy(ecs::Entity e) {
+        active().destroy(e);
+        ++queued_;
+    }
+
+    // Commands waiting here and in the job lanes.
+    size_t queued() const {
+        size_t n = queued_;
+        for (const auto& j : jobs_) n += j->queued();
+        return n;
+    }
+
+    // n job lanes, kept across frames. Call on the lane's own thread before
+    // the jobs start; never shrinks.
+    void reserve_jobs(size_t n) {
+        while (jobs_.size() < n) jobs_.push_back(std::make_unique<CommandLane>());
+    }
+    CommandLane& job(size_t j) { return *jobs_[j]; }
+    size_t       jobs() const  { return jobs_.size(); }
+
+    // Applies this lane's commands, then each job lane's. Main thread, no
+    // producer running. Returns the commands applied.
+    size_t flush(ecs::World& world) {
+        size_t n = 0;
+        if (queued_) {
+            n = queued_;
+            queued_ = 0;
+            ecs::CommandBuffer& full = active();
+            active_ ^= 1;
+            full.flush(world);
+        }
+        for (const auto& j : jobs_) n += j->flush(world);
+        return n;
+    }
+
+private:
+    ecs::CommandBuffer& active() { return buffers_[active_]; }
+
+    ecs::CommandBuffer                        buffers_[2];
+    unsigned                                  active_ = 0;
+    size_t                                    queued_ = 0;
+    std::vector<std::unique_ptr<CommandLane>> jobs_;
+};
+
+class DeferredCommands {
+public:
+    // Grows to at least n lanes. Main thread, between phases.
+    void reserve(size_t n) {
+        while (lanes_.size() < n) lanes_.push_back(std::make_unique<CommandLane>());
+    }
+    CommandLane& lane(size_t i) { return *lanes_[i]; }
+    size_t       lanes() const  { return lanes_.size(); }
+
+    size_t queued() const {
+        size_t n = 0;
+        for (const auto& l : lanes_) n += l->queued();
+        return n;
+    }
+
+    // Every lane in order. Returns the commands applied.
+    size_t flush(ecs::World& world) {
+        size_t n = 0;
+        for (const auto& l : lanes_) n += l->flush(world);
+        edits_ += n;
+        return n;
+    }
+
+    // Structural changes made directly on the World (not queued), e.g. a
+    // tag removed by the system that consumed it. Main thread.
+    void     note_edits(size_t n = 1) { edits_ += n; }
+    uint64_t edits() const            { return edits_; }
+
+    // The world's resource, created (with lane 0) if missing. Main thread.
+    static DeferredCommands& of(ecs::World& world) {
+        if (auto* p = world.try_resource<std::shared_ptr<DeferredCommands>>(); p && *p) return **p;
+        auto cmds = std::make_shared<DeferredCommands>();
+        cmds->reserve(1);
+        world.set_resource(cmds);
+        return *cmds;
+    }
+
+    // Where the calling code queues: its system's lane while the Pipeline
+    // runs it, else lane 0 (main thread only).
+    static CommandLane& local(ecs::World& world) {
+        if (CommandLane* l = current()) return *l;
+        return of(world).lane(0);
+    }
+
+    // world.deferred(), then every lane: for code that must land everything
+    // outside the Pipeline's flush points (resets, unloads, snapshots), so
+    // nothing queued earlier lands afterwards on recycled entities. Main
+    // thread, or an exclusive system.
+    static void flush_all(ecs::World& world) {
+        DeferredCommands& cmds = of(world);
+        flush_shared(world, cmds);
+        cmds.flush(world);
+    }
+
+    // Flushes world.deferred() if it holds commands, counting the flush in
+    // edits(). Returns whether it ran.
+    static bool flush_shared(ecs::World& world, DeferredCommands& cmds) {
+        if (!shared_pending(world)) return false;
+        world.deferred().flush(world);
+        cmds.note_edits();
+        return true;
+    }
+
+    // Whether world.deferred() holds commands.
+    static bool shared_pending(ecs::World& world) { return !world.deferred().empty(); }
+
+    // Makes `lane` this thread's local() lane until the scope ends.
+    class Scope {
+    public:
+        explicit Scope(CommandLane* lane) : prev_(current()) { current() = lane; }
+        ~Scope() { current() = prev_; }
+        Scope(const Scope&)            = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        CommandLane* prev_;
+    };
+
+private:
+    static CommandLane*& current() {
+        thread_local CommandLane* lane = nullptr;
+        return lane;
+    }
+
+    std::vector<std::unique_ptr<CommandLane>> lanes_;
+    uint64_t                                  edits_ = 0;
+};
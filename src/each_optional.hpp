@@ -0,0 +1,28 @@
+#pragma once
+#include <ecs/ecs.hpp>
+
+// ---------------------------------------------------------------------------
+// each_optional — World::each with one optional component.
+//
+//   each_optional<Opt, Ts...>(world, [](ecs::Entity, Ts&..., Opt*) { ... });
+//
+// Calls fn for every entity with all of Ts. The last argument points at the
+// entity's Opt, or is null without one. It runs as two archetype walks,
+// each<Ts..., Opt> then each<Ts...> excluding Opt, so the optional component
+// comes from the same dense column as the others instead of a per-entity
+// try_get lookup. Entities with Opt are visited before those without; order
+// within each group is the World's.
+//
+// The World already caches each query's matching archetypes, so no separate
+// entity list has to be kept in sync with hooks: hot loops use this (or a
+// second each<>) instead of try_get / has inside the callback.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+template <typename Opt, typename... Ts, typename F>
+void each_optional(ecs::World& world, F&& fn) {
+    world.each<Ts..., Opt>([&](ecs::Entity e, Ts&... cs, Opt& opt) { fn(e, cs..., &opt); });
+    world.each<Ts...>(ecs::World::Exclude<Opt>{},
+                      [&](ecs::Entity e, Ts&... cs) { fn(e, cs..., static_cast<Opt*>(nullptr)); });
+}
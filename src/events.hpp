@@ -1,49 +1,126 @@
 #pragma once
 #include <ecs/ecs.hpp>
-#include <functional>
+#include <ecs/modules/transform.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 // ---------------------------------------------------------------------------
 // Events<T> — typed, frame-scoped event queue
 //
 // Stored as a World resource. Systems emit via send() and consume via read().
-// EventRegistry::flush_all() clears all queues at the start of each frame.
+// EventRegistry::flush_all() flushes every queue at the start of each frame.
+//
+// Storage is a fixed slab of `capacity` events, allocated once, so send()
+// never reallocates mid-frame and clear() is O(1). Events are plain
+// messages (trivially destructible). Sends beyond the capacity are dropped
+// and counted in dropped(), just as FixedTime drops steps past its clamp.
+//
+// EventMode::Frame (the default): read() sees everything sent since the
+// last flush, so emitter and reader must be in the same frame. Logic → Logic,
+// for example.
+//
+// EventMode::Buffered: two slabs. send() fills the back buffer, and read()
+// returns the front — the events sent during the previous frame. The flush
+// swaps them. Events sent after a reader has run are read once, next frame,
+// instead of being cleared unseen. Physics → next frame's Logic, say.
 // ---------------------------------------------------------------------------
 
+enum class EventMode : uint8_t { Frame, Buffered };
+
 template<typename T>
 struct Events {
-    void send(T event)                     { buffer_.push_back(std::move(event)); }
-    const std::vector<T>& read()   const  { return buffer_; }
-    bool                  empty()  const  { return buffer_.empty(); }
-    void                  clear()         { buffer_.clear(); }
+    static_assert(std::is_trivially_destructible_v<T>, "events are plain messages");
+
+    static constexpr size_t DEFAULT_CAPACITY = 256;
+
+    explicit Events(size_t capacity = DEFAULT_CAPACITY, EventMode mode = EventMode::Frame)
+        : capacity_(capacity), mode_(mode) {
+        slabs_[0] = std::make_unique<T[]>(capacity_);
+        if (mode_ == EventMode::Buffered) slabs_[1] = std::make_unique<T[]>(capacity_);
+    }
+
+    void send(T event) {
+        const int b = back();
+        if (count_[b] == capacity_) { ++dropped_; return; }
+        slabs_[b][count_[b]++] = std::move(event);
+    }
+
+    std::span<const T> read() const {
+        const int f = front();
+        return {slabs_[f].get(), count_[f]};
+    }
+
+    bool   empty()    const { return count_[front()] == 0; }
+    size_t capacity() const { return capacity_; }
+    size_t dropped()  const { return dropped_; }  // total sends lost to a full queue
+    EventMode mode()  const { return mode_; }
+
+    // Empties both buffers.
+    void clear() { count_[0] = count_[1] = 0; }
+
+    // Start-of-frame step (EventRegistry::flush_all): Frame clears; Buffered
+    // makes this frame's sends readable and empties the new back buffer.
+    void flush() {
+        if (mode_ == EventMode::Frame) { count_[0] = 0; return; }
+        front_ ^= 1;
+        count_[back()] = 0;
+    }
 
 private:
-    std::vector<T> buffer_;
+    std::unique_ptr<T[]> slabs_[2];
+    size_t               count_[2] = {0, 0};
+    size_t               capacity_;
+    size_t               dropped_ = 0;
+    EventMode            mode_;
+    int                  front_   = 0; // Buffered only
+
+    int front() const { return mode_ == EventMode::Frame ? 0 : front_; }
+    int back()  const { return mode_ == EventMode::Frame ? 0 : front_ ^ 1; }
 };
 
 // ---------------------------------------------------------------------------
 // EventRegistry — flush coordinator (stored as a World resource)
 //
-// Call register_queue<T>(world) once per event type during startup.
+// Call register_queue<T>(world) once per event type during startup. It keeps
+// a direct pointer to the World's Events<T> resource and a plain function
+// pointer to flush it, so flush_all() needs no lookups or std::function
+// calls. Don't replace or remove a registered queue's resource afterwards.
 // Call flush_all() as the first Pre-Update step each frame.
 // ---------------------------------------------------------------------------
 
 class EventRegistry {
 public:
+    // Creates Events<T> (unless it already exists) and registers it. Calling
+    // it again for the same type returns the existing queue.
     template<typename T>
-    void register_queue(ecs::World& world) {
-        world.set_resource(Events<T>{});
-        flush_fns_.push_back([&world]() {
-            if (auto* q = world.try_resource<Events<T>>()) q->clear();
-        });
+    Events<T>& register_queue(ecs::World& world,
+                              size_t capacity = Events<T>::DEFAULT_CAPACITY,
+                              EventMode mode  = EventMode::Frame) {
+        if (!world.has_resource<Events<T>>()) world.set_resource(Events<T>{capacity, mode});
+        auto& queue = world.resource<Events<T>>();
+        for (const auto& q : queues_)
+            if (q.queue == &queue) return queue;
+        queues_.push_back({&queue, [](void* q) { static_cast<Events<T>*>(q)->flush(); }});
+        return queue;
     }
 
     void flush_all() {
-        for (auto& fn : flush_fns_) fn();
+        for (const auto& q : queues_) q.flush(q.queue);
     }
 
+    size_t size() const { return queues_.size(); }
+
 private:
-    std::vector<std::function<void()>> flush_fns_;
+    struct Queue {
+        void* queue;
+        void (*flush)(void*);
+    };
+    std::vector<Queue> queues_;
 };
 
 // ---------------------------------------------------------------------------
@@ -63,3 +140,26 @@ struct JumpEvent {
 struct LandEvent {
     ecs::Entity entity;
 };
+
+// Emitted by PhysicsSystem (via ContactTracker) for each pair of solid
+// bodies that starts touching, stays in contact through a step, or
+// separates. `point` (on a) and `normal` (a → b) are world space and zero
+// for Removed. Buffered queue: read the previous frame's contacts.
+struct ContactEvent {
+    enum class Type : uint8_t { Added, Persisted, Removed };
+    Type        type;
+    ecs::Entity a;
+    ecs::Entity b;
+    ecs::Vec3   point;
+    ecs::Vec3   normal;
+    float       depth;
+};
+
+// Emitted by PhysicsSystem when a body enters or leaves a sensor
+// (RigidBodyConfig::sensor). Buffered queue, like ContactEvent.
+struct TriggerEvent {
+    enum class Type : uint8_t { Enter, Exit };
+    Type        type;
+    ecs::Entity sensor;
+    ecs::Entity other;
+};
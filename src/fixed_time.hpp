@@ -0,0 +1,83 @@
+#pragma once
+#include "components.hpp"
+#include <ecs/ecs.hpp>
+#include <ecs/modules/transform.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// FixedTime — fixed-timestep scheduler state for the Physics phase.
+//
+// Stored as a World resource (created by PhysicsModule from PhysicsConfig).
+// Pipeline::step_fixed feeds it the frame delta; advance() returns how many
+// fixed steps are due, clamped to max_steps so a hitch can't spiral. Time
+// beyond the clamp is dropped (the simulation runs slow rather than
+// freezing the frame), and alpha is the leftover fraction of a step that
+// RenderSystem uses to blend TransformHistory with the current pose.
+//
+// When fold_substeps is set, the due steps run as a single Physics call with
+// dt * n, and collision_steps = n is passed to Jolt's Update.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+struct FixedTime {
+    // Configuration
+    float fixed_dt      = 1.0f / 60.0f;
+    int   max_steps     = 4;
+    bool  fold_substeps = false;
+
+    // Scheduler state
+    float accumulator      = 0.0f;
+    float alpha            = 0.0f; // [0, 1) — render blend factor
+    int   steps_this_frame = 0;
+    int   collision_steps  = 1;    // Jolt inCollisionSteps for the current Physics call
+
+    // Stats
+    uint64_t total_steps     = 0;
+    float    dropped_seconds = 0.0f;
+
+    // Adds frame_dt to the accumulator and returns the number of steps due.
+    int advance(float frame_dt) {
+        accumulator += std::max(0.0f, frame_dt);
+        int steps = static_cast<int>(accumulator / fixed_dt);
+        if (steps > max_steps) {
+            // Keep the sub-step remainder (alpha stays continuous), drop the rest.
+            const float remainder = std::fmod(accumulator, fixed_dt);
+            dropped_seconds += accumulator - remainder - static_cast<float>(max_steps) * fixed_dt;
+            steps       = max_steps;
+            accumulator = remainder + static_cast<float>(steps) * fixed_dt;
+        }
+        accumulator -= static_cast<float>(steps) * fixed_dt;
+        if (accumulator < 0.0f)      accumulator = 0.0f;
+        if (accumulator >= fixed_dt) accumulator = std::fmod(accumulator, fixed_dt); // float edge
+
+        alpha            = accumulator / fixed_dt;
+        steps_this_frame = steps;
+        total_steps     += static_cast<uint64_t>(steps);
+        return steps;
+    }
+};
+
+// Blends previous → current pose by alpha (lerp position, nlerp rotation)
+// and composes the world matrix. Valid for root entities (no Parent).
+inline ecs::Mat4 interpolate_pose(const TransformHistory& prev, const ecs::LocalTransform& cur, float alpha) {
+    const float a = std::clamp(alpha, 0.0f, 1.0f);
+    const float b = 1.0f - a;
+    ecs::Vec3 p = {prev.position.x * b + cur.position.x * a,
+                   prev.position.y * b + cur.position.y * a,
+                   prev.position.z * b + cur.position.z * a};
+
+    // Shortest-arc nlerp: flip the previous quaternion into the same hemisphere.
+    const ecs::Quat& q0 = prev.rotation;
+    const ecs::Quat& q1 = cur.rotation;
+    const float dot  = q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w;
+    const float s0   = (dot < 0.0f) ? -b : b;
+    ecs::Quat q = {q0.x * s0 + q1.x * a, q0.y * s0 + q1.y * a, q0.z * s0 + q1.z * a, q0.w * s0 + q1.w * a};
+    const float len = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+    if (len > 1e-6f) { q.x /= len; q.y /= len; q.z /= len; q.w /= len; }
+    else             { q = q1; }
+
+    return ecs::mat4_compose(p, q, cur.scale);
+}
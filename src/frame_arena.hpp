@@ -0,0 +1,142 @@
+#pragma once
+#include <ecs/ecs.hpp>
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// FrameArena — linear allocator for scratch memory that lives one frame.
+//
+// allocate() bumps an offset in one block; nothing is freed individually.
+// reset() (EventBusModule's EventFlush, the first Pre-Update step) makes the
+// whole block reusable. A frame that outgrows the block takes overflow
+// blocks from the heap, and the next reset() replaces the block with one
+// big enough for that frame's peak, so allocation stops once the largest
+// frame has been seen. The bump is a lock-free fetch_add; only overflow
+// takes a mutex, so Logic systems on different threads may share it.
+//
+// ArenaAllocator<T> / ArenaVector<T> put standard containers in it. Given a
+// null arena they use the heap, so code that takes frame_arena(world) works
+// without the resource. Arena memory is gone at the next reset(): never keep
+// a container (or a pointer into one) past the frame that filled it, and
+// never hand it to something that outlives the frame (resources, the
+// RenderSnapshot, the async step thread).
+//
+// World resource, as std::shared_ptr<FrameArena> (allocators hold its
+// address), created by EventBusModule.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+class FrameArena {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 256 * 1024;
+
+    explicit FrameArena(size_t capacity = DEFAULT_CAPACITY) { grow(capacity); }
+
+    FrameArena(const FrameArena&)            = delete;
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+        bytes = std::max<size_t>(bytes, 1);
+        // Worst-case padding is reserved with the request, so no retry loop.
+        const size_t start = offset_.fetch_add(bytes + align - 1, std::memory_order_relaxed);
+        if (start + bytes + align - 1 <= capacity_) {
+            const auto base = reinterpret_cast<uintptr_t>(block_.get()) + start;
+            return reinterpret_cast<void*>((base + align - 1) & ~(uintptr_t(align) - 1));
+        }
+        std::lock_guard<std::mutex> lock(overflow_m_);
+        overflow_.push_back(std::make_unique<std::byte[]>(bytes + align - 1));
+        overflow_bytes_ += bytes + align - 1;
+        const auto base = reinterpret_cast<uintptr_t>(overflow_.back().get());
+        return reinterpret_cast<void*>((base + align - 1) & ~(uintptr_t(align) - 1));
+    }
+
+    // Releases everything allocated since the last reset(). Nothing may be
+    // allocating concurrently.
+    void reset() {
+        const size_t used = this->used();
+        last_used_ = used;
+        peak_      = std::max(peak_, used);
+        if (!overflow_.empty()) {
+            overflow_.clear();
+            grow(peak_ + peak_ / 2);
+            ++grows_;
+        }
+        overflow_bytes_ = 0;
+        offset_.store(0, std::memory_order_relaxed);
+    }
+
+    // Bytes handed out this frame (including alignment padding and any
+    // overflow).
+    size_t used() const {
+        return std::min(offset_.load(std::memory_order_relaxed), capacity_) + overflow_bytes_;
+    }
+    size_t capacity()  const { return capacity_; }
+    size_t last_used() const { return last_used_; } // the frame before the last reset()
+    size_t peak()      const { return peak_; }
+    size_t grows()     const { return grows_; }     // resets that enlarged the block
+
+private:
+    std::unique_ptr<std::byte[]> block_;
+    size_t                       capacity_ = 0;
+    std::atomic<size_t>          offset_{0};
+
+    std::mutex                                overflow_m_;
+    std::vector<std::unique_ptr<std::byte[]>> overflow_;
+    size_t                                    overflow_bytes_ = 0;
+
+    size_t last_used_ = 0;
+    size_t peak_      = 0;
+    size_t grows_     = 0;
+
+    void grow(size_t capacity) {
+        block_    = std::make_unique<std::byte[]>(capacity);
+        capacity_ = capacity;
+    }
+};
+
+// Standard allocator over a FrameArena; the heap when the arena is null.
+// deallocate() is a no-op for arena memory.
+template <typename T>
+struct ArenaAllocator {
+    using value_type = T;
+
+    FrameArena* arena = nullptr;
+
+    ArenaAllocator() = default;
+    explicit ArenaAllocator(FrameArena* a) : arena(a) {}
+    template <typename U>
+    ArenaAllocator(const ArenaAllocator<U>& o) : arena(o.arena) {}
+
+    T* allocate(size_t n) {
+        if (arena) return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+        return std::allocator<T>{}.allocate(n);
+    }
+    void deallocate(T* p, size_t n) {
+        if (!arena) std::allocator<T>{}.deallocate(p, n);
+    }
+
+    template <typename U>
+    bool operator==(const ArenaAllocator<U>& o) const { return arena == o.arena; }
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+// The world's FrameArena, or null (heap) without one.
+inline FrameArena* frame_arena(ecs::World& world) {
+    auto* arena = world.try_resource<std::shared_ptr<FrameArena>>();
+    return arena ? arena->get() : nullptr;
+}
+
+// An empty ArenaVector in the world's arena.
+template <typename T>
+ArenaVector<T> frame_vector(ecs::World& world) {
+    return ArenaVector<T>(ArenaAllocator<T>(frame_arena(world)));
+}
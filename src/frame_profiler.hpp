@@ -0,0 +1,323 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// FrameProfiler — per-system CPU timings recorded by ecs::Pipeline.
+//
+// Stored as a World resource. When present, Pipeline wraps every system call
+// in a steady_clock sample and reports it via record(). Timings accumulate
+// per frame (a system called several times, e.g. Physics sub-steps, is
+// summed) and are committed to a HISTORY-frame ring buffer by begin_frame(),
+// which Pipeline::update calls at the top of every frame.
+//
+// start_capture() additionally records every call as a Chrome trace event
+// for the next N frames, then writes the JSON to disk (open it in
+// chrome://tracing or ui.perfetto.dev).
+//
+// For the overlay's frame graph, each committed frame also keeps its phase
+// totals, its fixed-step count (note_steps(), from Pipeline::step_fixed) and
+// its wall time, the latter over a longer FRAME_HISTORY ring that feeds
+// histogram() and low_ms(). Timings measured inside another system (Jolt's
+// own step inside "Physics") go through record_nested(), which keeps them
+// out of the phase totals.
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+struct FrameProfiler {
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr int HISTORY       = 120;  // frames kept for avg/max and the graph
+    static constexpr int FRAME_HISTORY = 2048; // frame times kept for the histogram and lows
+
+    enum Phase : int { PreUpdate = 0, Logic, Physics, Render, PhaseCount };
+
+    static const char* phase_name(int phase) {
+        switch (phase) {
+            case PreUpdate: return "Pre-Update";
+            case Logic:     return "Logic";
+            case Physics:   return "Physics";
+            case Render:    return "Render";
+            default:        return "?";
+        }
+    }
+
+    struct SystemStats {
+        std::string name;
+        int         phase = Logic;
+
+        float                      current_ms = 0.0f; // accumulating this frame
+        std::array<float, HISTORY> history{};         // committed frames (ring)
+
+        double   total_ms    = 0.0; // since last reset()
+        uint64_t total_calls = 0;
+    };
+
+    struct TraceEvent {
+        int     slot;
+        int64_t ts_us;
+        int64_t dur_us;
+    };
+
+    // -----------------------------------------------------------------------
+    // Recording (called by Pipeline)
+    // -----------------------------------------------------------------------
+
+    // Returns the stats slot for (name, phase), creating it on first use.
+    int slot(const std::string& name, int phase) {
+        for (size_t i = 0; i < systems_.size(); ++i)
+            if (systems_[i].name == name && systems_[i].phase == phase)
+                return static_cast<int>(i);
+        SystemStats s;
+        s.name  = name;
+        s.phase = phase;
+        systems_.push_back(std::move(s));
+        return static_cast<int>(systems_.size() - 1);
+    }
+
+    void record(int slot, Clock::time_point t0, Clock::time_point t1) { add(slot, t0, t1, true); }
+
+    // Like record(), for a span inside a system that is already timed: it
+    // counts towards its own slot and the trace, not the phase total.
+    void record_nested(int slot, Clock::time_point t0, Clock::time_point t1) { add(slot, t0, t1, false); }
+
+    // Fixed physics steps run this frame (Pipeline::step_fixed).
+    void note_steps(int steps) { steps_current_ += steps; }
+
+    // Commits the previous frame's accumulators into the ring buffer and
+    // starts a new frame. The first call only starts the clock.
+    void begin_frame() { begin_frame(Clock::now()); }
+
+    void begin_frame(Clock::time_point now) {
+        if (started_) {
+            head_   = (head_ + 1) % HISTORY;
+            frames_ = std::min(frames_ + 1, HISTORY);
+            for (auto& s : systems_) {
+                s.history[head_] = s.current_ms;
+                s.current_ms     = 0.0f;
+            }
+            for (int p = 0; p < PhaseCount; ++p) {
+                phase_history_[p][head_] = phase_current_[p];
+                phase_current_[p]        = 0.0f;
+            }
+            steps_history_[head_] = steps_current_;
+            steps_current_        = 0;
+
+            const float frame_ms  = std::chrono::duration<float, std::milli>(now - frame_start_).count();
+            frame_history_[head_] = frame_ms;
+            long_head_            = (long_head_ + 1) % FRAME_HISTORY;
+            long_frames_          = std::min(long_frames_ + 1, FRAME_HISTORY);
+            long_history_[long_head_] = frame_ms;
+
+            if (capture_remaining_ > 0 && --capture_remaining_ == 0) finish_capture();
+        }
+        started_     = true;
+        frame_start_ = now;
+    }
+
+    // Clears history and since-reset totals. System slots are kept.
+    void reset() {
+        for (auto& s : systems_) {
+            s.current_ms  = 0.0f;
+            s.history.fill(0.0f);
+            s.total_ms    = 0.0;
+            s.total_calls = 0;
+        }
+        for (auto& h : phase_history_) h.fill(0.0f);
+        phase_current_.fill(0.0f);
+        frame_history_.fill(0.0f);
+        steps_history_.fill(0);
+        steps_current_ = 0;
+        long_history_.fill(0.0f);
+        long_head_   = 0;
+        long_frames_ = 0;
+        head_    = 0;
+        frames_  = 0;
+        started_ = false;
+    }
+
+    // -----------------------------------------------------------------------
+    // Queries (averages and maxima over the committed history)
+    // -----------------------------------------------------------------------
+
+    int frames() const { return frames_; }
+    const std::vector<SystemStats>& systems() const { return systems_; }
+
+    float last_ms(const SystemStats& s) const { return frames_ ? s.history[head_] : 0.0f; }
+    float avg_ms(const SystemStats& s)  const { return avg(s.history); }
+    float max_ms(const SystemStats& s)  const { return max(s.history); }
+
+    float phase_avg_ms(int phase) const { return avg(phase_history_[phase]); }
+    float phase_max_ms(int phase) const { return max(phase_history_[phase]); }
+    float frame_avg_ms()          const { return avg(frame_history_); }
+    float frame_max_ms()          const { return max(frame_history_); }
+
+    // Per-frame values `ago` committed frames back (0 = last; < frames()).
+    float frame_ms(int ago)            const { return frame_history_[ring(ago)]; }
+    float phase_ms(int phase, int ago) const { return phase_history_[phase][ring(ago)]; }
+    float system_ms(const SystemStats& s, int ago) const { return s.history[ring(ago)]; }
+    int   steps(int ago)               const { return steps_history_[ring(ago)]; }
+
+    // Slot index for (name, phase), or -1 if nothing recorded under it.
+    int find(const std::string& name, int phase) const {
+        for (size_t i = 0; i < systems_.size(); ++i)
+            if (systems_[i].name == name && systems_[i].phase == phase) return static_cast<int>(i);
+        return -1;
+    }
+
+    // Frame times over the last FRAME_HISTORY frames, in bins of `bin_ms`;
+    // the last bin also counts everything slower. Returns the frames binned.
+    int histogram(uint32_t* bins, int bin_count, float bin_ms) const {
+        std::fill(bins, bins + bin_count, 0u);
+        for (int i = 0; i < long_frames_; ++i) {
+            const int b = static_cast<int>(long_history_[(long_head_ - i + FRAME_HISTORY) % FRAME_HISTORY] / bin_ms);
+            ++bins[std::clamp(b, 0, bin_count - 1)];
+        }
+        return long_frames_;
+    }
+
+    // Mean time of the slowest `fraction` of the last FRAME_HISTORY frames
+    // (at least one): low_ms(0.01f) is the "1% low".
+    float low_ms(float fraction) {
+        if (!long_frames_) return 0.0f;
+        low_scratch_.clear();
+        for (int i = 0; i < long_frames_; ++i)
+            low_scratch_.push_back(long_history_[(long_head_ - i + FRAME_HISTORY) % FRAME_HISTORY]);
+        const int n = std::clamp(static_cast<int>(static_cast<float>(long_frames_) * fraction + 0.999f), 1, long_frames_);
+        std::nth_element(low_scratch_.begin(), low_scratch_.begin() + (n - 1), low_scratch_.end(), std::greater<float>());
+        float sum = 0.0f;
+        for (int i = 0; i < n; ++i) sum += low_scratch_[i];
+        return sum / static_cast<float>(n);
+    }
+    int long_frames() const { return long_frames_; }
+
+    // Slot indices of the n systems with the highest average, slowest first.
+    std::vector<int> slowest(int n) const {
+        std::vector<int> idx(systems_.size());
+        for (size_t i = 0; i < idx.size(); ++i) idx[i] = static_cast<int>(i);
+        std::stable_sort(idx.begin(), idx.end(), [&](int a, int b) {
+            return avg_ms(systems_[a]) > avg_ms(systems_[b]);
+        });
+        if (static_cast<int>(idx.size()) > n) idx.resize(std::max(0, n));
+        return idx;
+    }
+
+    // -----------------------------------------------------------------------
+    // Chrome trace capture
+    // -----------------------------------------------------------------------
+
+    // Record every system call for the next `frames` frames, then write a
+    // Chrome trace JSON to `path`. Ignored while a capture is in progress.
+    bool start_capture(int frames, const std::string& path) {
+        if (capture_remaining_ > 0 || frames <= 0) return false;
+        trace_.clear();
+        capture_path_      = path;
+        capture_remaining_ = frames;
+        return true;
+    }
+
+    bool capturing()          const { return capture_remaining_ > 0; }
+    int  capture_remaining()  const { return capture_remaining_; }
+    const std::string& last_capture_path() const { return last_capture_path_; }
+
+    // Writes the captured events in Chrome "Trace Event" format. One track
+    // (tid) per phase so sub-steps and render calls don't overlap visually.
+    void write_chrome_trace(std::ostream& out) const {
+        out << "{\"traceEvents\":[";
+        for (int p = 0; p < PhaseCount; ++p) {
+            if (p) out << ',';
+            out << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << p
+                << ",\"args\":{\"name\":\"" << phase_name(p) << "\"}}";
+        }
+        for (const auto& e : trace_) {
+            const auto& s = systems_[e.slot];
+            out << ",{\"name\":\"";
+            write_escaped(out, s.name);
+            out << "\",\"cat\":\"" << phase_name(s.phase)
+                << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << s.phase
+                << ",\"ts\":" << e.ts_us << ",\"dur\":" << e.dur_us << '}';
+        }
+        out << "]}\n";
+    }
+
+    size_t trace_event_count() const { return trace_.size(); }
+
+private:
+    std::vector<SystemStats>                              systems_;
+    std::array<float, PhaseCount>                         phase_current_{};
+    std::array<std::array<float, HISTORY>, PhaseCount>    phase_history_{};
+    std::array<float, HISTORY>                            frame_history_{};
+    std::array<int, HISTORY>                              steps_history_{};
+    int                                                   steps_current_ = 0;
+    std::array<float, FRAME_HISTORY>                      long_history_{};
+    int                                                   long_head_   = 0;
+    int                                                   long_frames_ = 0;
+    std::vector<float>                                    low_scratch_; // reused by low_ms()
+    int                                                   head_    = 0;
+    int                                                   frames_  = 0;
+    bool                                                  started_ = false;
+    Clock::time_point                                     frame_start_{};
+
+    Clock::time_point       epoch_ = Clock::now();
+    std::vector<TraceEvent> trace_;
+    std::string             capture_path_;
+    std::string             last_capture_path_;
+    int                     capture_remaining_ = 0;
+
+    int64_t to_us(Clock::time_point t) const {
+        return std::chrono::duration_cast<std::chrono::microseconds>(t - epoch_).count();
+    }
+
+    void add(int slot, Clock::time_point t0, Clock::time_point t1, bool to_phase) {
+        if (slot < 0 || slot >= static_cast<int>(systems_.size())) return;
+        const float ms = std::chrono::duration<float, std::milli>(t1 - t0).count();
+        auto& s = systems_[slot];
+        s.current_ms  += ms;
+        s.total_ms    += ms;
+        s.total_calls += 1;
+        if (to_phase) phase_current_[s.phase] += ms;
+
+        if (capture_remaining_ > 0) {
+            trace_.push_back({slot, to_us(t0), std::max<int64_t>(1, to_us(t1) - to_us(t0))});
+        }
+    }
+
+    int ring(int ago) const { return (head_ - ago + HISTORY) % HISTORY; }
+
+    float avg(const std::array<float, HISTORY>& h) const {
+        if (!frames_) return 0.0f;
+        float sum = 0.0f;
+        for (int i = 0; i < frames_; ++i) sum += h[(head_ - i + HISTORY) % HISTORY];
+        return sum / static_cast<float>(frames_);
+    }
+
+    float max(const std::array<float, HISTORY>& h) const {
+        float m = 0.0f;
+        for (int i = 0; i < frames_; ++i) m = std::max(m, h[(head_ - i + HISTORY) % HISTORY]);
+        return m;
+    }
+
+    void finish_capture() {
+        std::ofstream f(capture_path_);
+        if (f) {
+            write_chrome_trace(f);
+            last_capture_path_ = capture_path_;
+        }
+        trace_.clear();
+    }
+
+    static void write_escaped(std::ostream& out, const std::string& s) {
+        for (char c : s) {
+            if (c == '"' || c == '\\') out << '\\';
+            out << c;
+        }
+    }
+};
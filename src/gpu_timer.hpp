@@ -0,0 +1,161 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// GpuTimer — GPU time of the scene pass and the debug overlay, from
+// timestamp queries read back a few frames late.
+//
+// begin(scope) / end(scope) each issue a timestamp query into the current
+// frame's slot; end_frame() (after EndDrawing) moves to the next of LATENCY
+// slots. A slot's results are read once the GPU has them, so the CPU never
+// waits: timings arrive LATENCY - 1 frames or so after the frame they
+// measure. If a slot is still pending when it comes round again, that frame
+// is not timed (dropped()).
+//
+// The queries go through a Backend of plain function pointers. The GL one
+// (GlGpuTimer below) is demo only; tests use a fake. The command stream is
+// batched by rlgl, so a caller flushes it (rlDrawRenderBatchActive) before
+// end() when the pass ends with batched 2D or line draws.
+//
+// World resource, created by RenderModule::install_gpu_timer (demo
+// --gpu-timer). Everything is a no-op until init() succeeds.
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+class GpuTimer {
+public:
+    enum Scope : int { Scene = 0, Overlay, ScopeCount };
+
+    static constexpr int LATENCY = 4;   // frames in flight
+    static constexpr int HISTORY = 120; // resolved frames kept for avg/max
+
+    struct Backend {
+        bool     (*create)(uint32_t* ids, int count)        = nullptr; // false: unsupported
+        void     (*destroy)(const uint32_t* ids, int count) = nullptr;
+        void     (*timestamp)(uint32_t id)                   = nullptr;
+        bool     (*ready)(uint32_t id)                       = nullptr;
+        uint64_t (*value_ns)(uint32_t id)                    = nullptr;
+    };
+
+    static const char* scope_name(int scope) {
+        switch (scope) {
+            case Scene:   return "Scene";
+            case Overlay: return "Overlay";
+            default:      return "?";
+        }
+    }
+
+    bool init(const Backend& backend) {
+        shutdown();
+        if (!backend.create || !backend.timestamp || !backend.ready || !backend.value_ns) return false;
+        if (!backend.create(ids_.data(), QUERY_COUNT)) return false;
+        backend_ = backend;
+        active_  = true;
+        return true;
+    }
+
+    void shutdown() {
+        if (active_ && backend_.destroy) backend_.destroy(ids_.data(), QUERY_COUNT);
+        active_ = false;
+        for (auto& f : frames_) f = {};
+    }
+
+    bool active() const { return active_; }
+
+    void begin(Scope s) {
+        if (!active_ || skip_) return;
+        backend_.timestamp(id(cur_, s, 0));
+        frames_[cur_].begun[s] = true;
+    }
+
+    void end(Scope s) {
+        if (!active_ || skip_ || !frames_[cur_].begun[s]) return;
+        backend_.timestamp(id(cur_, s, 1));
+        frames_[cur_].used[s] = true;
+    }
+
+    // Closes the current frame, reads back every slot the GPU has finished
+    // (oldest first) and opens the next slot.
+    void end_frame() {
+        if (!active_) return;
+        Slot& f = frames_[cur_];
+        if (!skip_) f.pending = std::any_of(f.used.begin(), f.used.end(), [](bool u) { return u; });
+        resolve();
+        cur_  = (cur_ + 1) % LATENCY;
+        skip_ = frames_[cur_].pending;
+        if (skip_) ++dropped_;
+        else       frames_[cur_] = {};
+    }
+
+    // Resolved history.
+    int      frames()  const { return count_; }
+    uint64_t dropped() const { return dropped_; }
+    float last_ms(int s) const { return count_ ? history_[s][head_] : 0.0f; }
+
+    float avg_ms(int s) const {
+        if (!count_) return 0.0f;
+        float sum = 0.0f;
+        for (int i = 0; i < count_; ++i) sum += history_[s][(head_ - i + HISTORY) % HISTORY];
+        return sum / static_cast<float>(count_);
+    }
+
+    float max_ms(int s) const {
+        float m = 0.0f;
+        for (int i = 0; i < count_; ++i) m = std::max(m, history_[s][(head_ - i + HISTORY) % HISTORY]);
+        return m;
+    }
+
+private:
+    static constexpr int QUERY_COUNT = LATENCY * ScopeCount * 2;
+
+    struct Slot {
+        std::array<bool, ScopeCount> begun{};
+        std::array<bool, ScopeCount> used{};
+        bool pending = false;
+    };
+
+    Backend                                            backend_;
+    std::array<uint32_t, QUERY_COUNT>                  ids_{};
+    std::array<Slot, LATENCY>                          frames_{};
+    std::array<std::array<float, HISTORY>, ScopeCount> history_{};
+    int      cur_     = 0;
+    bool     skip_    = false;
+    bool     active_  = false;
+    int      head_    = 0;
+    int      count_   = 0;
+    uint64_t dropped_ = 0;
+
+    uint32_t id(int slot, int scope, int edge) const { return ids_[(slot * ScopeCount + scope) * 2 + edge]; }
+
+    void resolve() {
+        for (int k = 1; k <= LATENCY; ++k) {
+            const int i = (cur_ + k) % LATENCY;
+            Slot& f = frames_[i];
+            if (!f.pending) continue;
+            for (int s = 0; s < ScopeCount; ++s)
+                if (f.used[s] && !backend_.ready(id(i, s, 1))) return; // in order: stop at the first unfinished
+            head_  = (head_ + 1) % HISTORY;
+            count_ = std::min(count_ + 1, HISTORY);
+            for (int s = 0; s < ScopeCount; ++s) {
+                float ms = 0.0f;
+                if (f.used[s]) {
+                    const uint64_t t0 = backend_.value_ns(id(i, s, 0));
+                    const uint64_t t1 = backend_.value_ns(id(i, s, 1));
+                    ms = t1 > t0 ? static_cast<float>(t1 - t0) / 1.0e6f : 0.0f;
+                }
+                history_[s][head_] = ms;
+            }
+            f.pending = false;
+        }
+    }
+};
+
+// The GL backend (gpu_timer_gl.cpp; demo only): GL_TIMESTAMP queries
+// (GL 3.3 / ARB_timer_query), loaded through GLFW. Call after InitWindow;
+// create() fails when the context lacks them.
+namespace GlGpuTimer {
+GpuTimer::Backend backend();
+} // namespace GlGpuTimer
@@ -0,0 +1,74 @@
+#include "gpu_timer.hpp"
+#include <GLFW/glfw3.h>
+
+// Raylib doesn't expose query objects through rlgl, so the four entry points
+// are loaded from the current context. Types and enums are spelled out to
+// avoid pulling in a GL loader header next to Raylib's own.
+
+namespace {
+
+using GLuint   = unsigned int;
+using GLint    = int;
+using GLsizei  = int;
+using GLenum   = unsigned int;
+using GLuint64 = unsigned long long;
+
+constexpr GLenum GL_TIMESTAMP_              = 0x8E28;
+constexpr GLenum GL_QUERY_RESULT_           = 0x8866;
+constexpr GLenum GL_QUERY_RESULT_AVAILABLE_ = 0x8867;
+
+using GenQueries          = void (*)(GLsizei, GLuint*);
+using DeleteQueries       = void (*)(GLsizei, const GLuint*);
+using QueryCounter        = void (*)(GLuint, GLenum);
+using GetQueryObjectiv    = void (*)(GLuint, GLenum, GLint*);
+using GetQueryObjectui64v = void (*)(GLuint, GLenum, GLuint64*);
+
+GenQueries          gen_queries    = nullptr;
+DeleteQueries       delete_queries = nullptr;
+QueryCounter        query_counter  = nullptr;
+GetQueryObjectiv    get_objectiv   = nullptr;
+GetQueryObjectui64v get_object64   = nullptr;
+
+bool create(uint32_t* ids, int count) {
+    if (!glfwGetCurrentContext()) return false;
+    gen_queries    = reinterpret_cast<GenQueries>(glfwGetProcAddress("glGenQueries"));
+    delete_queries = reinterpret_cast<DeleteQueries>(glfwGetProcAddress("glDeleteQueries"));
+    query_counter  = reinterpret_cast<QueryCounter>(glfwGetProcAddress("glQueryCounter"));
+    get_objectiv   = reinterpret_cast<GetQueryObjectiv>(glfwGetProcAddress("glGetQueryObjectiv"));
+    get_object64   = reinterpret_cast<GetQueryObjectui64v>(glfwGetProcAddress("glGetQueryObjectui64v"));
+    if (!gen_queries || !delete_queries || !query_counter || !get_objectiv || !get_object64) return false;
+    gen_queries(count, ids);
+    return true;
+}
+
+void destroy(const uint32_t* ids, int count) { delete_queries(count, ids); }
+
+void timestamp(uint32_t id) { query_counter(id, GL_TIMESTAMP_); }
+
+bool ready(uint32_t id) {
+    GLint available = 0;
+    get_objectiv(id, GL_QUERY_RESULT_AVAILABLE_, &available);
+    return available != 0;
+}
+
+uint64_t value_ns(uint32_t id) {
+    GLuint64 ns = 0;
+    get_object64(id, GL_QUERY_RESULT_, &ns);
+    return ns;
+}
+
+} // namespace
+
+namespace GlGpuTimer {
+
+GpuTimer::Backend backend() {
+    GpuTimer::Backend b;
+    b.create    = create;
+    b.destroy   = destroy;
+    b.timestamp = timestamp;
+    b.ready     = ready;
+    b.value_ns  = value_ns;
+    return b;
+}
+
+} // namespace GlGpuTimer
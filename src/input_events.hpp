@@ -0,0 +1,126 @@
+#pragma once
+#include "input_state.hpp"
+#include <array>
+#include <cstddef>
+#include <memory>
+#include <span>
+
+// ---------------------------------------------------------------------------
+// InputEventQueue — raw key and mouse-button events collected between two
+// InputGather runs.
+//
+// The event backend (GlfwInputEvents below) pushes one InputEvent per GLFW
+// key / mouse-button callback. Raylib's own callbacks still run first, so
+// IsKeyPressed keeps working for the debug keys. InputGatherSystem then
+// drains the queue with apply_events(). Keyboard cost is proportional to the
+// input actually received, and a press and release that land in the same
+// frame keep their order: the key ends up pressed but not down.
+//
+// Fixed capacity. Events past CAPACITY in one frame are counted in dropped()
+// and lost.
+//
+// poll_keys() is the polling backend's keyboard: it drains Raylib's
+// GetKeyPressed queue, and rescans every key when that queue may have
+// overflowed.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+class InputEventQueue {
+public:
+    static constexpr size_t CAPACITY = 256;
+
+    void push(const InputEvent& e) {
+        if (count_ == CAPACITY) { ++dropped_; return; }
+        events_[count_++] = e;
+    }
+
+    std::span<const InputEvent> events() const { return {events_.data(), count_}; }
+    size_t dropped() const { return dropped_; } // since start
+    void   clear() { count_ = 0; }
+
+private:
+    std::array<InputEvent, CAPACITY> events_{};
+    size_t count_   = 0;
+    size_t dropped_ = 0;
+};
+
+// Replaces the polled keyboard / mouse-button state in `record` with the
+// result of `events`, in order. keys_down and mouse_buttons carry over from
+// the previous frame; the *_pressed sets and the event list start empty.
+inline void apply_events(InputRecord& record, std::span<const InputEvent> events, double now) {
+    record.keys_pressed.reset();
+    record.mouse_buttons_pressed.reset();
+    record.event_count = 0;
+    record.time = now;
+
+    for (const InputEvent& e : events) {
+        const auto code = static_cast<size_t>(e.code);
+        switch (e.kind) {
+        case InputEvent::Kind::KeyDown:
+            if (code >= record.keys_down.size()) continue;
+            record.keys_down[code] = record.keys_pressed[code] = true;
+            break;
+        case InputEvent::Kind::KeyUp:
+            if (code >= record.keys_down.size()) continue;
+            record.keys_down[code] = false;
+            break;
+        case InputEvent::Kind::MouseDown:
+            if (code >= record.mouse_buttons.size()) continue;
+            record.mouse_buttons[code] = record.mouse_buttons_pressed[code] = true;
+            break;
+        case InputEvent::Kind::MouseUp:
+            if (code >= record.mouse_buttons.size()) continue;
+            record.mouse_buttons[code] = false;
+            break;
+        }
+        if (record.event_count < InputRecord::MAX_EVENTS)
+            record.events[record.event_count++] = e;
+    }
+}
+
+// Raylib's GetKeyPressed queue holds this many presses a frame
+// (MAX_KEY_PRESSED_QUEUE in rcore.c) and drops the rest.
+inline constexpr size_t KEY_QUEUE_CAPACITY = 16;
+
+// Polled keyboard. `keys` is the backend: pop() returns the next queued
+// press (0 when empty), down(k) and pressed(k) are IsKeyDown / IsKeyPressed.
+// Presses come from the queue, and only keys already held are polled for
+// release. A full queue may have dropped presses, so then every key is
+// polled as well; queued presses still count, since a tap released within
+// the frame is in the queue but neither down nor pressed by then. Returns
+// whether the full scan ran.
+template <typename Keys>
+bool poll_keys(InputRecord& input, Keys& keys) {
+    const size_t key_count = input.keys_down.size();
+    input.keys_pressed.reset();
+    if (input.keys_down.any()) {
+        for (size_t i = 0; i < key_count; i++)
+            if (input.keys_down[i] && !keys.down(static_cast<int>(i))) input.keys_down[i] = false;
+    }
+
+    size_t queued = 0;
+    for (int key = keys.pop(); key != 0; key = keys.pop()) {
+        ++queued;
+        if (key < 0 || static_cast<size_t>(key) >= key_count) continue;
+        input.keys_pressed[key] = true;
+        // A tap that was released within the frame is pressed but not down.
+        input.keys_down[key] = keys.down(key);
+    }
+    if (queued < KEY_QUEUE_CAPACITY) return false;
+
+    for (size_t i = 0; i < key_count; i++) {
+        const int key = static_cast<int>(i);
+        if (keys.pressed(key)) input.keys_pressed[i] = true;
+        input.keys_down[i] = keys.down(key);
+    }
+    return true;
+}
+
+// The GLFW backend (input_events_glfw.cpp; demo only). install() chains key
+// and mouse-button callbacks onto Raylib's on the current window; false if
+// there is no GLFW window. uninstall() restores Raylib's callbacks.
+namespace GlfwInputEvents {
+bool install(std::shared_ptr<InputEventQueue> queue);
+void uninstall();
+} // namespace GlfwInputEvents
@@ -0,0 +1,54 @@
+#include "input_events.hpp"
+#include <raylib.h>
+#include <GLFW/glfw3.h>
+
+// Raylib's key codes are GLFW's, and its mouse buttons 0-2 are GLFW's
+// left / right / middle, so codes pass through unchanged.
+
+namespace {
+
+std::shared_ptr<InputEventQueue> g_queue;
+GLFWwindow*                      g_window = nullptr;
+GLFWkeyfun                       g_prev_key   = nullptr;
+GLFWmousebuttonfun               g_prev_mouse = nullptr;
+
+void on_key(GLFWwindow* window, int key, int scancode, int action, int mods) {
+    if (g_prev_key) g_prev_key(window, key, scancode, action, mods);
+    if (!g_queue || action == GLFW_REPEAT) return;
+    g_queue->push({action == GLFW_PRESS ? InputEvent::Kind::KeyDown : InputEvent::Kind::KeyUp,
+                   static_cast<int16_t>(key), glfwGetTime()});
+}
+
+void on_mouse_button(GLFWwindow* window, int button, int action, int mods) {
+    if (g_prev_mouse) g_prev_mouse(window, button, action, mods);
+    if (!g_queue) return;
+    g_queue->push({action == GLFW_PRESS ? InputEvent::Kind::MouseDown : InputEvent::Kind::MouseUp,
+                   static_cast<int16_t>(button), glfwGetTime()});
+}
+
+} // namespace
+
+namespace GlfwInputEvents {
+
+bool install(std::shared_ptr<InputEventQueue> queue) {
+    auto* window = static_cast<GLFWwindow*>(GetWindowHandle());
+    if (!window || !queue) return false;
+    uninstall();
+    g_queue      = std::move(queue);
+    g_window     = window;
+    g_prev_key   = glfwSetKeyCallback(window, on_key);
+    g_prev_mouse = glfwSetMouseButtonCallback(window, on_mouse_button);
+    return true;
+}
+
+void uninstall() {
+    if (!g_window) return;
+    glfwSetKeyCallback(g_window, g_prev_key);
+    glfwSetMouseButtonCallback(g_window, g_prev_mouse);
+    g_window     = nullptr;
+    g_prev_key   = nullptr;
+    g_prev_mouse = nullptr;
+    g_queue.reset();
+}
+
+} // namespace GlfwInputEvents
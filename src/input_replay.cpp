@@ -0,0 +1,258 @@
+#include "input_replay.hpp"
+#include "components.hpp"
+#include <ecs/modules/transform.hpp>
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <iterator>
+
+namespace InputReplay {
+
+namespace {
+
+// Flushed to the file in chunks of about this size.
+constexpr size_t k_flush_bytes = 64 * 1024;
+
+// A literal run ends at this many unchanged bytes; shorter gaps stay in it.
+constexpr size_t k_min_skip = 3;
+
+template <typename T>
+void put(uint8_t*& p, const T& v) {
+    std::memcpy(p, &v, sizeof(T));
+    p += sizeof(T);
+}
+
+template <typename T>
+void get(const uint8_t*& p, T& v) {
+    std::memcpy(&v, p, sizeof(T));
+    p += sizeof(T);
+}
+
+template <size_t N>
+void put_bits(uint8_t*& p, const std::bitset<N>& bits) {
+    static_assert(N % 8 == 0);
+    for (size_t i = 0; i < N; i += 8) {
+        uint8_t b = 0;
+        for (size_t j = 0; j < 8; ++j) b |= static_cast<uint8_t>(bits[i + j]) << j;
+        *p++ = b;
+    }
+}
+
+template <size_t N>
+void get_bits(const uint8_t*& p, std::bitset<N>& bits) {
+    for (size_t i = 0; i < N; i += 8, ++p)
+        for (size_t j = 0; j < 8; ++j) bits[i + j] = (*p >> j) & 1u;
+}
+
+void pack(const Frame& f, uint8_t* image) {
+    uint8_t* p = image;
+    put(p, f.dt);
+    put(p, f.checksum);
+    put_bits(p, f.input.keys_down);
+    put_bits(p, f.input.keys_pressed);
+    put(p, f.input.mouse_pos.x);
+    put(p, f.input.mouse_pos.y);
+    put(p, f.input.mouse_delta.x);
+    put(p, f.input.mouse_delta.y);
+    put(p, f.input.mouse_wheel);
+    put_bits(p, f.input.mouse_buttons);
+    put_bits(p, f.input.mouse_buttons_pressed);
+
+    const size_t pads = std::min(f.input.gamepad_count, MAX_GAMEPADS);
+    *p++ = static_cast<uint8_t>(pads);
+    std::memset(p, 0, MAX_GAMEPADS * PAD_BYTES);
+    for (size_t i = 0; i < pads; ++i) {
+        const GamepadState& gp = f.input.gamepads[i];
+        *p++ = static_cast<uint8_t>(gp.id + 1);
+        for (float a : gp.axes) put(p, a);
+        put_bits(p, gp.buttons);
+        put_bits(p, gp.buttons_pressed);
+    }
+}
+
+void unpack(const uint8_t* image, Frame& f) {
+    const uint8_t* p = image;
+    get(p, f.dt);
+    get(p, f.checksum);
+    get_bits(p, f.input.keys_down);
+    get_bits(p, f.input.keys_pressed);
+    get(p, f.input.mouse_pos.x);
+    get(p, f.input.mouse_pos.y);
+    get(p, f.input.mouse_delta.x);
+    get(p, f.input.mouse_delta.y);
+    get(p, f.input.mouse_wheel);
+    get_bits(p, f.input.mouse_buttons);
+    get_bits(p, f.input.mouse_buttons_pressed);
+
+    const size_t pads = std::min<size_t>(*p++, MAX_GAMEPADS);
+    f.input.gamepads.fill(GamepadState{});
+    f.input.gamepad_count = pads;
+    for (size_t i = 0; i < pads; ++i) {
+        GamepadState& gp = f.input.gamepads[i];
+        gp.id        = static_cast<int>(*p++) - 1;
+        gp.connected = true;
+        for (float& a : gp.axes) get(p, a);
+        get_bits(p, gp.buttons);
+        get_bits(p, gp.buttons_pressed);
+    }
+}
+
+void put_varint(std::vector<uint8_t>& out, size_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+bool get_varint(const std::vector<uint8_t>& in, size_t& pos, size_t& v) {
+    v = 0;
+    for (unsigned shift = 0; pos < in.size() && shift < 32; shift += 7) {
+        const uint8_t b = in[pos++];
+        v |= static_cast<size_t>(b & 0x7f) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+} // namespace
+
+uint64_t checksum(ecs::World& world) {
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](const void* data, size_t n) {
+        const auto* b = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < n; ++i) h = (h ^ b[i]) * 1099511628211ull;
+    };
+    auto pose = [&](const ecs::LocalTransform& lt) {
+        mix(&lt.position, sizeof(lt.position));
+        mix(&lt.rotation, sizeof(lt.rotation));
+    };
+    world.each<TransformHistory, ecs::LocalTransform>(
+        [&](ecs::Entity, TransformHistory&, ecs::LocalTransform& lt) { pose(lt); });
+    world.each<PlayerTag, ecs::LocalTransform>(
+        [&](ecs::Entity, PlayerTag&, ecs::LocalTransform& lt) { pose(lt); });
+    return h;
+}
+
+// --- Recorder ---------------------------------------------------------------
+
+Recorder::Recorder() : image_(IMAGE_BYTES, 0) { reset(); }
+
+bool Recorder::open(const std::string& path) {
+    close();
+    reset();
+    file_.open(path, std::ios::binary | std::ios::trunc);
+    return file_.is_open();
+}
+
+void Recorder::reset() {
+    Header h{{MAGIC[0], MAGIC[1], MAGIC[2], MAGIC[3]}, VERSION, static_cast<uint32_t>(IMAGE_BYTES)};
+    out_.resize(sizeof(h));
+    std::memcpy(out_.data(), &h, sizeof(h));
+    prev_.assign(IMAGE_BYTES, 0);
+    frames_  = 0;
+    written_ = 0;
+}
+
+void Recorder::write(const Frame& frame) {
+    pack(frame, image_.data());
+
+    const uint8_t* cur  = image_.data();
+    const uint8_t* prev = prev_.data();
+    size_t i = 0;
+    while (i < IMAGE_BYTES) {
+        size_t skip = 0;
+        while (i + skip < IMAGE_BYTES && cur[i + skip] == prev[i + skip]) ++skip;
+        put_varint(out_, skip);
+        i += skip;
+        if (i == IMAGE_BYTES) break;
+
+        // Literal: up to the next run of k_min_skip unchanged bytes (or an
+        // unchanged tail).
+        size_t end = i;
+        while (end < IMAGE_BYTES) {
+            if (cur[end] != prev[end]) { ++end; continue; }
+            size_t same = end;
+            while (same < IMAGE_BYTES && same - end < k_min_skip && cur[same] == prev[same]) ++same;
+            if (same - end >= k_min_skip || same == IMAGE_BYTES) break;
+            end = same;
+        }
+        put_varint(out_, end - i);
+        for (; i < end; ++i) out_.push_back(cur[i] ^ prev[i]);
+    }
+    prev_.swap(image_);
+    ++frames_;
+
+    if (file_.is_open() && out_.size() >= k_flush_bytes) {
+        file_.write(reinterpret_cast<const char*>(out_.data()), static_cast<std::streamsize>(out_.size()));
+        written_ += out_.size();
+        out_.clear();
+    }
+}
+
+void Recorder::close() {
+    if (!file_.is_open()) return;
+    file_.write(reinterpret_cast<const char*>(out_.data()), static_cast<std::streamsize>(out_.size()));
+    written_ += out_.size();
+    out_.clear();
+    file_.close();
+}
+
+// --- Player -----------------------------------------------------------------
+
+bool Player::load(const std::string& path, std::string* error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    const std::vector<uint8_t> bytes(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>{});
+    return load_from_memory(bytes.data(), bytes.size(), error);
+}
+
+bool Player::load_from_memory(const void* data, size_t size, std::string* error) {
+    Header h;
+    if (!data || size < sizeof(h)) {
+        if (error) *error = "truncated header";
+        return false;
+    }
+    std::memcpy(&h, data, sizeof(h));
+    if (std::memcmp(h.magic, MAGIC, 4) != 0 || h.version != VERSION || h.image_bytes != IMAGE_BYTES) {
+        if (error) *error = "not a version " + std::to_string(VERSION) + " input recording";
+        return false;
+    }
+    const auto* b = static_cast<const uint8_t*>(data);
+    data_.assign(b, b + size);
+    rewind();
+    return true;
+}
+
+void Player::rewind() {
+    image_.assign(IMAGE_BYTES, 0);
+    pos_    = sizeof(Header);
+    frame_  = 0;
+    failed_ = false;
+}
+
+bool Player::next(Frame& out) {
+    if (failed_ || pos_ >= data_.size()) return false;
+
+    size_t i = 0;
+    while (i < IMAGE_BYTES) {
+        size_t skip = 0, count = 0;
+        if (!get_varint(data_, pos_, skip) || skip > IMAGE_BYTES - i) { failed_ = true; return false; }
+        i += skip;
+        if (i == IMAGE_BYTES) break;
+        if (!get_varint(data_, pos_, count) || count == 0 || count > IMAGE_BYTES - i
+            || count > data_.size() - pos_) {
+            failed_ = true;
+            return false;
+        }
+        for (size_t end = i + count; i < end; ++i) image_[i] ^= data_[pos_++];
+    }
+    unpack(image_.data(), out);
+    ++frame_;
+    return true;
+}
+
+} // namespace InputReplay
@@ -0,0 +1,111 @@
+#pragma once
+#include "input_state.hpp"
+#include <ecs/ecs.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// InputReplay — record each frame's InputRecord and dt, then play it back.
+//
+// A ".pinp" file starts with a Header. After that come frames until EOF.
+// Each frame is packed into a fixed IMAGE_BYTES image:
+//   { dt, checksum, key bits, mouse, gamepads[MAX_GAMEPADS] }
+// The frame is stored as that image XOR the previous frame's image, and the
+// XOR is run-length coded as (zero run, literal count, literal bytes) varint
+// pairs. An idle frame costs a byte or two.
+//
+// `checksum` is InputReplay::checksum(world), taken just before the frame's
+// update. A player that computes the same value at the same point finds the
+// first frame where the simulation diverged from the recording. This is how
+// bench --replay checks perf changes for behaviour changes. Bit-identical
+// results across machines need Jolt built with
+// CROSS_PLATFORM_DETERMINISTIC (CMake: PHYSICS_DETERMINISTIC=ON).
+//
+// Only the first MAX_GAMEPADS gamepads are recorded.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+namespace InputReplay {
+
+inline constexpr char     MAGIC[4]     = {'P', 'I', 'N', 'P'};
+inline constexpr uint32_t VERSION      = 1;
+inline constexpr size_t   MAX_GAMEPADS = 4;
+
+// dt, checksum, 2 × 512 key bits, mouse pos / delta / wheel, 2 × 8 button
+// bits, gamepad count, then per gamepad: id, 8 axes, 2 × 32 button bits.
+inline constexpr size_t PAD_BYTES   = 1 + 8 * 4 + 2 * 4;
+inline constexpr size_t IMAGE_BYTES = 4 + 8 + 2 * 64 + 5 * 4 + 2 + 1 + MAX_GAMEPADS * PAD_BYTES;
+
+struct Header {
+    char     magic[4];
+    uint32_t version;
+    uint32_t image_bytes; // IMAGE_BYTES of the writer; a mismatch is refused
+};
+
+struct Frame {
+    InputRecord input;
+    float       dt       = 0.0f;
+    uint64_t    checksum = 0;
+};
+
+// FNV-1a over the pose of every dynamic body (entities with
+// TransformHistory) and the player, in iteration order. Cheap enough to
+// take every frame.
+uint64_t checksum(ecs::World& world);
+
+// Encodes into memory, and optionally streams to a file as it goes.
+class Recorder {
+public:
+    Recorder();
+    ~Recorder() { close(); }
+
+    // Starts a new recording in `path` (truncated); any earlier one is
+    // closed first. False if it can't be opened.
+    bool open(const std::string& path);
+    void write(const Frame& frame);
+    void close(); // flushes; further writes only grow buffer()
+
+    size_t frames() const { return frames_; }
+    size_t bytes()  const { return written_ + out_.size(); }
+
+    // The encoded file so far, including the header, when no path is open.
+    const std::vector<uint8_t>& buffer() const { return out_; }
+
+private:
+    std::vector<uint8_t> out_;
+    std::vector<uint8_t> prev_;
+    std::vector<uint8_t> image_;
+    std::ofstream        file_;
+    size_t               frames_  = 0;
+    size_t               written_ = 0; // bytes already flushed to file_
+
+    void reset(); // header only, no frames
+};
+
+// Decodes a recording held in memory (load() reads the whole file).
+class Player {
+public:
+    bool load(const std::string& path, std::string* error = nullptr);
+    bool load_from_memory(const void* data, size_t size, std::string* error = nullptr);
+
+    // Next frame into `out`. False at the end, or if the data is corrupt
+    // (failed() tells which).
+    bool next(Frame& out);
+    void rewind();
+
+    size_t frame()  const { return frame_; }
+    bool   failed() const { return failed_; }
+
+private:
+    std::vector<uint8_t> data_;
+    std::vector<uint8_t> image_;
+    size_t               pos_    = 0;
+    size_t               frame_  = 0;
+    bool                 failed_ = false;
+};
+
+} // namespace InputReplay
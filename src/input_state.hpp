@@ -1,28 +1,77 @@
 #pragma once
 #include <ecs/ecs.hpp>
-#include <raylib.h>
-#include <vector>
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+// ---------------------------------------------------------------------------
+// InputRecord — every hardware input of one frame, gathered by
+// InputGatherSystem. Indices are Raylib's KeyboardKey / MouseButton /
+// GamepadAxis / GamepadButton values; systems that read them include
+// <raylib.h> for the names. InputReplay records and replays this resource.
+//
+// Fixed size and allocation-free: buttons are bitsets, and the real gamepads
+// are packed at the front of a fixed array in slot order, so gathering or
+// copying a record (replay, bench) never allocates. With the event backend
+// the record also lists the frame's timestamped key / mouse events.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+// One raw key or mouse-button transition, as queued by the event backend
+// (input_events.hpp). `time` is on Raylib's GetTime() clock.
+struct InputEvent {
+    enum class Kind : uint8_t { KeyDown, KeyUp, MouseDown, MouseUp };
+    Kind    kind = Kind::KeyDown;
+    int16_t code = 0;   // Raylib KeyboardKey / MouseButton
+    double  time = 0.0;
+};
 
 struct GamepadState {
-    int id = -1;
+    int id = -1;              // Raylib gamepad slot
     bool connected = false;
     float axes[8] = {0};
-    bool buttons[32] = {false};
-    bool buttons_pressed[32] = {false};
+    std::bitset<32> buttons;
+    std::bitset<32> buttons_pressed;
 };
 
 struct InputRecord {
+    // Matches the MAX_GAMEPADS patch applied to Raylib's config.h.
+    static constexpr size_t MAX_GAMEPADS = 16;
+
     // Keyboard
-    bool keys_down[512] = {false};
-    bool keys_pressed[512] = {false};
+    std::bitset<512> keys_down;
+    std::bitset<512> keys_pressed;
 
     // Mouse
-    Vector2 mouse_pos = {0, 0};
-    Vector2 mouse_delta = {0, 0};
+    ecs::Vec2 mouse_pos = {0, 0};
+    ecs::Vec2 mouse_delta = {0, 0};
     float mouse_wheel = 0.0f;
-    bool mouse_buttons[8] = {false};
-    bool mouse_buttons_pressed[8] = {false};
+    std::bitset<8> mouse_buttons;
+    std::bitset<8> mouse_buttons_pressed;
+
+    // Gamepads (filtered/real only): the first gamepad_count entries.
+    std::array<GamepadState, MAX_GAMEPADS> gamepads{};
+    size_t gamepad_count = 0;
+
+    std::span<const GamepadState> active_gamepads() const { return {gamepads.data(), gamepad_count}; }
+
+    // Event backend only (empty when polling): this frame's key and mouse
+    // transitions in arrival order, and when InputGather ran. Events past
+    // MAX_EVENTS still update the bitsets but are not listed here.
+    static constexpr size_t MAX_EVENTS = 32;
+    std::array<InputEvent, MAX_EVENTS> events{};
+    size_t event_count = 0;
+    double time = 0.0;
+
+    std::span<const InputEvent> frame_events() const { return {events.data(), event_count}; }
 
-    // Gamepads (Filtered/Real only)
-    std::vector<GamepadState> gamepads;
+    // Appends a pad; false (dropped) when all MAX_GAMEPADS entries are used.
+    bool add_gamepad(const GamepadState& gp) {
+        if (gamepad_count == MAX_GAMEPADS) return false;
+        gamepads[gamepad_count++] = gp;
+        return true;
+    }
 };
@@ -0,0 +1,80 @@
+#pragma once
+#include "components.hpp"
+#include <ecs/ecs.hpp>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// InstanceBatch — per-(ShapeType, LOD level) buckets of instance transforms.
+//
+// RenderSystem fills one bucket per shape and tessellation level each frame
+// (level 0 unless RenderLod picks a coarser one; always 0 for boxes) and
+// draws each non-empty bucket with a single DrawMeshInstanced call. The per-instance colour travels in
+// the model matrix's bottom row (elements 3, 7, 11, 15 of the column-major
+// array), which is always (0, 0, 0, 1) for an affine transform. The
+// instanced vertex shader (resources/shaders/lighting_instanced.vs) reads it
+// back and restores the row, so no second instance buffer is needed.
+//
+// Buckets keep their capacity across clear(), so steady-state frames don't
+// allocate.
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+struct InstanceBatch {
+    static constexpr size_t SHAPE_COUNT = 3; // ShapeType::Box, Sphere, Capsule
+    static constexpr size_t LOD_COUNT   = 3; // RenderLod::LEVELS
+
+    void clear() {
+        for (auto& b : buckets_) b.clear();
+    }
+
+    // Boxes have one mesh, so they always go to level 0 whatever `lod` says;
+    // one shape, one mesh, one draw call.
+    void add(ShapeType shape, const ecs::Mat4& model, const Color4& color, int lod = 0) {
+        buckets_[index(shape, has_lods(shape) ? lod : 0)].push_back(pack(model, color));
+    }
+
+    // Whether AssetResource bakes coarser meshes for the shape.
+    static constexpr bool has_lods(ShapeType shape) { return shape != ShapeType::Box; }
+
+    const std::vector<ecs::Mat4>& bucket(ShapeType shape, int lod = 0) const { return buckets_[index(shape, lod)]; }
+
+    // Instances at one level, all shapes.
+    size_t level_size(int lod) const {
+        size_t n = 0;
+        for (size_t s = 0; s < SHAPE_COUNT; ++s) n += buckets_[s * LOD_COUNT + clamp_lod(lod)].size();
+        return n;
+    }
+
+    size_t size() const {
+        size_t n = 0;
+        for (const auto& b : buckets_) n += b.size();
+        return n;
+    }
+
+    // Writes color into the bottom row of an affine model matrix.
+    static ecs::Mat4 pack(ecs::Mat4 model, const Color4& color) {
+        model.m[3]  = color.r;
+        model.m[7]  = color.g;
+        model.m[11] = color.b;
+        model.m[15] = color.a;
+        return model;
+    }
+
+    static Color4 unpack_color(const ecs::Mat4& packed) {
+        return {packed.m[3], packed.m[7], packed.m[11], packed.m[15]};
+    }
+
+private:
+    std::array<std::vector<ecs::Mat4>, SHAPE_COUNT * LOD_COUNT> buckets_;
+
+    static size_t clamp_lod(int lod) {
+        return lod <= 0 ? 0 : std::min(static_cast<size_t>(lod), LOD_COUNT - 1);
+    }
+    static size_t index(ShapeType shape, int lod) {
+        return static_cast<size_t>(shape) * LOD_COUNT + clamp_lod(lod);
+    }
+};
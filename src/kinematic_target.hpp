@@ -0,0 +1,46 @@
+#pragma once
+#include <ecs/ecs.hpp>
+#include <ecs/modules/transform.hpp>
+
+// ---------------------------------------------------------------------------
+// KinematicTarget — the last pose KinematicDriverSystem sent to a
+// BodyType::Kinematic body.
+//
+// Gameplay moves a kinematic body (moving platform, elevator) by writing its
+// LocalTransform; KinematicDriverSystem turns that into MoveKinematic before
+// each fixed step, and step() decides what each body needs:
+//   Move — the target changed: MoveKinematic toward it (and wake the body).
+//   Stop — unchanged since a Move: one more MoveKinematic to the same pose,
+//          which zeroes the velocity Jolt would otherwise keep applying.
+//   Skip — unchanged and already stopped: nothing to do.
+// Targets are compared exactly; any write that changes a bit counts.
+//
+// Added by PhysicsSystem's RigidBodyConfig hook to every kinematic body,
+// starting at its spawn pose.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+struct KinematicTarget {
+    enum class Action { Skip, Move, Stop };
+
+    ecs::Vec3 position = {0, 0, 0};
+    ecs::Quat rotation = {0, 0, 0, 1};
+    bool      moving   = false;
+
+    Action step(const ecs::LocalTransform& target) {
+        const bool same = position.x == target.position.x && position.y == target.position.y
+                       && position.z == target.position.z && rotation.x == target.rotation.x
+                       && rotation.y == target.rotation.y && rotation.z == target.rotation.z
+                       && rotation.w == target.rotation.w;
+        if (same) {
+            if (!moving) return Action::Skip;
+            moving = false;
+            return Action::Stop;
+        }
+        position = target.position;
+        rotation = target.rotation;
+        moving   = true;
+        return Action::Move;
+    }
+};
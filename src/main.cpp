@@ -1,5 +1,7 @@
+#include "modules/asset_module.hpp"
 #include "modules/event_bus_module.hpp"
 #include "modules/input_module.hpp"
+#include "modules/net_module.hpp"
 #include "modules/physics_module.hpp"
 #include "modules/render_module.hpp"
 #include "modules/audio_module.hpp"
@@ -7,69 +9,211 @@
 #include "modules/camera_module.hpp"
 #include "modules/character_module.hpp"
 #include "modules/builder_module.hpp"
+#include "modules/scene_module.hpp"
 #include "scene.hpp"
+#include "sim_thread.hpp"
 #include <ecs/ecs.hpp>
 #include <raylib.h>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <string>
+#include <system_error>
 
 static const char* SCENE_PATH = "resources/scenes/default.json";
+static const char* BAKED_PATH = "resources/scenes/default.pscn"; // written by scene_bake
+
+// Spawn the scene from its baked image when that is at least as new as the
+// JSON (RFC-0025); otherwise, or if the image is rejected, parse the JSON.
+static void load_scene(ecs::World& world) {
+    namespace fs = std::filesystem;
+    std::error_code ec_json, ec_baked;
+    const auto json_time  = fs::last_write_time(SCENE_PATH, ec_json);
+    const auto baked_time = fs::last_write_time(BAKED_PATH, ec_baked);
+    if (!ec_baked && (ec_json || baked_time >= json_time) && SceneLoader::load_binary(world, BAKED_PATH))
+        return;
+    SceneLoader::load(world, SCENE_PATH);
+}
+
+// The R keys, and a streamed load landing. Runs at the top of every frame,
+// while nothing else touches the World.
+static void handle_resets(ecs::World& world, ecs::Pipeline& pipeline, bool& streaming) {
+    if (IsKeyPressed(KEY_R)) {
+        // R: instant reset: restore the snapshot taken after the last
+        // load in place (RFC-0038). If bodies have gone since, or there
+        // is no snapshot, fall through to the full reset.
+        // Ctrl+R: hot reload from the JSON, keyed by "_name" (RFC-0027).
+        // Shift+R: full reset — destroy everything and stream the scene
+        // back in over the next frames (RFC-0028).
+        const bool shift = IsKeyDown(KEY_LEFT_SHIFT) || IsKeyDown(KEY_RIGHT_SHIFT);
+        const bool ctrl  = IsKeyDown(KEY_LEFT_CONTROL) || IsKeyDown(KEY_RIGHT_CONTROL);
+        if (ctrl && !shift) {
+            if (!SceneModule::loading(world)) {
+                SceneLoader::reload(world, SCENE_PATH);
+                PhysicsModule::commit_bodies(world);
+                PhysicsModule::clear_snapshot(world); // next R picks up the edits
+                pipeline.serialize_next_frame();      // PhysicsTeleport tags may add archetypes
+            }
+        } else if (shift || SceneModule::loading(world) || !PhysicsModule::restore_snapshot(world)) {
+            SceneModule::reset_async(world, SCENE_PATH);
+        } else {
+            BuilderModule::rewind_pool(world);  // the restore parked every platform
+        }
+    }
+
+    // A streamed load that has just landed is the new reset point.
+    const bool loading = SceneModule::loading(world);
+    if (streaming && !loading) {
+        BuilderModule::fill_pool(world);   // the unload destroyed the pool's platforms
+        PhysicsModule::commit_bodies(world);
+        PhysicsModule::save_snapshot(world);
+    }
+    streaming = loading;
+}
+
+// demo [--record <file.pinp>] [--input-events] [--pipelined] [--async-physics]
+//      [--gpu-timer] [--server [port] | --client <host[:port]>]
+//   --record        record every frame's input for bench --replay.
+//   --input-events  gather keys and mouse buttons from GLFW callbacks
+//                   (timestamped, sub-frame ordered) instead of polling.
+//   --pipelined     simulate frame N on a second thread while the main
+//                   thread draws frame N - 1 from its RenderSnapshot.
+//   --async-physics run the fixed steps on their own thread, overlapping
+//                   Render (same as "async_step": true in the scene).
+//   --gpu-timer     time the scene pass and the debug overlay on the GPU
+//                   (timestamp queries; "Profiler" rows in the debug panel).
+//   --server        send every client the dynamic bodies and characters
+//                   each physics tick (UDP, default port 27960).
+//   --client        watch a server's simulation instead of running one: no
+//                   player control, building or local physics steps. Both
+//                   sides must load the same scene (RFC-0057).
+int main(int argc, char** argv) {
+    const char* record_path  = nullptr;
+    bool        input_events = false;
+    bool        pipelined    = false;
+    bool        async_step   = false;
+    bool        gpu_timer    = false;
+    bool        server       = false;
+    uint16_t    server_port  = NetModule::DEFAULT_PORT;
+    std::string client_host;
+    uint16_t    client_port  = NetModule::DEFAULT_PORT;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) record_path = argv[++i];
+        else if (std::strcmp(argv[i], "--input-events") == 0) input_events = true;
+        else if (std::strcmp(argv[i], "--pipelined") == 0) pipelined = true;
+        else if (std::strcmp(argv[i], "--async-physics") == 0) async_step = true;
+        else if (std::strcmp(argv[i], "--gpu-timer") == 0) gpu_timer = true;
+        else if (std::strcmp(argv[i], "--server") == 0) {
+            server = true;
+            if (i + 1 < argc && argv[i + 1][0] != '-') server_port = static_cast<uint16_t>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--client") == 0 && i + 1 < argc) {
+            client_host = argv[++i];
+            const size_t colon = client_host.rfind(':');
+            if (colon != std::string::npos) {
+                client_port = static_cast<uint16_t>(std::atoi(client_host.c_str() + colon + 1));
+                client_host.resize(colon);
+            }
+        }
+    }
 
-int main() {
     InitWindow(1280, 720, "Physics Integration - Dynamic Parkour");
     SetTargetFPS(60);
 
     ecs::World    world;
     ecs::Pipeline pipeline;
+    pipeline.set_threads(2);  // Logic has two independent chains: character → audio, and builder
 
     // --- Engine Modules ---
     // These add only to Pre-Update, Physics, and Render phases — not Logic.
     // Installation order within this group is flexible.
     EventBusModule::install(world, pipeline);  // Pre-Update: event flush (must be first)
+    DebugModule::install(world, pipeline);     // DebugPanel + FrameProfiler (before any module adding rows)
+    AssetModule::install(world, pipeline);     // Pre-Update: finish loads, hot reload (before Render/Audio)
     InputModule::install(world, pipeline);     // Pre-Update: input gather + player input
-    PhysicsModule::install(world, pipeline);   // Physics:    Jolt step + propagate_transforms
-    RenderModule::install(world, pipeline);    // Render:     3D scene
-    DebugModule::install(world, pipeline);     // Render:     debug overlay (before game modules)
+    if (record_path) InputModule::install_recorder(world, pipeline, record_path); // after InputGather
+    if (input_events) InputModule::install_event_backend(world); // GLFW callbacks (after InitWindow)
+    PhysicsConfig physics_cfg;                 // optional "physics" block in the scene file
+    SceneLoader::load_physics_config(SCENE_PATH, physics_cfg);
+    if (async_step) physics_cfg.async_step = true;
+    PhysicsModule::install(world, pipeline, physics_cfg); // Physics: Jolt step; Render: dirty transform propagation (first)
+    const bool spectator = !client_host.empty() &&
+                           NetModule::install_client(world, pipeline, client_host, client_port); // Pre-Update: apply snapshots
+    if (server && !spectator) NetModule::install_server(world, pipeline, server_port); // Physics: snapshots (after "Physics")
+    SceneModule::install(world, pipeline);     // Pre-Update: async scene commit (after PhysicsModule)
+    RenderModule::install(world, pipeline, pipelined); // Render: 3D scene (pipelined: snapshot capture only)
+    if (gpu_timer) RenderModule::install_gpu_timer(world); // Profiler: GPU scene / overlay rows
+    if (!pipelined) {
+        DebugModule::install_overlay(world, pipeline);  // Render: debug overlay (after 3D scene)
+        RenderModule::install_present(world, pipeline); // Render: EndDrawing (after all Render installs)
+    }
 
     // --- Game Modules ---
     // Logic ordering is a hard constraint (see ARCH-0013).
-    // Pipeline::add_logic appends in call order, so install order = execution order.
+    // Pipeline::add_logic appends in call order. Systems that share data run
+    // in install order, and Builder (which shares nothing) may overlap.
     //
-    //   Camera → CharInput → CharState → Audio → Builder → CharMotor
+    //   Camera → CharInput → CharState → Audio ─┐
+    //   Builder ────────────────────────────────┴→ PhysicsQuery → CharMotor
     //
     CameraModule::install(world, pipeline);             // Logic[1]: Camera (must be first)
     CharacterModule::install(world, pipeline);          // Logic[2,3]: CharInput, CharState
     AudioModule::install(world, pipeline);              // Logic[4]: Audio + device/resource setup
-    BuilderModule::install(world, pipeline);            // Logic[5]: PlatformBuilder
-    CharacterModule::install_motor(world, pipeline);    // Logic[6]: CharMotor (must be last)
+    if (!spectator) BuilderModule::install(world, pipeline); // Logic[5]: PlatformBuilder
+    PhysicsModule::install_queries(world, pipeline);    // Logic[6]: PhysicsQuery batch (after submitters)
+    if (!spectator) CharacterModule::install_motor(world, pipeline); // Logic[7]: CharMotor (must be last)
 
     // --- Scene ---
-    SceneLoader::load(world, SCENE_PATH);
+    load_scene(world);
+    BuilderModule::fill_pool(world);            // parked platform bodies (RFC-0042)
+    PhysicsModule::commit_bodies(world);        // batch broadphase insert + optimize
+    PhysicsModule::save_snapshot(world);        // the point R resets to (RFC-0038)
 
     // --- Game Loop ---
-    float accumulator  = 0.0f;
-    const float fixed_dt = 1.0f / 60.0f;
-
-    while (!WindowShouldClose()) {
-        float dt = GetFrameTime();
-
-        if (IsKeyPressed(KEY_R)) {
-            SceneLoader::unload(world);
-            SceneLoader::load(world, SCENE_PATH);
+    bool streaming = false;
+    if (pipelined) {
+        // Frame N simulates on `sim` while this thread, which owns the GL
+        // context and input, draws frame N - 1 (RFC-0045).
+        // Main-thread Logic systems (Audio) run here after the simulation
+        // job, which has already emitted their events.
+        SimThread sim;
+        pipeline.defer_main_thread(true);
+        while (!WindowShouldClose()) {
+            const float dt = GetFrameTime();
+            sim.wait();
+            pipeline.main_thread_logic(world, dt); // last frame's Logic results
+            PhysicsModule::join_step(world);  // async step: last frame's results
+            if (!spectator) handle_resets(world, pipeline, streaming);
+            pipeline.pre_update(world, dt);   // InputGather reads Raylib: main thread
+            const auto frame = RenderModule::begin_frame(world);
+            sim.run([&world, &pipeline, dt, spectator] {
+                pipeline.logic(world, dt);
+                if (!spectator) pipeline.step_fixed(world, dt);
+                PhysicsModule::kick_step(world);
+                pipeline.render(world);       // TransformPropagate, RenderCapture
+            });
+            RenderModule::draw_frame(frame);
         }
+        sim.wait();
+    } else {
+        while (!WindowShouldClose()) {
+            float dt = GetFrameTime();
+            PhysicsModule::join_step(world);  // async step: last frame's results
+            if (!spectator) handle_resets(world, pipeline, streaming);
 
-        pipeline.update(world, dt);
+            pipeline.update(world, dt);
+            if (!spectator) pipeline.step_fixed(world, dt); // FixedTime: capped catch-up, sets render alpha
+            PhysicsModule::kick_step(world);  // async step: overlaps Render
 
-        accumulator += dt;
-        while (accumulator >= fixed_dt) {
-            pipeline.step_physics(world, fixed_dt);
-            accumulator -= fixed_dt;
+            pipeline.render(world);
         }
-
-        pipeline.render(world);
     }
+    PhysicsModule::join_step(world);
 
     // --- Shutdown ---
-    AudioModule::shutdown(world);   // unload sounds + CloseAudioDevice
-    RenderModule::shutdown(world);  // unload shaders
+    InputModule::shutdown(world);   // flush an input recording, detach GLFW callbacks
+    AudioModule::shutdown(world);   // unload voices and sounds + CloseAudioDevice
+    RenderModule::shutdown(world);  // unload meshes, release shaders
+    AssetModule::shutdown(world);   // stop the loader thread, unload what is left
     CloseWindow();
     return 0;
 }
@@ -0,0 +1,108 @@
+#pragma once
+#include <cstddef>
+#include <string>
+
+#if defined(_WIN32)
+#  ifndef WIN32_LEAN_AND_MEAN
+#    define WIN32_LEAN_AND_MEAN
+#  endif
+#  ifndef NOMINMAX
+#    define NOMINMAX
+#  endif
+#  include <windows.h>
+#else
+#  include <fcntl.h>
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#  include <unistd.h>
+#endif
+
+// ---------------------------------------------------------------------------
+// MappedFile — read-only memory map of a whole file (RAII).
+//
+// Used by SceneLoader::load_binary so a baked scene is read straight from
+// the page cache with no intermediate copy. data() is nullptr if the file
+// could not be opened or is empty. Move-only.
+// ---------------------------------------------------------------------------
+
+class MappedFile {
+public:
+    explicit MappedFile(const std::string& path) { open(path); }
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+    MappedFile(MappedFile&& o) noexcept { *this = static_cast<MappedFile&&>(o); }
+    MappedFile& operator=(MappedFile&& o) noexcept {
+        if (this != &o) {
+            close();
+            data_ = o.data_;
+            size_ = o.size_;
+#if defined(_WIN32)
+            file_ = o.file_;
+            map_  = o.map_;
+            o.file_ = INVALID_HANDLE_VALUE;
+            o.map_  = nullptr;
+#endif
+            o.data_ = nullptr;
+            o.size_ = 0;
+        }
+        return *this;
+    }
+
+    const void* data() const { return data_; }
+    size_t      size() const { return size_; }
+    explicit operator bool() const { return data_ != nullptr; }
+
+private:
+    const void* data_ = nullptr;
+    size_t      size_ = 0;
+
+#if defined(_WIN32)
+    HANDLE file_ = INVALID_HANDLE_VALUE;
+    HANDLE map_  = nullptr;
+
+    void open(const std::string& path) {
+        file_ = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (file_ == INVALID_HANDLE_VALUE) return;
+        LARGE_INTEGER sz;
+        if (!GetFileSizeEx(file_, &sz) || sz.QuadPart == 0) { close(); return; }
+        map_ = CreateFileMappingA(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!map_) { close(); return; }
+        data_ = MapViewOfFile(map_, FILE_MAP_READ, 0, 0, 0);
+        if (!data_) { close(); return; }
+        size_ = static_cast<size_t>(sz.QuadPart);
+    }
+
+    void close() {
+        if (data_) UnmapViewOfFile(data_);
+        if (map_)  CloseHandle(map_);
+        if (file_ != INVALID_HANDLE_VALUE) CloseHandle(file_);
+        data_ = nullptr;
+        size_ = 0;
+        map_  = nullptr;
+        file_ = INVALID_HANDLE_VALUE;
+    }
+#else
+    void open(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return;
+        struct stat st;
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            void* p = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p != MAP_FAILED) {
+                data_ = p;
+                size_ = static_cast<size_t>(st.st_size);
+            }
+        }
+        ::close(fd); // the mapping keeps the file alive
+    }
+
+    void close() {
+        if (data_) munmap(const_cast<void*>(data_), size_);
+        data_ = nullptr;
+        size_ = 0;
+    }
+#endif
+};
@@ -0,0 +1,55 @@
+#pragma once
+#include "../asset_manager.hpp"
+#include "../assets.hpp"
+#include "../audio_resource.hpp"
+#include "../debug_panel.hpp"
+#include "../pipeline.hpp"
+#include <ecs/ecs.hpp>
+#include <memory>
+
+// ---------------------------------------------------------------------------
+// AssetModule
+//
+// Creates the AssetManager world resource, with the worker watching every
+// loaded file (WATCH_SECONDS), and adds the "AssetPump" Pre-Update step: it
+// finishes loads on the main thread and runs the reload listeners, which
+// rebind AssetResource's shaders and AudioResource's voices. Adds an
+// "Engine/Assets" debug row when a DebugPanel exists.
+//
+// install() must run before RenderModule::install and AudioModule::install,
+// which request their files from the manager; the earlier it runs, the more
+// of the reading overlaps the rest of startup. shutdown() after both
+// modules' shutdowns and before CloseWindow().
+// ---------------------------------------------------------------------------
+
+struct AssetModule {
+    static constexpr float WATCH_SECONDS = 0.5f;
+
+    struct PumpStep {
+        static constexpr const char* name        = "AssetPump";
+        static constexpr int         phase       = FrameProfiler::PreUpdate;
+        static constexpr bool        main_thread = true;
+        using writes = ecs::TypeList<std::shared_ptr<AssetManager>, AssetResource, AudioResource>;
+        static void run(ecs::World& w, float) { manager(w).pump(); }
+    };
+
+    static void install(ecs::World& world, ecs::Pipeline& pipeline) {
+        auto assets = std::make_shared<AssetManager>();
+        assets->cache().watch(WATCH_SECONDS);
+        world.set_resource(assets);
+
+        pipeline.add<PumpStep>();
+
+        if (auto* panel = world.try_resource<DebugPanel>()) {
+            panel->watch("Engine", "Assets", [&world](DebugText& out) {
+                const AssetCache& c = manager(world).cache();
+                out.format("%zu live, %zu loading, %zu reloads, %zu failed", c.live(), c.loading(), c.reloads(),
+                           c.failed());
+            }, DebugPanel::SLOW_HZ);
+        }
+    }
+
+    static AssetManager& manager(ecs::World& world) { return *world.resource<std::shared_ptr<AssetManager>>(); }
+
+    static void shutdown(ecs::World& world) { manager(world).shutdown(); }
+};
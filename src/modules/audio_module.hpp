@@ -1,37 +1,74 @@
 #pragma once
 #include "../audio_resource.hpp"
+#include "../components.hpp"
+#include "../debug_panel.hpp"
 #include "../events.hpp"
 #include "../pipeline.hpp"
 #include "../systems/audio.hpp"
+#include "asset_module.hpp"
+#include "character_module.hpp"
 #include <ecs/ecs.hpp>
 #include <raylib.h>
 
 // ---------------------------------------------------------------------------
 // AudioModule
 //
-// Initialises Raylib's audio device, loads the AudioResource (Sound handles),
-// and adds AudioSystem to the Logic phase.
+// Initialises Raylib's audio device, requests the AudioResource clips from
+// the AssetManager (AssetModule must be installed first) without waiting
+// for them, and adds AudioSystem to the Logic phase. Each clip's voices are
+// bound when its Sound arrives and after every hot reload.
 //
 // Pipeline placement: AudioSystem must run after CharacterStateSystem
 // (which emits JumpEvent / LandEvent) and before CharacterMotorSystem.
 // Callers must respect this by installing AudioModule between
-// CharacterModule::install and CharacterModule::install_motor.
+// CharacterModule::install and CharacterModule::install_motor. It reads the
+// event queues, the emitters' WorldTransform and MainCamera (the listener),
+// and Raylib audio stays on the main thread. Under --pipelined, Logic runs on
+// the simulation thread, so the Pipeline defers Audio to main_thread_logic().
+// The main thread calls it once the frame's simulation job is done, before
+// the next EventFlush.
 //
 // shutdown() unloads sounds and closes the audio device. Must be called
-// before CloseWindow().
+// before AssetModule::shutdown() and CloseWindow().
 // ---------------------------------------------------------------------------
 
 struct AudioModule {
+    struct Step {
+        static constexpr const char* name        = "Audio";
+        static constexpr int         phase       = FrameProfiler::Logic;
+        static constexpr bool        main_thread = true;
+        using reads  = ecs::TypeList<Events<JumpEvent>, Events<LandEvent>, MainCamera, ecs::WorldTransform>;
+        using writes = ecs::TypeList<AudioResource>;
+        using after  = ecs::TypeList<CharacterModule::StateStep>;
+        static void run(ecs::World& w, float dt) { AudioSystem::Update(w, dt); }
+    };
+
     static void install(ecs::World& world, ecs::Pipeline& pipeline) {
         InitAudioDevice();
+        AssetManager& manager = AssetModule::manager(world);
         AudioResource audio;
-        audio.load();
+        audio.load(manager);
         world.set_resource(std::move(audio));
-        pipeline.add_logic([](ecs::World& w, float dt) { AudioSystem::Update(w, dt); });
+        for (size_t c = 0; c < AudioResource::CLIPS; ++c) {
+            manager.on_upload(world.resource<AudioResource>().clips[c], [&world, c] {
+                world.resource<AudioResource>().bind(AssetModule::manager(world), AudioClip(c));
+            });
+        }
+        pipeline.add<Step>();
+
+        if (auto* panel = world.try_resource<DebugPanel>()) {
+            panel->watch("Audio", "Voices", [&world](DebugText& out) {
+                auto* audio = world.try_resource<AudioResource>();
+                if (!audio) { out.set("-"); return; }
+                const VoicePool& p = audio->pool;
+                out.format("%zu / %zu, %zu merged, %zu culled, %zu stolen, %zu dropped", p.playing(),
+                           p.max_voices, p.coalesced(), p.culled(), p.stolen(), p.dropped());
+            }, DebugPanel::SLOW_HZ);
+        }
     }
 
     static void shutdown(ecs::World& world) {
-        world.resource<AudioResource>().unload();
+        world.resource<AudioResource>().unload(AssetModule::manager(world));
         CloseAudioDevice();
     }
 };
@@ -1,17 +1,63 @@
 #pragma once
+#include "../components.hpp"
+#include "../culling.hpp"
+#include "../debug_panel.hpp"
+#include "../physics_query.hpp"
 #include "../pipeline.hpp"
+#include "../platform_pool.hpp"
 #include "../systems/builder.hpp"
+#include "../transform_dirty.hpp"
 #include <ecs/ecs.hpp>
+#include <cstddef>
 
 // ---------------------------------------------------------------------------
 // BuilderModule
 //
 // Adds PlatformBuilderSystem to the Logic phase. Runs after CharacterState
-// (it reads PlayerInput and PlayerState) and before CharacterMotor.
+// (it reads PlayerInput and PlayerState) and before CharacterMotor. It shares
+// nothing the character chain writes, so a threaded Pipeline overlaps them.
+// Its placement raycast is a PhysicsQuery request, answered by
+// PhysicsQuerySystem before CharMotor.
+//
+// Platforms come from a PlatformPool resource of `pool_capacity` parked
+// bodies (RFC-0042): a plant moves one into place, and at the cap the oldest
+// is moved. Call fill_pool() after every scene load, before the body commit
+// and the reset snapshot, and rewind_pool() after a snapshot restore. Without a filled pool (capacity 0, or mid-stream)
+// the builder spawns as before. Its structural changes (spawns, the
+// PhysicsTeleport on a moved slot) go on its own CommandLane
+// (deferred_commands.hpp), so it declares no Access::Deferred.
 // ---------------------------------------------------------------------------
 
 struct BuilderModule {
-    static void install(ecs::World& /*world*/, ecs::Pipeline& pipeline) {
-        pipeline.add_logic([](ecs::World& w, float) { PlatformBuilderSystem::Update(w); });
+    struct Step {
+        static constexpr const char* name  = "Builder";
+        static constexpr int         phase = FrameProfiler::Logic;
+        using reads  = ecs::TypeList<PlayerTag, ecs::WorldTransform, PlayerInput>;
+        using writes = ecs::TypeList<PlayerState, PhysicsQuery, PlatformPool, ecs::LocalTransform, RenderCulling,
+                                     TransformDirty>;
+        static void run(ecs::World& w, float dt) { PlatformBuilderSystem::Update(w, dt); }
+    };
+
+    static void install(ecs::World& world, ecs::Pipeline& pipeline,
+                        size_t pool_capacity = PlatformPool::DEFAULT_CAPACITY) {
+        world.set_resource(PlatformPool{pool_capacity});
+
+        pipeline.add<Step>();
+
+        if (auto* panel = world.try_resource<DebugPanel>()) {
+            panel->watch("Builder", "Platforms", [&world](DebugText& out) {
+                auto* pool = world.try_resource<PlatformPool>();
+                if (!pool) { out.set("-"); return; }
+                out.format("%zu / %zu placed, %zu recycled", pool->placed(), pool->size(), pool->recycled());
+            }, DebugPanel::SLOW_HZ);
+        }
+    }
+
+    // Number of platforms created (0 when the pool was already full).
+    static size_t fill_pool(ecs::World& world) { return PlatformBuilderSystem::FillPool(world); }
+
+    // After PhysicsModule::restore_snapshot: every slot is parked again.
+    static void rewind_pool(ecs::World& world) {
+        if (auto* pool = world.try_resource<PlatformPool>()) pool->rewind();
     }
 };
@@ -1,6 +1,8 @@
 #pragma once
 #include "../components.hpp"
 #include "../debug_panel.hpp"
+#include "../input_state.hpp"
+#include "../physics_handles.hpp"
 #include "../pipeline.hpp"
 #include "../systems/camera.hpp"
 #include <ecs/ecs.hpp>
@@ -14,18 +16,26 @@
 // Pipeline placement: CameraSystem MUST be the first Logic-phase step — it
 // writes view_forward / view_right to MainCamera, which CharacterInputSystem
 // reads immediately after. Install this module before any other Logic-phase
-// game module.
+// game module. Its declared write of MainCamera is what orders CharInput
+// after it when the Pipeline runs systems in parallel.
 // ---------------------------------------------------------------------------
 
 struct CameraModule {
+    struct Step {
+        static constexpr const char* name  = "Camera";
+        static constexpr int         phase = FrameProfiler::Logic;
+        using reads  = ecs::TypeList<InputRecord, PlayerTag, PlayerInput, ecs::WorldTransform, CharacterHandle>;
+        using writes = ecs::TypeList<MainCamera>;
+        static void run(ecs::World& w, float dt) { CameraSystem::Update(w, dt); }
+    };
+
     static void install(ecs::World& world, ecs::Pipeline& pipeline) {
-        pipeline.add_logic([](ecs::World& w, float dt) { CameraSystem::Update(w, dt); });
+        pipeline.add<Step>();
 
         if (auto* panel = world.try_resource<DebugPanel>()) {
-            panel->watch("Camera", "Mode", [&world]() {
+            panel->watch("Camera", "Mode", [&world](DebugText& out) {
                 auto* cam = world.try_resource<MainCamera>();
-                if (!cam) return std::string("-");
-                return cam->follow_mode ? std::string("Follow") : std::string("Manual");
+                out.set(!cam ? "-" : cam->follow_mode ? "Follow" : "Manual");
             });
         }
     }
@@ -2,13 +2,15 @@
 #include "../components.hpp"
 #include "../debug_panel.hpp"
 #include "../events.hpp"
+#include "../physics_handles.hpp"
 #include "../pipeline.hpp"
 #include "../systems/character_input.hpp"
 #include "../systems/character_motor.hpp"
 #include "../systems/character_state.hpp"
+#include "camera_module.hpp"
 #include <ecs/ecs.hpp>
-#include <cstdio>
 #include <string>
+#include <utility>
 
 // ---------------------------------------------------------------------------
 // CharacterModule
@@ -28,9 +30,38 @@
 //   AudioModule::install          → logic: Audio
 //   BuilderModule::install        → logic: Builder
 //   CharacterModule::install_motor → logic: CharMotor  (last)
+//
+// CharInput and CharState declare their access, so with a threaded Pipeline
+// they can overlap Builder. CharMotor declares none: it is exclusive, and it
+// runs after every other Logic system. The steps' `after` lists hold the
+// part of this order that can be named from here (CharInput after Camera).
 // ---------------------------------------------------------------------------
 
 struct CharacterModule {
+    struct InputStep {
+        static constexpr const char* name  = "CharInput";
+        static constexpr int         phase = FrameProfiler::Logic;
+        using reads  = ecs::TypeList<MainCamera, PlayerTag, PlayerInput>;
+        using writes = ecs::TypeList<CharacterIntent>;
+        using after  = ecs::TypeList<CameraModule::Step>;
+        static void run(ecs::World& w, float dt) { CharacterInputSystem::Update(w, dt); }
+    };
+    struct StateStep {
+        static constexpr const char* name  = "CharState";
+        static constexpr int         phase = FrameProfiler::Logic;
+        using reads  = ecs::TypeList<CharacterHandle, CharacterIntent>;
+        using writes = ecs::TypeList<CharacterState, Events<JumpEvent>, Events<LandEvent>>;
+        using after  = ecs::TypeList<InputStep>;
+        static void run(ecs::World& w, float dt) { CharacterStateSystem::Update(w, dt); }
+    };
+    // Exclusive.
+    struct MotorStep {
+        static constexpr const char* name  = "CharMotor";
+        static constexpr int         phase = FrameProfiler::Logic;
+        using after = ecs::TypeList<StateStep>;
+        static void run(ecs::World& w, float dt) { CharacterMotorSystem::Update(w, dt); }
+    };
+
     static void install(ecs::World& world, ecs::Pipeline& pipeline) {
         // Lifecycle hooks
         CharacterInputSystem::Register(world);
@@ -42,33 +73,35 @@ struct CharacterModule {
         world.resource<EventRegistry>().register_queue<LandEvent>(world);
 
         // Logic pipeline — CharInput then CharState
-        pipeline.add_logic([](ecs::World& w, float dt) { CharacterInputSystem::Update(w, dt); });
-        pipeline.add_logic([](ecs::World& w, float dt) { CharacterStateSystem::Update(w, dt); });
+        pipeline.add<InputStep>();
+        pipeline.add<StateStep>();
 
-        // Debug rows
+        // Debug rows — the player's state (every character has a CharacterState).
+        // each<> so "-" stays while there is no player; the first one shows.
         if (auto* panel = world.try_resource<DebugPanel>()) {
-            panel->watch("Character", "Mode", [&world]() {
-                std::string r = "-";
-                world.each<CharacterState>([&](ecs::Entity, CharacterState& s) {
-                    r = (s.mode == CharacterState::Mode::Grounded) ? "Grounded" : "Airborne";
+            panel->watch("Character", "Mode", [&world](DebugText& out) {
+                bool shown = false;
+                out.set("-");
+                world.each<PlayerTag, CharacterState>([&](ecs::Entity, PlayerTag&, CharacterState& s) {
+                    if (std::exchange(shown, true)) return;
+                    out.set(s.mode == CharacterState::Mode::Grounded ? "Grounded" : "Airborne");
                 });
-                return r;
             });
-            panel->watch("Character", "Jump Count", [&world]() {
-                std::string r = "-";
-                world.each<CharacterState>([&](ecs::Entity, CharacterState& s) {
-                    r = std::to_string(s.jump_count);
+            panel->watch("Character", "Jump Count", [&world](DebugText& out) {
+                bool shown = false;
+                out.set("-");
+                world.each<PlayerTag, CharacterState>([&](ecs::Entity, PlayerTag&, CharacterState& s) {
+                    if (std::exchange(shown, true)) return;
+                    out.format("%d", s.jump_count);
                 });
-                return r;
             });
-            panel->watch("Character", "Air Time", [&world]() {
-                std::string r = "-";
-                world.each<CharacterState>([&](ecs::Entity, CharacterState& s) {
-                    char b[16];
-                    std::snprintf(b, sizeof(b), "%.2f s", s.air_time);
-                    r = b;
+            panel->watch("Character", "Air Time", [&world](DebugText& out) {
+                bool shown = false;
+                out.set("-");
+                world.each<PlayerTag, CharacterState>([&](ecs::Entity, PlayerTag&, CharacterState& s) {
+                    if (std::exchange(shown, true)) return;
+                    out.format("%.2f s", s.air_time);
                 });
-                return r;
             });
         }
     }
@@ -76,6 +109,6 @@ struct CharacterModule {
     // Adds CharacterMotorSystem to the Logic phase.
     // Must be called after all other Logic-phase installs.
     static void install_motor(ecs::World& /*world*/, ecs::Pipeline& pipeline) {
-        pipeline.add_logic([](ecs::World& w, float dt) { CharacterMotorSystem::Update(w, dt); });
+        pipeline.add<MotorStep>();
     }
 };
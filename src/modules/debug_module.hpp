@@ -1,41 +1,94 @@
 #pragma once
 #include "../debug_panel.hpp"
+#include "../frame_arena.hpp"
+#include "../frame_profiler.hpp"
 #include "../pipeline.hpp"
 #include "../systems/debug.hpp"
 #include <ecs/ecs.hpp>
 #include <raylib.h>
-#include <cstdio>
 #include <string>
 
 // ---------------------------------------------------------------------------
 // DebugModule
 //
-// Creates the DebugPanel world resource, registers Engine-level debug rows
-// (FPS, Frame Time, Entity count), and adds DebugSystem to the Render phase
-// (after RenderSystem).
+// install() creates the DebugPanel and FrameProfiler world resources and
+// registers Engine-level debug rows (FPS, Frame Time, Entity count) and the
+// Profiler section (per-phase ms, slowest systems, 1% / 0.1% lows, F4 trace
+// capture). DebugSystem draws the FrameProfiler's frame graph beside the panel.
+// Rows that don't need per-frame updates refresh at DebugPanel::SLOW_HZ.
 //
-// Must be installed BEFORE any game module that wants to add its own debug
-// rows, so that the DebugPanel resource exists when those modules call
-// world.try_resource<DebugPanel>()->watch(...).
+// install_overlay() adds DebugSystem to the Render phase. It must be called
+// after RenderModule::install and before RenderModule::install_present.
+//
+// install() must run BEFORE any module that wants to add its own debug rows
+// (engine modules included), so that the DebugPanel resource exists when
+// those modules call world.try_resource<DebugPanel>()->watch(...).
 // ---------------------------------------------------------------------------
 
 struct DebugModule {
-    static void install(ecs::World& world, ecs::Pipeline& pipeline) {
+    // Exclusive.
+    struct OverlayStep {
+        static constexpr const char* name  = "Debug";
+        static constexpr int         phase = FrameProfiler::Render;
+        static void run(ecs::World& w, float dt) { DebugSystem::Update(w, dt); }
+    };
+
+    static void install(ecs::World& world, ecs::Pipeline& /*pipeline*/) {
         DebugPanel panel;
 
-        panel.watch("Engine", "FPS", []() {
-            return std::to_string(GetFPS());
+        panel.watch("Engine", "FPS", [](DebugText& out) {
+            out.format("%d", GetFPS());
         });
-        panel.watch("Engine", "Frame Time", []() {
-            char b[16];
-            std::snprintf(b, sizeof(b), "%d ms", (int)(GetFrameTime() * 1000));
-            return std::string(b);
+        panel.watch("Engine", "Frame Time", [](DebugText& out) {
+            out.format("%.2f ms", GetFrameTime() * 1000.0f);
         });
-        panel.watch("Engine", "Entities", [&world]() {
-            return std::to_string(world.count());
+        panel.watch("Engine", "Entities", [&world](DebugText& out) {
+            out.format("%zu", world.count());
+        }, DebugPanel::SLOW_HZ);
+        panel.watch("Engine", "Frame Arena", [&world](DebugText& out) {
+            const FrameArena* arena = frame_arena(world);
+            if (!arena) { out.set("-"); return; }
+            out.format("%.1f / %.0f KB (peak %.1f)", arena->last_used() / 1024.0,
+                       arena->capacity() / 1024.0, arena->peak() / 1024.0);
+        }, DebugPanel::SLOW_HZ);
+
+        // Profiler: averages over the last FrameProfiler::HISTORY frames.
+        for (int p = 0; p < FrameProfiler::PhaseCount; ++p) {
+            panel.watch("Profiler", FrameProfiler::phase_name(p), [&world, p](DebugText& out) {
+                auto* prof = world.try_resource<FrameProfiler>();
+                if (!prof) { out.set("-"); return; }
+                out.format("%.2f ms (max %.2f)", prof->phase_avg_ms(p), prof->phase_max_ms(p));
+            }, DebugPanel::SLOW_HZ);
+        }
+        for (int rank = 0; rank < 3; ++rank) {
+            panel.watch("Profiler", "Slowest #" + std::to_string(rank + 1), [&world, rank](DebugText& out) {
+                auto* prof = world.try_resource<FrameProfiler>();
+                if (!prof) { out.set("-"); return; }
+                auto top = prof->slowest(rank + 1);
+                if (static_cast<int>(top.size()) <= rank) { out.set("-"); return; }
+                const auto& s = prof->systems()[top[rank]];
+                out.format("%s %.2f ms", s.name.c_str(), prof->avg_ms(s));
+            }, DebugPanel::SLOW_HZ);
+        }
+        panel.watch("Profiler", "1% / 0.1% Low", [&world](DebugText& out) {
+            auto* prof = world.try_resource<FrameProfiler>();
+            if (!prof || !prof->long_frames()) { out.set("-"); return; }
+            out.format("%.1f / %.1f ms", prof->low_ms(0.01f), prof->low_ms(0.001f));
+        }, DebugPanel::SLOW_HZ);
+        panel.watch("Profiler", "Trace [F4]", [&world](DebugText& out) {
+            auto* prof = world.try_resource<FrameProfiler>();
+            if (!prof) out.set("-");
+            else if (prof->capturing()) out.format("capturing (%d)", prof->capture_remaining());
+            else if (!prof->last_capture_path().empty()) out.format("saved %s", prof->last_capture_path().c_str());
+            else out.set("idle");
         });
 
         world.set_resource(std::move(panel));
-        pipeline.add_render([](ecs::World& w, float dt) { DebugSystem::Update(w, dt); });
+        world.set_resource(FrameProfiler{});
+    }
+
+    // Adds the overlay draw to the Render phase (after the 3D scene).
+    static void install_overlay(ecs::World& /*world*/, ecs::Pipeline& pipeline) {
+        pipeline.add<OverlayStep>();
     }
 };
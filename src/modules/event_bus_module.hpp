@@ -1,21 +1,32 @@
 #pragma once
 #include "../events.hpp"
+#include "../frame_arena.hpp"
 #include "../pipeline.hpp"
 #include <ecs/ecs.hpp>
+#include <memory>
 
 // ---------------------------------------------------------------------------
 // EventBusModule
 //
-// Creates the EventRegistry world resource and installs the per-frame flush
-// as the first Pre-Update step. Must be the first module installed so that
-// all subsequent modules can call register_queue<T>() on a live registry.
+// Creates the EventRegistry and FrameArena world resources and installs the
+// per-frame flush as the first Pre-Update step: it flushes every event queue
+// and resets the arena. Must be the first module installed so that all
+// subsequent modules can call register_queue<T>() on a live registry.
 // ---------------------------------------------------------------------------
 
 struct EventBusModule {
+    struct FlushStep {
+        static constexpr const char* name  = "EventFlush";
+        static constexpr int         phase = FrameProfiler::PreUpdate;
+        static void run(ecs::World& w, float) {
+            w.resource<EventRegistry>().flush_all();
+            if (auto* arena = frame_arena(w)) arena->reset();
+        }
+    };
+
     static void install(ecs::World& world, ecs::Pipeline& pipeline) {
         world.set_resource(EventRegistry{});
-        pipeline.add_pre_update([](ecs::World& w, float) {
-            w.resource<EventRegistry>().flush_all();
-        });
+        world.set_resource(std::make_shared<FrameArena>());
+        pipeline.add<FlushStep>();
     }
 };
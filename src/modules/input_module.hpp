@@ -1,20 +1,114 @@
 #pragma once
+#include "../components.hpp"
+#include "../debug_panel.hpp"
+#include "../input_events.hpp"
+#include "../input_replay.hpp"
+#include "../input_state.hpp"
 #include "../pipeline.hpp"
 #include "../systems/input_gather.hpp"
 #include "../systems/player_input.hpp"
 #include <ecs/ecs.hpp>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <utility>
 
 // ---------------------------------------------------------------------------
 // InputModule
 //
 // Adds InputGatherSystem and PlayerInputSystem to the Pre-Update phase.
 // InputGather must precede PlayerInput (it writes the InputRecord that
-// PlayerInput reads). Both run after the EventBus flush.
+// PlayerInput reads). Both run after the EventBus flush. InputGather polls
+// Raylib, so it is pinned to the main thread.
+//
+// install_recorder() adds an "InputRecorder" step after InputGather. Each
+// frame it appends the InputRecord, the frame dt and the world checksum to
+// an InputReplay file (input_replay.hpp). bench --replay plays the file back
+// headlessly.
+//
+// install_event_backend() switches keyboard and mouse buttons from polling
+// to GLFW callbacks (input_events.hpp), which gives each press a timestamp
+// and keeps sub-frame order. Call after InitWindow. Call shutdown() to
+// flush a recording and detach the callbacks.
 // ---------------------------------------------------------------------------
 
 struct InputModule {
+    struct GatherStep {
+        static constexpr const char* name        = "InputGather";
+        static constexpr int         phase       = FrameProfiler::PreUpdate;
+        static constexpr bool        main_thread = true;
+        using writes = ecs::TypeList<InputRecord>;
+        static void run(ecs::World& w, float) { InputGatherSystem::Update(w); }
+    };
+    struct PlayerStep {
+        static constexpr const char* name  = "PlayerInput";
+        static constexpr int         phase = FrameProfiler::PreUpdate;
+        using reads  = ecs::TypeList<InputRecord>;
+        using writes = ecs::TypeList<PlayerInput>;
+        using after  = ecs::TypeList<GatherStep>;
+        static void run(ecs::World& w, float) { PlayerInputSystem::Update(w); }
+    };
+
     static void install(ecs::World& /*world*/, ecs::Pipeline& pipeline) {
-        pipeline.add_pre_update([](ecs::World& w, float) { InputGatherSystem::Update(w); });
-        pipeline.add_pre_update([](ecs::World& w, float) { PlayerInputSystem::Update(w); });
+        pipeline.add<GatherStep>();
+        pipeline.add<PlayerStep>();
+    }
+
+    // False (nothing installed) if `path` can't be created.
+    static bool install_recorder(ecs::World& world, ecs::Pipeline& pipeline, const std::string& path) {
+        auto recorder = std::make_shared<InputReplay::Recorder>();
+        if (!recorder->open(path)) {
+            std::cerr << "InputModule: cannot record to '" << path << "'." << std::endl;
+            return false;
+        }
+        world.set_resource(recorder);
+        pipeline.add_pre_update("InputRecorder",
+            ecs::Access{}.read<InputRecord, TransformHistory, PlayerTag, ecs::LocalTransform>(),
+            [recorder](ecs::World& w, float dt) {
+                auto* input = w.try_resource<InputRecord>();
+                if (!input) return;
+                InputReplay::Frame frame;
+                frame.input    = *input;
+                frame.dt       = dt;
+                frame.checksum = InputReplay::checksum(w);
+                recorder->write(frame);
+            });
+        return true;
+    }
+
+    // False (polling stays) if there is no GLFW window.
+    static bool install_event_backend(ecs::World& world) {
+        auto queue = std::make_shared<InputEventQueue>();
+        if (!GlfwInputEvents::install(queue)) {
+            std::cerr << "InputModule: no GLFW window; keeping the polling backend." << std::endl;
+            return false;
+        }
+        world.set_resource(queue);
+        if (auto* panel = world.try_resource<DebugPanel>()) {
+            panel->watch("Input", "Events", [&world](DebugText& out) {
+                auto* q = world.try_resource<std::shared_ptr<InputEventQueue>>();
+                auto* r = world.try_resource<InputRecord>();
+                if (!q || !*q || !r) { out.set("-"); return; }
+                out.format("%zu this frame, %zu dropped", r->event_count, (*q)->dropped());
+            });
+            panel->watch("Input", "Jump age", [&world, last_ms = 0.0f](DebugText& out) mutable {
+                bool seen = false; // each<>: no player while a scene streams in
+                world.each<PlayerInput>([&](ecs::Entity, PlayerInput& pi) {
+                    if (std::exchange(seen, true)) return;
+                    if (pi.jump) last_ms = pi.jump_age * 1000.0f;
+                });
+                out.format("%.2f ms", last_ms);
+            });
+        }
+        return true;
+    }
+
+    static void shutdown(ecs::World& world) {
+        GlfwInputEvents::uninstall();
+        auto* recorder = world.try_resource<std::shared_ptr<InputReplay::Recorder>>();
+        if (!recorder || !*recorder) return;
+        (*recorder)->close();
+        std::cout << "InputModule: recorded " << (*recorder)->frames() << " frames ("
+                  << (*recorder)->bytes() / 1024 << " KB)." << std::endl;
     }
 };
@@ -0,0 +1,117 @@
+#pragma once
+#include "../components.hpp"
+#include "../debug_panel.hpp"
+#include "../fixed_time.hpp"
+#include "../net_session.hpp"
+#include "../pipeline.hpp"
+#include "../systems/net.hpp"
+#include "physics_module.hpp"
+#include <ecs/ecs.hpp>
+#include <ecs/modules/transform.hpp>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <string>
+
+// ---------------------------------------------------------------------------
+// NetModule
+//
+// Snapshot replication to spectating clients over UDP (RFC-0057).
+//
+// install_server() opens `port` and adds NetServerSystem to the Physics
+// phase. Install it right after PhysicsModule, so it follows "Physics" and
+// sends the poses that step produced. With PhysicsConfig::async_step the
+// step's results land at the next join_step(), so each snapshot is a frame
+// behind.
+//
+// install_client() resolves the server and adds NetClientSystem to
+// Pre-Update. A client is a spectator: main.cpp leaves out the character
+// motor and the builder and skips step_fixed, so nothing but the snapshots
+// moves a replicated entity. Both sides must load the same scene.
+//
+// Each returns false, logging why, if its socket can't be set up; the
+// program then runs as if it had not been asked. Adds a "Net" debug
+// section when a DebugPanel exists.
+// ---------------------------------------------------------------------------
+
+struct NetModule {
+    static constexpr uint16_t DEFAULT_PORT = 27960;
+
+    struct SendStep {
+        static constexpr const char* name  = "NetSend";
+        static constexpr int         phase = FrameProfiler::Physics;
+        using reads  = ecs::TypeList<ecs::WorldTransform, TransformHistory, CharacterControllerConfig, FixedTime>;
+        using writes = ecs::TypeList<std::shared_ptr<NetServerSession>>;
+        using after  = ecs::TypeList<PhysicsModule::Step>;
+        static void run(ecs::World& w, float dt) { NetServerSystem::Update(w, dt); }
+    };
+    struct ReceiveStep {
+        static constexpr const char* name  = "NetReceive";
+        static constexpr int         phase = FrameProfiler::PreUpdate;
+        using reads  = ecs::TypeList<FixedTime, CharacterControllerConfig>;
+        using writes = ecs::TypeList<std::shared_ptr<NetClientSession>, ecs::LocalTransform, ecs::WorldTransform,
+                                     TransformHistory>;
+        static void run(ecs::World& w, float dt) { NetClientSystem::Update(w, dt); }
+    };
+
+    static bool install_server(ecs::World& world, ecs::Pipeline& pipeline, uint16_t port = DEFAULT_PORT) {
+        auto session = std::make_shared<NetServerSession>();
+        if (!session->socket.open(port)) {
+            std::cerr << "NetModule: could not listen on UDP port " << port << "\n";
+            return false;
+        }
+        world.set_resource(session);
+
+        pipeline.add<SendStep>();
+
+        if (auto* panel = world.try_resource<DebugPanel>()) {
+            panel->watch("Net", "Server", [&world](DebugText& out) {
+                auto* s = world.try_resource<std::shared_ptr<NetServerSession>>();
+                if (!s || !*s) { out.set("-"); return; }
+                const NetReplication::Server& server = (*s)->server;
+                out.format("%zu clients, %zu entities, tick %u", server.peers(), (*s)->replicated, (*s)->tick);
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Net", "Sent", [&world](DebugText& out) {
+                auto* s = world.try_resource<std::shared_ptr<NetServerSession>>();
+                if (!s || !*s) { out.set("-"); return; }
+                const NetReplication::Server& server = (*s)->server;
+                out.format("%zu B, %zu moving / tick (%zu full, %zu oversize)", server.last_bytes(),
+                           server.last_entries(), server.full_snapshots(), server.oversize());
+            }, DebugPanel::SLOW_HZ);
+        }
+        return true;
+    }
+
+    static bool install_client(ecs::World& world, ecs::Pipeline& pipeline, const std::string& host,
+                               uint16_t port = DEFAULT_PORT) {
+        auto session = std::make_shared<NetClientSession>();
+        if (!UdpSocket::resolve(host, port, session->server)) {
+            std::cerr << "NetModule: could not resolve " << host << "\n";
+            return false;
+        }
+        if (!session->socket.open()) {
+            std::cerr << "NetModule: could not open a UDP socket\n";
+            return false;
+        }
+        world.set_resource(session);
+
+        pipeline.add<ReceiveStep>();
+
+        if (auto* panel = world.try_resource<DebugPanel>()) {
+            panel->watch("Net", "Client", [&world](DebugText& out) {
+                auto* s = world.try_resource<std::shared_ptr<NetClientSession>>();
+                if (!s || !*s) { out.set("-"); return; }
+                const NetReplication::Client& client = (*s)->client;
+                out.format("tick %u (playing %.1f), %zu dropped", client.newest(), client.playback(),
+                           client.dropped());
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Net", "Received", [&world](DebugText& out) {
+                auto* s = world.try_resource<std::shared_ptr<NetClientSession>>();
+                if (!s || !*s) { out.set("-"); return; }
+                out.format("%.1f KB, %zu applied, %zu unmapped", (*s)->client.bytes_in() / 1024.0, (*s)->applied,
+                           (*s)->unmapped);
+            }, DebugPanel::SLOW_HZ);
+        }
+        return true;
+    }
+};
@@ -1,28 +1,244 @@
 #pragma once
+#include "../debug_panel.hpp"
+#include "../events.hpp"
+#include "../fixed_time.hpp"
+#include "../physics_config.hpp"
 #include "../physics_context.hpp"
+#include "../physics_query.hpp"
+#include "../physics_snapshot.hpp"
 #include "../pipeline.hpp"
+#include "../systems/kinematic_driver.hpp"
 #include "../systems/physics.hpp"
+#include "../systems/physics_query.hpp"
+#include "../transform_dirty.hpp"
 #include <ecs/ecs.hpp>
-#include <ecs/modules/transform_propagation.hpp>
 #include <memory>
+#include <string>
 
 // ---------------------------------------------------------------------------
 // PhysicsModule
 //
 // Initialises Jolt's allocator, creates and registers the PhysicsContext
-// world resource, installs PhysicsSystem lifecycle hooks (on_add/on_remove
-// for RigidBodyConfig), and wires the fixed-step physics update +
-// transform propagation into the Physics pipeline phase.
+// world resource (sized by the given PhysicsConfig), installs PhysicsSystem lifecycle hooks (on_add/on_remove
+// for RigidBodyConfig), and wires the fixed-step physics update into the
+// Physics pipeline phase. The FixedTime resource (step rate, catch-up cap,
+// substep folding) is seeded from the config; drive it with
+// Pipeline::step_fixed.
+//
+// Kinematic bodies follow their LocalTransform: a "KinematicDriver" system
+// runs just before "Physics" in every fixed step (kinematic_driver.hpp).
+//
+// Transform propagation is not part of the step. The TransformDirty resource
+// collects entities whose LocalTransform changed outside the simulation (an
+// on_add<WorldTransform> hook marks every new one), and a "TransformPropagate"
+// system refreshes them once per rendered frame. Install this module before
+// RenderModule so it is the first Render system (transform_dirty.hpp).
+//
+// commit_bodies() should be called after a bulk load (SceneLoader::load) to
+// insert the new bodies as one batch and rebuild the broadphase tree. If it
+// is skipped, the next physics step commits them without the rebuild. It also
+// prunes ShapeCache entries no body references any more.
+//
+// With an EventRegistry (install EventBusModule first), it registers the
+// buffered ContactEvent and TriggerEvent queues. PhysicsSystem fills them
+// after each step, and Logic reads them the following frame.
+//
+// save_snapshot() / restore_snapshot() capture the simulation into the
+// PhysicsSnapshot resource and put it back in place (physics_snapshot.hpp).
+// restore_snapshot() returns false if there is no snapshot or the body set
+// has changed since the capture; reload the scene then.
+//
+// With PhysicsConfig::async_step the "Physics" system only queues the
+// frame's steps. kick_step() starts them on a dedicated thread after
+// step_fixed, and join_step() waits and writes the results back; call it at
+// the top of the next frame, before anything else touches the World or
+// Jolt (resets, Pre-Update, snapshots, shutdown). The step then overlaps
+// Render and Present, and what's drawn is one frame behind (RFC-0046).
+//
+// It also creates the PhysicsQuery resource. install_queries() adds its
+// executor (PhysicsQuerySystem) to Logic; call it after every Logic system
+// that submits queries and right before CharacterModule::install_motor.
+//
+// Adds a "Physics" debug section (body counts, temp allocator high-water
+// mark, shape cache stats, snapshot size, queries per frame, transforms
+// propagated) if DebugPanel exists.
 // ---------------------------------------------------------------------------
 
 struct PhysicsModule {
-    static void install(ecs::World& world, ecs::Pipeline& pipeline) {
+    // All exclusive: they call into Jolt and write transforms wholesale.
+    struct KinematicStep {
+        static constexpr const char* name  = "KinematicDriver";
+        static constexpr int         phase = FrameProfiler::Physics;
+        static void run(ecs::World& w, float dt) { KinematicDriverSystem::Update(w, dt); }
+    };
+    struct Step {
+        static constexpr const char* name  = "Physics";
+        static constexpr int         phase = FrameProfiler::Physics;
+        using after = ecs::TypeList<KinematicStep>;
+        static void run(ecs::World& w, float dt) { PhysicsSystem::Update(w, dt); }
+    };
+    struct PropagateStep {
+        static constexpr const char* name  = "TransformPropagate";
+        static constexpr int         phase = FrameProfiler::Render;
+        using after = ecs::TypeList<Step>;
+        static void run(ecs::World& w, float) { propagate_dirty(w); }
+    };
+    struct QueryStep {
+        static constexpr const char* name  = "PhysicsQuery";
+        static constexpr int         phase = FrameProfiler::Logic;
+        static void run(ecs::World& w, float) { PhysicsQuerySystem::Update(w); }
+    };
+
+    static void install(ecs::World& world, ecs::Pipeline& pipeline,
+                        const PhysicsConfig& config = {}) {
         PhysicsContext::InitJoltAllocator();
-        world.set_resource(std::make_shared<PhysicsContext>());
+        world.set_resource(std::make_shared<PhysicsContext>(config));
+        world.set_resource(PhysicsQuery{});
+        world.set_resource(std::make_shared<PhysicsSnapshot>());
+
+        FixedTime fixed;
+        fixed.fixed_dt      = 1.0f / config.fixed_hz;
+        fixed.max_steps     = config.max_steps_per_frame;
+        fixed.fold_substeps = config.fold_substeps;
+        world.set_resource(fixed);
+        world.set_resource(TransformDirty{});
+
+        if (auto* events = world.try_resource<EventRegistry>()) {
+            events->register_queue<ContactEvent>(world, 4096, EventMode::Buffered);
+            events->register_queue<TriggerEvent>(world, 512, EventMode::Buffered);
+        }
+
         PhysicsSystem::Register(world);
-        pipeline.add_physics([](ecs::World& w, float dt) {
-            PhysicsSystem::Update(w, dt);
-            ecs::propagate_transforms(w);
+        world.on_add<ecs::WorldTransform>([](ecs::World& w, ecs::Entity e, ecs::WorldTransform&) {
+            if (auto* dirty = w.try_resource<TransformDirty>()) dirty->mark(e);
         });
+        pipeline.add<KinematicStep>();
+        pipeline.add<Step>();
+        pipeline.add<PropagateStep>();
+
+        if (auto* panel = world.try_resource<DebugPanel>()) {
+            panel->watch("Physics", "Bodies", [&world](DebugText& out) {
+                auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+                if (!ctx_ptr || !*ctx_ptr) { out.set("-"); return; }
+                const auto& ctx = **ctx_ptr;
+                out.format("%u / %u (%u active)", ctx.stats.bodies, ctx.config.max_bodies,
+                           ctx.stats.active_bodies);
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Physics", "Asleep", [&world](DebugText& out) {
+                auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+                if (!ctx_ptr || !*ctx_ptr) { out.set("-"); return; }
+                const PhysicsStats& st = (*ctx_ptr)->stats;
+                out.format("%u of %u dynamic (+%u last step)", st.dynamic_asleep, st.dynamic_bodies,
+                           st.fell_asleep);
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Physics", "Islands", [&world](DebugText& out) {
+                auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+                if (!ctx_ptr || !*ctx_ptr) { out.set("-"); return; }
+                const PhysicsStats& st = (*ctx_ptr)->stats;
+                out.format("%u (largest %u)", st.islands, st.largest_island);
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Physics", "Body Pairs", [&world](DebugText& out) {
+                auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+                if (!ctx_ptr || !*ctx_ptr) { out.set("-"); return; }
+                const auto& ctx = **ctx_ptr;
+                out.format("%u / %u (%u sensor)", ctx.stats.contact_pairs + ctx.stats.sensor_pairs,
+                           ctx.config.max_body_pairs, ctx.stats.sensor_pairs);
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Physics", "Auto CCD", [&world](DebugText& out) {
+                auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+                if (!ctx_ptr || !*ctx_ptr) { out.set("-"); return; }
+                const PhysicsStats& st = (*ctx_ptr)->stats;
+                out.format("%u of %u linear-cast", st.auto_ccd_cast, st.auto_ccd);
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Physics", "Failed Creates", [&world](DebugText& out) {
+                auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+                if (!ctx_ptr || !*ctx_ptr) { out.set("-"); return; }
+                out.format("%u", (*ctx_ptr)->failed_body_creates);
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Physics", "Temp Peak", [&world](DebugText& out) {
+                auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+                if (!ctx_ptr || !*ctx_ptr) { out.set("-"); return; }
+                const auto& ta = *(*ctx_ptr)->temp_allocator;
+                out.format("%.2f / %.1f MB", ta.peak() / (1024.0 * 1024.0), ta.capacity() / (1024.0 * 1024.0));
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Physics", "Steps/Frame", [&world](DebugText& out) {
+                auto* ft = world.try_resource<FixedTime>();
+                if (!ft) { out.set("-"); return; }
+                out.format("%d (alpha %.2f)", ft->steps_this_frame, ft->alpha);
+            });
+            panel->watch("Physics", "Dropped", [&world](DebugText& out) {
+                auto* ft = world.try_resource<FixedTime>();
+                if (!ft) { out.set("-"); return; }
+                out.format("%.2f s", ft->dropped_seconds);
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Physics", "Contacts", [&world](DebugText& out) {
+                auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+                if (!ctx_ptr || !*ctx_ptr) { out.set("-"); return; }
+                const size_t pairs = (*ctx_ptr)->contact_tracker.open_pairs();
+                auto* ev = world.try_resource<Events<ContactEvent>>();
+                if (ev && ev->dropped()) out.format("%zu pairs, %zu dropped", pairs, ev->dropped());
+                else                     out.format("%zu pairs", pairs);
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Physics", "Snapshot", [&world](DebugText& out) {
+                auto* snap = world.try_resource<std::shared_ptr<PhysicsSnapshot>>();
+                if (!snap || !*snap || !(*snap)->valid()) { out.set("-"); return; }
+                out.format("%zu bodies, %.1f KB", (*snap)->bodies(), (*snap)->bytes() / 1024.0);
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Physics", "Queries", [&world](DebugText& out) {
+                auto* q = world.try_resource<PhysicsQuery>();
+                if (q) out.format("%zu / frame", q->executed()); else out.set("-");
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Physics", "Shapes", [&world](DebugText& out) {
+                auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+                if (!ctx_ptr || !*ctx_ptr) { out.set("-"); return; }
+                out.format("%zu cached", (*ctx_ptr)->shapes.size());
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Physics", "Propagate", [&world](DebugText& out) {
+                auto* dirty = world.try_resource<TransformDirty>();
+                if (!dirty) { out.set("-"); return; }
+                out.format("%zu%s", dirty->last_composed(), dirty->last_full() ? " (full)" : "");
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Physics", "Shape Hit/Miss", [&world](DebugText& out) {
+                auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+                if (!ctx_ptr || !*ctx_ptr) { out.set("-"); return; }
+                const auto& cache = (*ctx_ptr)->shapes;
+                out.format("%llu / %llu",
+                           static_cast<unsigned long long>(cache.hits()),
+                           static_cast<unsigned long long>(cache.misses()));
+            }, DebugPanel::SLOW_HZ);
+        }
+    }
+
+    // Adds the PhysicsQuery executor to the Logic phase. Exclusive (no
+    // Access): it runs alone, so its queries skip Jolt's body locks.
+    static void install_queries(ecs::World& /*world*/, ecs::Pipeline& pipeline) {
+        pipeline.add<QueryStep>();
+    }
+
+    // Async step (no-ops otherwise): start the queued steps / finish them.
+    static void kick_step(ecs::World& world) { PhysicsSystem::KickQueued(world); }
+    static void join_step(ecs::World& world) { PhysicsSystem::JoinQueued(world); }
+
+    static bool save_snapshot(ecs::World& world) {
+        auto* snap = world.try_resource<std::shared_ptr<PhysicsSnapshot>>();
+        return snap && *snap && (*snap)->capture(world);
+    }
+
+    static bool restore_snapshot(ecs::World& world) {
+        auto* snap = world.try_resource<std::shared_ptr<PhysicsSnapshot>>();
+        if (!snap || !*snap || !(*snap)->restore(world)) return false;
+        if (auto* dirty = world.try_resource<TransformDirty>()) dirty->mark_all();
+        return true;
+    }
+
+    static void clear_snapshot(ecs::World& world) {
+        auto* snap = world.try_resource<std::shared_ptr<PhysicsSnapshot>>();
+        if (snap && *snap) (*snap)->clear();
+    }
+
+    static void commit_bodies(ecs::World& world) {
+        PhysicsSystem::CommitPendingBodies(world, true);
+        auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+        if (ctx_ptr && *ctx_ptr) (*ctx_ptr)->shapes.prune();
     }
 };
@@ -1,29 +1,220 @@
 #pragma once
 #include "../assets.hpp"
 #include "../components.hpp"
+#include "../culling.hpp"
+#include "../debug_panel.hpp"
+#include "../frame_profiler.hpp"
+#include "../gpu_timer.hpp"
 #include "../pipeline.hpp"
+#include "../render_lod.hpp"
+#include "../render_snapshot.hpp"
+#include "../systems/debug.hpp"
 #include "../systems/renderer.hpp"
+#include "asset_module.hpp"
 #include <ecs/ecs.hpp>
+#include <raylib.h>
+#include <algorithm>
+#include <iostream>
+#include <memory>
+#include <string>
 
 // ---------------------------------------------------------------------------
 // RenderModule
 //
-// Loads the AssetResource (shaders), creates the MainCamera world resource,
-// and adds RenderSystem to the Render phase.
+// Loads the AssetResource (shaders through the AssetManager, so AssetModule
+// must be installed first; meshes per LOD level), creates the
+// MainCamera, RenderCulling, RenderLod and RenderSnapshotBuffer world
+// resources, and adds RenderSystem to the Render phase. Adds "Render" debug
+// rows (visible/culled counts, instances per LOD level, draw calls,
+// instances and vertices, uniform uploads, snapshot age) when a DebugPanel
+// exists. install_gpu_timer() opts in to GPU timestamps (RFC-0049).
 //
-// shutdown() must be called before CloseWindow() to unload GPU resources.
+// install_present() adds the EndDrawing step. It must be called after every
+// other Render-phase install (e.g. DebugModule) so overlays land in the
+// current frame.
+//
+// With `pipelined`, the Render phase only captures a RenderSnapshot
+// ("RenderCapture"), and draws nothing: skip install_present() and
+// DebugModule::install_overlay(). main.cpp then runs the simulation of frame
+// N on a SimThread while the main thread draws frame N - 1:
+//
+//   sim.wait();                                   // the World is free again
+//   pipeline.pre_update(world, dt);               // input: main thread
+//   auto frame = RenderModule::begin_frame(world);
+//   sim.run([&] { pipeline.logic(world, dt); pipeline.step_fixed(world, dt);
+//                 pipeline.render(world); });     // ends with the capture
+//   RenderModule::draw_frame(frame);              // GL: main thread
+//
+// begin_frame() must run while the simulation is idle: it refreshes the
+// debug panel and picks up the newest snapshot. draw_frame() touches only
+// what begin_frame() returned. The frame graph beside the debug panel is
+// left out in this mode, since the profiler is written by the running
+// simulation (RFC-0045).
+//
+// shutdown() must be called before AssetModule::shutdown() and CloseWindow()
+// to unload GPU resources.
 // ---------------------------------------------------------------------------
 
 struct RenderModule {
-    static void install(ecs::World& world, ecs::Pipeline& pipeline) {
+    // All exclusive: Raylib draws, and the capture reads everything.
+    struct DrawStep {
+        static constexpr const char* name  = "Render";
+        static constexpr int         phase = FrameProfiler::Render;
+        static void run(ecs::World& w, float) { RenderSystem::Update(w); }
+    };
+    struct CaptureStep {
+        static constexpr const char* name  = "RenderCapture";
+        static constexpr int         phase = FrameProfiler::Render;
+        static void run(ecs::World& w, float) {
+            auto& buffer = *w.resource<std::shared_ptr<RenderSnapshotBuffer>>();
+            RenderSystem::Capture(w, buffer.write(), buffer.aspect);
+            buffer.publish();
+        }
+    };
+    struct PresentStep {
+        static constexpr const char* name  = "Present";
+        static constexpr int         phase = FrameProfiler::Render;
+        static void run(ecs::World& w, float) { RenderSystem::Present(w); }
+    };
+
+    static void install(ecs::World& world, ecs::Pipeline& pipeline, bool pipelined = false) {
+        AssetManager& manager = AssetModule::manager(world);
         AssetResource assets;
-        assets.load();
+        assets.load(manager);
         world.set_resource(assets);
+        // Bound on their first upload and again on every hot reload. A frame
+        // can't be drawn without them, so this is where startup waits.
+        const AssetResource& loaded = world.resource<AssetResource>();
+        for (const AssetManager::Handle* h : {&loaded.lighting_handle, &loaded.instanced_handle}) {
+            manager.on_upload(*h, [&world] {
+                world.resource<AssetResource>().bind_shaders(AssetModule::manager(world));
+            });
+        }
+        manager.wait(loaded.lighting_handle);
+        manager.wait(loaded.instanced_handle);
         world.set_resource(MainCamera{});
-        pipeline.add_render([](ecs::World& w, float) { RenderSystem::Update(w); });
+        world.set_resource(RenderCulling{});
+        world.set_resource(RenderLod{});
+        world.set_resource(std::make_shared<RenderSnapshotBuffer>());
+        RenderSystem::Register(world);
+        if (pipelined) pipeline.add<CaptureStep>();
+        else           pipeline.add<DrawStep>();
+
+        if (auto* panel = world.try_resource<DebugPanel>()) {
+            panel->watch("Render", "Visible", [&world](DebugText& out) {
+                auto* c = world.try_resource<RenderCulling>();
+                if (c) out.format("%u", c->visible); else out.set("-");
+            });
+            panel->watch("Render", "Culled", [&world](DebugText& out) {
+                auto* c = world.try_resource<RenderCulling>();
+                if (c) out.format("%u", c->culled); else out.set("-");
+            });
+            panel->watch("Render", "Static Grid", [&world](DebugText& out) {
+                auto* c = world.try_resource<RenderCulling>();
+                if (c) out.format("%zu in %zu cells", c->statics.size(), c->statics.cell_count());
+                else   out.set("-");
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Render", "LOD 0/1/2", [&world](DebugText& out) {
+                auto* l = world.try_resource<RenderLod>();
+                if (l) out.format("%u / %u / %u", l->counts[0], l->counts[1], l->counts[2]);
+                else   out.set("-");
+            });
+            panel->watch("Render", "Draw Calls", [&world](DebugText& out) {
+                auto* a = world.try_resource<AssetResource>();
+                if (a) out.format("%u (%u shader switches)", a->stats.draw_calls, a->stats.shader_changes);
+                else   out.set("-");
+            });
+            panel->watch("Render", "Instances", [&world](DebugText& out) {
+                auto* a = world.try_resource<AssetResource>();
+                if (a) out.format("%u (%llu vertices)", a->stats.instances,
+                                  static_cast<unsigned long long>(a->stats.vertices));
+                else   out.set("-");
+            });
+            panel->watch("Render", "Uniforms", [&world](DebugText& out) {
+                auto* a = world.try_resource<AssetResource>();
+                if (a) out.format("%u set / %u skipped", a->stats.uniform_uploads, a->stats.uniform_skipped);
+                else   out.set("-");
+            });
+            if (pipelined) {
+                panel->watch("Render", "Snapshot", [&world](DebugText& out) {
+                    auto* b = world.try_resource<std::shared_ptr<RenderSnapshotBuffer>>();
+                    if (b && *b) out.format("frame %llu", static_cast<unsigned long long>((*b)->published()));
+                    else         out.set("-");
+                }, DebugPanel::SLOW_HZ);
+            }
+        }
+    }
+
+    // Creates the GpuTimer resource (demo --gpu-timer) and adds its
+    // "Profiler" rows: GPU time of the scene pass and the overlay beside the
+    // CPU time of the systems that issue them. False, with a warning and
+    // nothing added, if the GL context has no timestamp queries. Call after install() and
+    // DebugModule::install.
+    static bool install_gpu_timer(ecs::World& world) {
+        GpuTimer timer;
+        if (!timer.init(GlGpuTimer::backend())) {
+            std::cerr << "RenderModule: no GL timestamp queries; GPU timing off." << std::endl;
+            return false;
+        }
+        world.set_resource(timer);
+
+        if (auto* panel = world.try_resource<DebugPanel>()) {
+            const struct { GpuTimer::Scope scope; const char* label; const char* system; } rows[] = {
+                {GpuTimer::Scene,   "GPU Scene",   "Render"},
+                {GpuTimer::Overlay, "GPU Overlay", "Debug"},
+            };
+            for (const auto& r : rows) {
+                panel->watch("Profiler", r.label, [&world, r](DebugText& out) {
+                    auto* gpu = world.try_resource<GpuTimer>();
+                    if (!gpu || !gpu->frames()) { out.set("-"); return; }
+                    auto* prof = world.try_resource<FrameProfiler>();
+                    const int slot = prof ? prof->find(r.system, FrameProfiler::Render) : -1;
+                    if (slot >= 0) out.format("%.2f ms (CPU %.2f)", gpu->avg_ms(r.scope), prof->avg_ms(prof->systems()[slot]));
+                    else           out.format("%.2f ms (max %.2f)", gpu->avg_ms(r.scope), gpu->max_ms(r.scope));
+                }, DebugPanel::SLOW_HZ);
+            }
+        }
+        return true;
+    }
+
+    // What draw_frame() needs, gathered while the simulation is idle.
+    struct Frame {
+        const RenderSnapshot* snapshot = nullptr;
+        AssetResource*        assets   = nullptr;
+        const DebugPanel*     panel    = nullptr;
+        GpuTimer*             gpu      = nullptr;
+    };
+
+    static Frame begin_frame(ecs::World& world) {
+        Frame frame;
+        auto* buffer = world.try_resource<std::shared_ptr<RenderSnapshotBuffer>>();
+        frame.assets = world.try_resource<AssetResource>();
+        if (!buffer || !*buffer || !frame.assets) return frame;
+        (*buffer)->aspect = static_cast<float>(GetScreenWidth()) / static_cast<float>(std::max(1, GetScreenHeight()));
+        frame.snapshot = &(*buffer)->read();
+        DebugSystem::Refresh(world, GetFrameTime());
+        frame.panel = world.try_resource<DebugPanel>();
+        frame.gpu   = world.try_resource<GpuTimer>();
+        return frame;
+    }
+
+    // Draws the scene and the debug panel, then presents (EndDrawing).
+    static void draw_frame(const Frame& frame) {
+        if (!frame.snapshot) return;
+        RenderSystem::Draw(*frame.snapshot, *frame.assets, frame.gpu);
+        if (frame.panel) DebugSystem::Draw(*frame.panel, nullptr, frame.gpu);
+        EndDrawing();
+        if (frame.gpu) frame.gpu->end_frame();
+    }
+
+    // Adds the frame present (EndDrawing) to the Render phase.
+    // Must be called after all other Render-phase installs.
+    static void install_present(ecs::World& /*world*/, ecs::Pipeline& pipeline) {
+        pipeline.add<PresentStep>();
     }
 
     static void shutdown(ecs::World& world) {
-        world.resource<AssetResource>().unload();
+        if (auto* gpu = world.try_resource<GpuTimer>()) gpu->shutdown();
+        world.resource<AssetResource>().unload(AssetModule::manager(world));
     }
 };
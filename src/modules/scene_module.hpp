@@ -0,0 +1,128 @@
+#pragma once
+#include "../debug_panel.hpp"
+#include "../deferred_commands.hpp"
+#include "../physics_context.hpp"
+#include "../physics_handles.hpp"
+#include "../pipeline.hpp"
+#include "../scene.hpp"
+#include "../scene_async.hpp"
+#include "../scene_chunks.hpp"
+#include "../components.hpp"
+#include <ecs/modules/transform.hpp>
+#include "physics_module.hpp"
+#include <ecs/ecs.hpp>
+#include <memory>
+#include <optional>
+#include <string>
+
+// ---------------------------------------------------------------------------
+// SceneModule
+//
+// install() creates the AsyncSceneLoader world resource and adds a
+// Pre-Update "SceneStream" system that commits up to `entities_per_frame`
+// staged entities each frame (they land at the Logic deferred flush). Once
+// the last batch has been flushed it runs PhysicsModule::commit_bodies, so a
+// streamed load ends with the same broadphase rebuild as a synchronous one.
+//
+// load_async() starts a background load of a JSON scene. Its worker also
+// builds each entity's collision shape into the PhysicsContext ShapeCache,
+// so the on_add hooks on the main thread only look shapes up.
+// reset_async() is the streamed equivalent of unload + load: it cancels a
+// load in flight and lands its queued entities first, so unload sees them.
+// The player is kept through it and re-posed when the scene's player entity
+// streams in, so the systems that expect exactly one player (Camera,
+// PlayerInput, the renderer) keep finding it while the rest loads.
+//
+// It also adds a Pre-Update "SceneChunks" system that, when a chunked scene
+// is loaded (SceneChunks::load), streams cells around the PlayerTag's
+// WorldTransform. Its spawns and destroys join the next batch body commit.
+//
+// Must be installed after PhysicsModule. Adds a "Scene" debug section
+// (load state and progress, chunk counts) if DebugPanel exists.
+// ---------------------------------------------------------------------------
+
+struct SceneModule {
+    static void install(ecs::World& world, ecs::Pipeline& pipeline, size_t entities_per_frame = 256) {
+        world.set_resource(std::make_shared<AsyncSceneLoader>());
+
+        pipeline.add_pre_update("SceneStream", [entities_per_frame](ecs::World& w, float) {
+            auto* loader = w.try_resource<std::shared_ptr<AsyncSceneLoader>>();
+            if (!loader || !*loader) return;
+            if ((*loader)->pump(w, entities_per_frame)) PhysicsModule::commit_bodies(w);
+        });
+
+        pipeline.add_pre_update("SceneChunks", [](ecs::World& w, float) {
+            auto* chunks = w.try_resource<SceneChunks>();
+            if (!chunks) return;
+            // each<>, not single<>: a chunked scene may have no player, and
+            // none while a streamed load brings it in. The first one leads.
+            bool  found = false;
+            float x = 0.0f, z = 0.0f;
+            w.each<PlayerTag, ecs::WorldTransform>([&](ecs::Entity, PlayerTag&, ecs::WorldTransform& wt) {
+                if (found) return;
+                x = wt.matrix.m[12];
+                z = wt.matrix.m[14];
+                found = true;
+            });
+            if (found) chunks->update(w, x, z);
+        });
+
+        if (auto* panel = world.try_resource<DebugPanel>()) {
+            panel->watch("Scene", "Chunks", [&world](DebugText& out) {
+                auto* chunks = world.try_resource<SceneChunks>();
+                if (!chunks) { out.set("-"); return; }
+                out.format("%zu / %zu cells, %zu / %zu live",
+                           chunks->loaded_cells(), chunks->cell_count(), chunks->live(), chunks->streamed());
+            }, DebugPanel::SLOW_HZ);
+            panel->watch("Scene", "Loading", [&world](DebugText& out) {
+                auto* loader = world.try_resource<std::shared_ptr<AsyncSceneLoader>>();
+                if (!loader || !*loader) { out.set("-"); return; }
+                const auto& l = **loader;
+                switch (l.state()) {
+                case AsyncSceneLoader::State::Idle:   out.set("idle");   break;
+                case AsyncSceneLoader::State::Failed: out.set("failed"); break;
+                case AsyncSceneLoader::State::Parsing:
+                    out.format("%3.0f%% (parsed %zu)", l.progress() * 100.0f, l.parsed());
+                    break;
+                case AsyncSceneLoader::State::Committing:
+                    out.format("%3.0f%% (%zu / %zu)", l.progress() * 100.0f, l.committed(), l.total());
+                    break;
+                }
+            }, DebugPanel::SLOW_HZ);
+        }
+    }
+
+    static bool loading(ecs::World& world) {
+        auto* loader = world.try_resource<std::shared_ptr<AsyncSceneLoader>>();
+        return loader && *loader && (*loader)->busy();
+    }
+
+    static void reset_async(ecs::World& world, const std::string& path) {
+        if (auto* loader = world.try_resource<std::shared_ptr<AsyncSceneLoader>>(); loader && *loader)
+            (*loader)->cancel();
+        DeferredCommands::flush_all(world);
+        std::optional<ecs::Entity> player;
+        world.each<PlayerTag>([&](ecs::Entity e, PlayerTag&) { if (!player) player = e; });
+        SceneLoader::unload(world, true);
+        load_async(world, path, player);
+    }
+
+    static void load_async(ecs::World& world, const std::string& path,
+                           std::optional<ecs::Entity> player = std::nullopt) {
+        auto* loader = world.try_resource<std::shared_ptr<AsyncSceneLoader>>();
+        if (!loader || !*loader) return;
+
+        AsyncSceneLoader::Prepare prepare;
+        if (auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>(); ctx_ptr && *ctx_ptr) {
+            // Same shape choice as the RigidBodyConfig hook; the cache is
+            // thread-safe and keeps the shape for the hook to find.
+            prepare = [ctx = *ctx_ptr](const SceneEntityDesc& d) {
+                if (!d.rigid_body) return;
+                if (d.box_collider)         ctx->shapes.box(MathBridge::ToJolt(d.box_collider->half_extents));
+                else if (d.sphere_collider) ctx->shapes.sphere(d.sphere_collider->radius);
+                else if (d.shape_collider)  ctx->named_shape(d.shape_collider->shape);
+            };
+        }
+        (*loader)->start(path, std::move(prepare), player);
+    }
+};
@@ -0,0 +1,537 @@
+#include "net_replication.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace NetReplication {
+
+namespace {
+
+enum : uint8_t { TYPE_SNAPSHOT = 1, TYPE_ACK = 2 };
+
+// Entry flags: one bit per position axis, the rotation, or a removal.
+enum : uint8_t { FLAG_X = 1, FLAG_Y = 2, FLAG_Z = 4, FLAG_ROT = 8, FLAG_GONE = 0x80 };
+
+constexpr size_t k_header_bytes = 2 + 1 + 1 + 4 + 4 + 1 + 1 + 2;
+constexpr size_t k_ack_bytes    = 2 + 1 + 1 + 4;
+constexpr size_t k_entry_max    = 5 + 1 + 3 * 5 + 4;
+constexpr float  k_sqrt2        = 1.41421356f;
+
+// Pulls the playback clock toward its target by this fraction a sample.
+constexpr float k_clock_gain = 0.05f;
+
+// Fragments of ticks newer than the newest assembled one, kept waiting.
+constexpr size_t k_max_pending = 8;
+
+void put_u8(std::vector<uint8_t>& out, uint8_t v) { out.push_back(v); }
+
+void put_u16_at(std::vector<uint8_t>& out, size_t at, uint16_t v) {
+    out[at]     = static_cast<uint8_t>(v);
+    out[at + 1] = static_cast<uint8_t>(v >> 8);
+}
+
+void put_u32(std::vector<uint8_t>& out, uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<uint8_t>(v >> (8 * i)));
+}
+
+void put_varint(std::vector<uint8_t>& out, uint32_t v) {
+    while (v >= 0x80) {
+        out.push_back(static_cast<uint8_t>(v | 0x80));
+        v >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(v));
+}
+
+uint32_t zigzag(int32_t v) { return (static_cast<uint32_t>(v) << 1) ^ static_cast<uint32_t>(v >> 31); }
+int32_t  unzigzag(uint32_t v) { return static_cast<int32_t>(v >> 1) ^ -static_cast<int32_t>(v & 1); }
+
+// Bounds-checked reads; any overrun leaves `ok` false.
+struct Reader {
+    const uint8_t* p;
+    const uint8_t* end;
+    bool           ok = true;
+
+    uint8_t u8() {
+        if (p >= end) { ok = false; return 0; }
+        return *p++;
+    }
+    uint16_t u16() {
+        const uint16_t lo = u8();
+        return static_cast<uint16_t>(lo | (u8() << 8));
+    }
+    uint32_t u32() {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(u8()) << (8 * i);
+        return v;
+    }
+    uint32_t varint() {
+        uint32_t v = 0;
+        for (int shift = 0; shift < 35; shift += 7) {
+            const uint8_t b = u8();
+            v |= static_cast<uint32_t>(b & 0x7f) << shift;
+            if (!(b & 0x80)) return v;
+        }
+        ok = false;
+        return 0;
+    }
+};
+
+void put_header(std::vector<uint8_t>& out, uint8_t type) {
+    out.push_back('P');
+    out.push_back('N');
+    put_u8(out, VERSION);
+    put_u8(out, type);
+}
+
+bool read_header(Reader& in, uint8_t type) {
+    return in.u8() == 'P' && in.u8() == 'N' && in.u8() == VERSION && in.u8() == type && in.ok;
+}
+
+// The pose an entity new to the client is encoded against.
+const QPose& zero_pose() {
+    static const QPose zero = quantize({0, 0, 0}, {0, 0, 0, 1});
+    return zero;
+}
+
+void write_entry(std::vector<uint8_t>& out, uint32_t delta, const QPose& pose, const QPose& base) {
+    put_varint(out, delta);
+    uint8_t flags = 0;
+    for (int a = 0; a < 3; ++a)
+        if (pose.p[a] != base.p[a]) flags |= static_cast<uint8_t>(FLAG_X << a);
+    if (pose.r != base.r) flags |= FLAG_ROT;
+    put_u8(out, flags);
+    for (int a = 0; a < 3; ++a)
+        if (flags & (FLAG_X << a))
+            put_varint(out, zigzag(static_cast<int32_t>(static_cast<uint32_t>(pose.p[a]) -
+                                                        static_cast<uint32_t>(base.p[a]))));
+    if (flags & FLAG_ROT) put_u32(out, pose.r);
+}
+
+uint16_t entry_count(const std::vector<uint8_t>& fragment) {
+    return static_cast<uint16_t>(fragment[k_header_bytes - 2] | (fragment[k_header_bytes - 1] << 8));
+}
+
+} // namespace
+
+// ---------------------------------------------------------------------------
+// Quantisation
+// ---------------------------------------------------------------------------
+
+// Smallest three: the index of the largest component in the top two bits
+// (made positive, since q and -q are the same rotation), then the other
+// three, each in [-1/√2, 1/√2], in ten bits.
+uint32_t quantize_rotation(const ecs::Quat& q) {
+    float c[4] = {q.x, q.y, q.z, q.w};
+    const float len = std::sqrt(c[0] * c[0] + c[1] * c[1] + c[2] * c[2] + c[3] * c[3]);
+    if (len < 1e-6f) return quantize_rotation({0, 0, 0, 1});
+
+    int largest = 0;
+    for (int i = 1; i < 4; ++i)
+        if (std::fabs(c[i]) > std::fabs(c[largest])) largest = i;
+    const float sign = (c[largest] < 0.0f ? -1.0f : 1.0f) / len;
+
+    uint32_t r = static_cast<uint32_t>(largest) << 30;
+    int shift = 20;
+    for (int i = 0; i < 4; ++i) {
+        if (i == largest) continue;
+        const float n = std::clamp(c[i] * sign * k_sqrt2 * 0.5f + 0.5f, 0.0f, 1.0f);
+        r |= static_cast<uint32_t>(std::lround(n * 1023.0f)) << shift;
+        shift -= 10;
+    }
+    return r;
+}
+
+ecs::Quat dequantize_rotation(uint32_t r) {
+    const int largest = static_cast<int>(r >> 30);
+    float c[4];
+    float sum = 0.0f;
+    int shift = 20;
+    for (int i = 0; i < 4; ++i) {
+        if (i == largest) continue;
+        const float n = static_cast<float>((r >> shift) & 1023u) / 1023.0f;
+        c[i] = (n - 0.5f) * 2.0f / k_sqrt2;
+        sum += c[i] * c[i];
+        shift -= 10;
+    }
+    c[largest] = std::sqrt(std::max(0.0f, 1.0f - sum));
+    return {c[0], c[1], c[2], c[3]};
+}
+
+QPose quantize(const ecs::Vec3& position, const ecs::Quat& rotation) {
+    QPose q;
+    const float p[3] = {position.x, position.y, position.z};
+    for (int a = 0; a < 3; ++a) q.p[a] = static_cast<int32_t>(std::lround(p[a] * POS_SCALE));
+    q.r = quantize_rotation(rotation);
+    return q;
+}
+
+ecs::Vec3 dequantize_position(const QPose& q) {
+    return {static_cast<float>(q.p[0]) / POS_SCALE, static_cast<float>(q.p[1]) / POS_SCALE,
+            static_cast<float>(q.p[2]) / POS_SCALE};
+}
+
+ecs::Quat rotation_of(const ecs::Mat4& mat) {
+    const float* m = mat.m;
+    const auto len = [](float x, float y, float z) {
+        const float l = std::sqrt(x * x + y * y + z * z);
+        return l > 1e-6f ? l : 1.0f;
+    };
+    const float sx = len(m[0], m[1], m[2]), sy = len(m[4], m[5], m[6]), sz = len(m[8], m[9], m[10]);
+    // r<row><col>; column c is m[4c .. 4c + 2].
+    const float r00 = m[0] / sx, r10 = m[1] / sx, r20 = m[2] / sx;
+    const float r01 = m[4] / sy, r11 = m[5] / sy, r21 = m[6] / sy;
+    const float r02 = m[8] / sz, r12 = m[9] / sz, r22 = m[10] / sz;
+
+    const float trace = r00 + r11 + r22;
+    if (trace > 0.0f) {
+        const float s = std::sqrt(trace + 1.0f) * 2.0f;
+        return {(r21 - r12) / s, (r02 - r20) / s, (r10 - r01) / s, 0.25f * s};
+    }
+    if (r00 > r11 && r00 > r22) {
+        const float s = std::sqrt(1.0f + r00 - r11 - r22) * 2.0f;
+        return {0.25f * s, (r01 + r10) / s, (r02 + r20) / s, (r21 - r12) / s};
+    }
+    if (r11 > r22) {
+        const float s = std::sqrt(1.0f + r11 - r00 - r22) * 2.0f;
+        return {(r01 + r10) / s, 0.25f * s, (r12 + r21) / s, (r02 - r20) / s};
+    }
+    const float s = std::sqrt(1.0f + r22 - r00 - r11) * 2.0f;
+    return {(r02 + r20) / s, (r12 + r21) / s, 0.25f * s, (r10 - r01) / s};
+}
+
+const Entry* Snapshot::find(uint32_t id) const {
+    auto it = std::lower_bound(entries.begin(), entries.end(), id,
+                               [](const Entry& e, uint32_t v) { return e.id < v; });
+    return it != entries.end() && it->id == id ? &*it : nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// Encoding
+// ---------------------------------------------------------------------------
+
+bool encode(const Snapshot& snap, const Snapshot* baseline, std::vector<std::vector<uint8_t>>& fragments) {
+    const size_t first = fragments.size();
+    uint32_t prev_id = 0;
+    uint16_t count   = 0;
+
+    const auto begin_fragment = [&] {
+        std::vector<uint8_t>& f = fragments.emplace_back();
+        f.reserve(MAX_PACKET);
+        put_header(f, TYPE_SNAPSHOT);
+        put_u32(f, snap.tick);
+        put_u32(f, baseline ? baseline->tick : NO_TICK);
+        put_u8(f, 0); // index and count: patched below
+        put_u8(f, 0);
+        f.resize(k_header_bytes); // entry count
+        prev_id = 0;
+        count   = 0;
+    };
+    const auto reserve_entry = [&] {
+        if (fragments.back().size() + k_entry_max > MAX_PACKET) {
+            put_u16_at(fragments.back(), k_header_bytes - 2, count);
+            begin_fragment();
+        }
+        ++count;
+    };
+    begin_fragment();
+
+    static const std::vector<Entry> none;
+    const std::vector<Entry>& base = baseline ? baseline->entries : none;
+    size_t i = 0, j = 0;
+    while (i < snap.entries.size() || j < base.size()) {
+        if (j == base.size() || (i < snap.entries.size() && snap.entries[i].id < base[j].id)) {
+            const Entry& e = snap.entries[i++];
+            reserve_entry();
+            write_entry(fragments.back(), e.id - prev_id, e.pose, zero_pose());
+            prev_id = e.id;
+        } else if (i == snap.entries.size() || base[j].id < snap.entries[i].id) {
+            const Entry& gone = base[j++];
+            reserve_entry();
+            put_varint(fragments.back(), gone.id - prev_id);
+            put_u8(fragments.back(), FLAG_GONE);
+            prev_id = gone.id;
+        } else {
+            const Entry& e = snap.entries[i++];
+            const Entry& b = base[j++];
+            if (e.pose == b.pose) continue;
+            reserve_entry();
+            write_entry(fragments.back(), e.id - prev_id, e.pose, b.pose);
+            prev_id = e.id;
+        }
+    }
+    put_u16_at(fragments.back(), k_header_bytes - 2, count);
+
+    const size_t n = fragments.size() - first;
+    if (n > 255) {
+        fragments.resize(first);
+        return false;
+    }
+    for (size_t f = 0; f < n; ++f) {
+        fragments[first + f][k_header_bytes - 4] = static_cast<uint8_t>(f);
+        fragments[first + f][k_header_bytes - 3] = static_cast<uint8_t>(n);
+    }
+    return true;
+}
+
+void encode_ack(uint32_t tick, std::vector<uint8_t>& out) {
+    out.clear();
+    put_header(out, TYPE_ACK);
+    put_u32(out, tick);
+}
+
+bool decode_ack(const uint8_t* data, size_t size, uint32_t& tick) {
+    if (size != k_ack_bytes) return false;
+    Reader in{data, data + size};
+    if (!read_header(in, TYPE_ACK)) return false;
+    tick = in.u32();
+    return in.ok;
+}
+
+// ---------------------------------------------------------------------------
+// Server
+// ---------------------------------------------------------------------------
+
+bool Server::receive(PeerKey peer, const uint8_t* data, size_t size) {
+    uint32_t ack = NO_TICK;
+    if (!decode_ack(data, size, ack)) return false;
+    auto it = std::find_if(peers_.begin(), peers_.end(), [&](const Peer& p) { return p.key == peer; });
+    if (it == peers_.end()) {
+        if (peers_.size() >= MAX_PEERS) return false;
+        peers_.push_back({peer, NO_TICK, NO_TICK});
+        it = peers_.end() - 1;
+    }
+    // NO_TICK: the client (re)joined and has no baseline. Otherwise acks
+    // may arrive out of order; the newest wins.
+    it->acked = ack == NO_TICK ? NO_TICK : std::max(it->acked, ack);
+    it->heard = NO_TICK; // stamped with the next broadcast's tick
+    return true;
+}
+
+void Server::broadcast(Snapshot snap, const Send& send) {
+    history_.push_back(std::move(snap));
+    if (history_.size() > HISTORY) history_.pop_front();
+    const Snapshot& cur = history_.back();
+
+    for (Peer& p : peers_)
+        if (p.heard == NO_TICK) p.heard = cur.tick;
+    peers_.erase(std::remove_if(peers_.begin(), peers_.end(),
+                                [&](const Peer& p) { return cur.tick - p.heard > TIMEOUT_TICKS; }),
+                 peers_.end());
+
+    last_bytes_   = 0;
+    last_entries_ = 0;
+    for (const Peer& peer : peers_) {
+        const Snapshot* base = peer.acked != NO_TICK ? find(peer.acked) : nullptr;
+        if (!base) ++full_;
+        fragments_.clear();
+        if (!encode(cur, base, fragments_)) {
+            ++oversize_;
+            continue;
+        }
+        for (const std::vector<uint8_t>& f : fragments_) {
+            send(peer.key, f);
+            last_bytes_   += f.size();
+            last_entries_ += entry_count(f);
+        }
+    }
+    bytes_sent_ += last_bytes_;
+}
+
+const Snapshot* Server::find(uint32_t tick) const {
+    for (auto it = history_.rbegin(); it != history_.rend(); ++it)
+        if (it->tick == tick) return &*it;
+    return nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// Client
+// ---------------------------------------------------------------------------
+
+const Snapshot* Client::find(uint32_t tick) const {
+    for (auto it = history_.rbegin(); it != history_.rend(); ++it)
+        if (it->tick == tick) return &*it;
+    return nullptr;
+}
+
+bool Client::receive(const uint8_t* data, size_t size) {
+    bytes_in_ += size;
+    Reader in{data, data + size};
+    if (!read_header(in, TYPE_SNAPSHOT)) {
+        ++dropped_;
+        return false;
+    }
+    const uint32_t tick     = in.u32();
+    const uint32_t baseline = in.u32();
+    const uint8_t  index    = in.u8();
+    const uint8_t  count    = in.u8();
+    const uint16_t entries  = in.u16();
+    if (!in.ok || count == 0 || index >= count || tick == NO_TICK || baseline >= tick) {
+        ++dropped_;
+        return false;
+    }
+    if (tick <= newest()) return false; // late or duplicate: already past it
+
+    const Snapshot* base = baseline != NO_TICK ? find(baseline) : nullptr;
+    if (baseline != NO_TICK && !base) {
+        ++dropped_; // its baseline has left the history (or never arrived)
+        return false;
+    }
+
+    auto it = std::find_if(pending_.begin(), pending_.end(), [&](const Pending& p) { return p.tick == tick; });
+    if (it == pending_.end()) {
+        if (pending_.size() >= k_max_pending) {
+            auto oldest = std::min_element(pending_.begin(), pending_.end(),
+                                           [](const Pending& a, const Pending& b) { return a.tick < b.tick; });
+            pending_.erase(oldest);
+            ++dropped_;
+        }
+        Pending& p = pending_.emplace_back();
+        p.tick     = tick;
+        p.baseline = baseline;
+        p.count    = count;
+        p.have.assign(count, false);
+        it = pending_.end() - 1;
+    }
+    Pending& p = *it;
+    if (p.baseline != baseline || p.count != count) {
+        ++dropped_;
+        return false;
+    }
+    if (p.have[index]) return false;
+
+    // Decode into the tail, and take it back off if the fragment is bad.
+    const size_t changed_mark = p.changed.size();
+    const size_t removed_mark = p.removed.size();
+    uint32_t id = 0;
+    for (uint16_t e = 0; e < entries && in.ok; ++e) {
+        id += in.varint();
+        const uint8_t flags = in.u8();
+        if (flags & FLAG_GONE) {
+            p.removed.push_back(id);
+            continue;
+        }
+        const Entry* prev = base ? base->find(id) : nullptr;
+        Entry entry{id, prev ? prev->pose : zero_pose()};
+        for (int a = 0; a < 3; ++a)
+            if (flags & (FLAG_X << a))
+                entry.pose.p[a] = static_cast<int32_t>(static_cast<uint32_t>(entry.pose.p[a]) +
+                                                       static_cast<uint32_t>(unzigzag(in.varint())));
+        if (flags & FLAG_ROT) entry.pose.r = in.u32();
+        p.changed.push_back(entry);
+    }
+    if (!in.ok || in.p != in.end) {
+        p.changed.resize(changed_mark);
+        p.removed.resize(removed_mark);
+        ++dropped_;
+        return false;
+    }
+    p.have[index] = true;
+    if (++p.got < p.count) return false;
+
+    const bool ok = assemble(p);
+    // Anything older than this tick can no longer be used.
+    pending_.erase(std::remove_if(pending_.begin(), pending_.end(),
+                                  [&](const Pending& q) { return q.tick <= tick; }),
+                   pending_.end());
+    if (!ok) ++dropped_;
+    return ok;
+}
+
+// The baseline minus the removals, overlaid with the changes.
+bool Client::assemble(const Pending& p) {
+    const Snapshot* base = p.baseline != NO_TICK ? find(p.baseline) : nullptr;
+    if (p.baseline != NO_TICK && !base) return false;
+
+    std::vector<Entry> changed = p.changed;
+    std::sort(changed.begin(), changed.end(), [](const Entry& a, const Entry& b) { return a.id < b.id; });
+    std::vector<uint32_t> removed = p.removed;
+    std::sort(removed.begin(), removed.end());
+
+    Snapshot snap;
+    snap.tick = p.tick;
+    static const std::vector<Entry> none;
+    const std::vector<Entry>& prev = base ? base->entries : none;
+    snap.entries.reserve(prev.size() + changed.size());
+    size_t i = 0, c = 0, r = 0;
+    while (i < prev.size() || c < changed.size()) {
+        if (c == changed.size() || (i < prev.size() && prev[i].id < changed[c].id)) {
+            const Entry& e = prev[i++];
+            while (r < removed.size() && removed[r] < e.id) ++r;
+            if (r < removed.size() && removed[r] == e.id) continue;
+            snap.entries.push_back(e);
+        } else {
+            if (i < prev.size() && prev[i].id == changed[c].id) ++i;
+            snap.entries.push_back(changed[c++]);
+        }
+    }
+
+    history_.push_back(std::move(snap));
+    if (history_.size() > HISTORY) history_.pop_front();
+    ++received_;
+    return true;
+}
+
+bool Client::sample(float ticks, std::vector<Pose>& out) {
+    out.clear();
+    if (history_.empty()) return false;
+
+    const float target = static_cast<float>(history_.back().tick) - INTERP_DELAY;
+    if (!started_) {
+        playback_ = target;
+        started_  = true;
+        full_     = true;
+    } else {
+        playback_ += ticks;
+        const float error = target - playback_;
+        if (std::fabs(error) > 2.0f * INTERP_DELAY) {
+            playback_ = target; // a stall or a burst: jump rather than crawl
+            full_     = true;
+        } else {
+            playback_ += error * k_clock_gain;
+        }
+    }
+    playback_ = std::min(playback_, static_cast<float>(history_.back().tick));
+
+    // The snapshots either side of the playback time; the nearest end when
+    // it is outside the history.
+    auto hi = std::upper_bound(history_.begin(), history_.end(), playback_,
+                               [](float t, const Snapshot& s) { return t < static_cast<float>(s.tick); });
+    const Snapshot& b = hi == history_.end() ? history_.back() : *hi;
+    const Snapshot& a = hi == history_.begin() || hi == history_.end() ? b : *(hi - 1);
+    const float t = &a == &b ? 1.0f
+                             : std::clamp((playback_ - static_cast<float>(a.tick)) /
+                                              static_cast<float>(b.tick - a.tick), 0.0f, 1.0f);
+
+    scratch_.clear();
+    size_t ia = 0, im = 0;
+    for (const Entry& e : b.entries) {
+        while (ia < a.entries.size() && a.entries[ia].id < e.id) ++ia;
+        while (im < moving_.size() && moving_[im] < e.id) ++im;
+        const Entry* from  = ia < a.entries.size() && a.entries[ia].id == e.id ? &a.entries[ia] : nullptr;
+        const bool   moves = from && from->pose != e.pose;
+        const bool   was   = im < moving_.size() && moving_[im] == e.id;
+        if (!full_ && !moves && !was && from) continue; // at rest, and already written there
+
+        Pose pose{e.id, dequantize_position(e.pose), dequantize_rotation(e.pose.r)};
+        if (moves) {
+            const ecs::Vec3 p0 = dequantize_position(from->pose);
+            const ecs::Quat q0 = dequantize_rotation(from->pose.r);
+            const ecs::Quat q1 = pose.rotation;
+            const float s = 1.0f - t;
+            pose.position = {p0.x * s + pose.position.x * t, p0.y * s + pose.position.y * t,
+                             p0.z * s + pose.position.z * t};
+            const float dot = q0.x * q1.x + q0.y * q1.y + q0.z * q1.z + q0.w * q1.w;
+            const float s0  = dot < 0.0f ? -s : s;
+            ecs::Quat q = {q0.x * s0 + q1.x * t, q0.y * s0 + q1.y * t, q0.z * s0 + q1.z * t,
+                           q0.w * s0 + q1.w * t};
+            const float len = std::sqrt(q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w);
+            if (len > 1e-6f) pose.rotation = {q.x / len, q.y / len, q.z / len, q.w / len};
+            scratch_.push_back(e.id);
+        }
+        out.push_back(pose);
+    }
+    moving_.swap(scratch_);
+    full_ = false;
+    return true;
+}
+
+} // namespace NetReplication
@@ -0,0 +1,190 @@
+#pragma once
+#include <ecs/ecs.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// NetReplication — quantised, delta-compressed pose snapshots for
+// spectating clients, independent of the transport.
+//
+// The server records one Snapshot per physics tick: every replicated
+// entity's id and pose, quantised (positions to 1/POS_SCALE m in int32,
+// rotations smallest-three in 32 bits). Each client acks the newest
+// snapshot it has assembled, and the server encodes the next one against
+// that ack:
+//
+//   fragment = header { magic "PN", version, type, tick u32,
+//                       baseline tick u32, fragment index u8, count u8,
+//                       entry count u16 }
+//              entries  { id delta varint, flags u8,
+//                         zigzag varint per changed axis, rotation u32 }
+//
+// The flags say which axes and whether the rotation follow, or that the
+// entity has gone. An entity whose quantised pose equals the baseline's is
+// not written, and neither is an unchanged axis or rotation, so a sleeping
+// body costs nothing and the bytes per client follow the number of moving entities.
+// Baseline 0 is a full snapshot, sent until the client's first ack and
+// whenever its ack has left the server's HISTORY. Snapshots are split into
+// fragments of at most MAX_PACKET bytes; the client assembles a tick once
+// it has all of them and drops it if its baseline is gone.
+//
+// Client::sample() plays the received ticks back INTERP_DELAY ticks behind
+// the newest, lerping positions and nlerping rotations between the two
+// snapshots around the playback time. It only reports the entities that
+// are moving (or just stopped), so applying them costs the same as
+// receiving them.
+//
+// Ids are the server's entity indices. Both sides spawn the same scene, so
+// a client maps them to its own entities (NetClientSystem).
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+namespace NetReplication {
+
+inline constexpr uint8_t  VERSION      = 1;
+inline constexpr float    POS_SCALE    = 1024.0f; // quantisation steps per metre
+inline constexpr size_t   MAX_PACKET   = 1200;    // bytes: under any path MTU
+inline constexpr size_t   HISTORY      = 64;      // snapshots kept on both sides (~1 s at 60 Hz)
+inline constexpr float    INTERP_DELAY = 4.0f;    // ticks the client plays behind the newest
+inline constexpr uint32_t NO_TICK      = 0;       // ticks start at 1
+
+struct QPose {
+    int32_t  p[3] = {0, 0, 0};
+    uint32_t r    = 0;
+    bool operator==(const QPose& o) const { return p[0] == o.p[0] && p[1] == o.p[1] && p[2] == o.p[2] && r == o.r; }
+    bool operator!=(const QPose& o) const { return !(*this == o); }
+};
+
+uint32_t  quantize_rotation(const ecs::Quat& q);
+ecs::Quat dequantize_rotation(uint32_t r);
+QPose     quantize(const ecs::Vec3& position, const ecs::Quat& rotation);
+ecs::Vec3 dequantize_position(const QPose& q);
+
+// The rotation of column-major `m`, with any scale divided out.
+ecs::Quat rotation_of(const ecs::Mat4& m);
+
+struct Entry {
+    uint32_t id;
+    QPose    pose;
+};
+
+struct Snapshot {
+    uint32_t           tick = NO_TICK;
+    std::vector<Entry> entries; // ascending id
+
+    const Entry* find(uint32_t id) const;
+};
+
+// Appends the fragments of `snap` encoded against `baseline` (null: full).
+// False, with nothing appended, if it would need more than 255 fragments.
+bool encode(const Snapshot& snap, const Snapshot* baseline, std::vector<std::vector<uint8_t>>& fragments);
+
+// Client → server: the newest assembled tick, or NO_TICK to join.
+void encode_ack(uint32_t tick, std::vector<uint8_t>& out);
+bool decode_ack(const uint8_t* data, size_t size, uint32_t& tick);
+
+// ---------------------------------------------------------------------------
+// Server — the tick history and each peer's ack.
+// ---------------------------------------------------------------------------
+
+class Server {
+public:
+    using PeerKey = uint64_t; // transport address
+    using Send    = std::function<void(PeerKey, const std::vector<uint8_t>&)>;
+
+    static constexpr size_t   MAX_PEERS     = 16;
+    static constexpr uint32_t TIMEOUT_TICKS = 300; // a peer silent this long is dropped
+
+    // An ack registers its sender. False if the packet isn't one or the
+    // server is full.
+    bool receive(PeerKey peer, const uint8_t* data, size_t size);
+
+    // Adds the tick's snapshot (ticks must increase) and sends every peer
+    // its delta, dropping peers that have timed out.
+    void broadcast(Snapshot snap, const Send& send);
+
+    const Snapshot* find(uint32_t tick) const;
+
+    size_t   peers()          const { return peers_.size(); }
+    uint32_t tick()           const { return history_.empty() ? NO_TICK : history_.back().tick; }
+    size_t   last_bytes()     const { return last_bytes_; }   // all peers, last broadcast
+    size_t   last_entries()   const { return last_entries_; } // entries written, all peers
+    size_t   full_snapshots() const { return full_; }
+    size_t   oversize()       const { return oversize_; }
+    uint64_t bytes_sent()     const { return bytes_sent_; }
+
+private:
+    struct Peer {
+        PeerKey  key;
+        uint32_t acked;
+        uint32_t heard; // tick of the first broadcast after its last ack
+    };
+
+    std::deque<Snapshot>             history_;
+    std::vector<Peer>                peers_;
+    std::vector<std::vector<uint8_t>> fragments_; // reused
+    size_t   last_bytes_   = 0;
+    size_t   last_entries_ = 0;
+    size_t   full_         = 0;
+    size_t   oversize_     = 0;
+    uint64_t bytes_sent_   = 0;
+};
+
+// ---------------------------------------------------------------------------
+// Client — assembles fragments against the history and plays it back.
+// ---------------------------------------------------------------------------
+
+struct Pose {
+    uint32_t  id;
+    ecs::Vec3 position;
+    ecs::Quat rotation;
+};
+
+class Client {
+public:
+    // Returns true when the packet completed a tick.
+    bool receive(const uint8_t* data, size_t size);
+
+    // The newest assembled tick, for the ack.
+    uint32_t        newest()   const { return history_.empty() ? NO_TICK : history_.back().tick; }
+    const Snapshot* find(uint32_t tick) const;
+
+    // Advances the playback clock by `ticks` and writes the interpolated
+    // poses that changed. False (out empty) until a snapshot has arrived.
+    bool sample(float ticks, std::vector<Pose>& out);
+
+    float    playback()  const { return playback_; }
+    size_t   received()  const { return received_; }  // ticks assembled
+    size_t   dropped()   const { return dropped_; }   // fragments refused or abandoned
+    uint64_t bytes_in()  const { return bytes_in_; }
+
+private:
+    struct Pending {
+        uint32_t              tick = NO_TICK;
+        uint32_t              baseline = NO_TICK;
+        uint8_t               count = 0;
+        std::vector<bool>     have;
+        size_t                got = 0;
+        std::vector<Entry>    changed;  // unordered until assembled
+        std::vector<uint32_t> removed;
+    };
+
+    std::deque<Snapshot>  history_;
+    std::vector<Pending>  pending_;
+    std::vector<uint32_t> moving_; // ids written by the last sample(), ascending
+    std::vector<uint32_t> scratch_;
+    float    playback_ = 0.0f;
+    bool     started_  = false;
+    bool     full_     = true;  // next sample() writes every entity
+    size_t   received_ = 0;
+    size_t   dropped_  = 0;
+    uint64_t bytes_in_ = 0;
+
+    bool assemble(const Pending& p);
+};
+
+} // namespace NetReplication
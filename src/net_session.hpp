@@ -0,0 +1,44 @@
+#pragma once
+#include "net_replication.hpp"
+#include "net_socket.hpp"
+#include "transform_batch.hpp"
+#include <ecs/ecs.hpp>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// NetServerSession / NetClientSession — the replication state and socket
+// of each side (RFC-0057).
+//
+// World resources, as std::shared_ptr (the socket can't be copied),
+// created by NetModule::install_server / install_client. A process is one
+// or the other, or neither.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+struct NetServerSession {
+    NetReplication::Server server;
+    UdpSocket              socket;
+    uint32_t               tick = NetReplication::NO_TICK;
+    size_t                 replicated = 0; // entities in the last snapshot
+    std::vector<uint8_t>   buffer = std::vector<uint8_t>(NetReplication::MAX_PACKET);
+};
+
+struct NetClientSession {
+    NetReplication::Client client;
+    UdpSocket              socket;
+    UdpSocket::Address     server;
+
+    // Server id (entity index) → this World's entity, for the entities that
+    // can be replicated. Rebuilt when an id is missing.
+    std::unordered_map<uint32_t, ecs::Entity> entities;
+
+    std::vector<NetReplication::Pose> poses;  // reused by NetClientSystem
+    TransformBatch                    batch;
+    std::vector<uint8_t>              buffer = std::vector<uint8_t>(NetReplication::MAX_PACKET);
+    std::vector<uint8_t>              ack;
+    size_t applied  = 0; // poses written last frame
+    size_t unmapped = 0; // ids with no entity here (the scenes differ)
+};
@@ -0,0 +1,147 @@
+#include "net_socket.hpp"
+#include <iostream>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using Native  = SOCKET;
+using SockLen = int;
+static int  last_error() { return WSAGetLastError(); }
+static bool would_block(int err) { return err == WSAEWOULDBLOCK; }
+static bool refused(int err) { return err == WSAECONNRESET; }
+static void close_handle(intptr_t h) { closesocket(static_cast<SOCKET>(h)); }
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+using Native  = int;
+using SockLen = socklen_t;
+static int  last_error() { return errno; }
+static bool would_block(int err) { return err == EAGAIN || err == EWOULDBLOCK; }
+static bool refused(int err) { return err == ECONNREFUSED; }
+static void close_handle(intptr_t h) { ::close(static_cast<int>(h)); }
+#endif
+
+namespace {
+
+#ifdef _WIN32
+// Winsock is started with the first socket and stays up for the process.
+bool start_sockets() {
+    static const bool ok = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return ok;
+}
+#else
+bool start_sockets() { return true; }
+#endif
+
+sockaddr_in to_sockaddr(const UdpSocket::Address& a) {
+    sockaddr_in sa{};
+    sa.sin_family      = AF_INET;
+    sa.sin_addr.s_addr = htonl(a.ip);
+    sa.sin_port        = htons(a.port);
+    return sa;
+}
+
+} // namespace
+
+bool UdpSocket::open(uint16_t port) {
+    close();
+    if (!start_sockets()) {
+        report("socket startup failed");
+        return false;
+    }
+    const auto s = ::socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+#ifdef _WIN32
+    if (s == INVALID_SOCKET) { report("socket() failed"); return false; }
+#else
+    if (s < 0) { report("socket() failed"); return false; }
+#endif
+    handle_ = static_cast<Handle>(s);
+
+    sockaddr_in sa = to_sockaddr({INADDR_ANY, port});
+    if (::bind(s, reinterpret_cast<const sockaddr*>(&sa), sizeof(sa)) != 0) {
+        report("bind() failed");
+        close();
+        return false;
+    }
+#ifdef _WIN32
+    u_long nonblocking = 1;
+    const bool ok = ioctlsocket(s, FIONBIO, &nonblocking) == 0;
+#else
+    const int flags = fcntl(s, F_GETFL, 0);
+    const bool ok = flags >= 0 && fcntl(s, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+    if (!ok) {
+        report("could not make the socket non-blocking");
+        close();
+        return false;
+    }
+    return true;
+}
+
+void UdpSocket::close() {
+    if (handle_ == INVALID) return;
+    close_handle(handle_);
+    handle_ = INVALID;
+}
+
+bool UdpSocket::send(const Address& to, const void* data, size_t size) {
+    if (handle_ == INVALID) return false;
+    const sockaddr_in sa = to_sockaddr(to);
+    const auto sent = ::sendto(static_cast<Native>(handle_),
+                               static_cast<const char*>(data), static_cast<int>(size), 0,
+                               reinterpret_cast<const sockaddr*>(&sa), sizeof(sa));
+    if (sent >= 0 && static_cast<size_t>(sent) == size) return true;
+    if (sent < 0 && !would_block(last_error()) && !refused(last_error())) report("sendto() failed");
+    return false;
+}
+
+bool UdpSocket::receive(Address& from, void* data, size_t capacity, size_t& size) {
+    if (handle_ == INVALID) return false;
+    for (;;) {
+        sockaddr_in sa{};
+        SockLen     len = sizeof(sa);
+        const auto got = ::recvfrom(static_cast<Native>(handle_),
+                                    static_cast<char*>(data), static_cast<int>(capacity), 0,
+                                    reinterpret_cast<sockaddr*>(&sa), &len);
+        if (got < 0) {
+            const int err = last_error();
+            // A refused send to a peer that has gone surfaces here as an
+            // error on some platforms; skip it and keep draining.
+            if (refused(err)) continue;
+            if (!would_block(err)) report("recvfrom() failed");
+            return false;
+        }
+        from = {ntohl(sa.sin_addr.s_addr), ntohs(sa.sin_port)};
+        size = static_cast<size_t>(got);
+        return true;
+    }
+}
+
+bool UdpSocket::resolve(const std::string& host, uint16_t port, Address& out) {
+    if (!start_sockets()) return false;
+    addrinfo hints{};
+    hints.ai_family   = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* found   = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &found) != 0 || !found) return false;
+    const auto* sa = reinterpret_cast<const sockaddr_in*>(found->ai_addr);
+    out = {ntohl(sa->sin_addr.s_addr), port};
+    freeaddrinfo(found);
+    return true;
+}
+
+void UdpSocket::report(const char* what) {
+    if (reported_) return;
+    reported_ = true;
+    std::cerr << "UdpSocket: " << what << " (error " << last_error() << ")\n";
+}
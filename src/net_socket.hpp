@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ---------------------------------------------------------------------------
+// UdpSocket — a non-blocking IPv4 datagram socket (BSD sockets, Winsock on
+// Windows).
+//
+// open(port) binds to that port on every interface (0: any free port).
+// receive() returns false when nothing is waiting, so a system can drain it
+// each frame without stalling. Addresses are host-order IPv4 + port, and
+// key() packs one into the id NetReplication::Server tracks peers by.
+//
+// Errors other than "would block" are reported once to std::cerr and the
+// call returns false; a datagram is either sent whole or not at all.
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+class UdpSocket {
+public:
+    struct Address {
+        uint32_t ip   = 0; // host order
+        uint16_t port = 0;
+
+        uint64_t key() const { return (static_cast<uint64_t>(ip) << 16) | port; }
+        static Address from_key(uint64_t k) {
+            return {static_cast<uint32_t>(k >> 16), static_cast<uint16_t>(k & 0xffff)};
+        }
+    };
+
+    UdpSocket() = default;
+    ~UdpSocket() { close(); }
+
+    UdpSocket(const UdpSocket&)            = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    bool open(uint16_t port = 0);
+    void close();
+    bool is_open() const { return handle_ != INVALID; }
+
+    bool send(const Address& to, const void* data, size_t size);
+    // Up to `capacity` bytes of the next datagram; false when none is queued.
+    bool receive(Address& from, void* data, size_t capacity, size_t& size);
+
+    // "host" or a dotted address. False if it doesn't resolve to IPv4.
+    static bool resolve(const std::string& host, uint16_t port, Address& out);
+
+private:
+    using Handle = intptr_t;
+    static constexpr Handle INVALID = -1;
+
+    Handle handle_   = INVALID;
+    bool   reported_ = false;
+
+    void report(const char* what);
+};
@@ -0,0 +1,74 @@
+#pragma once
+#include "physics_layers.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ---------------------------------------------------------------------------
+// PhysicsConfig — capacities and threading for PhysicsContext.
+//
+// Defaults match the values PhysicsContext used to hardcode, plus the
+// fixed-step schedule that seeds the FixedTime resource. Scenes can
+// override any field with a top-level "physics" block (or a standalone
+// config file), read via SceneLoader::load_physics_config before
+// PhysicsModule::install. Jolt preallocates from these numbers, so size
+// them per level: CreateBody fails once max_bodies is reached. The layer
+// table is fixed for the context's lifetime too.
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+struct PhysicsConfig {
+    uint32_t max_bodies              = 1024;
+    uint32_t num_body_mutexes        = 0;    // 0 = Jolt default
+    uint32_t max_body_pairs          = 1024;
+    uint32_t max_contact_constraints = 1024;
+    size_t   temp_allocator_bytes    = 10 * 1024 * 1024;
+    int      worker_threads          = -1;   // -1 = auto (hardware threads - 1, at least 1)
+    size_t   character_temp_bytes    = 1024 * 1024; // per CharacterMotor job (one per job-system thread)
+
+    // Fixed timestep (FixedTime resource)
+    float    fixed_hz                = 60.0f;
+    int      max_steps_per_frame     = 4;
+    bool     fold_substeps           = false; // one Jolt Update with N collision steps
+
+    // Run the frame's fixed steps on a dedicated thread, from after Logic to
+    // the start of the next frame, so they overlap Render (RFC-0046). The
+    // loop must call PhysicsModule::kick_step / join_step.
+    bool     async_step              = false;
+
+    // Sleeping (Jolt's PhysicsSettings). A body sleeps once every point on
+    // it has moved slower than sleep_velocity for time_before_sleep seconds;
+    // RigidBodyConfig::allow_sleeping opts single bodies out. Lower the time
+    // or raise the velocity for piles that should settle sooner.
+    bool     allow_sleeping          = true;
+    float    time_before_sleep       = 0.5f;  // s
+    float    sleep_velocity          = 0.03f; // m/s
+
+    // MotionQuality::Auto bodies switch to LinearCast when one step moves
+    // them more than ccd_promote × their shape's inner radius, and back to
+    // Discrete below ccd_demote × (the gap keeps them from flickering).
+    float    ccd_promote             = 0.5f;
+    float    ccd_demote              = 0.25f;
+
+    // Object / broadphase layers and the collision matrix (physics_layers.hpp)
+    PhysicsLayers layers;
+
+    // Where ShapeCollider assets live: <shape_dir>/<name>.jshape (cooked by
+    // shape_cook) or <name>.json (built at load time)
+    std::string shape_dir = "resources/shapes";
+
+    // Whether an Auto body should be LinearCast for the next step, given its
+    // current mode and how far it moved in the last one.
+    bool wants_linear_cast(bool casting, float travel, float inner_radius) const {
+        return travel > inner_radius * (casting ? ccd_demote : ccd_promote);
+    }
+
+    // Resolves worker_threads against the reported hardware concurrency.
+    // hardware_concurrency() may return 0 ("unknown"); never underflow.
+    int resolved_worker_threads(unsigned hardware_threads) const {
+        if (worker_threads >= 0) return worker_threads;
+        return std::max(1, static_cast<int>(hardware_threads) - 1);
+    }
+};
@@ -10,125 +10,387 @@
 #include <Jolt/Physics/Collision/Shape/SphereShape.h>
 #include <Jolt/Physics/Body/BodyCreationSettings.h>
 #include <Jolt/Physics/Body/BodyActivationListener.h>
+#include <Jolt/Physics/Collision/ContactListener.h>
+#include <Jolt/Physics/Character/CharacterVirtual.h>
 #include <Jolt/Physics/Collision/Shape/RotatedTranslatedShape.h>
+#include "contact_events.hpp"
+#include "frame_profiler.hpp"
+#include "physics_config.hpp"
+#include "physics_handles.hpp"
+#include "physics_stats.hpp"
+#include "shape_cache.hpp"
+#include "shape_cook.hpp"
+#include "sim_thread.hpp"
+#include "transform_batch.hpp"
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <mutex>
 #include <iostream>
+#include <thread>
 #include <vector>
 
-// Layer definitions
+// Fixed layer indices every PhysicsLayers table keeps (physics_layers.hpp).
+// Further layers are looked up by name: ctx.config.layers.find("Debris").
 namespace Layers {
-    static constexpr JPH::ObjectLayer NON_MOVING = 0;
-    static constexpr JPH::ObjectLayer MOVING = 1;
-    static constexpr JPH::ObjectLayer NUM_LAYERS = 2;
+    static constexpr JPH::ObjectLayer NON_MOVING = PhysicsLayers::STATIC;
+    static constexpr JPH::ObjectLayer MOVING     = PhysicsLayers::MOVING;
 };
 
 namespace BroadPhaseLayers {
     static constexpr JPH::BroadPhaseLayer NON_MOVING(0);
     static constexpr JPH::BroadPhaseLayer MOVING(1);
-    static constexpr JPH::uint NUM_LAYERS(2);
 };
 
 // ---------------------------------------------------------------------------
-// Jolt Boilerplate Implementation
+// Jolt layer interfaces over a PhysicsLayers table.
+//
+// Each callback is one array read and a bit test. The table must outlive
+// the PhysicsSystem; PhysicsContext passes its own config.layers.
 // ---------------------------------------------------------------------------
 
 class BPLayerInterfaceImpl final : public JPH::BroadPhaseLayerInterface {
 public:
-    BPLayerInterfaceImpl() {
-        // Create a mapping table from object layer to broad phase layer
-        mObjectToBroadPhase[Layers::NON_MOVING] = BroadPhaseLayers::NON_MOVING;
-        mObjectToBroadPhase[Layers::MOVING] = BroadPhaseLayers::MOVING;
-    }
+    explicit BPLayerInterfaceImpl(const PhysicsLayers& layers) : layers_(layers) {}
 
     virtual JPH::uint GetNumBroadPhaseLayers() const override {
-        return BroadPhaseLayers::NUM_LAYERS;
+        return layers_.broadphase_count();
     }
 
     virtual JPH::BroadPhaseLayer GetBroadPhaseLayer(JPH::ObjectLayer inLayer) const override {
-        JPH_ASSERT(inLayer < Layers::NUM_LAYERS);
-        return mObjectToBroadPhase[inLayer];
+        JPH_ASSERT(inLayer < layers_.layer_count());
+        return JPH::BroadPhaseLayer(static_cast<JPH::BroadPhaseLayer::Type>(layers_.broadphase(inLayer)));
     }
 
 #if defined(JPH_EXTERNAL_PROFILE) || defined(JPH_PROFILE_ENABLED)
     virtual const char *GetBroadPhaseLayerName(JPH::BroadPhaseLayer inLayer) const override {
-        switch ((JPH::BroadPhaseLayer::Type)inLayer) {
-            case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::NON_MOVING: return "NON_MOVING";
-            case (JPH::BroadPhaseLayer::Type)BroadPhaseLayers::MOVING: return "MOVING";
-            default: JPH_ASSERT(false); return "INVALID";
-        }
+        const auto i = static_cast<uint32_t>(static_cast<JPH::BroadPhaseLayer::Type>(inLayer));
+        return i < layers_.broadphase_count() ? layers_.broadphase_name(i).c_str() : "INVALID";
     }
 #endif // JPH_EXTERNAL_PROFILE || JPH_PROFILE_ENABLED
 
 private:
-    JPH::BroadPhaseLayer mObjectToBroadPhase[Layers::NUM_LAYERS];
+    const PhysicsLayers& layers_;
 };
 
 class ObjectVsBroadPhaseLayerFilterImpl : public JPH::ObjectVsBroadPhaseLayerFilter {
 public:
+    explicit ObjectVsBroadPhaseLayerFilterImpl(const PhysicsLayers& layers) : layers_(layers) {}
+
     virtual bool ShouldCollide(JPH::ObjectLayer inLayer1, JPH::BroadPhaseLayer inLayer2) const override {
-        switch (inLayer1) {
-            case Layers::NON_MOVING:
-                return inLayer2 == BroadPhaseLayers::MOVING;
-            case Layers::MOVING:
-                return true; // Collides with everything
-            default:
-                JPH_ASSERT(false);
-                return false;
-        }
+        return layers_.collides_broadphase(inLayer1, static_cast<JPH::BroadPhaseLayer::Type>(inLayer2));
     }
+
+private:
+    const PhysicsLayers& layers_;
 };
 
 class ObjectLayerPairFilterImpl : public JPH::ObjectLayerPairFilter {
 public:
+    explicit ObjectLayerPairFilterImpl(const PhysicsLayers& layers) : layers_(layers) {}
+
     virtual bool ShouldCollide(JPH::ObjectLayer inObject1, JPH::ObjectLayer inObject2) const override {
-        switch (inObject1) {
-            case Layers::NON_MOVING:
-                return inObject2 == Layers::MOVING; // Non moving only collides with moving
-            case Layers::MOVING:
-                return true; // Moving collides with everything
-            default:
-                JPH_ASSERT(false);
-                return false;
-        }
+        return layers_.collides(inObject1, inObject2);
+    }
+
+private:
+    const PhysicsLayers& layers_;
+};
+
+// Query filters. Stateless, so one shared instance of each serves every
+// gameplay query (PhysicsQuerySystem) instead of one built per call.
+struct StaticOnlyLayerFilter final : public JPH::ObjectLayerFilter {
+    bool ShouldCollide(JPH::ObjectLayer inLayer) const override {
+        return inLayer == Layers::NON_MOVING;
+    }
+};
+
+// Every layer but Static (debris, sensors, characters, ... included).
+struct MovingOnlyLayerFilter final : public JPH::ObjectLayerFilter {
+    bool ShouldCollide(JPH::ObjectLayer inLayer) const override {
+        return inLayer != Layers::NON_MOVING;
     }
 };
 
+// ---------------------------------------------------------------------------
+// DeactivationRecorder — collects bodies Jolt put to sleep during a step.
+//
+// Callbacks arrive on job threads with the body lock held, so this only
+// appends under a mutex. PhysicsSystem drains the list after each Update to
+// sync the final resting pose of bodies that just left the active list.
+// ---------------------------------------------------------------------------
+
+class DeactivationRecorder final : public JPH::BodyActivationListener {
+public:
+    void OnBodyActivated(const JPH::BodyID&, JPH::uint64) override {}
+
+    void OnBodyDeactivated(const JPH::BodyID& inBodyID, JPH::uint64) override {
+        std::lock_guard<std::mutex> lock(mutex_);
+        deactivated_.push_back(inBodyID);
+    }
+
+    // Moves the recorded IDs into out (cleared first). Main thread only.
+    void drain(std::vector<JPH::BodyID>& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        out.clear();
+        out.swap(deactivated_);
+    }
+
+private:
+    std::mutex               mutex_;
+    std::vector<JPH::BodyID> deactivated_;
+};
+
+// ---------------------------------------------------------------------------
+// ContactRecorder — Jolt ContactListener feeding ContactTracker.
+//
+// Callbacks arrive on job threads, often many at once, so each one only
+// appends a ContactRecord to its own thread's slot (PerThreadBuffer: no
+// mutex). Added / Persisted read the entities from the bodies' user data.
+// Removed gets IDs only, and the tracker resolves those from its open pairs.
+// PhysicsSystem drains after each Update.
+// ---------------------------------------------------------------------------
+
+class ContactRecorder final : public JPH::ContactListener {
+public:
+    explicit ContactRecorder(size_t max_threads) : records_(max_threads) {}
+
+    void OnContactAdded(const JPH::Body& b1, const JPH::Body& b2,
+                        const JPH::ContactManifold& m, JPH::ContactSettings&) override {
+        record(ContactRecord::Type::Added, b1, b2, m);
+    }
+
+    void OnContactPersisted(const JPH::Body& b1, const JPH::Body& b2,
+                            const JPH::ContactManifold& m, JPH::ContactSettings&) override {
+        record(ContactRecord::Type::Persisted, b1, b2, m);
+    }
+
+    void OnContactRemoved(const JPH::SubShapeIDPair& pair) override {
+        ContactRecord r;
+        r.type   = ContactRecord::Type::Removed;
+        r.body_a = pair.GetBody1ID().GetIndexAndSequenceNumber();
+        r.body_b = pair.GetBody2ID().GetIndexAndSequenceNumber();
+        if (r.body_a > r.body_b) std::swap(r.body_a, r.body_b);
+        records_.push(r);
+    }
+
+    // Main thread, no step running.
+    void drain(std::vector<ContactRecord>& out) { records_.drain(out); }
+
+private:
+    PerThreadBuffer<ContactRecord> records_;
+
+    void record(ContactRecord::Type type, const JPH::Body& b1, const JPH::Body& b2,
+                const JPH::ContactManifold& m) {
+        // Jolt orders b1 < b2 by ID; the normal points from b1 to b2.
+        ContactRecord r;
+        r.type        = type;
+        r.sensor      = b1.IsSensor() || b2.IsSensor();
+        r.a_is_sensor = b1.IsSensor();
+        r.body_a      = b1.GetID().GetIndexAndSequenceNumber();
+        r.body_b      = b2.GetID().GetIndexAndSequenceNumber();
+        r.a           = BodyUserData::ToEntity(b1.GetUserData());
+        r.b           = BodyUserData::ToEntity(b2.GetUserData());
+        r.point       = MathBridge::FromJolt(m.GetWorldSpaceContactPointOn1(0));
+        r.normal      = MathBridge::FromJolt(m.mWorldSpaceNormal);
+        r.depth       = m.mPenetrationDepth;
+        records_.push(r);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// TrackingTempAllocator — TempAllocatorImpl plus usage / high-water mark.
+//
+// Jolt's temp allocator is a stack: frees arrive in reverse allocation
+// order, possibly from job threads (ordered by job dependencies), so an
+// atomic running total is enough to track usage.
+// ---------------------------------------------------------------------------
+
+class TrackingTempAllocator final : public JPH::TempAllocator {
+public:
+    explicit TrackingTempAllocator(size_t bytes) : impl_(static_cast<JPH::uint>(bytes)), capacity_(bytes) {}
+
+    void* Allocate(JPH::uint inSize) override {
+        void* p = impl_.Allocate(inSize);
+        const size_t now = used_.fetch_add(aligned(inSize), std::memory_order_relaxed) + aligned(inSize);
+        size_t peak = peak_.load(std::memory_order_relaxed);
+        while (now > peak && !peak_.compare_exchange_weak(peak, now, std::memory_order_relaxed)) {}
+        return p;
+    }
+
+    void Free(void* inAddress, JPH::uint inSize) override {
+        impl_.Free(inAddress, inSize);
+        used_.fetch_sub(aligned(inSize), std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return capacity_; }
+    size_t used()     const { return used_.load(std::memory_order_relaxed); }
+    size_t peak()     const { return peak_.load(std::memory_order_relaxed); }
+    void   reset_peak()     { peak_.store(used(), std::memory_order_relaxed); }
+
+private:
+    JPH::TempAllocatorImpl impl_;
+    size_t                 capacity_;
+    std::atomic<size_t>    used_{0};
+    std::atomic<size_t>    peak_{0};
+
+    // Matches TempAllocatorImpl's internal rounding.
+    static size_t aligned(JPH::uint size) { return JPH::AlignUp(size, JPH_RVECTOR_ALIGNMENT); }
+};
+
 // ---------------------------------------------------------------------------
 // Physics Context Resource
 // ---------------------------------------------------------------------------
 
 class PhysicsContext {
 public:
-    JPH::TempAllocatorImpl* temp_allocator = nullptr;
+    TrackingTempAllocator* temp_allocator = nullptr;
     JPH::JobSystemThreadPool* job_system = nullptr;
     JPH::PhysicsSystem* physics_system = nullptr;
 
+    // Bodies created by the on_add hook but not yet in the broadphase, and
+    // bodies whose entity is gone but which are still in it. Each list is
+    // submitted as one batch by PhysicsSystem::CommitPendingBodies;
+    // pending_adds_asleep (static bodies and RigidBodyConfig::start_asleep)
+    // is added without activating. pending_discards are bodies whose entity
+    // went before they were committed: they stay in the add lists until the
+    // next commit or create, which drops them all in one pass and destroys
+    // them, so an unload never searches the add lists once per body.
+    std::vector<JPH::BodyID> pending_adds;
+    std::vector<JPH::BodyID> pending_adds_asleep;
+    std::vector<JPH::BodyID> pending_removes;
+    std::vector<JPH::BodyID> pending_discards;
+
+    // Shared collider shapes (see shape_cache.hpp)
+    ShapeCache shapes;
+
+    // Active-body sync (PhysicsSystem::Update): Jolt's active list plus the
+    // bodies that fell asleep during the step. Scratch vectors are reused.
+    DeactivationRecorder     deactivation_recorder;
+    JPH::BodyIDVector        active_scratch;
+    std::vector<JPH::BodyID> deactivated_scratch;
+    TransformBatch           transform_batch; // their WorldTransforms, composed as one batch
+
+    // MotionQuality::Auto bodies, re-evaluated after every step. Entries
+    // whose body is gone are dropped on the next pass.
+    struct AutoCcdBody {
+        JPH::BodyID id;
+        float       inner_radius;
+        bool        casting;
+    };
+    std::vector<AutoCcdBody> auto_ccd;
+    uint32_t                 auto_ccd_casting = 0;
+
+    // KinematicDriverSystem scratch: sleeping bodies it moved, woken as one batch.
+    std::vector<JPH::BodyID> kinematic_wake;
+
+    // Counts after the last step (physics_stats.hpp), for the debug panel.
+    PhysicsStats          stats;
+    BodyIslands           islands;
+    std::vector<uint32_t> stats_scratch;
+    JPH::BodyManager::BodyStats body_counts; // read by gather_step, copied into stats by apply_step
+
+    // Poses read out of Jolt after a step, written into the ECS afterwards
+    // (PhysicsSystem's gather / apply halves).
+    struct BodyPose {
+        ecs::Entity entity;
+        ecs::Vec3   position;
+        ecs::Quat   rotation;
+        bool        settled; // fell asleep during the step
+    };
+    std::vector<BodyPose> step_poses;
+
+    // Async step (PhysicsConfig::async_step, RFC-0046). PhysicsSystem::Update
+    // only queues; PhysicsSystem::KickQueued runs the queue on step_thread and
+    // JoinQueued applies the results. In between, the step thread owns Jolt's
+    // bodies and the main thread owns the ECS: nothing else may call into
+    // Jolt (body creation, queries, character updates) until the join.
+    struct StepRequest {
+        float dt;
+        int   collision_steps;
+    };
+    std::vector<StepRequest>         step_queue;
+    bool                             step_in_flight = false;
+    FrameProfiler::Clock::time_point step_t0{}, step_t1{}; // the last async step's Jolt time
+    std::unique_ptr<SimThread>       step_thread;          // null unless async_step
+
+    // Contact / sensor events (contact_events.hpp): recorded per job thread,
+    // merged into Events<ContactEvent> / Events<TriggerEvent> after each step.
+    std::unique_ptr<ContactRecorder> contact_recorder;
+    ContactTracker                   contact_tracker;
+    std::vector<ContactRecord>       contact_scratch;
+
+    // PhysicsQuerySystem scratch, reused each frame: per-request shapes and
+    // ignored bodies (resolved on the main thread), overlap body IDs.
+    std::vector<JPH::RefConst<JPH::Shape>> query_shapes;
+    std::vector<JPH::BodyID>               query_ignore;
+    std::vector<JPH::BodyID>               query_overlap_ids;
+
+    // CharacterMotorSystem jobs: one temp allocator per concurrent job (the
+    // shared temp_allocator is not thread-safe) and one character-vs-character
+    // set per island. Both grow on demand and are reused each frame.
+    std::vector<std::unique_ptr<JPH::TempAllocatorImpl>>                   character_temp;
+    std::vector<std::unique_ptr<JPH::CharacterVsCharacterCollisionSimple>> character_groups;
+
+    // Capacities and layer table this context was built with (read-only
+    // after construction). Declared before the layer interfaces, which
+    // reference config.layers.
+    PhysicsConfig config;
+
     // Layer interfaces
-    BPLayerInterfaceImpl broad_phase_layer_interface;
-    ObjectVsBroadPhaseLayerFilterImpl object_vs_broadphase_layer_filter;
-    ObjectLayerPairFilterImpl object_layer_pair_filter;
+    BPLayerInterfaceImpl broad_phase_layer_interface{config.layers};
+    ObjectVsBroadPhaseLayerFilterImpl object_vs_broadphase_layer_filter{config.layers};
+    ObjectLayerPairFilterImpl object_layer_pair_filter{config.layers};
+
+    // Layer CharacterMotorSystem collides as: "Character" if the table has
+    // it, else MOVING.
+    JPH::ObjectLayer character_layer = Layers::MOVING;
 
     // Allocator for Jolt (Singleton)
     static void InitJoltAllocator() {
         JPH::RegisterDefaultAllocator();
     }
 
-    PhysicsContext() {
+    // CreateBody failures (body limit reached) since startup
+    uint32_t failed_body_creates = 0;
+
+    explicit PhysicsContext(const PhysicsConfig& cfg = {}) : config(cfg) {
+        if (const uint32_t c = config.layers.find("Character"); c != PhysicsLayers::INVALID)
+            character_layer = static_cast<JPH::ObjectLayer>(c);
+
         // Create Factory
         JPH::Factory::sInstance = new JPH::Factory();
         JPH::RegisterTypes();
 
         // Init Physics System
-        temp_allocator = new JPH::TempAllocatorImpl(10 * 1024 * 1024);
-        job_system = new JPH::JobSystemThreadPool(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, std::thread::hardware_concurrency() - 1);
-        
+        temp_allocator = new TrackingTempAllocator(config.temp_allocator_bytes);
+        const int workers = config.resolved_worker_threads(std::thread::hardware_concurrency());
+        job_system = new JPH::JobSystemThreadPool(JPH::cMaxPhysicsJobs, JPH::cMaxPhysicsBarriers, workers);
+
         physics_system = new JPH::PhysicsSystem();
-        physics_system->Init(1024, 0, 1024, 1024, broad_phase_layer_interface, object_vs_broadphase_layer_filter, object_layer_pair_filter);
+        physics_system->Init(config.max_bodies, config.num_body_mutexes, config.max_body_pairs,
+                             config.max_contact_constraints, broad_phase_layer_interface,
+                             object_vs_broadphase_layer_filter, object_layer_pair_filter);
+        JPH::PhysicsSettings settings = physics_system->GetPhysicsSettings();
+        settings.mAllowSleeping               = config.allow_sleeping;
+        settings.mTimeBeforeSleep             = config.time_before_sleep;
+        settings.mPointVelocitySleepThreshold = config.sleep_velocity;
+        physics_system->SetPhysicsSettings(settings);
+        physics_system->SetBodyActivationListener(&deactivation_recorder);
+        // Job threads plus the thread calling Update.
+        contact_recorder = std::make_unique<ContactRecorder>(static_cast<size_t>(workers) + 1);
+        physics_system->SetContactListener(contact_recorder.get());
+        if (config.async_step) step_thread = std::make_unique<SimThread>();
 
-        std::cout << "Jolt Physics Initialized." << std::endl;
+        std::cout << "Jolt Physics Initialized (max_bodies=" << config.max_bodies
+                  << ", workers=" << workers
+                  << ", layers=" << config.layers.layer_count()
+                  << ", temp=" << (config.temp_allocator_bytes >> 20) << " MB"
+                  << (config.async_step ? ", async step" : "") << ")." << std::endl;
     }
 
     ~PhysicsContext() {
+        step_thread.reset(); // finishes a running step before Jolt goes away
         if (physics_system) delete physics_system;
         if (job_system) delete job_system;
         if (temp_allocator) delete temp_allocator;
@@ -138,6 +400,12 @@ public:
         }
     }
 
+    // ShapeCollider asset from config.shape_dir, cached by name (thread-safe;
+    // the async scene loader warms it from its worker). nullptr if missing.
+    JPH::RefConst<JPH::Shape> named_shape(const std::string& name) {
+        return shapes.named(name, [&] { return ShapeCook::load(config.shape_dir, name); });
+    }
+
     // Helper to optimize body creation
     JPH::BodyInterface& GetBodyInterface() { return physics_system->GetBodyInterface(); }
     const JPH::BodyInterface& GetBodyInterface() const { return physics_system->GetBodyInterface(); }
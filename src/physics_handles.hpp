@@ -22,6 +22,23 @@ namespace MathBridge {
 #endif
 }
 
+// ---------------------------------------------------------------------------
+// Body user data  (entity <-> Jolt body back-link)
+//
+// PhysicsSystem stores the owning entity in BodyCreationSettings::mUserData
+// so walks over Jolt's own lists (active bodies, contacts) can find their
+// entity without a reverse lookup table. Always check world.alive() on the
+// result: a body can outlive its entity until the next batch commit.
+// ---------------------------------------------------------------------------
+namespace BodyUserData {
+    inline JPH::uint64 FromEntity(ecs::Entity e) {
+        return (static_cast<JPH::uint64>(e.generation) << 32) | e.index;
+    }
+    inline ecs::Entity ToEntity(JPH::uint64 data) {
+        return ecs::Entity{static_cast<uint32_t>(data & 0xffffffffu), static_cast<uint32_t>(data >> 32)};
+    }
+}
+
 // ---------------------------------------------------------------------------
 // Physics Runtime Handles (Managed by PhysicsSystem / CharacterMotorSystem)
 // Not data components — opaque links into the Jolt simulation.
@@ -0,0 +1,160 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+
+// ---------------------------------------------------------------------------
+// PhysicsLayers — object layers, their broadphase buckets, and which pairs
+// collide.
+//
+// A layer is a name, a broadphase bucket, and a bitmask of the layers it
+// collides with. The mask is always symmetric. PhysicsContext's Jolt filters
+// answer every test with a single bit lookup in these masks. Names are only
+// resolved when a body is created:
+//
+//   RigidBodyConfig::layer = "Debris"   →   find("Debris")   →   object layer
+//
+// The default table keeps STATIC (0) and MOVING (1) exactly as before, and
+// adds layers that do not test against themselves. Debris and Sensor get
+// their own broadphase buckets:
+//
+//   layer       broadphase   collides with
+//   Static      NON_MOVING   Moving Debris Character Projectile
+//   Moving      MOVING       everything
+//   Debris      DEBRIS       Static Moving Character
+//   Sensor      SENSOR       Moving Projectile
+//   Character   MOVING       Static Moving Debris Projectile
+//   Projectile  MOVING       Static Moving Sensor Character
+//
+// Bodies without a layer name go to Static or Moving by BodyType, as before.
+// CharacterMotorSystem uses Character when the table has it.
+//
+// Scenes replace it with a "layers" block in their physics config (see
+// SceneLoader::physics_config_from_string).
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+class PhysicsLayers {
+public:
+    static constexpr uint32_t MAX_LAYERS     = 32; // one bit each in a uint32_t mask
+    static constexpr uint32_t MAX_BROADPHASE = 8;
+    static constexpr uint32_t INVALID        = ~0u;
+
+    // Fixed indices every table keeps (Layers:: in physics_context.hpp).
+    static constexpr uint32_t STATIC = 0;
+    static constexpr uint32_t MOVING = 1;
+
+    PhysicsLayers() {
+        add_broadphase("NON_MOVING");
+        add_broadphase("MOVING");
+        add_broadphase("DEBRIS");
+        add_broadphase("SENSOR");
+        add_layer("Static",     0);
+        add_layer("Moving",     1);
+        add_layer("Debris",     2);
+        add_layer("Sensor",     3);
+        add_layer("Character",  1);
+        add_layer("Projectile", 1);
+        for (const char* other : {"Moving", "Debris", "Character", "Projectile"}) set_collides("Static", other);
+        for (const char* other : {"Moving", "Debris", "Sensor", "Character", "Projectile"}) set_collides("Moving", other);
+        set_collides("Sensor", "Projectile");
+        set_collides("Character", "Debris");
+        set_collides("Character", "Projectile");
+    }
+
+    // No buckets and no layers, for building a table from scratch.
+    static PhysicsLayers empty() { PhysicsLayers l; l.clear(); return l; }
+
+    void clear() { layer_count_ = 0; broadphase_count_ = 0; }
+
+    // --- Building ----------------------------------------------------------
+
+    // Returns the new bucket's index, or INVALID when full / duplicate.
+    uint32_t add_broadphase(const std::string& name) {
+        if (broadphase_count_ == MAX_BROADPHASE || find_broadphase(name) != INVALID) return INVALID;
+        broadphase_names_[broadphase_count_] = name;
+        return broadphase_count_++;
+    }
+
+    // Returns the new layer's index, or INVALID when full / duplicate / the
+    // bucket does not exist. A new layer collides with nothing.
+    uint32_t add_layer(const std::string& name, uint32_t broadphase) {
+        if (layer_count_ == MAX_LAYERS || broadphase >= broadphase_count_ || find(name) != INVALID)
+            return INVALID;
+        names_[layer_count_]      = name;
+        broadphase_[layer_count_] = static_cast<uint8_t>(broadphase);
+        collides_[layer_count_]   = 0;
+        ++layer_count_;
+        rebuild_broadphase_masks();
+        return layer_count_ - 1;
+    }
+
+    // Sets both directions. False if either name is unknown.
+    bool set_collides(const std::string& a, const std::string& b, bool value = true) {
+        const uint32_t i = find(a), j = find(b);
+        if (i == INVALID || j == INVALID) return false;
+        set_collides(i, j, value);
+        return true;
+    }
+
+    void set_collides(uint32_t a, uint32_t b, bool value = true) {
+        if (value) { collides_[a] |= bit(b);  collides_[b] |= bit(a); }
+        else       { collides_[a] &= ~bit(b); collides_[b] &= ~bit(a); }
+        rebuild_broadphase_masks();
+    }
+
+    // --- Lookup ------------------------------------------------------------
+
+    uint32_t find(const std::string& name) const {
+        for (uint32_t i = 0; i < layer_count_; ++i) if (names_[i] == name) return i;
+        return INVALID;
+    }
+
+    uint32_t find_broadphase(const std::string& name) const {
+        for (uint32_t i = 0; i < broadphase_count_; ++i) if (broadphase_names_[i] == name) return i;
+        return INVALID;
+    }
+
+    uint32_t layer_count()      const { return layer_count_; }
+    uint32_t broadphase_count() const { return broadphase_count_; }
+
+    const std::string& name(uint32_t layer)                const { return names_[layer]; }
+    const std::string& broadphase_name(uint32_t broadphase) const { return broadphase_names_[broadphase]; }
+    uint32_t           broadphase(uint32_t layer)          const { return broadphase_[layer]; }
+    uint32_t           mask(uint32_t layer)                const { return collides_[layer]; }
+
+    // --- Filtering (Jolt filter callbacks; constant time) ------------------
+
+    bool collides(uint32_t a, uint32_t b) const { return (collides_[a] & bit(b)) != 0; }
+
+    // True if `layer` collides with any layer in bucket `broadphase`.
+    bool collides_broadphase(uint32_t layer, uint32_t broadphase) const {
+        return (broadphase_mask_[layer] & (1u << broadphase)) != 0;
+    }
+
+    // A usable table keeps Static and Moving at their fixed indices.
+    bool valid() const {
+        return layer_count_ > MOVING && names_[STATIC] == "Static" && names_[MOVING] == "Moving";
+    }
+
+private:
+    std::array<std::string, MAX_LAYERS>     names_;
+    std::array<uint8_t, MAX_LAYERS>         broadphase_{};
+    std::array<uint32_t, MAX_LAYERS>        collides_{};        // bit j: collides with layer j
+    std::array<uint8_t, MAX_LAYERS>         broadphase_mask_{}; // bit k: collides with a layer in bucket k
+    std::array<std::string, MAX_BROADPHASE> broadphase_names_;
+    uint32_t                                layer_count_      = 0;
+    uint32_t                                broadphase_count_ = 0;
+
+    static uint32_t bit(uint32_t layer) { return 1u << layer; }
+
+    void rebuild_broadphase_masks() {
+        for (uint32_t i = 0; i < layer_count_; ++i) {
+            uint8_t m = 0;
+            for (uint32_t j = 0; j < layer_count_; ++j)
+                if (collides_[i] & bit(j)) m |= static_cast<uint8_t>(1u << broadphase_[j]);
+            broadphase_mask_[i] = m;
+        }
+    }
+};
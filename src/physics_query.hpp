@@ -0,0 +1,178 @@
+#pragma once
+#include <ecs/ecs.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// PhysicsQuery — batched raycasts, shape casts and overlaps for gameplay.
+//
+// Systems submit requests during Logic and keep the returned Id:
+//
+//   auto id = query.ray(origin, dir, QueryLayers::StaticOnly);
+//
+// PhysicsQuerySystem (systems/physics_query.cpp, installed by
+// PhysicsModule::install_queries right before CharMotor) takes everything
+// submitted so far, runs it in parallel batches on Jolt's job system, and
+// writes each result into the slot next to its request. From then until the
+// next execute (one frame), status(id) is Done and hit(id) / overlaps(id)
+// return the result; after that it is Expired. Systems that run before the
+// executor therefore read their answer on the next frame, and systems after
+// it have theirs queued for the next frame's batch.
+//
+// Filters are shared values (QueryLayers plus an entity to ignore), mapped to
+// reusable Jolt filter objects by the executor, not constructed per query.
+//
+// Stored as a World resource. No Jolt or Raylib dependency — compilable in
+// the headless test target.
+// ---------------------------------------------------------------------------
+
+enum class QueryLayers : uint8_t { All, StaticOnly, MovingOnly }; // MovingOnly: every layer but Static
+enum class QueryShape  : uint8_t { Sphere, Box };
+enum class QueryStatus : uint8_t { Pending, Done, Expired };
+
+struct QueryHit {
+    bool        hit      = false;
+    float       fraction = 1.0f;   // along the ray / sweep, in [0, 1]
+    ecs::Vec3   point{};
+    ecs::Vec3   normal{};          // surface normal at the hit, away from the body
+    ecs::Entity entity{};          // check world.alive(): bodies can outlive entities
+};
+
+class PhysicsQuery {
+public:
+    struct Id {
+        uint32_t batch = 0;        // 0 = never submitted
+        uint32_t index = 0;
+        bool valid() const { return batch != 0; }
+    };
+
+    struct Request {
+        enum class Kind : uint8_t { Ray, Cast, Overlap };
+        Kind        kind   = Kind::Ray;
+        QueryShape  shape  = QueryShape::Sphere;
+        QueryLayers layers = QueryLayers::All;
+        ecs::Vec3   origin{};      // ray start / shape centre
+        ecs::Vec3   direction{};   // ray / sweep: full length, not normalised
+        ecs::Vec3   extents{};     // sphere: x = radius; box: half extents
+        ecs::Entity ignore{};      // its RigidBodyHandle body is skipped
+        uint32_t    max_hits   = 0;    // overlap
+        uint32_t    first_hit  = 0;    // overlap: offset into the entity list
+    };
+
+    struct Slot {
+        Request  request;
+        QueryHit result;           // ray / cast
+        uint32_t hit_count = 0;    // overlap: entities written from first_hit
+    };
+
+    static constexpr uint32_t DEFAULT_MAX_OVERLAPS = 16;
+
+    // --- Submission (Logic) ------------------------------------------------
+
+    Id ray(const ecs::Vec3& origin, const ecs::Vec3& direction,
+           QueryLayers layers = QueryLayers::All, ecs::Entity ignore = {}) {
+        Request r;
+        r.kind      = Request::Kind::Ray;
+        r.layers    = layers;
+        r.origin    = origin;
+        r.direction = direction;
+        r.ignore    = ignore;
+        return submit(r);
+    }
+
+    Id cast(QueryShape shape, const ecs::Vec3& extents, const ecs::Vec3& origin,
+            const ecs::Vec3& direction, QueryLayers layers = QueryLayers::All, ecs::Entity ignore = {}) {
+        Request r;
+        r.kind      = Request::Kind::Cast;
+        r.shape     = shape;
+        r.extents   = extents;
+        r.layers    = layers;
+        r.origin    = origin;
+        r.direction = direction;
+        r.ignore    = ignore;
+        return submit(r);
+    }
+
+    Id overlap(QueryShape shape, const ecs::Vec3& extents, const ecs::Vec3& centre,
+               QueryLayers layers = QueryLayers::All, ecs::Entity ignore = {},
+               uint32_t max_hits = DEFAULT_MAX_OVERLAPS) {
+        Request r;
+        r.kind      = Request::Kind::Overlap;
+        r.shape     = shape;
+        r.extents   = extents;
+        r.layers    = layers;
+        r.origin    = centre;
+        r.ignore    = ignore;
+        r.max_hits  = max_hits;
+        r.first_hit = pending_hits_;
+        pending_hits_ += max_hits;
+        return submit(r);
+    }
+
+    // --- Results -----------------------------------------------------------
+
+    QueryStatus status(Id id) const {
+        if (id.batch == pending_batch_) return QueryStatus::Pending;
+        if (id.batch == done_batch_ && id.index < done_.size()) return QueryStatus::Done;
+        return QueryStatus::Expired;
+    }
+
+    // Ray / cast result, or nullptr unless status(id) is Done.
+    const QueryHit* hit(Id id) const {
+        return status(id) == QueryStatus::Done ? &done_[id.index].result : nullptr;
+    }
+
+    // Entities overlapping an overlap request (sorted, unique, at most
+    // max_hits), or an empty range unless status(id) is Done.
+    struct Range {
+        const ecs::Entity* first = nullptr;
+        const ecs::Entity* last  = nullptr;
+        const ecs::Entity* begin() const { return first; }
+        const ecs::Entity* end()   const { return last; }
+        size_t size() const { return static_cast<size_t>(last - first); }
+        bool   empty() const { return first == last; }
+    };
+    Range overlaps(Id id) const {
+        if (status(id) != QueryStatus::Done) return {};
+        const Slot& s = done_[id.index];
+        const ecs::Entity* p = done_hits_.data() + s.request.first_hit;
+        return {p, p + s.hit_count};
+    }
+
+    // --- Execution (PhysicsQuerySystem) ------------------------------------
+
+    // Makes everything submitted so far the current batch, dropping the
+    // previous one's results, and returns its slots for the executor to
+    // fill. Later submissions go to the next batch.
+    std::vector<Slot>& begin_execute() {
+        done_.swap(pending_);
+        pending_.clear();
+        done_hits_.assign(pending_hits_, ecs::Entity{});
+        pending_hits_  = 0;
+        done_batch_    = pending_batch_;
+        pending_batch_ = pending_batch_ + 1 == 0 ? 1 : pending_batch_ + 1; // 0 stays "never"
+        return done_;
+    }
+
+    // Overlap output, sized by begin_execute().
+    ecs::Entity* hit_buffer() { return done_hits_.data(); }
+
+    size_t pending()  const { return pending_.size(); }
+    size_t executed() const { return done_.size(); }  // in the current batch
+
+private:
+    std::vector<Slot>        pending_;
+    std::vector<Slot>        done_;
+    std::vector<ecs::Entity> done_hits_;
+    uint32_t                 pending_hits_  = 0;
+    uint32_t                 pending_batch_ = 1;
+    uint32_t                 done_batch_    = 0;
+
+    Id submit(const Request& r) {
+        Slot s;
+        s.request = r;
+        pending_.push_back(s);
+        return {pending_batch_, static_cast<uint32_t>(pending_.size() - 1)};
+    }
+};
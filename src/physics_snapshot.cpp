@@ -0,0 +1,104 @@
+#include "physics_snapshot.hpp"
+#include "deferred_commands.hpp"
+#include "physics_context.hpp"
+#include "systems/physics.hpp"
+#include <algorithm>
+#include <iostream>
+#include <memory>
+
+namespace {
+
+bool entity_less(ecs::Entity a, ecs::Entity b) {
+    return a.index != b.index ? a.index < b.index : a.generation < b.generation;
+}
+
+} // namespace
+
+bool PhysicsSnapshot::capture(ecs::World& world) {
+    auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+    if (!ctx_ptr || !*ctx_ptr) return false;
+    auto& ctx = **ctx_ptr;
+
+    // SaveState only records bodies in the broadphase.
+    DeferredCommands::flush_all(world);
+    PhysicsSystem::CommitPendingBodies(world, false);
+
+    clear();
+    ctx.physics_system->SaveState(state_);
+
+    world.each<RigidBodyHandle>([&](ecs::Entity e, RigidBodyHandle& h) { bodies_.push_back({e, h.id}); });
+    std::sort(bodies_.begin(), bodies_.end(), [](const Body& a, const Body& b) { return entity_less(a.entity, b.entity); });
+
+    world.each<CharacterHandle>([&](ecs::Entity e, CharacterHandle& h) {
+        if (!h.character) return;
+        h.character->SaveState(state_);
+        characters_.push_back({e, h.character.get()});
+    });
+
+    components_.capture(world);
+    contacts_ = ctx.contact_tracker;
+    bytes_    = state_.GetData().size();
+    valid_    = !state_.IsFailed();
+    return valid_;
+}
+
+bool PhysicsSnapshot::restore(ecs::World& world) {
+    if (!valid_) return false;
+    auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+    if (!ctx_ptr || !*ctx_ptr) return false;
+    auto& ctx = **ctx_ptr;
+
+    DeferredCommands::flush_all(world);
+
+    // Every captured body and character must still be the same object.
+    for (const Body& b : bodies_) {
+        auto* h = world.alive(b.entity) ? world.try_get<RigidBodyHandle>(b.entity) : nullptr;
+        if (!h || h->id != b.id) return false;
+    }
+    for (const Character& c : characters_) {
+        auto* h = world.alive(c.entity) ? world.try_get<CharacterHandle>(c.entity) : nullptr;
+        if (!h || h->character.get() != c.character) return false;
+    }
+
+    // Bodies and characters made since the capture did not exist then.
+    auto captured = [&](ecs::Entity e) {
+        auto it = std::lower_bound(bodies_.begin(), bodies_.end(), e,
+                                   [](const Body& b, ecs::Entity x) { return entity_less(b.entity, x); });
+        if (it != bodies_.end() && it->entity == e) return true;
+        return std::any_of(characters_.begin(), characters_.end(), [&](const Character& c) { return c.entity == e; });
+    };
+    std::vector<ecs::Entity> newer;
+    world.each<RigidBodyHandle>([&](ecs::Entity e, RigidBodyHandle&) { if (!captured(e)) newer.push_back(e); });
+    world.each<CharacterHandle>([&](ecs::Entity e, CharacterHandle&) { if (!captured(e)) newer.push_back(e); });
+    for (ecs::Entity e : newer)
+        if (world.alive(e)) world.destroy(e);
+    PhysicsSystem::CommitPendingBodies(world, false);
+
+    // Same order as capture: the PhysicsSystem, then each character.
+    state_.Rewind();
+    bool ok = ctx.physics_system->RestoreState(state_);
+    for (const Character& c : characters_)
+        c.character->RestoreState(state_);
+    ok = ok && !state_.IsFailed();
+    if (!ok) {
+        // Cannot happen for a consistent capture; Jolt may have applied part
+        // of it, so drop the snapshot rather than trust it again.
+        std::cerr << "PhysicsSnapshot: restore failed; reload the scene." << std::endl;
+        valid_ = false;
+        return false;
+    }
+
+    components_.restore(world);
+    ctx.contact_tracker = contacts_;
+    return true;
+}
+
+void PhysicsSnapshot::clear() {
+    state_.Clear();
+    bodies_.clear();
+    characters_.clear();
+    components_.clear();
+    contacts_.clear();
+    bytes_ = 0;
+    valid_ = false;
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include "component_snapshot.hpp"
+#include "components.hpp"
+#include "contact_events.hpp"
+#include "physics_handles.hpp"
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/StateRecorderImpl.h>
+#include <ecs/ecs.hpp>
+#include <ecs/modules/transform.hpp>
+#include <cstddef>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// PhysicsSnapshot — the whole simulation at one instant, restorable in place.
+//
+// capture() commits pending bodies, then records:
+// - Jolt's state (PhysicsSystem::SaveState: bodies, velocities, sleep state,
+//   contact cache) and each CharacterVirtual's SaveState, into one
+//   StateRecorderImpl.
+// - The ECS state the simulation feeds or reads (Components below), plus the
+//   open ContactTracker pairs.
+// - Which entity owned which body and character.
+//
+// restore() writes all of that back over the live bodies. Nothing is
+// destroyed or re-created except bodies made after the capture (builder
+// platforms), which are destroyed so the reset point is exact. If any
+// captured body or character has since gone, restore() returns false and
+// changes nothing. The caller then reloads the scene, which is what
+// main.cpp's R does.
+//
+// Main thread, between frames (no step or deferred flush running).
+// PhysicsModule creates one as a world resource (std::shared_ptr).
+// ---------------------------------------------------------------------------
+
+class PhysicsSnapshot {
+public:
+    using Components = ComponentSnapshot<ecs::LocalTransform, ecs::WorldTransform, TransformHistory,
+                                         CharacterIntent, CharacterState, PlayerState>;
+
+    // False without a PhysicsContext.
+    bool capture(ecs::World& world);
+
+    // False (world untouched) if nothing was captured or a captured body or
+    // character is gone or was replaced.
+    bool restore(ecs::World& world);
+
+    bool   valid() const { return valid_; }
+    size_t bytes() const { return bytes_; }
+    size_t bodies() const { return bodies_.size(); }
+    void   clear();
+
+private:
+    struct Body {
+        ecs::Entity entity;
+        JPH::BodyID id;
+    };
+    struct Character {
+        ecs::Entity            entity;
+        JPH::CharacterVirtual* character;
+    };
+
+    JPH::StateRecorderImpl state_;
+    std::vector<Body>      bodies_;     // sorted by entity index
+    std::vector<Character> characters_; // in SaveState order
+    Components             components_;
+    ContactTracker         contacts_;
+    size_t                 bytes_ = 0;
+    bool                   valid_ = false;
+};
@@ -0,0 +1,103 @@
+#pragma once
+#include "contact_events.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// PhysicsStats — body, island and contact counts after the last step.
+//
+// Jolt does not expose its island builder or broadphase pair list, so
+// BodyIslands rebuilds the same grouping from what the step reports: the
+// awake bodies (its active list) and the ContactRecorder records of the
+// solid pairs touching this step. Two awake bodies in contact share an
+// island; static and sleeping bodies join nothing, so a pile resting on the
+// floor is one island and a pile that has gone to sleep is none. Jolt's
+// constraint links are not seen (the demo creates no constraints).
+//
+// PhysicsSystem fills PhysicsContext::stats on the main thread after each
+// step (apply half), before the records turn into events. The body counts
+// come from what the gather half read out of Jolt, so the debug panel reads
+// this snapshot and never Jolt itself (an async step may be running).
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+struct PhysicsStats {
+    uint32_t bodies         = 0; // in the PhysicsSystem, any motion type
+    uint32_t active_bodies  = 0; // awake after the step (dynamic + kinematic)
+    uint32_t dynamic_bodies = 0; // in the PhysicsSystem
+    uint32_t dynamic_asleep = 0; // ...of which not awake
+    uint32_t islands        = 0; // groups of awake bodies in contact
+    uint32_t largest_island = 0; // bodies in the biggest one
+    uint32_t contact_pairs  = 0; // solid body pairs touching this step
+    uint32_t sensor_pairs   = 0; // ...and pairs with a sensor
+    uint32_t fell_asleep    = 0; // bodies deactivated during the step
+    uint32_t auto_ccd       = 0; // MotionQuality::Auto bodies
+    uint32_t auto_ccd_cast  = 0; // ...currently LinearCast
+};
+
+class BodyIslands {
+public:
+    // Groups `active` (BodyID values, any order) by the solid Added /
+    // Persisted records in `records`, writing islands, largest_island,
+    // contact_pairs and sensor_pairs into stats. Scratch is reused.
+    void build(const std::vector<uint32_t>& active, const std::vector<ContactRecord>& records,
+               PhysicsStats& stats) {
+        ids_.assign(active.begin(), active.end());
+        std::sort(ids_.begin(), ids_.end());
+        parent_.resize(ids_.size());
+        size_.assign(ids_.size(), 1);
+        for (uint32_t i = 0; i < parent_.size(); ++i) parent_[i] = i;
+
+        pairs_.clear();
+        sensors_.clear();
+        for (const ContactRecord& r : records) {
+            if (r.type == ContactRecord::Type::Removed) continue;
+            (r.sensor ? sensors_ : pairs_).push_back(r.key());
+            if (r.sensor) continue;
+            const uint32_t a = index(r.body_a), b = index(r.body_b);
+            if (a != NONE && b != NONE) unite(a, b);
+        }
+        stats.contact_pairs = unique_count(pairs_);
+        stats.sensor_pairs  = unique_count(sensors_);
+
+        stats.islands = stats.largest_island = 0;
+        for (uint32_t i = 0; i < parent_.size(); ++i) {
+            if (parent_[i] != i) continue;
+            ++stats.islands;
+            stats.largest_island = std::max(stats.largest_island, size_[i]);
+        }
+    }
+
+private:
+    static constexpr uint32_t NONE = ~0u;
+
+    std::vector<uint32_t> ids_, parent_, size_;
+    std::vector<uint64_t> pairs_, sensors_;
+
+    uint32_t index(uint32_t id) const {
+        auto it = std::lower_bound(ids_.begin(), ids_.end(), id);
+        return it != ids_.end() && *it == id ? static_cast<uint32_t>(it - ids_.begin()) : NONE;
+    }
+
+    uint32_t root(uint32_t i) {
+        while (parent_[i] != i) i = parent_[i] = parent_[parent_[i]];
+        return i;
+    }
+
+    void unite(uint32_t a, uint32_t b) {
+        a = root(a);
+        b = root(b);
+        if (a == b) return;
+        if (size_[a] < size_[b]) std::swap(a, b);
+        parent_[b] = a;
+        size_[a] += size_[b];
+    }
+
+    static uint32_t unique_count(std::vector<uint64_t>& keys) {
+        std::sort(keys.begin(), keys.end());
+        return static_cast<uint32_t>(std::unique(keys.begin(), keys.end()) - keys.begin());
+    }
+};
@@ -1,61 +1,416 @@
 #pragma once
+#include "deferred_commands.hpp"
+#include "fixed_time.hpp"
+#include "frame_profiler.hpp"
+#include "pipeline_step.hpp"
+#include "system_access.hpp"
+#include "task_pool.hpp"
 #include <ecs/ecs.hpp>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
 #include <vector>
 #include <functional>
+#include <string>
+#include <thread>
+#include <utility>
 
 namespace ecs {
 
 /**
  * @brief Manages groups of systems categorized by execution phase.
+ *
+ * Systems may be registered with a name; unnamed systems are labelled
+ * "<Phase> #<index>". When a FrameProfiler resource exists, every system
+ * call is timed and reported to it under that name (see frame_profiler.hpp).
+ *
+ * Systems may also declare an Access (system_access.hpp). Within a phase,
+ * every system depends on each earlier one it conflicts with; systems
+ * without an Access conflict with everything, so install order stays the
+ * execution order wherever it matters. With set_threads(n > 1), each phase
+ * runs as that dependency graph on a work-stealing TaskPool, and the caller
+ * joins in. Otherwise, or while the graph has no independent systems, the
+ * systems run one after another in install order.
+ *
+ * The ECS fills its query cache lazily (not thread-safe), so a phase also
+ * runs serially on its first frame and whenever the entity count or
+ * DeferredCommands::edits() has changed since it last started. That catches
+ * new archetypes from spawns, and from components added or removed through
+ * a flush. A system that adds or removes components directly reports it
+ * with DeferredCommands::note_edits(). After other structural edits outside
+ * the Pipeline, call serialize_next_frame().
+ *
+ * Each system also gets a CommandLane of its own (deferred_commands.hpp),
+ * current while it runs, so systems queueing structural changes through
+ * DeferredCommands::local() need not declare Access::Deferred or run in
+ * turn. Both flushes in logic() apply world.deferred() and then every lane
+ * in install order, and skip the flush when nothing is queued.
+ *
+ * Systems whose Access is on_main_thread() run on the thread that constructed
+ * the Pipeline; a phase holding one asserts it is called from there. When
+ * logic() runs elsewhere (the pipelined render mode's simulation thread),
+ * defer_main_thread() leaves those Logic systems out of logic(), and the
+ * main thread runs them with main_thread_logic().
+ *
+ * add<Step>() takes a system described by a type (pipeline_step.hpp): its
+ * name, phase and Access come from the type, and a step's declared `after`
+ * order is checked at compile time. A StaticPipeline (static_pipeline.hpp)
+ * runs a fixed list of such steps with direct calls; this class stays the
+ * runtime-configurable one.
  */
 class Pipeline {
 public:
     using SystemFunc = std::function<void(World&, float)>;
 
-    void add_pre_update(SystemFunc func) { pre_update_.push_back(func); }
-    void add_logic(SystemFunc func) { logic_.push_back(func); }
-    void add_physics(SystemFunc func) { physics_.push_back(func); }
-    void add_render(SystemFunc func) { render_.push_back(func); }
+    void add_pre_update(SystemFunc func) { add(pre_update_, FrameProfiler::PreUpdate, {}, Access::all(), std::move(func)); }
+    void add_logic(SystemFunc func)      { add(logic_,      FrameProfiler::Logic,     {}, Access::all(), std::move(func)); }
+    void add_physics(SystemFunc func)    { add(physics_,    FrameProfiler::Physics,   {}, Access::all(), std::move(func)); }
+    void add_render(SystemFunc func)     { add(render_,     FrameProfiler::Render,    {}, Access::all(), std::move(func)); }
+
+    void add_pre_update(std::string name, SystemFunc func) { add(pre_update_, FrameProfiler::PreUpdate, std::move(name), Access::all(), std::move(func)); }
+    void add_logic(std::string name, SystemFunc func)      { add(logic_,      FrameProfiler::Logic,     std::move(name), Access::all(), std::move(func)); }
+    void add_physics(std::string name, SystemFunc func)    { add(physics_,    FrameProfiler::Physics,   std::move(name), Access::all(), std::move(func)); }
+    void add_render(std::string name, SystemFunc func)     { add(render_,     FrameProfiler::Render,    std::move(name), Access::all(), std::move(func)); }
+
+    void add_pre_update(std::string name, Access access, SystemFunc func) { add(pre_update_, FrameProfiler::PreUpdate, std::move(name), std::move(access), std::move(func)); }
+    void add_logic(std::string name, Access access, SystemFunc func)      { add(logic_,      FrameProfiler::Logic,     std::move(name), std::move(access), std::move(func)); }
+    void add_physics(std::string name, Access access, SystemFunc func)    { add(physics_,    FrameProfiler::Physics,   std::move(name), std::move(access), std::move(func)); }
+    void add_render(std::string name, Access access, SystemFunc func)     { add(render_,     FrameProfiler::Render,    std::move(name), std::move(access), std::move(func)); }
+
+    template <PipelineStep S> void add() {
+        static_assert(S::phase >= FrameProfiler::PreUpdate && S::phase < FrameProfiler::PhaseCount,
+                      "step phase must be a FrameProfiler::Phase");
+        static_assert(StepAfterEnforced<S>::value,
+                      "a step listed in `after` shares no data with this step, so a threaded Pipeline may reorder them");
+        add(phase_of(S::phase), S::phase, S::name, step_access<S>(), [](World& w, float dt) { S::run(w, dt); });
+    }
+
+    /**
+     * @brief The names of a phase's systems in install order (tooling, and
+     * StaticPipeline::mirrors).
+     */
+    std::vector<std::string> names(int phase) const {
+        std::vector<std::string> out;
+        for (const System& sys : phase_of(phase).systems) out.push_back(sys.name);
+        return out;
+    }
+
+    /**
+     * @brief Sets how many threads run independent systems, counting the
+     * caller. 0 or 1 runs every phase serially (the default).
+     */
+    void set_threads(size_t threads) {
+        pool_.reset();
+        if (threads > 1) pool_ = std::make_unique<TaskPool>(threads - 1);
+    }
+
+    size_t threads() const { return pool_ ? pool_->workers() + 1 : 1; }
+
+    /**
+     * @brief Forces every phase to run serially once, so the ECS query cache
+     * is refilled single-threaded after structural changes made outside the
+     * pipeline.
+     */
+    void serialize_next_frame() {
+        for (Phase* ph : {&pre_update_, &logic_, &physics_, &render_}) ph->stamp = NO_STAMP;
+    }
 
     /**
-     * @brief Executes the standard update flow.
+     * @brief With `on`, logic() skips the Logic systems marked
+     * on_main_thread(); main_thread_logic() runs them instead. For callers
+     * that run logic() off the main thread.
+     */
+    void defer_main_thread(bool on) { defer_main_ = on; }
+
+    /**
+     * @brief Runs the Logic systems deferred by defer_main_thread(), in
+     * install order, on the main thread, then a deferred flush. Call it once
+     * logic() has returned (they see its results, including this frame's
+     * events) and before the next pre_update().
+     */
+    void main_thread_logic(World& world, float dt) {
+        if (!defer_main_) return;
+        assert(std::this_thread::get_id() == main_thread_ && "main_thread_logic() runs on the main thread");
+        Phase& ph = logic_;
+        if (!ph.built) build(ph);
+        ph.commands = &DeferredCommands::of(world);
+        ph.commands->reserve(lanes_);
+        run_serial(ph, world, dt, Only::MainThread);
+        flush_deferred(world, flush_slot_);
+    }
+
+    /**
+     * @brief Executes the standard update flow: pre_update() then logic().
      */
     void update(World& world, float dt) {
-        // 1. Input / Pre-processing
-        for (auto& sys : pre_update_) sys(world, dt);
-        
+        pre_update(world, dt);
+        logic(world, dt);
+    }
+
+    /**
+     * @brief Starts a profiler frame and runs the Pre-Update systems (input,
+     * scene commits). The pipelined render mode calls this on the main
+     * thread and logic() on the simulation thread.
+     */
+    void pre_update(World& world, float dt) {
+        if (auto* prof = world.try_resource<FrameProfiler>()) prof->begin_frame();
+        run(pre_update_, world, dt);
+    }
+
+    /**
+     * @brief Runs the Logic systems and both deferred flushes.
+     */
+    void logic(World& world, float dt) {
         // 2. Gameplay Logic
-        for (auto& sys : logic_) sys(world, dt);
+        run(logic_, world, dt);
 
         // 3. Sync structural changes (e.g. spawned platforms) before physics
-        world.deferred().flush(world);
+        flush_deferred(world, flush_slot_);
 
         // 4. Simulation (Note: In fixed-step mode, this is called separately)
         // for (auto& sys : physics_) sys(world, dt);
 
         // 5. Cleanup / Sync structural changes before rendering
-        world.deferred().flush(world);
+        flush_deferred(world, flush_slot_);
     }
 
     /**
      * @brief Executes only the physics/simulation systems.
      */
     void step_physics(World& world, float dt) {
-        for (auto& sys : physics_) sys(world, dt);
+        run(physics_, world, dt);
+    }
+
+    /**
+     * @brief Runs the physics systems on the fixed timestep held in the
+     * FixedTime resource (created with defaults if missing).
+     *
+     * Steps due this frame are clamped to FixedTime::max_steps. With
+     * fold_substeps, they run as one call of dt * n and collision_steps = n;
+     * otherwise as n calls of fixed_dt. Returns the number of fixed steps.
+     */
+    int step_fixed(World& world, float frame_dt) {
+        return run_fixed(world, frame_dt, [&](float dt) { step_physics(world, dt); });
     }
 
     /**
      * @brief Executes rendering systems.
      */
     void render(World& world) {
-        for (auto& sys : render_) sys(world, 0.0f);
+        run(render_, world, 0.0f);
+    }
+
+    /**
+     * @brief step_fixed() for any physics runner: calls `step(dt)` once per
+     * due step, or once folded. Shared with StaticPipeline.
+     */
+    template <typename StepFn> static int run_fixed(World& world, float frame_dt, StepFn&& step) {
+        if (!world.try_resource<FixedTime>()) world.set_resource(FixedTime{});
+        auto& ft = world.resource<FixedTime>();
+        const int   steps    = ft.advance(frame_dt);
+        const float fixed_dt = ft.fixed_dt;
+        if (auto* prof = world.try_resource<FrameProfiler>()) prof->note_steps(steps);
+        if (steps == 0) return 0;
+
+        if (ft.fold_substeps && steps > 1) {
+            ft.collision_steps = steps;
+            step(fixed_dt * static_cast<float>(steps));
+            world.resource<FixedTime>().collision_steps = 1;
+        } else {
+            for (int i = 0; i < steps; ++i) step(fixed_dt);
+        }
+        return steps;
+    }
+
+    /**
+     * @brief A deferred flush point: world.deferred(), then every
+     * CommandLane. Skipped, and not recorded, when nothing is queued. Both
+     * flushes of logic() accumulate into one Logic-phase "Deferred Flush"
+     * entry, since deferred spawns (platforms, scene entities) land here;
+     * `slot` caches it. What it applies counts in DeferredCommands::edits(),
+     * so the phases run serially next time. Shared with StaticPipeline.
+     */
+    static void flush_deferred(World& world, int& slot) {
+        DeferredCommands& cmds   = DeferredCommands::of(world);
+        const bool        lanes  = cmds.queued() > 0;
+        const bool        shared = DeferredCommands::shared_pending(world);
+        if (!lanes && !shared) return;
+
+        const auto t0 = FrameProfiler::Clock::now();
+        if (shared) DeferredCommands::flush_shared(world, cmds);
+        if (lanes)  cmds.flush(world);
+        if (auto* prof = world.try_resource<FrameProfiler>()) {
+            if (slot < 0) slot = prof->slot("Deferred Flush", FrameProfiler::Logic);
+            prof->record(slot, t0, FrameProfiler::Clock::now());
+        }
     }
 
 private:
-    std::vector<SystemFunc> pre_update_;
-    std::vector<SystemFunc> logic_;
-    std::vector<SystemFunc> physics_;
-    std::vector<SystemFunc> render_;
+    struct System {
+        std::string name;
+        int         phase;
+        SystemFunc  fn;
+        Access      access;
+        size_t      lane = 0;  // DeferredCommands lane
+        int         slot = -1; // FrameProfiler slot, resolved on first timed call
+        FrameProfiler::Clock::time_point t0{}, t1{}; // last call, for a parallel run
+    };
+
+    static constexpr size_t NO_STAMP = SIZE_MAX;
+
+    // A phase's systems and the dependency graph built from their Accesses.
+    struct Phase {
+        std::vector<System>                      systems;
+        std::vector<std::vector<uint32_t>>       next;    // successors of each system
+        std::vector<uint32_t>                    preds;   // predecessor counts
+        std::unique_ptr<std::atomic<uint32_t>[]> pending; // preds left this run
+        std::atomic<uint32_t>                    finished{0};
+        bool                                     built    = false;
+        bool                                     parallel = false; // some pair may overlap
+        bool                                     has_main = false; // some system is on_main_thread()
+        bool                                     skip_main = false; // this run leaves those out
+        size_t                                   stamp    = NO_STAMP; // world.count() as the last run started
+        uint64_t                                 edits    = 0;        // DeferredCommands::edits() then
+
+        // Per-run context for the pool tasks.
+        World*            world    = nullptr;
+        float             dt       = 0.0f;
+        TaskPool*         pool     = nullptr;
+        DeferredCommands* commands = nullptr;
+    };
+
+    Phase                     pre_update_;
+    Phase                     logic_;
+    Phase                     physics_;
+    Phase                     render_;
+    std::unique_ptr<TaskPool> pool_;
+    int                       flush_slot_  = -1;
+    size_t                    lanes_       = 1; // lane 0 is for code outside any system
+    std::thread::id           main_thread_ = std::this_thread::get_id();
+    bool                      defer_main_  = false;
+
+    // Which of a phase's systems a serial run calls.
+    enum class Only { All, OffMainThread, MainThread };
+
+    Phase& phase_of(int phase) {
+        switch (phase) {
+            case FrameProfiler::PreUpdate: return pre_update_;
+            case FrameProfiler::Logic:     return logic_;
+            case FrameProfiler::Physics:   return physics_;
+            default:                       return render_;
+        }
+    }
+    const Phase& phase_of(int phase) const { return const_cast<Pipeline*>(this)->phase_of(phase); }
+
+    void add(Phase& ph, int phase, std::string name, Access access, SystemFunc func) {
+        if (name.empty())
+            name = std::string(FrameProfiler::phase_name(phase)) + " #" + std::to_string(ph.systems.size());
+        ph.systems.push_back({std::move(name), phase, std::move(func), std::move(access), lanes_++});
+        ph.built = false;
+    }
+
+    static void build(Phase& ph) {
+        const size_t n = ph.systems.size();
+        ph.next.assign(n, {});
+        ph.preds.assign(n, 0);
+        ph.pending  = std::make_unique<std::atomic<uint32_t>[]>(n);
+        ph.parallel = false;
+        ph.has_main = false;
+        for (size_t i = 0; i < n; ++i) {
+            ph.has_main = ph.has_main || ph.systems[i].access.main_thread;
+            for (size_t j = 0; j < i; ++j) {
+                if (ph.systems[j].access.conflicts(ph.systems[i].access)) {
+                    ph.next[j].push_back(static_cast<uint32_t>(i));
+                    ++ph.preds[i];
+                } else {
+                    ph.parallel = true;
+                }
+            }
+        }
+        ph.built = true;
+        ph.stamp = NO_STAMP;
+    }
+
+    void run(Phase& ph, World& world, float dt) {
+        if (!ph.built) build(ph);
+        ph.skip_main = defer_main_ && &ph == &logic_;
+        assert((!ph.has_main || ph.skip_main || std::this_thread::get_id() == main_thread_)
+               && "a phase with on_main_thread() systems runs on the thread that built the Pipeline");
+        ph.commands = &DeferredCommands::of(world);
+        ph.commands->reserve(lanes_);
+        // Stamped before the run: a structural change made during it makes
+        // the next run serial too.
+        const size_t   count = world.count();
+        const uint64_t edits = ph.commands->edits();
+        const bool     fresh = ph.stamp == count && ph.edits == edits;
+        ph.stamp = count;
+        ph.edits = edits;
+        if (pool_ && ph.parallel && fresh) run_parallel(ph, world, dt);
+        else run_serial(ph, world, dt, ph.skip_main ? Only::OffMainThread : Only::All);
+    }
+
+    static void run_serial(Phase& ph, World& world, float dt, Only only) {
+        for (auto& sys : ph.systems) {
+            if (only != Only::All && sys.access.main_thread != (only == Only::MainThread)) continue;
+            const DeferredCommands::Scope lane(&ph.commands->lane(sys.lane));
+            if (!world.try_resource<FrameProfiler>()) {
+                sys.fn(world, dt);
+                continue;
+            }
+            const auto t0 = FrameProfiler::Clock::now();
+            sys.fn(world, dt);
+            const auto t1 = FrameProfiler::Clock::now();
+            // Re-fetch: the system may have added resources.
+            if (auto* prof = world.try_resource<FrameProfiler>()) {
+                if (sys.slot < 0) sys.slot = prof->slot(sys.name, sys.phase);
+                prof->record(sys.slot, t0, t1);
+            }
+        }
+    }
+
+    // Systems are released to the pool as their last predecessor finishes.
+    // Timings are kept per system and reported from the caller afterwards,
+    // since FrameProfiler is single-threaded.
+    void run_parallel(Phase& ph, World& world, float dt) {
+        const uint32_t n = static_cast<uint32_t>(ph.systems.size());
+        ph.world = &world;
+        ph.dt    = dt;
+        ph.pool  = pool_.get();
+        ph.finished.store(0, std::memory_order_relaxed);
+        for (uint32_t i = 0; i < n; ++i) ph.pending[i].store(ph.preds[i], std::memory_order_relaxed);
+        for (uint32_t i = 0; i < n; ++i)
+            if (ph.preds[i] == 0) dispatch(ph, i);
+        pool_->run_until([&] { return ph.finished.load(std::memory_order_acquire) == n; });
+
+        if (auto* prof = world.try_resource<FrameProfiler>()) {
+            for (auto& sys : ph.systems) {
+                if (ph.skip_main && sys.access.main_thread) continue;
+                if (sys.slot < 0) sys.slot = prof->slot(sys.name, sys.phase);
+                prof->record(sys.slot, sys.t0, sys.t1);
+            }
+        }
+    }
+
+    static void dispatch(Phase& ph, uint32_t i) {
+        const TaskPool::Task task{&run_task, &ph, i};
+        if (ph.systems[i].access.main_thread && !ph.skip_main) ph.pool->push_main(task);
+        else                                  ph.pool->push(task);
+    }
+
+    static void run_task(void* ctx, uint32_t i) {
+        Phase& ph  = *static_cast<Phase*>(ctx);
+        System& sys = ph.systems[i];
+        sys.t0 = FrameProfiler::Clock::now();
+        if (!(ph.skip_main && sys.access.main_thread)) { // deferred: release its successors only
+            const DeferredCommands::Scope lane(&ph.commands->lane(sys.lane));
+            sys.fn(*ph.world, ph.dt);
+        }
+        sys.t1 = FrameProfiler::Clock::now();
+        for (uint32_t s : ph.next[i])
+            if (ph.pending[s].fetch_sub(1, std::memory_order_acq_rel) == 1) dispatch(ph, s);
+        ph.finished.fetch_add(1, std::memory_order_release);
+    }
 };
 
 } // namespace ecs
@@ -0,0 +1,101 @@
+#pragma once
+#include "system_access.hpp"
+#include <ecs/ecs.hpp>
+#include <concepts>
+#include <type_traits>
+
+// ---------------------------------------------------------------------------
+// Pipeline steps — a system described by a type, so it can be added to the
+// dynamic Pipeline (pipeline.add<Step>()) or listed in a StaticPipeline
+// (static_pipeline.hpp) and dispatched with no std::function between them.
+//
+//   struct StateStep {
+//       static constexpr const char* name  = "CharState";
+//       static constexpr int         phase = FrameProfiler::Logic;
+//       using reads  = ecs::TypeList<CharacterHandle, CharacterIntent>;
+//       using writes = ecs::TypeList<CharacterState>;
+//       using after  = ecs::TypeList<InputStep>;       // optional
+//       static constexpr bool main_thread = false;      // optional
+//       static void run(ecs::World& w, float dt) { CharacterStateSystem::Update(w, dt); }
+//   };
+//
+// `reads` / `writes` are the step's Access (system_access.hpp). A step that
+// declares neither is exclusive, like a system added without an Access.
+//
+// `after` lists the steps this one must follow when both are installed: the
+// ordering rules of ARCH-0013, written where the step is. Phases run in
+// order, but within a phase the Pipeline only keeps install order between
+// steps that conflict, so a listed step must be in an earlier phase or
+// conflict with this one. That is checked at compile time when the step is
+// added; a StaticPipeline also checks the order of its list.
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+namespace ecs {
+
+template <typename... Ts> struct TypeList {};
+
+template <typename T, typename List> struct TypeListContains;
+template <typename T, typename... Ts>
+struct TypeListContains<T, TypeList<Ts...>> : std::bool_constant<(std::is_same_v<T, Ts> || ...)> {};
+
+template <typename A, typename B> struct TypeListOverlaps;
+template <typename... As, typename B>
+struct TypeListOverlaps<TypeList<As...>, B> : std::bool_constant<(TypeListContains<As, B>::value || ...)> {};
+
+template <typename S>
+concept PipelineStep = requires(World& w, float dt) {
+    { S::name } -> std::convertible_to<const char*>;
+    { S::phase } -> std::convertible_to<int>;
+    S::run(w, dt);
+};
+
+template <typename S> struct StepReads                                     { using type = TypeList<>; };
+template <typename S> requires requires { typename S::reads; } struct StepReads<S>  { using type = typename S::reads; };
+template <typename S> struct StepWrites                                    { using type = TypeList<>; };
+template <typename S> requires requires { typename S::writes; } struct StepWrites<S> { using type = typename S::writes; };
+template <typename S> struct StepAfter                                     { using type = TypeList<>; };
+template <typename S> requires requires { typename S::after; } struct StepAfter<S>  { using type = typename S::after; };
+
+template <typename S>
+inline constexpr bool step_exclusive = !requires { typename S::reads; } && !requires { typename S::writes; };
+
+template <typename S>
+inline constexpr bool step_main_thread = [] {
+    if constexpr (requires { S::main_thread; }) return static_cast<bool>(S::main_thread);
+    else return false;
+}();
+
+// Access::conflicts, on the declared type lists.
+template <typename A, typename B>
+inline constexpr bool step_conflicts =
+    step_exclusive<A> || step_exclusive<B>
+    || TypeListOverlaps<typename StepWrites<A>::type, typename StepWrites<B>::type>::value
+    || TypeListOverlaps<typename StepWrites<A>::type, typename StepReads<B>::type>::value
+    || TypeListOverlaps<typename StepReads<A>::type, typename StepWrites<B>::type>::value;
+
+// Whether every step S lists in `after` is in an earlier phase or conflicts
+// with it, so install order between them holds on a threaded Pipeline too.
+template <typename S, typename List = typename StepAfter<S>::type> struct StepAfterEnforced;
+template <typename S, typename... As>
+struct StepAfterEnforced<S, TypeList<As...>>
+    : std::bool_constant<((As::phase < S::phase || (As::phase == S::phase && step_conflicts<S, As>)) && ...)> {};
+
+template <typename... Ts> void read_list(Access& a, TypeList<Ts...>)  { a.read<Ts...>(); }
+template <typename... Ts> void write_list(Access& a, TypeList<Ts...>) { a.write<Ts...>(); }
+
+// The Access the dynamic Pipeline schedules S with.
+template <PipelineStep S> Access step_access() {
+    Access a;
+    if constexpr (step_exclusive<S>) {
+        a = Access::all();
+    } else {
+        read_list(a, typename StepReads<S>::type{});
+        write_list(a, typename StepWrites<S>::type{});
+    }
+    if constexpr (step_main_thread<S>) a.on_main_thread();
+    return a;
+}
+
+} // namespace ecs
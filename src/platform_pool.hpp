@@ -0,0 +1,76 @@
+#pragma once
+#include <ecs/ecs.hpp>
+#include <cstddef>
+#include <optional>
+#include <utility>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// PlatformPool — a fixed set of pre-created builder platforms, recycled
+// oldest-first.
+//
+// PlatformBuilderSystem::FillPool creates `capacity` static platform
+// entities after a scene load, parked out of sight at PARK. Their bodies
+// enter the broadphase with the rest of the scene's commit. A plant then
+// moves the next slot into place (LocalTransform + PhysicsTeleport) instead
+// of creating an entity, a shape and a body. Once every slot is out, the
+// platform placed longest ago is picked up and moved. The builder never
+// holds more than `capacity` bodies however long the session runs.
+//
+// The slots are WorldTag entities, so an unload destroys them. acquire()
+// returns nothing for a dead slot; the builder falls back to spawning until
+// FillPool runs again after the next load. Slots are created before the
+// reset snapshot is taken, so R restores them as parked bodies and then
+// rewinds the pool.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+class PlatformPool {
+public:
+    static constexpr size_t    DEFAULT_CAPACITY = 64;
+    static constexpr ecs::Vec3 PARK             = {0.0f, -1000.0f, 0.0f};
+
+    explicit PlatformPool(size_t capacity = DEFAULT_CAPACITY) : capacity_(capacity) {}
+
+    size_t capacity() const { return capacity_; }
+    size_t size()     const { return slots_.size(); }
+
+    // Replaces the slots; nothing is placed yet.
+    void assign(std::vector<ecs::Entity> slots) {
+        slots_    = std::move(slots);
+        next_     = 0;
+        placed_   = 0;
+        recycled_ = 0;
+    }
+    const std::vector<ecs::Entity>& slots() const { return slots_; }
+
+    // Every slot is parked again (a snapshot restore): place from the first.
+    void rewind() {
+        next_     = 0;
+        placed_   = 0;
+        recycled_ = 0;
+    }
+
+    // The slot to place next: a parked one while any are left, then the one
+    // placed longest ago. Nothing if the pool is empty or that slot is dead.
+    std::optional<ecs::Entity> acquire(ecs::World& world) {
+        if (slots_.empty()) return std::nullopt;
+        const ecs::Entity e = slots_[next_];
+        if (!world.alive(e)) return std::nullopt;
+        next_ = (next_ + 1) % slots_.size();
+        if (placed_ < slots_.size()) ++placed_;
+        else ++recycled_;
+        return e;
+    }
+
+    size_t placed()   const { return placed_; }   // since assign() / rewind()
+    size_t recycled() const { return recycled_; } // placements that moved a placed platform
+
+private:
+    std::vector<ecs::Entity> slots_;
+    size_t capacity_ = DEFAULT_CAPACITY;
+    size_t next_     = 0;
+    size_t placed_   = 0;
+    size_t recycled_ = 0;
+};
@@ -0,0 +1,20 @@
+#pragma once
+#include <cstddef>
+
+// ---------------------------------------------------------------------------
+// ProcessMemory — how much memory this process holds right now.
+//
+// resident_bytes() is the resident set (Windows: the working set), read
+// from the OS: /proc/self/statm on Linux, task_info on macOS and
+// GetProcessMemoryInfo on Windows. It includes Jolt's preallocations and
+// every thread stack, which the bench's operator new counter does not
+// see. 0 where the platform gives no answer.
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+namespace ProcessMemory {
+
+size_t resident_bytes();
+
+} // namespace ProcessMemory
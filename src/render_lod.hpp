@@ -0,0 +1,59 @@
+#pragma once
+#include "culling.hpp"
+#include "instance_batch.hpp"
+#include <ecs/ecs.hpp>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+
+// ---------------------------------------------------------------------------
+// RenderLod — distance-based tessellation level for instanced meshes.
+//
+// RenderSystem::Capture picks a level for every visible instance from its
+// projected size: the bounding radius of its world-space Aabb over the
+// distance from the camera (MainCamera::lerp_pos) to the Aabb's centre. At a
+// 45° field of view and a 720-pixel-high window, a ratio of 0.05 is a radius
+// of about 43 pixels and 0.015 about 13. Level 0 is the full mesh;
+// AssetResource bakes coarser sphere and capsule meshes for levels 1 and 2.
+// Boxes have one mesh, and InstanceBatch::add files them all at level 0.
+// InstanceBatch buckets by (shape, level), so each level is still one
+// DrawMeshInstanced call.
+//
+// World resource, created by RenderModule. Without one, or with enabled =
+// false, everything draws at level 0. counts holds last frame's visible
+// instances per level (debug panel).
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+struct RenderLod {
+    static constexpr size_t LEVELS = 3;
+
+    bool  enabled = true;
+    float level1  = 0.05f;  // projected ratio below which level 1 is used
+    float level2  = 0.015f; // ... and level 2
+
+    std::array<uint32_t, LEVELS> counts = {};
+
+    int select(float radius, float distance) const {
+        if (!enabled || distance <= radius) return 0;
+        const float ratio = radius / distance;
+        if (ratio >= level1) return 0;
+        if (ratio >= level2) return 1;
+        return 2;
+    }
+
+    // Level for world-space bounds seen from eye.
+    int select(const Aabb& bounds, const ecs::Vec3& eye) const {
+        const float ex = (bounds.max.x - bounds.min.x) * 0.5f;
+        const float ey = (bounds.max.y - bounds.min.y) * 0.5f;
+        const float ez = (bounds.max.z - bounds.min.z) * 0.5f;
+        const float dx = (bounds.min.x + bounds.max.x) * 0.5f - eye.x;
+        const float dy = (bounds.min.y + bounds.max.y) * 0.5f - eye.y;
+        const float dz = (bounds.min.z + bounds.max.z) * 0.5f - eye.z;
+        return select(std::sqrt(ex * ex + ey * ey + ez * ez), std::sqrt(dx * dx + dy * dy + dz * dz));
+    }
+};
+
+static_assert(RenderLod::LEVELS == InstanceBatch::LOD_COUNT);
@@ -0,0 +1,91 @@
+#pragma once
+#include "culling.hpp"
+#include "instance_batch.hpp"
+#include <ecs/ecs.hpp>
+#include <array>
+#include <cstdint>
+#include <mutex>
+
+// ---------------------------------------------------------------------------
+// RenderSnapshot — everything RenderSystem draws for one frame, copied out
+// of the World.
+//
+// RenderSystem::Capture fills it: the culled instances (InstanceBatch, colour
+// packed in the matrix), the camera, the player position the shaders shadow
+// around, and the player's orientation gizmo. RenderSystem::Draw reads
+// nothing else, so a snapshot can be drawn while the simulation is already
+// writing the next frame.
+//
+// RenderSnapshotBuffer is a triple buffer between the two. The producer
+// fills write() and publish()es it. The consumer's read() swaps in the
+// newest published snapshot, or keeps its current one if nothing new was
+// published. Neither side ever waits for the other, and each owns its slot
+// until its next call. RenderModule creates one as a world resource
+// (std::shared_ptr); in the pipelined mode the simulation thread produces
+// and the main thread consumes (RFC-0045).
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+struct RenderSnapshot {
+    InstanceBatch batch;
+
+    // Camera (MainCamera's smoothed pose). Without a MainCamera nothing is
+    // culled and the full ground grid is drawn.
+    bool      has_camera    = false;
+    ecs::Vec3 camera_pos    = {0, 0, 0};
+    ecs::Vec3 camera_target = {0, 0, 0};
+    float     fovy          = 45.0f;
+    Aabb      view;                    // frustum bounds, for the ground grid
+
+    ecs::Vec3 player_pos = {0, 0, 0};
+
+    // Orientation gizmo: forward, right, up, already scaled.
+    bool                     has_gizmo    = false;
+    ecs::Vec3                gizmo_origin = {0, 0, 0};
+    std::array<ecs::Vec3, 3> gizmo_axes   = {};
+
+    uint64_t frame = 0; // RenderSnapshotBuffer::published() at publish time
+};
+
+class RenderSnapshotBuffer {
+public:
+    // The producer's slot. Contents are whatever it held three publishes ago.
+    RenderSnapshot& write() { return slots_[write_]; }
+
+    void publish() {
+        std::lock_guard<std::mutex> lock(m_);
+        slots_[write_].frame = ++published_;
+        std::swap(write_, ready_);
+        fresh_ = true;
+    }
+
+    // The newest published snapshot; the same one again if nothing was
+    // published since the last call. frame == 0 before the first publish.
+    const RenderSnapshot& read() {
+        std::lock_guard<std::mutex> lock(m_);
+        if (fresh_) {
+            std::swap(read_, ready_);
+            fresh_ = false;
+        }
+        return slots_[read_];
+    }
+
+    uint64_t published() const {
+        std::lock_guard<std::mutex> lock(m_);
+        return published_;
+    }
+
+    // Width / height of the window the consumer draws into. The producer
+    // culls with it; the consumer sets it between frames.
+    float aspect = 16.0f / 9.0f;
+
+private:
+    std::array<RenderSnapshot, 3> slots_;
+    mutable std::mutex            m_;
+    int                           write_     = 0;
+    int                           ready_     = 1;
+    int                           read_      = 2;
+    bool                          fresh_     = false;
+    uint64_t                      published_ = 0;
+};
@@ -0,0 +1,103 @@
+#pragma once
+#include "components.hpp"
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// Render state bookkeeping for RenderSystem::Draw.
+//
+//   UniformCache — the last value uploaded to each (shader program, uniform
+//                  location). update() says whether a new value differs, so
+//                  unchanged uniforms are never re-sent. Raylib's
+//                  SetShaderValue binds the program for every call, so a
+//                  skipped upload is also a skipped bind.
+//   DrawQueue    — one frame's instanced draws, sorted by shader program
+//                  (then shape and LOD level) so each program is bound once.
+//   RenderStats  — per-frame counters for the debug panel.
+//
+// AssetResource owns one of each; RenderSystem::Draw resets the queue and
+// stats every frame. Call UniformCache::clear() after reloading a shader.
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+struct RenderStats {
+    uint32_t draw_calls      = 0;
+    uint32_t instances       = 0;
+    uint64_t vertices        = 0; // mesh vertices × instances
+    uint32_t shader_changes  = 0; // program switches between draws
+    uint32_t uniform_uploads = 0;
+    uint32_t uniform_skipped = 0;
+};
+
+class UniformCache {
+public:
+    static constexpr size_t MAX_BYTES = 64; // a mat4
+
+    // True when value differs from the last one recorded for
+    // (program, location), which it then becomes. Locations < 0 (not in the
+    // program) are never uploaded; values over MAX_BYTES always are.
+    bool update(unsigned program, int location, const void* data, size_t bytes, RenderStats* stats = nullptr) {
+        if (location < 0 || bytes == 0) return false;
+        if (bytes > MAX_BYTES) {
+            if (stats) ++stats->uniform_uploads;
+            return true;
+        }
+        const uint64_t key = (static_cast<uint64_t>(program) << 32) | static_cast<uint32_t>(location);
+        Entry& e = values_[key];
+        if (e.bytes == bytes && std::memcmp(e.data.data(), data, bytes) == 0) {
+            if (stats) ++stats->uniform_skipped;
+            return false;
+        }
+        std::memcpy(e.data.data(), data, bytes);
+        e.bytes = bytes;
+        if (stats) ++stats->uniform_uploads;
+        return true;
+    }
+
+    void   clear()      { values_.clear(); }
+    size_t size() const { return values_.size(); }
+
+private:
+    struct Entry {
+        std::array<unsigned char, MAX_BYTES> data{};
+        size_t bytes = 0;
+    };
+    std::unordered_map<uint64_t, Entry> values_;
+};
+
+class DrawQueue {
+public:
+    struct Command {
+        unsigned  shader = 0;
+        ShapeType shape  = ShapeType::Box;
+        int       lod    = 0;
+    };
+
+    void clear() { commands_.clear(); }
+    void push(unsigned shader, ShapeType shape, int lod) { commands_.push_back({shader, shape, lod}); }
+
+    // Orders by program, then shape, then level. Returns the number of
+    // program switches drawing in that order costs (the first bind counts).
+    uint32_t sort() {
+        std::stable_sort(commands_.begin(), commands_.end(), [](const Command& a, const Command& b) {
+            if (a.shader != b.shader) return a.shader < b.shader;
+            if (a.shape != b.shape) return static_cast<int>(a.shape) < static_cast<int>(b.shape);
+            return a.lod < b.lod;
+        });
+        uint32_t changes = 0;
+        for (size_t i = 0; i < commands_.size(); ++i)
+            if (i == 0 || commands_[i].shader != commands_[i - 1].shader) ++changes;
+        return changes;
+    }
+
+    const std::vector<Command>& commands() const { return commands_; }
+
+private:
+    std::vector<Command> commands_;
+};
@@ -1,8 +1,19 @@
 #include "scene.hpp"
 #include "components.hpp"
+#include "culling.hpp"
+#include "deferred_commands.hpp"
+#include "fixed_time.hpp"
+#include "frame_arena.hpp"
+#include "scene_binary.hpp"
+#include "scene_chunks.hpp"
+#include "scene_desc.hpp"
+#include "mapped_file.hpp"
+#include "transform_dirty.hpp"
 #include <ecs/modules/transform.hpp>
 #include <nlohmann/json.hpp>
+#include <algorithm>
 #include <fstream>
+#include <functional>
 #include <stdexcept>
 #include <string>
 #include <vector>
@@ -40,51 +51,90 @@ static BodyType parse_body_type(const std::string& s) {
     throw std::runtime_error("SceneLoader: unknown body type '" + s + "'");
 }
 
+static MotionQuality parse_motion_quality(const std::string& s) {
+    if (s == "Discrete")   return MotionQuality::Discrete;
+    if (s == "LinearCast") return MotionQuality::LinearCast;
+    if (s == "Auto")       return MotionQuality::Auto;
+    throw std::runtime_error("SceneLoader: unknown motion quality '" + s + "'");
+}
+
+// Replaces `out` with a "layers" block:
+//   { "broadphase": ["NON_MOVING", "MOVING", ...],
+//     "objects": [ { "name": "Static", "broadphase": "NON_MOVING",
+//                    "collides": ["Moving", ...] }, ... ] }
+// Collisions are symmetric, so each pair only needs listing once.
+static void read_layers(const json& j, PhysicsLayers& out) {
+    PhysicsLayers layers = PhysicsLayers::empty();
+    for (const auto& bp : j.at("broadphase"))
+        if (layers.add_broadphase(bp.get<std::string>()) == PhysicsLayers::INVALID)
+            throw std::runtime_error("SceneLoader: bad broadphase layer list");
+    for (const auto& o : j.at("objects")) {
+        const std::string name = o.at("name").get<std::string>();
+        const uint32_t    bp   = layers.find_broadphase(o.at("broadphase").get<std::string>());
+        if (bp == PhysicsLayers::INVALID || layers.add_layer(name, bp) == PhysicsLayers::INVALID)
+            throw std::runtime_error("SceneLoader: bad object layer '" + name + "'");
+    }
+    for (const auto& o : j.at("objects")) {
+        const std::string name = o.at("name").get<std::string>();
+        for (const auto& other : o.value("collides", json::array()))
+            if (!layers.set_collides(name, other.get<std::string>()))
+                throw std::runtime_error("SceneLoader: layer '" + name + "' collides with unknown layer");
+    }
+    if (!layers.valid())
+        throw std::runtime_error("SceneLoader: layer table must start with Static, Moving");
+    out = layers;
+}
+
 // ---------------------------------------------------------------------------
-// Entity spawning
+// Entity decoding and spawning (scene_desc.hpp)
 // ---------------------------------------------------------------------------
 
-static void spawn_entity(ecs::World& world, const json& e) {
-    auto ent = world.create();
+SceneEntityDesc SceneDesc::parse_entity(const json& e) {
+    SceneEntityDesc d;
+    d.name = e.value("_name", std::string());
 
-    // 1. LocalTransform + WorldTransform (must precede physics hooks)
     if (e.contains("transform")) {
         const auto& t = e["transform"];
         ecs::Vec3 pos = t.contains("position") ? parse_vec3(t["position"]) : ecs::Vec3{0,0,0};
         ecs::Quat rot = t.contains("rotation") ? parse_quat(t["rotation"]) : ecs::Quat{0,0,0,1};
         ecs::Vec3 scl = t.contains("scale")    ? parse_vec3(t["scale"])    : ecs::Vec3{1,1,1};
-        world.add(ent, ecs::LocalTransform{pos, rot, scl});
-        world.add(ent, ecs::WorldTransform{});
+        d.transform = ecs::LocalTransform{pos, rot, scl};
     }
 
-    // 2. Colliders (must precede RigidBodyConfig so PhysicsSystem can read them)
     if (e.contains("box_collider")) {
-        world.add(ent, BoxCollider{parse_vec3(e["box_collider"]["half_extents"])});
+        d.box_collider = BoxCollider{parse_vec3(e["box_collider"]["half_extents"])};
     }
     if (e.contains("sphere_collider")) {
-        world.add(ent, SphereCollider{e["sphere_collider"]["radius"].get<float>()});
+        d.sphere_collider = SphereCollider{e["sphere_collider"]["radius"].get<float>()};
+    }
+
+    if (e.contains("shape_collider")) {
+        d.shape_collider = ShapeCollider{e["shape_collider"].at("shape").get<std::string>()};
     }
 
-    // 3. Visual representation
     if (e.contains("mesh")) {
         const auto& m = e["mesh"];
         ShapeType shape        = parse_shape(m.value("shape", std::string("Box")));
         Color4    color        = m.contains("color")        ? parse_color4(m["color"])        : Colors::White;
         ecs::Vec3 scale_offset = m.contains("scale_offset") ? parse_vec3(m["scale_offset"])   : ecs::Vec3{1,1,1};
-        world.add(ent, MeshRenderer{shape, color, scale_offset});
+        d.mesh = MeshRenderer{shape, color, scale_offset};
     }
 
-    // 4. Physics / character (triggers on_add lifecycle hooks — added last so
-    //    sibling components are already present when the hook fires)
     if (e.contains("rigid_body")) {
         const auto& rb = e["rigid_body"];
         RigidBodyConfig cfg;
-        cfg.type        = parse_body_type(rb.value("type", std::string("Dynamic")));
-        cfg.mass        = rb.value("mass",        1.0f);
-        cfg.friction    = rb.value("friction",    0.5f);
-        cfg.restitution = rb.value("restitution", 0.0f);
-        cfg.sensor      = rb.value("sensor",      false);
-        world.add(ent, std::move(cfg));
+        cfg.type            = parse_body_type(rb.value("type", std::string("Dynamic")));
+        cfg.mass            = rb.value("mass",            0.0f);
+        cfg.friction        = rb.value("friction",        0.5f);
+        cfg.restitution     = rb.value("restitution",     0.0f);
+        cfg.sensor          = rb.value("sensor",          false);
+        cfg.layer           = rb.value("layer",           std::string());
+        cfg.allow_sleeping  = rb.value("allow_sleeping",  true);
+        cfg.start_asleep    = rb.value("start_asleep",    false);
+        cfg.linear_damping  = rb.value("linear_damping",  0.05f);
+        cfg.angular_damping = rb.value("angular_damping", 0.05f);
+        cfg.motion_quality  = parse_motion_quality(rb.value("motion_quality", std::string("Discrete")));
+        d.rigid_body = cfg;
     }
     if (e.contains("character")) {
         const auto& ch = e["character"];
@@ -93,21 +143,382 @@ static void spawn_entity(ecs::World& world, const json& e) {
         cfg.radius          = ch.value("radius",          0.4f);
         cfg.mass            = ch.value("mass",            70.0f);
         cfg.max_slope_angle = ch.value("max_slope_angle", 45.0f);
-        world.add(ent, std::move(cfg));
+        d.character = cfg;
     }
 
-    // 5. Tags and player-specific components
     if (e.contains("tags")) {
         for (const auto& tag : e["tags"]) {
             const std::string t = tag.get<std::string>();
-            if (t == "World")  world.add(ent, WorldTag{});
-            if (t == "Player") {
-                world.add(ent, PlayerTag{});
-                world.add(ent, PlayerInput{});
-                world.add(ent, PlayerState{});
+            if (t == "World")  d.world_tag  = true;
+            if (t == "Player") d.player_tag = true;
+        }
+    }
+    return d;
+}
+
+ecs::Entity SceneDesc::spawn_entity(ecs::World& world, const SceneEntityDesc& d) {
+    auto ent = world.create();
+
+    // 1. LocalTransform + WorldTransform (must precede physics hooks)
+    if (d.transform) {
+        world.add(ent, *d.transform);
+        world.add(ent, ecs::WorldTransform{});
+    }
+
+    // 2. Colliders (must precede RigidBodyConfig so PhysicsSystem can read them)
+    if (d.box_collider)    world.add(ent, *d.box_collider);
+    if (d.sphere_collider) world.add(ent, *d.sphere_collider);
+    if (d.shape_collider)  world.add(ent, *d.shape_collider);
+
+    // 3. Visual representation
+    if (d.mesh) world.add(ent, *d.mesh);
+
+    // 4. Physics / character (triggers on_add lifecycle hooks — added last so
+    //    sibling components are already present when the hook fires)
+    if (d.rigid_body) world.add(ent, *d.rigid_body);
+    if (d.character)  world.add(ent, *d.character);
+
+    // 5. Tags and player-specific components
+    if (d.world_tag) world.add(ent, WorldTag{});
+    if (d.player_tag) {
+        world.add(ent, PlayerTag{});
+        world.add(ent, PlayerInput{});
+        world.add(ent, PlayerState{});
+    }
+    return ent;
+}
+
+ecs::Entity SceneDesc::spawn_deferred(ecs::World& world, const SceneEntityDesc& d) {
+    auto  ent = world.create();
+    auto& cmd = world.deferred();
+
+    if (d.transform) {
+        cmd.add(ent, *d.transform);
+        cmd.add(ent, ecs::WorldTransform{});
+    }
+    if (d.box_collider)    cmd.add(ent, *d.box_collider);
+    if (d.sphere_collider) cmd.add(ent, *d.sphere_collider);
+    if (d.shape_collider)  cmd.add(ent, *d.shape_collider);
+    if (d.mesh)            cmd.add(ent, *d.mesh);
+    if (d.rigid_body)      cmd.add(ent, *d.rigid_body);
+    if (d.character)       cmd.add(ent, *d.character);
+    if (d.world_tag)       cmd.add(ent, WorldTag{});
+    if (d.player_tag) {
+        cmd.add(ent, PlayerTag{});
+        cmd.add(ent, PlayerInput{});
+        cmd.add(ent, PlayerState{});
+    }
+    record(world, ent, d);
+    return ent;
+}
+
+void SceneDesc::repose(ecs::World& world, ecs::Entity e, const SceneEntityDesc& d) {
+    if (d.transform) {
+        if (auto* lt = world.try_get<ecs::LocalTransform>(e)) *lt = *d.transform;
+        if (auto* dirty = world.try_resource<TransformDirty>()) dirty->mark(e);
+        if ((d.rigid_body || d.character) && !world.has<PhysicsTeleport>(e))
+            world.add(e, PhysicsTeleport{});
+    }
+    if (auto* input = world.try_get<PlayerInput>(e)) *input = PlayerInput{};
+    if (auto* state = world.try_get<PlayerState>(e)) *state = PlayerState{};
+    record(world, e, d);
+}
+
+void SceneDesc::record(ecs::World& world, ecs::Entity e, const SceneEntityDesc& d) {
+    if (!world.has_resource<SceneIndex>()) world.set_resource(SceneIndex{});
+    auto& index = world.resource<SceneIndex>();
+    if (d.name.empty() || !index.named.try_emplace(d.name, SceneIndex::Entry{e, d}).second)
+        index.unnamed.push_back(e);
+}
+
+void SceneDesc::forget(ecs::World& world, ecs::Entity e, const SceneEntityDesc& d) {
+    auto* index = world.try_resource<SceneIndex>();
+    if (!index) return;
+    if (!d.name.empty()) {
+        auto it = index->named.find(d.name);
+        if (it != index->named.end() && it->second.entity == e) {
+            index->named.erase(it);
+            return;
+        }
+    }
+    auto it = std::find(index->unnamed.begin(), index->unnamed.end(), e);
+    if (it == index->unnamed.end()) return;
+    *it = index->unnamed.back(); // order is not kept
+    index->unnamed.pop_back();
+}
+
+static bool same_vec3(const ecs::Vec3& a, const ecs::Vec3& b) {
+    return a.x == b.x && a.y == b.y && a.z == b.z;
+}
+
+template <typename T, typename Eq>
+static bool same_optional(const std::optional<T>& a, const std::optional<T>& b, Eq eq) {
+    if (a.has_value() != b.has_value()) return false;
+    return !a || eq(*a, *b);
+}
+
+bool SceneDesc::same_structure(const SceneEntityDesc& a, const SceneEntityDesc& b) {
+    return a.transform.has_value() == b.transform.has_value()
+        && a.mesh.has_value()      == b.mesh.has_value()
+        && a.world_tag  == b.world_tag
+        && a.player_tag == b.player_tag
+        && same_optional(a.box_collider, b.box_collider, [](const BoxCollider& x, const BoxCollider& y) {
+               return same_vec3(x.half_extents, y.half_extents); })
+        && same_optional(a.sphere_collider, b.sphere_collider, [](const SphereCollider& x, const SphereCollider& y) {
+               return x.radius == y.radius; })
+        && same_optional(a.shape_collider, b.shape_collider, [](const ShapeCollider& x, const ShapeCollider& y) {
+               return x.shape == y.shape; })
+        && same_optional(a.rigid_body, b.rigid_body, [](const RigidBodyConfig& x, const RigidBodyConfig& y) {
+               return x.type == y.type && x.mass == y.mass && x.friction == y.friction
+                   && x.restitution == y.restitution && x.sensor == y.sensor && x.layer == y.layer
+                   && x.allow_sleeping == y.allow_sleeping && x.start_asleep == y.start_asleep
+                   && x.linear_damping == y.linear_damping && x.angular_damping == y.angular_damping
+                   && x.motion_quality == y.motion_quality; })
+        && same_optional(a.character, b.character, [](const CharacterControllerConfig& x, const CharacterControllerConfig& y) {
+               return x.height == y.height && x.radius == y.radius && x.mass == y.mass
+                   && x.max_slope_angle == y.max_slope_angle; });
+}
+
+bool SceneDesc::same_transform(const SceneEntityDesc& a, const SceneEntityDesc& b) {
+    return same_optional(a.transform, b.transform, [](const ecs::LocalTransform& x, const ecs::LocalTransform& y) {
+        return same_vec3(x.position, y.position) && same_vec3(x.scale, y.scale)
+            && x.rotation.x == y.rotation.x && x.rotation.y == y.rotation.y
+            && x.rotation.z == y.rotation.z && x.rotation.w == y.rotation.w;
+    });
+}
+
+bool SceneDesc::same_mesh(const SceneEntityDesc& a, const SceneEntityDesc& b) {
+    return same_optional(a.mesh, b.mesh, [](const MeshRenderer& x, const MeshRenderer& y) {
+        return x.shape_type == y.shape_type && same_vec3(x.scale_offset, y.scale_offset)
+            && x.color.r == y.color.r && x.color.g == y.color.g
+            && x.color.b == y.color.b && x.color.a == y.color.a;
+    });
+}
+
+// ---------------------------------------------------------------------------
+// Streaming decode
+//
+// EntityStream is a SAX handler that materialises one element of the root
+// "entities" array at a time as a small DOM, hands it to `on_entity`, and
+// drops it. Everything else in the file (the "physics" block, unknown keys)
+// is skipped without being stored, so peak memory is one entity, not the
+// whole scene.
+// ---------------------------------------------------------------------------
+
+namespace {
+
+class EntityStream final : public nlohmann::json_sax<json> {
+public:
+    using OnEntity = std::function<void(const json&)>;
+
+    explicit EntityStream(OnEntity on_entity) : on_entity_(std::move(on_entity)) {}
+
+    // True once the root "entities" array has been closed.
+    bool complete() const { return complete_; }
+
+    bool null() override                                   { return value(nullptr); }
+    bool boolean(bool v) override                          { return value(v); }
+    bool number_integer(number_integer_t v) override       { return value(v); }
+    bool number_unsigned(number_unsigned_t v) override     { return value(v); }
+    bool number_float(number_float_t v, const string_t&) override { return value(v); }
+    bool string(string_t& v) override                      { return value(std::move(v)); }
+    bool binary(binary_t& v) override                      { return value(json::binary(std::move(v))); }
+
+    bool start_object(std::size_t) override {
+        ++depth_;
+        if (building()) {
+            stack_.push_back(insert(json::object()));
+        } else if (in_entities_ && depth_ == ENTITY_DEPTH) {
+            current_ = json::object();
+            stack_.push_back(&current_);
+        }
+        return true;
+    }
+
+    bool end_object() override {
+        if (building()) {
+            stack_.pop_back();
+            if (stack_.empty()) on_entity_(current_);
+        }
+        --depth_;
+        return true;
+    }
+
+    bool start_array(std::size_t) override {
+        ++depth_;
+        if (building()) {
+            stack_.push_back(insert(json::array()));
+        } else if (depth_ == ENTITY_DEPTH - 1 && root_key_ == "entities") {
+            in_entities_ = true;
+        }
+        return true;
+    }
+
+    bool end_array() override {
+        if (building()) {
+            stack_.pop_back();
+        } else if (in_entities_ && depth_ == ENTITY_DEPTH - 1) {
+            in_entities_ = false;
+            complete_    = true;
+        }
+        --depth_;
+        return true;
+    }
+
+    bool key(string_t& k) override {
+        if (building())       key_      = k;
+        else if (depth_ == 1) root_key_ = k;
+        return true;
+    }
+
+    bool parse_error(std::size_t, const std::string&, const nlohmann::detail::exception&) override {
+        return false;
+    }
+
+private:
+    static constexpr int ENTITY_DEPTH = 3; // root object → "entities" array → entity
+
+    OnEntity           on_entity_;
+    json               current_;
+    std::vector<json*> stack_;     // open containers inside current_
+    std::string        key_;       // pending key inside current_
+    std::string        root_key_;  // last key seen on the root object
+    int                depth_       = 0;
+    bool               in_entities_ = false;
+    bool               complete_    = false;
+
+    bool building() const { return !stack_.empty(); }
+
+    json* insert(json&& v) {
+        json& top = *stack_.back();
+        if (top.is_object()) return &(top[key_] = std::move(v));
+        top.push_back(std::move(v));
+        return &top.back();
+    }
+
+    template <typename T>
+    bool value(T&& v) {
+        if (building()) insert(json(std::forward<T>(v)));
+        return true;
+    }
+};
+
+// Streams `input` (string or istream), calling `on_entity` for each decoded
+// entity as its object closes. False on malformed JSON, a missing
+// "entities" array, or a decode error.
+template <typename Input, typename F>
+bool stream_entities(Input&& input, F&& on_entity) {
+    try {
+        EntityStream sax([&](const json& e) { on_entity(SceneDesc::parse_entity(e)); });
+        return json::sax_parse(std::forward<Input>(input), &sax) && sax.complete();
+    } catch (const std::exception&) {
+        return false;
+    }
+}
+
+// On failure the entities spawned so far are destroyed again, so a failed
+// load leaves the world as it was.
+template <typename Input>
+bool stream_scene(ecs::World& world, Input&& input) {
+    std::vector<std::pair<ecs::Entity, SceneEntityDesc>> spawned;
+    const bool ok = stream_entities(std::forward<Input>(input), [&](SceneEntityDesc&& d) {
+        const ecs::Entity e = SceneDesc::spawn_entity(world, d);
+        spawned.emplace_back(e, std::move(d));
+    });
+    if (ok) {
+        for (const auto& [e, d] : spawned) SceneDesc::record(world, e, d);
+        return true;
+    }
+    for (const auto& [e, d] : spawned) world.destroy(e);
+    DeferredCommands::flush_all(world);
+    return false;
+}
+
+// Applies `next` to the entities recorded in the SceneIndex: matching names
+// are diffed and updated in place, the rest are destroyed or spawned.
+SceneReloadStats apply_reload(ecs::World& world, std::vector<SceneEntityDesc>& next) {
+    SceneReloadStats stats;
+    if (!world.has_resource<SceneIndex>()) world.set_resource(SceneIndex{});
+    SceneIndex old = std::move(world.resource<SceneIndex>());
+    world.resource<SceneIndex>() = SceneIndex{};
+
+    bool visuals_changed = false;
+    std::vector<std::pair<ecs::Entity, SceneEntityDesc*>> keep;
+
+    for (auto& d : next) {
+        auto it = d.name.empty() ? old.named.end() : old.named.find(d.name);
+        if (it == old.named.end() || !world.alive(it->second.entity)) {
+            SceneDesc::record(world, SceneDesc::spawn_entity(world, d), d);
+            ++stats.added;
+            continue;
+        }
+        const ecs::Entity      e    = it->second.entity;
+        const SceneEntityDesc& prev = it->second.desc;
+
+        if (!SceneDesc::same_structure(prev, d)) {
+            // Collider, body or tag changes rebuild this one entity only.
+            world.destroy(e);
+            SceneDesc::record(world, SceneDesc::spawn_entity(world, d), d);
+            ++stats.respawned;
+        } else {
+            bool changed = false;
+            if (!SceneDesc::same_transform(prev, d)) {
+                if (auto* lt = world.try_get<ecs::LocalTransform>(e)) *lt = *d.transform;
+                if (auto* dirty = world.try_resource<TransformDirty>()) dirty->mark(e);
+                if ((d.rigid_body || d.character) && !world.has<PhysicsTeleport>(e))
+                    world.add(e, PhysicsTeleport{});
+                changed = true;
+            }
+            if (!SceneDesc::same_mesh(prev, d)) {
+                if (auto* mr = world.try_get<MeshRenderer>(e)) *mr = *d.mesh;
+                changed = true;
             }
+            visuals_changed |= changed;
+            changed ? ++stats.updated : ++stats.unchanged;
+            SceneDesc::record(world, e, d);
+        }
+        old.named.erase(it);
+    }
+
+    for (const auto& [name, entry] : old.named) {
+        if (world.alive(entry.entity)) world.destroy(entry.entity);
+        ++stats.removed;
+    }
+    for (auto e : old.unnamed) {
+        if (world.alive(e)) world.destroy(e);
+        ++stats.removed;
+    }
+    DeferredCommands::flush_all(world);
+
+    // Moved or recoloured statics keep their WorldTag, so the renderer's
+    // hooks don't see them — invalidate its static grid directly.
+    if (visuals_changed) {
+        if (auto* culling = world.try_resource<RenderCulling>()) {
+            const auto* ft = world.try_resource<FixedTime>();
+            culling->mark_dirty(ft ? ft->total_steps : 0);
         }
     }
+    return stats;
+}
+
+} // namespace
+
+bool SceneDesc::read_file(const std::string& path, std::vector<SceneEntityDesc>& out,
+                          const std::atomic<bool>* cancel, std::atomic<size_t>* parsed) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    out.clear();
+    return stream_entities(file, [&](SceneEntityDesc&& d) {
+        if (cancel && cancel->load(std::memory_order_relaxed))
+            throw std::runtime_error("SceneLoader: cancelled");
+        out.push_back(std::move(d));
+        if (parsed) parsed->fetch_add(1, std::memory_order_relaxed);
+    });
+}
+
+bool SceneDesc::read_string(const std::string& json_str, std::vector<SceneEntityDesc>& out) {
+    out.clear();
+    return stream_entities(json_str, [&](SceneEntityDesc&& d) { out.push_back(std::move(d)); });
 }
 
 // ---------------------------------------------------------------------------
@@ -115,28 +526,111 @@ static void spawn_entity(ecs::World& world, const json& e) {
 // ---------------------------------------------------------------------------
 
 bool SceneLoader::load_from_string(ecs::World& world, const std::string& json_str) {
+    return stream_scene(world, json_str);
+}
+
+bool SceneLoader::load(ecs::World& world, const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return false;
+    return stream_scene(world, file);
+}
+
+bool SceneLoader::bake_from_string(const std::string& json_str, std::vector<uint8_t>& out) {
+    std::vector<SceneEntityDesc> entities;
+    if (!SceneDesc::read_string(json_str, entities)) return false;
+    SceneBinary::write(entities, out);
+    return true;
+}
+
+bool SceneLoader::bake(const std::string& json_path, const std::string& out_path) {
+    std::ifstream file(json_path);
+    if (!file.is_open()) return false;
+    const std::string content(std::istreambuf_iterator<char>(file),
+                              std::istreambuf_iterator<char>{});
+    std::vector<uint8_t> image;
+    if (!bake_from_string(content, image)) return false;
+    std::ofstream out(out_path, std::ios::binary | std::ios::trunc);
+    if (!out.is_open()) return false;
+    out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    return out.good();
+}
+
+bool SceneLoader::load_binary_from_memory(ecs::World& world, const void* data, size_t size) {
+    return SceneBinary::spawn(world, data, size);
+}
+
+bool SceneLoader::load_binary(ecs::World& world, const std::string& path) {
+    const MappedFile file(path);
+    if (!file) return false;
+    return load_binary_from_memory(world, file.data(), file.size());
+}
+
+bool SceneLoader::physics_config_from_string(const std::string& json_str, PhysicsConfig& out) {
     try {
-        json scene = json::parse(json_str);
-        for (const auto& entity_json : scene.at("entities")) {
-            spawn_entity(world, entity_json);
-        }
+        json root = json::parse(json_str);
+        const json& p = root.contains("physics") ? root.at("physics") : root;
+        PhysicsConfig cfg = out;
+        cfg.max_bodies              = p.value("max_bodies",              cfg.max_bodies);
+        cfg.num_body_mutexes        = p.value("num_body_mutexes",        cfg.num_body_mutexes);
+        cfg.max_body_pairs          = p.value("max_body_pairs",          cfg.max_body_pairs);
+        cfg.max_contact_constraints = p.value("max_contact_constraints", cfg.max_contact_constraints);
+        cfg.worker_threads          = p.value("worker_threads",          cfg.worker_threads);
+        cfg.fixed_hz                = p.value("fixed_hz",                cfg.fixed_hz);
+        cfg.max_steps_per_frame     = p.value("max_steps_per_frame",     cfg.max_steps_per_frame);
+        cfg.fold_substeps           = p.value("fold_substeps",           cfg.fold_substeps);
+        cfg.async_step              = p.value("async_step",              cfg.async_step);
+        cfg.allow_sleeping          = p.value("allow_sleeping",          cfg.allow_sleeping);
+        cfg.time_before_sleep       = p.value("time_before_sleep",       cfg.time_before_sleep);
+        cfg.sleep_velocity          = p.value("sleep_velocity",          cfg.sleep_velocity);
+        cfg.ccd_promote             = p.value("ccd_promote",             cfg.ccd_promote);
+        cfg.ccd_demote              = p.value("ccd_demote",              cfg.ccd_demote);
+        if (cfg.fixed_hz <= 0.0f || cfg.max_steps_per_frame < 1)
+            throw std::runtime_error("SceneLoader: invalid fixed-step settings");
+        if (p.contains("temp_allocator_mb"))
+            cfg.temp_allocator_bytes = static_cast<size_t>(p.at("temp_allocator_mb").get<double>() * 1024.0 * 1024.0);
+        if (p.contains("character_temp_mb"))
+            cfg.character_temp_bytes = static_cast<size_t>(p.at("character_temp_mb").get<double>() * 1024.0 * 1024.0);
+        if (p.contains("layers")) read_layers(p.at("layers"), cfg.layers);
+        cfg.shape_dir               = p.value("shape_dir",               cfg.shape_dir);
+        out = cfg;
         return true;
     } catch (const std::exception&) {
         return false;
     }
 }
 
-bool SceneLoader::load(ecs::World& world, const std::string& path) {
+bool SceneLoader::load_physics_config(const std::string& path, PhysicsConfig& out) {
     std::ifstream file(path);
     if (!file.is_open()) return false;
     const std::string content(std::istreambuf_iterator<char>(file),
                               std::istreambuf_iterator<char>{});
-    return load_from_string(world, content);
+    return physics_config_from_string(content, out);
+}
+
+bool SceneLoader::reload_from_string(ecs::World& world, const std::string& json_str,
+                                     SceneReloadStats* stats) {
+    std::vector<SceneEntityDesc> next;
+    if (!SceneDesc::read_string(json_str, next)) return false;
+    const SceneReloadStats s = apply_reload(world, next);
+    if (stats) *stats = s;
+    return true;
+}
+
+bool SceneLoader::reload(ecs::World& world, const std::string& path, SceneReloadStats* stats) {
+    std::vector<SceneEntityDesc> next;
+    if (!SceneDesc::read_file(path, next)) return false;
+    const SceneReloadStats s = apply_reload(world, next);
+    if (stats) *stats = s;
+    return true;
 }
 
-void SceneLoader::unload(ecs::World& world) {
-    std::vector<ecs::Entity> to_destroy;
-    world.each<WorldTag>([&](ecs::Entity e, WorldTag&) { to_destroy.push_back(e); });
+void SceneLoader::unload(ecs::World& world, bool keep_player) {
+    if (world.has_resource<SceneIndex>()) world.resource<SceneIndex>() = SceneIndex{};
+    if (world.has_resource<SceneChunks>()) world.remove_resource<SceneChunks>(); // its entities are WorldTag
+    auto to_destroy = frame_vector<ecs::Entity>(world);
+    world.each<WorldTag>([&](ecs::Entity e, WorldTag&) {
+        if (!keep_player || !world.has<PlayerTag>(e)) to_destroy.push_back(e);
+    });
     for (auto e : to_destroy) world.destroy(e);
-    world.deferred().flush(world);
+    DeferredCommands::flush_all(world);
 }
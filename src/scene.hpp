@@ -1,25 +1,78 @@
 #pragma once
+#include "physics_config.hpp"
 #include <ecs/ecs.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 // ---------------------------------------------------------------------------
 // SceneLoader — reads JSON scene files and populates an ECS World.
 //
+// JSON is the authoring format. bake() packs a scene into the binary .pscn
+// format (scene_binary.hpp), which load_binary() memory-maps and spawns with
+// no text parsing — used by the demo at startup and on reset.
+//
 // Components are added in lifecycle-safe order (colliders before rigid_body,
 // transform before character) so on_add hooks fire with sibling data present.
 // No Jolt or Raylib dependency — compilable in the headless test target.
 // ---------------------------------------------------------------------------
 
+// What SceneLoader::reload did, by entity.
+struct SceneReloadStats {
+    size_t added     = 0; // new names (and every unnamed entity)
+    size_t removed   = 0; // names gone from the file (and the old unnamed ones)
+    size_t respawned = 0; // collider / body / character / tag changes
+    size_t updated   = 0; // transform or mesh changed in place
+    size_t unchanged = 0;
+};
+
 class SceneLoader {
 public:
-    // Load entities from a JSON file into world.
-    // Returns false if the file cannot be opened or the JSON is malformed.
+    // Load entities from a JSON file into world. The file is parsed as a
+    // stream and each entity is spawned as soon as its object closes, so
+    // memory is bounded by one entity rather than the whole scene.
+    // Returns false if the file cannot be opened or the JSON is malformed;
+    // entities spawned before the error are destroyed again.
     static bool load(ecs::World& world, const std::string& path);
 
     // Parse and spawn from a JSON string — identical to load() but avoids
     // file I/O. Intended for unit testing.
     static bool load_from_string(ecs::World& world, const std::string& json);
 
-    // Destroy all WorldTag entities and flush deferred commands.
-    static void unload(ecs::World& world);
+    // Bake a JSON scene into .pscn. Returns false if the input cannot be
+    // read or parsed, or the output cannot be written.
+    static bool bake(const std::string& json_path, const std::string& out_path);
+    static bool bake_from_string(const std::string& json, std::vector<uint8_t>& out);
+
+    // Memory-map a baked .pscn file and spawn its entities. Returns false
+    // (spawning nothing) if the file is missing, truncated or not a
+    // compatible .pscn image.
+    static bool load_binary(ecs::World& world, const std::string& path);
+    static bool load_binary_from_memory(ecs::World& world, const void* data, size_t size);
+
+    // Hot reload: diff the file against what the loaders spawned, keyed by
+    // each entity's "_name", and apply only the differences. Unchanged
+    // entities (and their Jolt bodies) are left alone — including any state
+    // the simulation gave them. A changed transform or mesh is written in
+    // place (bodies and characters are moved via PhysicsTeleport); a
+    // changed collider, body, character or tag set respawns that entity.
+    // Unnamed entities are always replaced. Entities spawned outside the
+    // loaders (e.g. built platforms) are not touched.
+    // Returns false, changing nothing, if the file cannot be read or parsed.
+    static bool reload(ecs::World& world, const std::string& path, SceneReloadStats* stats = nullptr);
+    static bool reload_from_string(ecs::World& world, const std::string& json,
+                                   SceneReloadStats* stats = nullptr);
+
+    // Destroy all WorldTag entities and flush deferred commands. With
+    // keep_player, PlayerTag entities stay (a streamed reset re-poses the
+    // player rather than leaving the world without one while it loads).
+    static void unload(ecs::World& world, bool keep_player = false);
+
+    // Read PhysicsConfig overrides from a scene's top-level "physics" block,
+    // or from the root object of a standalone config file. Missing keys keep
+    // the values already in `out`. Returns false (leaving `out` untouched)
+    // if the file cannot be opened or the JSON is malformed.
+    static bool load_physics_config(const std::string& path, PhysicsConfig& out);
+    static bool physics_config_from_string(const std::string& json, PhysicsConfig& out);
 };
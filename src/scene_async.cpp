@@ -0,0 +1,105 @@
+#include "scene_async.hpp"
+#include <algorithm>
+#include <exception>
+
+void AsyncSceneLoader::start(const std::string& path, Prepare prepare, std::optional<ecs::Entity> player) {
+    cancel();
+
+    parsed_.store(0, std::memory_order_relaxed);
+    staged_.clear();
+    committed_     = 0;
+    total_         = 0;
+    failed_        = false;
+    final_pending_ = false;
+    active_        = true;
+    player_        = player;
+    worker_.store(static_cast<int>(Worker::Running), std::memory_order_relaxed);
+
+    thread_ = std::thread([this, path, prepare = std::move(prepare)]() {
+        std::vector<SceneEntityDesc> out;
+        bool ok = SceneDesc::read_file(path, out, &cancel_, &parsed_);
+        try {
+            for (size_t i = 0; ok && prepare && i < out.size(); ++i) {
+                if (cancel_.load(std::memory_order_relaxed)) ok = false;
+                else prepare(out[i]);
+            }
+        } catch (const std::exception&) {
+            ok = false;
+        }
+        // The main thread reads staged_ only after it sees Ready (acquire).
+        staged_ = std::move(out);
+        worker_.store(static_cast<int>(ok ? Worker::Ready : Worker::Failed), std::memory_order_release);
+    });
+}
+
+void AsyncSceneLoader::cancel() {
+    cancel_.store(true, std::memory_order_relaxed);
+    if (thread_.joinable()) thread_.join();
+    cancel_.store(false, std::memory_order_relaxed);
+    worker_.store(static_cast<int>(Worker::Ready), std::memory_order_relaxed);
+    staged_.clear();
+    active_        = false;
+    final_pending_ = false;
+    player_.reset();
+}
+
+bool AsyncSceneLoader::pump(ecs::World& world, size_t budget) {
+    if (!active_) return false;
+
+    const auto w = static_cast<Worker>(worker_.load(std::memory_order_acquire));
+    if (w == Worker::Running) return false;
+    if (thread_.joinable()) thread_.join();
+
+    if (w == Worker::Failed) {
+        staged_.clear();
+        active_ = false;
+        failed_ = true;
+        return false;
+    }
+
+    // The previous call queued the last batch and the Pipeline has flushed it.
+    if (final_pending_) {
+        expected_ = total_;
+        staged_.clear();
+        staged_.shrink_to_fit();
+        active_        = false;
+        final_pending_ = false;
+        return true;
+    }
+
+    total_ = staged_.size();
+    const size_t end = std::min(total_, committed_ + std::max<size_t>(budget, 1));
+    for (size_t i = committed_; i < end; ++i) {
+        const SceneEntityDesc& d = staged_[i];
+        if (d.player_tag && player_ && world.alive(*player_)) {
+            SceneDesc::repose(world, *player_, d);
+            player_.reset();
+        } else {
+            SceneDesc::spawn_deferred(world, d);
+        }
+    }
+    committed_ = end;
+    if (committed_ == total_) final_pending_ = true;
+    return false;
+}
+
+AsyncSceneLoader::State AsyncSceneLoader::state() const {
+    if (failed_) return State::Failed;
+    if (!active_) return State::Idle;
+    return static_cast<Worker>(worker_.load(std::memory_order_acquire)) == Worker::Running
+        ? State::Parsing : State::Committing;
+}
+
+float AsyncSceneLoader::progress() const {
+    switch (state()) {
+    case State::Idle:   return 1.0f;
+    case State::Failed: return 0.0f;
+    case State::Parsing:
+        if (expected_ == 0) return 0.0f;
+        return 0.5f * std::min(1.0f, static_cast<float>(parsed()) / static_cast<float>(expected_));
+    case State::Committing:
+        if (total_ == 0) return 1.0f;
+        return 0.5f + 0.5f * static_cast<float>(committed_) / static_cast<float>(total_);
+    }
+    return 0.0f;
+}
@@ -0,0 +1,86 @@
+#pragma once
+#include "scene_desc.hpp"
+#include <ecs/ecs.hpp>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// AsyncSceneLoader — loads a JSON scene without stalling the frame.
+//
+// start() hands the path to a worker thread, which reads and parses the file
+// into a staging buffer of SceneEntityDescs and then runs the optional
+// `prepare` callback on each one (PhysicsModule uses it to build collision
+// shapes into the ShapeCache). Nothing touches the World until the whole
+// file has parsed, so a bad file spawns nothing.
+//
+// pump() runs on the main thread once per frame (SceneModule installs it in
+// Pre-Update). It queues up to `budget` staged entities via
+// SceneDesc::spawn_deferred; the Pipeline's deferred flush after Logic then
+// adds them and fires their hooks. pump() returns true exactly once, on the
+// first call after the last batch has been flushed.
+//
+// start() may be given a `player` kept from the previous scene (a streamed
+// reset). The scene's first player entity then re-poses it
+// (SceneDesc::repose) rather than spawning a second, so there is a player on
+// every frame of the load.
+//
+// Stored in the World as std::shared_ptr<AsyncSceneLoader> (it owns a
+// thread). No Jolt or Raylib dependency — compilable in the headless test
+// target.
+// ---------------------------------------------------------------------------
+
+class AsyncSceneLoader {
+public:
+    using Prepare = std::function<void(const SceneEntityDesc&)>;
+
+    enum class State { Idle, Parsing, Committing, Failed };
+
+    AsyncSceneLoader() = default;
+    ~AsyncSceneLoader() { cancel(); }
+
+    AsyncSceneLoader(const AsyncSceneLoader&)            = delete;
+    AsyncSceneLoader& operator=(const AsyncSceneLoader&) = delete;
+
+    // Begins loading `path`, cancelling any load already in flight (entities
+    // it already committed stay in the world). `player`, if alive, is
+    // re-posed by the scene's first player entity.
+    void start(const std::string& path, Prepare prepare = {}, std::optional<ecs::Entity> player = std::nullopt);
+
+    // Stops the worker and drops anything not yet committed.
+    void cancel();
+
+    // Commits up to `budget` staged entities. See the header comment.
+    bool pump(ecs::World& world, size_t budget);
+
+    State state() const;
+    bool  busy() const { const State s = state(); return s == State::Parsing || s == State::Committing; }
+
+    // 0 → 1 over the whole load: parsing fills the first half (by entities
+    // decoded, against the previous load's size when known), committing the
+    // second.
+    float  progress() const;
+    size_t parsed()    const { return parsed_.load(std::memory_order_relaxed); }
+    size_t committed() const { return committed_; }
+    size_t total()     const { return total_; }
+
+private:
+    enum class Worker : int { Running, Ready, Failed };
+
+    std::thread                  thread_;
+    std::atomic<bool>            cancel_{false};
+    std::atomic<int>             worker_{static_cast<int>(Worker::Ready)};
+    std::atomic<size_t>          parsed_{0};
+    std::vector<SceneEntityDesc> staged_;      // owned by the worker until Ready
+    size_t                       committed_     = 0;
+    size_t                       total_         = 0;
+    size_t                       expected_      = 0; // previous load's size, for progress
+    bool                         active_        = false;
+    bool                         final_pending_ = false;
+    bool                         failed_        = false;
+    std::optional<ecs::Entity>   player_;            // kept across a streamed reset; re-posed once
+};
@@ -0,0 +1,344 @@
+#include "scene_binary.hpp"
+#include "components.hpp"
+#include <ecs/modules/transform.hpp>
+#include <bit>
+#include <cstring>
+
+static_assert(std::endian::native == std::endian::little,
+              "SceneBinary: .pscn files are little-endian");
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// Accumulates one column-major section; each row pushes one value to every
+// column. Floats are stored by bit pattern.
+struct ColumnSection {
+    SceneBinary::Section               kind;
+    uint32_t                           columns;
+    std::vector<std::vector<uint32_t>> data;
+
+    ColumnSection(SceneBinary::Section k, uint32_t cols) : kind(k), columns(cols), data(cols) {}
+
+    uint32_t rows() const { return static_cast<uint32_t>(data[0].size()); }
+
+    void push(uint32_t col, uint32_t v) { data[col].push_back(v); }
+    void push(uint32_t col, float v)    { data[col].push_back(std::bit_cast<uint32_t>(v)); }
+};
+
+void append_bytes(std::vector<uint8_t>& out, const void* src, size_t n) {
+    const auto* p = static_cast<const uint8_t*>(src);
+    out.insert(out.end(), p, p + n);
+}
+
+void pad4(std::vector<uint8_t>& out) {
+    while (out.size() % 4) out.push_back(0);
+}
+
+} // namespace
+
+void SceneBinary::write(const std::vector<SceneEntityDesc>& entities, std::vector<uint8_t>& out) {
+    ColumnSection names(Section::Names, 3);
+    ColumnSection xf(Section::Transform, 11);
+    ColumnSection box(Section::Box, 4);
+    ColumnSection sphere(Section::Sphere, 2);
+    ColumnSection shape(Section::Shape, 3);
+    ColumnSection mesh(Section::Mesh, 9);
+    ColumnSection rb(Section::RigidBody, 12);
+    ColumnSection ch(Section::Character, 5);
+    ColumnSection tags(Section::Tags, 2);
+    std::vector<uint8_t> strings;
+
+    for (uint32_t i = 0; i < entities.size(); ++i) {
+        const SceneEntityDesc& d = entities[i];
+        if (!d.name.empty()) {
+            names.push(0, i);
+            names.push(1, static_cast<uint32_t>(strings.size()));
+            names.push(2, static_cast<uint32_t>(d.name.size()));
+            append_bytes(strings, d.name.data(), d.name.size());
+        }
+        if (d.transform) {
+            const auto& t = *d.transform;
+            const float v[10] = {t.position.x, t.position.y, t.position.z,
+                                 t.rotation.x, t.rotation.y, t.rotation.z, t.rotation.w,
+                                 t.scale.x, t.scale.y, t.scale.z};
+            xf.push(0, i);
+            for (uint32_t c = 0; c < 10; ++c) xf.push(c + 1, v[c]);
+        }
+        if (d.box_collider) {
+            box.push(0, i);
+            box.push(1, d.box_collider->half_extents.x);
+            box.push(2, d.box_collider->half_extents.y);
+            box.push(3, d.box_collider->half_extents.z);
+        }
+        if (d.sphere_collider) {
+            sphere.push(0, i);
+            sphere.push(1, d.sphere_collider->radius);
+        }
+        if (d.shape_collider) {
+            shape.push(0, i);
+            shape.push(1, static_cast<uint32_t>(strings.size()));
+            shape.push(2, static_cast<uint32_t>(d.shape_collider->shape.size()));
+            append_bytes(strings, d.shape_collider->shape.data(), d.shape_collider->shape.size());
+        }
+        if (d.mesh) {
+            const auto& m = *d.mesh;
+            mesh.push(0, i);
+            mesh.push(1, static_cast<uint32_t>(m.shape_type));
+            mesh.push(2, m.color.r);
+            mesh.push(3, m.color.g);
+            mesh.push(4, m.color.b);
+            mesh.push(5, m.color.a);
+            mesh.push(6, m.scale_offset.x);
+            mesh.push(7, m.scale_offset.y);
+            mesh.push(8, m.scale_offset.z);
+        }
+        if (d.rigid_body) {
+            const auto& r = *d.rigid_body;
+            rb.push(0, i);
+            rb.push(1, static_cast<uint32_t>(r.type));
+            rb.push(2, r.mass);
+            rb.push(3, r.friction);
+            rb.push(4, r.restitution);
+            rb.push(5, static_cast<uint32_t>(r.sensor ? 1 : 0));
+            rb.push(6, static_cast<uint32_t>(strings.size()));
+            rb.push(7, static_cast<uint32_t>(r.layer.size()));
+            append_bytes(strings, r.layer.data(), r.layer.size());
+            rb.push(8, (r.allow_sleeping ? RB_ALLOW_SLEEPING : 0u) | (r.start_asleep ? RB_START_ASLEEP : 0u));
+            rb.push(9, r.linear_damping);
+            rb.push(10, r.angular_damping);
+            rb.push(11, static_cast<uint32_t>(r.motion_quality));
+        }
+        if (d.character) {
+            const auto& c = *d.character;
+            ch.push(0, i);
+            ch.push(1, c.height);
+            ch.push(2, c.radius);
+            ch.push(3, c.mass);
+            ch.push(4, c.max_slope_angle);
+        }
+        const uint32_t flags = (d.world_tag ? TAG_WORLD : 0u) | (d.player_tag ? TAG_PLAYER : 0u);
+        if (flags) {
+            tags.push(0, i);
+            tags.push(1, flags);
+        }
+    }
+
+    const ColumnSection* cols[] = {&names, &xf, &box, &sphere, &shape, &mesh, &rb, &ch, &tags};
+    std::vector<SectionEntry> table;
+
+    out.clear();
+    const uint32_t section_count = static_cast<uint32_t>(std::size(cols)) + 1;
+    out.resize(sizeof(Header) + section_count * sizeof(SectionEntry));
+
+    for (const ColumnSection* s : cols) {
+        SectionEntry e{static_cast<uint32_t>(s->kind), s->rows(), s->columns,
+                       static_cast<uint32_t>(out.size()), s->rows() * s->columns * 4u};
+        for (const auto& column : s->data) append_bytes(out, column.data(), column.size() * 4);
+        table.push_back(e);
+    }
+    table.push_back({static_cast<uint32_t>(Section::Strings), static_cast<uint32_t>(strings.size()), 0,
+                     static_cast<uint32_t>(out.size()), static_cast<uint32_t>(strings.size())});
+    append_bytes(out, strings.data(), strings.size());
+    pad4(out);
+
+    Header h{};
+    std::memcpy(h.magic, MAGIC, 4);
+    h.version       = VERSION;
+    h.entity_count  = static_cast<uint32_t>(entities.size());
+    h.section_count = section_count;
+    std::memcpy(out.data(), &h, sizeof(h));
+    std::memcpy(out.data() + sizeof(h), table.data(), table.size() * sizeof(SectionEntry));
+}
+
+// ---------------------------------------------------------------------------
+// Reader
+// ---------------------------------------------------------------------------
+
+namespace {
+
+// Read-only view of one validated column section.
+struct ColumnView {
+    const uint8_t* base  = nullptr;
+    uint32_t       count = 0;
+
+    uint32_t u32(uint32_t col, uint32_t row) const {
+        uint32_t v;
+        std::memcpy(&v, base + (size_t(col) * count + row) * 4, 4);
+        return v;
+    }
+    float f32(uint32_t col, uint32_t row) const { return std::bit_cast<float>(u32(col, row)); }
+    ecs::Vec3 vec3(uint32_t col, uint32_t row) const { return {f32(col, row), f32(col + 1, row), f32(col + 2, row)}; }
+};
+
+constexpr uint32_t expected_columns(SceneBinary::Section s) {
+    switch (s) {
+    case SceneBinary::Section::Names:     return 3;
+    case SceneBinary::Section::Strings:   return 0;
+    case SceneBinary::Section::Transform: return 11;
+    case SceneBinary::Section::Box:       return 4;
+    case SceneBinary::Section::Sphere:    return 2;
+    case SceneBinary::Section::Mesh:      return 9;
+    case SceneBinary::Section::RigidBody: return 12;
+    case SceneBinary::Section::Character: return 5;
+    case SceneBinary::Section::Tags:      return 2;
+    case SceneBinary::Section::Shape:     return 3;
+    }
+    return ~0u;
+}
+
+} // namespace
+
+bool SceneBinary::spawn(ecs::World& world, const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    if (!bytes || size < sizeof(Header)) return false;
+
+    Header h;
+    std::memcpy(&h, bytes, sizeof(h));
+    if (std::memcmp(h.magic, MAGIC, 4) != 0 || h.version != VERSION) return false;
+    if (h.section_count > (size - sizeof(Header)) / sizeof(SectionEntry)) return false;
+
+    // Validate everything before touching the world, so a bad file spawns nothing.
+    ColumnView views[16] = {};
+    for (uint32_t s = 0; s < h.section_count; ++s) {
+        SectionEntry e;
+        std::memcpy(&e, bytes + sizeof(Header) + s * sizeof(SectionEntry), sizeof(e));
+        if (e.kind == 0 || e.kind >= std::size(views)) continue; // unknown: skip (forward compatible)
+        const uint32_t cols = expected_columns(static_cast<Section>(e.kind));
+        if (cols == ~0u) continue;
+        if (uint64_t(e.offset) + e.bytes > size) return false;
+        if (cols == 0) {
+            if (e.bytes != e.count) return false;
+        } else {
+            if (e.columns != cols || uint64_t(e.count) * cols * 4 != e.bytes) return false;
+            if (e.offset % 4) return false;
+        }
+        views[e.kind] = {bytes + e.offset, e.count};
+    }
+    for (size_t k = 0; k < std::size(views); ++k) {
+        if (k == static_cast<size_t>(Section::Strings)) continue;
+        const ColumnView& v = views[k];
+        for (uint32_t r = 0; r < v.count; ++r)
+            if (v.u32(0, r) >= h.entity_count) return false;
+    }
+    const ColumnView& names_v = views[static_cast<size_t>(Section::Names)];
+    const uint32_t    strings = views[static_cast<size_t>(Section::Strings)].count;
+    for (uint32_t r = 0; r < names_v.count; ++r)
+        if (uint64_t(names_v.u32(1, r)) + names_v.u32(2, r) > strings) return false;
+    const ColumnView& shape_v = views[static_cast<size_t>(Section::Shape)];
+    for (uint32_t r = 0; r < shape_v.count; ++r)
+        if (uint64_t(shape_v.u32(1, r)) + shape_v.u32(2, r) > strings) return false;
+    const ColumnView& mesh_v = views[static_cast<size_t>(Section::Mesh)];
+    for (uint32_t r = 0; r < mesh_v.count; ++r)
+        if (mesh_v.u32(1, r) > static_cast<uint32_t>(ShapeType::Capsule)) return false;
+    const ColumnView& rb_v = views[static_cast<size_t>(Section::RigidBody)];
+    for (uint32_t r = 0; r < rb_v.count; ++r) {
+        if (rb_v.u32(1, r) > static_cast<uint32_t>(BodyType::Dynamic)) return false;
+        if (uint64_t(rb_v.u32(6, r)) + rb_v.u32(7, r) > strings) return false;
+        if (rb_v.u32(11, r) > static_cast<uint32_t>(MotionQuality::Auto)) return false;
+    }
+
+    std::vector<ecs::Entity> ents(h.entity_count);
+    for (auto& e : ents) e = world.create();
+
+    // Mirrors what was spawned, for SceneIndex (hot reload diffs against it).
+    std::vector<SceneEntityDesc> descs(h.entity_count);
+
+    const auto section = [&](Section s) -> const ColumnView& { return views[static_cast<size_t>(s)]; };
+
+    {
+        const ColumnView& v = section(Section::Names);
+        const char* blob = reinterpret_cast<const char*>(section(Section::Strings).base);
+        for (uint32_t r = 0; r < v.count; ++r) descs[v.u32(0, r)].name.assign(blob + v.u32(1, r), v.u32(2, r));
+    }
+
+    // Same order as SceneDesc::spawn_entity, one component type at a time:
+    // every on_add hook sees its entity's earlier components already present.
+    {
+        const ColumnView& v = section(Section::Transform);
+        for (uint32_t r = 0; r < v.count; ++r) {
+            const uint32_t i = v.u32(0, r);
+            const ecs::LocalTransform lt{
+                v.vec3(1, r),
+                ecs::Quat{v.f32(4, r), v.f32(5, r), v.f32(6, r), v.f32(7, r)},
+                v.vec3(8, r)};
+            world.add(ents[i], lt);
+            world.add(ents[i], ecs::WorldTransform{});
+            descs[i].transform = lt;
+        }
+    }
+    {
+        const ColumnView& v = section(Section::Box);
+        for (uint32_t r = 0; r < v.count; ++r) {
+            const uint32_t i = v.u32(0, r);
+            world.add(ents[i], *(descs[i].box_collider = BoxCollider{v.vec3(1, r)}));
+        }
+    }
+    {
+        const ColumnView& v = section(Section::Sphere);
+        for (uint32_t r = 0; r < v.count; ++r) {
+            const uint32_t i = v.u32(0, r);
+            world.add(ents[i], *(descs[i].sphere_collider = SphereCollider{v.f32(1, r)}));
+        }
+    }
+    {
+        const ColumnView& v = section(Section::Shape);
+        const char* blob = reinterpret_cast<const char*>(section(Section::Strings).base);
+        for (uint32_t r = 0; r < v.count; ++r) {
+            const uint32_t i = v.u32(0, r);
+            world.add(ents[i], *(descs[i].shape_collider = ShapeCollider{std::string(blob + v.u32(1, r), v.u32(2, r))}));
+        }
+    }
+    {
+        const ColumnView& v = section(Section::Mesh);
+        for (uint32_t r = 0; r < v.count; ++r) {
+            const uint32_t i = v.u32(0, r);
+            world.add(ents[i], *(descs[i].mesh = MeshRenderer{
+                static_cast<ShapeType>(v.u32(1, r)),
+                Color4{v.f32(2, r), v.f32(3, r), v.f32(4, r), v.f32(5, r)},
+                v.vec3(6, r)}));
+        }
+    }
+    {
+        const ColumnView& v = section(Section::RigidBody);
+        const char* blob = reinterpret_cast<const char*>(section(Section::Strings).base);
+        for (uint32_t r = 0; r < v.count; ++r) {
+            const uint32_t i     = v.u32(0, r);
+            const uint32_t flags = v.u32(8, r);
+            world.add(ents[i], *(descs[i].rigid_body = RigidBodyConfig{
+                static_cast<BodyType>(v.u32(1, r)), v.f32(2, r), v.f32(3, r), v.f32(4, r), v.u32(5, r) != 0,
+                std::string(blob + v.u32(6, r), v.u32(7, r)),
+                (flags & RB_ALLOW_SLEEPING) != 0, (flags & RB_START_ASLEEP) != 0, v.f32(9, r), v.f32(10, r),
+                static_cast<MotionQuality>(v.u32(11, r))}));
+        }
+    }
+    {
+        const ColumnView& v = section(Section::Character);
+        for (uint32_t r = 0; r < v.count; ++r) {
+            const uint32_t i = v.u32(0, r);
+            world.add(ents[i], *(descs[i].character = CharacterControllerConfig{
+                v.f32(1, r), v.f32(2, r), v.f32(3, r), v.f32(4, r)}));
+        }
+    }
+    {
+        const ColumnView& v = section(Section::Tags);
+        for (uint32_t r = 0; r < v.count; ++r) {
+            const uint32_t i = v.u32(0, r);
+            const ecs::Entity e = ents[i];
+            const uint32_t flags = v.u32(1, r);
+            descs[i].world_tag  = (flags & TAG_WORLD) != 0;
+            descs[i].player_tag = (flags & TAG_PLAYER) != 0;
+            if (flags & TAG_WORLD) world.add(e, WorldTag{});
+            if (flags & TAG_PLAYER) {
+                world.add(e, PlayerTag{});
+                world.add(e, PlayerInput{});
+                world.add(e, PlayerState{});
+            }
+        }
+    }
+
+    for (uint32_t i = 0; i < h.entity_count; ++i) SceneDesc::record(world, ents[i], descs[i]);
+    return true;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include "scene_desc.hpp"
+#include <ecs/ecs.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// SceneBinary — the baked ".pscn" scene format.
+//
+// JSON stays the authoring format; `scene_bake` (tools/scene_bake) turns it
+// into this packed layout so the loader does no text parsing or per-field
+// key lookups. A file is:
+//
+//   Header        { magic "PSCN", version, entity_count, section_count }
+//   Section[]     { kind, count, columns, offset, bytes }
+//   payload       (sections, 4-byte aligned)
+//
+// Component sections are column-major (SoA): `columns` arrays of `count`
+// 4-byte values. Column 0 is the entity index (0..entity_count-1); the rest
+// are the component's fields in declaration order, floats or u32 enums.
+// Names are a separate section pointing into a string blob, as are
+// RigidBody layer names and ShapeCollider asset names.
+//
+// All values are little-endian 32-bit; readers copy with memcpy, so the
+// payload needs no alignment beyond the file's own.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+namespace SceneBinary {
+
+inline constexpr char     MAGIC[4] = {'P', 'S', 'C', 'N'};
+inline constexpr uint32_t VERSION  = 5;
+
+enum class Section : uint32_t {
+    Names     = 1, // columns: entity, blob offset, length
+    Strings   = 2, // raw bytes, columns = 0
+    Transform = 3, // px py pz  qx qy qz qw  sx sy sz
+    Box       = 4, // hx hy hz
+    Sphere    = 5, // radius
+    Mesh      = 6, // shape  r g b a  ox oy oz
+    RigidBody = 7, // type mass friction restitution sensor  layer offset, length (v2)
+                   // flags (RB_*)  linear, angular damping (v4)  motion quality (v5)
+    Character = 8, // height radius mass max_slope_angle
+    Tags      = 9, // flags (TAG_*)
+    Shape     = 10, // ShapeCollider name: blob offset, length (v3)
+};
+
+inline constexpr uint32_t TAG_WORLD  = 1u << 0;
+inline constexpr uint32_t TAG_PLAYER = 1u << 1;
+
+inline constexpr uint32_t RB_ALLOW_SLEEPING = 1u << 0;
+inline constexpr uint32_t RB_START_ASLEEP   = 1u << 1;
+
+struct Header {
+    char     magic[4];
+    uint32_t version;
+    uint32_t entity_count;
+    uint32_t section_count;
+};
+
+struct SectionEntry {
+    uint32_t kind;    // Section
+    uint32_t count;   // rows (or bytes for Strings)
+    uint32_t columns; // 4-byte columns per row; 0 for Strings
+    uint32_t offset;  // from start of file
+    uint32_t bytes;   // payload size; count * columns * 4 for column sections
+};
+
+// Packs decoded entities into a .pscn image (replaces `out`).
+void write(const std::vector<SceneEntityDesc>& entities, std::vector<uint8_t>& out);
+
+// Validates the image and spawns its entities. Returns false without
+// touching the world if the header, section table or any section bounds are
+// bad. Sections are added in lifecycle-safe order (see SceneDesc::spawn_entity)
+// across the whole scene, one component type at a time.
+bool spawn(ecs::World& world, const void* data, size_t size);
+
+} // namespace SceneBinary
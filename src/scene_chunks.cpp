@@ -0,0 +1,146 @@
+#include "scene_chunks.hpp"
+#include "deferred_commands.hpp"
+#include <algorithm>
+#include <cmath>
+
+// Half the XZ footprint of an entity, from its collider (or mesh) and scale.
+static float half_extent_xz(const SceneEntityDesc& d) {
+    const ecs::Vec3 s = d.transform ? d.transform->scale : ecs::Vec3{1, 1, 1};
+    const float sxz = std::max(std::fabs(s.x), std::fabs(s.z));
+    if (d.box_collider)
+        return std::max(d.box_collider->half_extents.x * std::fabs(s.x),
+                        d.box_collider->half_extents.z * std::fabs(s.z));
+    if (d.sphere_collider) return d.sphere_collider->radius * sxz;
+    return 0.5f * sxz; // unit mesh
+}
+
+static int32_t cell_of(float v, float size) {
+    return static_cast<int32_t>(std::floor(v / size));
+}
+
+// Parses through `read` (file or string), replaces any earlier chunked
+// scene, and spawns the resident entities. Streamed entities are recorded in
+// the SceneIndex as they spawn, like a load's, so a hot reload diffs them
+// instead of spawning duplicates.
+template <typename Read>
+static bool load_chunked(ecs::World& world, Read&& read, const ChunkConfig& config) {
+    std::vector<SceneEntityDesc> descs;
+    if (!read(descs)) return false;
+    if (auto* previous = world.try_resource<SceneChunks>()) previous->clear(world);
+    SceneChunks chunks;
+    for (const auto& d : chunks.build(std::move(descs), config))
+        SceneDesc::record(world, SceneDesc::spawn_entity(world, d), d);
+    world.set_resource(std::move(chunks));
+    return true;
+}
+
+bool SceneChunks::load(ecs::World& world, const std::string& path, const ChunkConfig& config) {
+    return load_chunked(world, [&](std::vector<SceneEntityDesc>& out) { return SceneDesc::read_file(path, out); },
+                        config);
+}
+
+bool SceneChunks::load_from_string(ecs::World& world, const std::string& json, const ChunkConfig& config) {
+    return load_chunked(world, [&](std::vector<SceneEntityDesc>& out) { return SceneDesc::read_string(json, out); },
+                        config);
+}
+
+std::vector<SceneEntityDesc> SceneChunks::build(std::vector<SceneEntityDesc> descs, const ChunkConfig& config) {
+    config_ = config;
+    config_.cell_size     = std::max(config_.cell_size, 1.0f);
+    config_.unload_radius = std::max(config_.unload_radius, config_.load_radius);
+    descs_.clear();
+    cells_.clear();
+    lookup_.clear();
+    live_ = 0;
+
+    std::vector<SceneEntityDesc> resident;
+    for (auto& d : descs) {
+        if (!d.transform || d.player_tag || 2.0f * half_extent_xz(d) > config_.cell_size) {
+            resident.push_back(std::move(d));
+            continue;
+        }
+        const int32_t cx = cell_of(d.transform->position.x, config_.cell_size);
+        const int32_t cz = cell_of(d.transform->position.z, config_.cell_size);
+        auto [it, inserted] = lookup_.try_emplace(key(cx, cz), static_cast<uint32_t>(cells_.size()));
+        if (inserted) {
+            cells_.emplace_back();
+            cells_.back().cx = cx;
+            cells_.back().cz = cz;
+        }
+        cells_[it->second].members.push_back(static_cast<uint32_t>(descs_.size()));
+        descs_.push_back(std::move(d));
+    }
+    return resident;
+}
+
+float SceneChunks::dist2(const Cell& c, float x, float z) const {
+    const float s  = config_.cell_size;
+    const float x0 = c.cx * s, z0 = c.cz * s;
+    const float dx = std::max({x0 - x, 0.0f, x - (x0 + s)});
+    const float dz = std::max({z0 - z, 0.0f, z - (z0 + s)});
+    return dx * dx + dz * dz;
+}
+
+size_t SceneChunks::update(ecs::World& world, float x, float z) {
+    const float load2   = config_.load_radius * config_.load_radius;
+    const float unload2 = config_.unload_radius * config_.unload_radius;
+
+    order_.clear();
+    for (uint32_t i = 0; i < cells_.size(); ++i) {
+        Cell& c = cells_[i];
+        const float d2 = dist2(c, x, z);
+        if (d2 <= load2)        c.wanted = true;
+        else if (d2 > unload2)  c.wanted = false;
+        const bool pending = c.wanted ? c.live.size() < c.members.size() : !c.live.empty();
+        if (pending) order_.emplace_back(c.wanted ? d2 : -1.0f, i); // unloads sort first
+    }
+    std::sort(order_.begin(), order_.end());
+
+    size_t ops = 0;
+    for (const auto& [d2, i] : order_) {
+        Cell& c = cells_[i];
+        while (ops < config_.budget) {
+            if (c.wanted) {
+                if (c.live.size() == c.members.size()) break;
+                const SceneEntityDesc& d = descs_[c.members[c.live.size()]];
+                const ecs::Entity      e = SceneDesc::spawn_entity(world, d);
+                SceneDesc::record(world, e, d);
+                c.live.push_back(e);
+                ++live_;
+            } else {
+                if (c.live.empty()) break;
+                despawn(world, c, c.live.size() - 1);
+                c.live.pop_back();
+                --live_;
+            }
+            ++ops;
+        }
+        if (ops >= config_.budget) break;
+    }
+    if (ops) DeferredCommands::flush_all(world);
+    return ops;
+}
+
+void SceneChunks::despawn(ecs::World& world, const Cell& c, size_t i) {
+    const ecs::Entity e = c.live[i];
+    SceneDesc::forget(world, e, descs_[c.members[i]]);
+    if (world.alive(e)) world.destroy(e);
+}
+
+void SceneChunks::clear(ecs::World& world) {
+    for (auto& c : cells_) {
+        for (size_t i = 0; i < c.live.size(); ++i) despawn(world, c, i);
+        c.live.clear();
+    }
+    DeferredCommands::flush_all(world);
+    descs_.clear();
+    cells_.clear();
+    lookup_.clear();
+    live_ = 0;
+}
+
+size_t SceneChunks::loaded_cells() const {
+    size_t n = 0;
+    for (const auto& c : cells_) n += (!c.members.empty() && c.live.size() == c.members.size());
+    return n;
+}
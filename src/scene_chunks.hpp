@@ -0,0 +1,90 @@
+#pragma once
+#include "scene_desc.hpp"
+#include <ecs/ecs.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// SceneChunks — streams a large scene in and out around the player.
+//
+// load() parses a scene once into SceneEntityDescs and bins them into square
+// XZ cells of `cell_size` metres by transform position. On each update()
+// (SceneModule's Pre-Update "SceneChunks" system, from the PlayerTag's
+// WorldTransform):
+//
+//   - a cell whose nearest point is within load_radius is wanted,
+//   - a wanted cell only becomes unwanted beyond unload_radius (hysteresis,
+//     so standing on a boundary doesn't thrash),
+//   - at most `budget` entities are spawned or destroyed per update —
+//     unloads first, then loads nearest-cell-first.
+//
+// Live entities and Jolt bodies are therefore bounded by the view radius,
+// not the level; only the decoded descriptions of far cells stay in memory.
+//
+// Some entities are resident (spawned by load() and never streamed): the
+// player, anything without a transform, and anything wider than a cell
+// (ground planes), which would otherwise vanish with the cell holding its
+// centre. Streamed entities are respawned at their authored pose, and are
+// in the SceneIndex (SceneDesc::record) while they are live, so a hot reload
+// updates them in place. Loading a chunked scene again first clears the
+// previous one's streamed entities.
+//
+// Stored as a world resource. No Jolt or Raylib dependency — compilable in
+// the headless test target.
+// ---------------------------------------------------------------------------
+
+struct ChunkConfig {
+    float  cell_size     = 32.0f;
+    float  load_radius   = 64.0f;
+    float  unload_radius = 80.0f;  // must be >= load_radius
+    size_t budget        = 128;    // entity spawns + destroys per update
+};
+
+class SceneChunks {
+public:
+    // Parse the scene, spawn its resident entities and set the SceneChunks
+    // resource. Returns false (spawning nothing) if the file cannot be read
+    // or parsed. Call PhysicsModule::commit_bodies afterwards, like a load.
+    static bool load(ecs::World& world, const std::string& path, const ChunkConfig& config = {});
+    static bool load_from_string(ecs::World& world, const std::string& json, const ChunkConfig& config = {});
+
+    // Bins `descs`; returns the resident ones for the caller to spawn.
+    std::vector<SceneEntityDesc> build(std::vector<SceneEntityDesc> descs, const ChunkConfig& config);
+
+    // Streams cells around (x, z). Returns the number of entities spawned or
+    // destroyed (<= config.budget). Outside any each() iteration.
+    size_t update(ecs::World& world, float x, float z);
+
+    // Destroys every streamed entity still alive and forgets the scene.
+    void clear(ecs::World& world);
+
+    size_t cell_count()   const { return cells_.size(); }
+    size_t loaded_cells() const;   // cells with every member live
+    size_t live()         const { return live_; }
+    size_t streamed()     const { return descs_.size(); }
+    const ChunkConfig& config() const { return config_; }
+
+private:
+    struct Cell {
+        int32_t                  cx = 0, cz = 0;
+        std::vector<uint32_t>    members;  // indices into descs_
+        std::vector<ecs::Entity> live;     // spawned for members[0 .. live.size())
+        bool                     wanted = false;
+    };
+
+    ChunkConfig                            config_;
+    std::vector<SceneEntityDesc>           descs_;
+    std::vector<Cell>                      cells_;
+    std::unordered_map<uint64_t, uint32_t> lookup_;
+    std::vector<std::pair<float, uint32_t>> order_; // scratch: (distance², cell)
+    size_t                                 live_ = 0;
+
+    static uint64_t key(int32_t cx, int32_t cz) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(cx)) << 32) | static_cast<uint32_t>(cz);
+    }
+    float dist2(const Cell& c, float x, float z) const;
+    void  despawn(ecs::World& world, const Cell& c, size_t i); // live[i]: out of the SceneIndex and the World
+};
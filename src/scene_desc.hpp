@@ -0,0 +1,99 @@
+#pragma once
+#include "components.hpp"
+#include <ecs/ecs.hpp>
+#include <ecs/modules/transform.hpp>
+#include <nlohmann/json_fwd.hpp>
+#include <atomic>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// SceneEntityDesc — one scene entity, decoded but not yet spawned.
+//
+// The middle step between every scene source (JSON DOM, baked binary) and
+// the World. spawn_entity() is the single place that knows the
+// lifecycle-safe add order, so all loaders get it for free.
+//
+// Internal to the scene loaders (scene.cpp, scene_binary.cpp); game code
+// uses SceneLoader.
+// ---------------------------------------------------------------------------
+
+struct SceneEntityDesc {
+    std::string name; // "_name" in JSON; empty if absent
+
+    std::optional<ecs::LocalTransform>        transform;
+    std::optional<BoxCollider>                box_collider;
+    std::optional<SphereCollider>             sphere_collider;
+    std::optional<ShapeCollider>              shape_collider;
+    std::optional<MeshRenderer>               mesh;
+    std::optional<RigidBodyConfig>            rigid_body;
+    std::optional<CharacterControllerConfig>  character;
+    bool                                      world_tag  = false;
+    bool                                      player_tag = false;
+};
+
+// ---------------------------------------------------------------------------
+// SceneIndex — world resource recording what the loaders spawned.
+//
+// Named entities ("_name") map to their entity and the description they were
+// spawned from; SceneLoader::reload diffs a new scene against these. Unnamed
+// entities cannot be matched and are only listed so reload can replace them.
+// Cleared by SceneLoader::unload.
+// ---------------------------------------------------------------------------
+
+struct SceneIndex {
+    struct Entry {
+        ecs::Entity     entity;
+        SceneEntityDesc desc;
+    };
+    std::unordered_map<std::string, Entry> named;
+    std::vector<ecs::Entity>               unnamed;
+};
+
+namespace SceneDesc {
+
+// Decodes one element of a scene's "entities" array. Throws on malformed
+// input (unknown shape or body type, wrong value types).
+SceneEntityDesc parse_entity(const nlohmann::json& e);
+
+// Creates the entity and adds its components in lifecycle-safe order:
+// transform → colliders → mesh → rigid_body / character → tags, so on_add
+// hooks fire with sibling data present.
+ecs::Entity spawn_entity(ecs::World& world, const SceneEntityDesc& desc);
+
+// Same order as spawn_entity, but only the entity is created now: its
+// components are queued on world.deferred() and arrive (firing their hooks)
+// at the next flush. Records the entity in the SceneIndex.
+ecs::Entity spawn_deferred(ecs::World& world, const SceneEntityDesc& desc);
+
+// Puts a kept entity back where `desc` spawns it instead of spawning a new
+// one: its transform (bodies and characters via PhysicsTeleport), fresh
+// PlayerInput / PlayerState, and a SceneIndex record. Its other components
+// are left as they are. Used for the player across a streamed reset.
+void repose(ecs::World& world, ecs::Entity e, const SceneEntityDesc& desc);
+
+// Streams a JSON scene file into `out` without touching any World. Safe to
+// call from a worker thread. Stops early, returning false, if `cancel` is
+// set. `parsed` (if given) counts entities decoded so far.
+bool read_file(const std::string& path, std::vector<SceneEntityDesc>& out,
+               const std::atomic<bool>* cancel = nullptr, std::atomic<size_t>* parsed = nullptr);
+bool read_string(const std::string& json, std::vector<SceneEntityDesc>& out);
+
+// Records a spawned entity in the world's SceneIndex (created on first use).
+// A name already present in the index is recorded as unnamed instead.
+void record(ecs::World& world, ecs::Entity e, const SceneEntityDesc& desc);
+
+// Drops an entity record() added, before the caller destroys it (a streamed
+// cell going out). Nothing happens if it is not in the index.
+void forget(ecs::World& world, ecs::Entity e, const SceneEntityDesc& desc);
+
+// Field-wise comparisons used by reload. same_structure() covers everything
+// whose change needs the entity respawned: colliders, body and character
+// configs, tags, and whether a transform or mesh is present at all.
+bool same_structure(const SceneEntityDesc& a, const SceneEntityDesc& b);
+bool same_transform(const SceneEntityDesc& a, const SceneEntityDesc& b);
+bool same_mesh(const SceneEntityDesc& a, const SceneEntityDesc& b);
+
+} // namespace SceneDesc
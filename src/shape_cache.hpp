@@ -0,0 +1,137 @@
+#pragma once
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// ---------------------------------------------------------------------------
+// ShapeCache — shared, immutable collision shapes keyed by type + size.
+//
+// Owned by PhysicsContext. Jolt shapes are ref-counted and immutable once
+// built, so every body with the same collider dimensions can share one
+// instance. Dimensions are quantized to QUANTUM metres so float noise from
+// scene files (0.5 vs 0.50000006) doesn't defeat the cache.
+//
+// Shape assets (ShapeCollider: compound, mesh, height field) are cached by
+// name. named() runs `load` once per name, and a failed load is not cached,
+// so a fixed file is picked up on the next try.
+//
+// prune() drops entries held only by the cache (no live body uses them);
+// PhysicsModule::commit_bodies calls it after scene loads.
+//
+// Thread-safe: the async scene loader warms the cache from its worker while
+// the main thread creates bodies.
+// ---------------------------------------------------------------------------
+
+class ShapeCache {
+public:
+    static constexpr float QUANTUM = 0.001f; // 1 mm
+
+    JPH::RefConst<JPH::Shape> box(const JPH::Vec3& half_extents) {
+        const Key key{Kind::Box, q(half_extents.GetX()), q(half_extents.GetY()), q(half_extents.GetZ())};
+        return get_or_create(key, [&]() -> JPH::RefConst<JPH::Shape> {
+            return new JPH::BoxShape(half_extents);
+        });
+    }
+
+    JPH::RefConst<JPH::Shape> sphere(float radius) {
+        const Key key{Kind::Sphere, q(radius), 0, 0};
+        return get_or_create(key, [&]() -> JPH::RefConst<JPH::Shape> {
+            return new JPH::SphereShape(radius);
+        });
+    }
+
+    // `load` returns the shape (or nullptr) for an asset name; it runs with
+    // the cache locked, so concurrent callers load each name once.
+    template <typename Load>
+    JPH::RefConst<JPH::Shape> named(const std::string& name, Load&& load) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = named_.find(name);
+        if (it != named_.end()) {
+            ++hits_;
+            return it->second;
+        }
+        ++misses_;
+        auto shape = load();
+        if (shape) named_.emplace(name, shape);
+        return shape;
+    }
+
+    // Releases shapes no body references any more. Returns the number dropped.
+    size_t prune() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return prune(shapes_) + prune(named_);
+    }
+
+    void clear() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        shapes_.clear();
+        named_.clear();
+    }
+
+    size_t   size()   const { std::lock_guard<std::mutex> lock(mutex_); return shapes_.size() + named_.size(); }
+    uint64_t hits()   const { std::lock_guard<std::mutex> lock(mutex_); return hits_; }
+    uint64_t misses() const { std::lock_guard<std::mutex> lock(mutex_); return misses_; }
+
+private:
+    enum class Kind : uint8_t { Box, Sphere };
+
+    struct Key {
+        Kind    kind;
+        int32_t a, b, c;
+        bool operator==(const Key& o) const {
+            return kind == o.kind && a == o.a && b == o.b && c == o.c;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key& k) const {
+            uint64_t h = static_cast<uint64_t>(k.kind);
+            for (int32_t v : {k.a, k.b, k.c})
+                h = (h ^ static_cast<uint32_t>(v)) * 0x100000001b3ull; // FNV-1a step
+            return static_cast<size_t>(h);
+        }
+    };
+
+    std::unordered_map<Key, JPH::RefConst<JPH::Shape>, KeyHash> shapes_;
+    std::unordered_map<std::string, JPH::RefConst<JPH::Shape>>  named_;
+    uint64_t hits_   = 0;
+    uint64_t misses_ = 0;
+    mutable std::mutex mutex_;
+
+    static int32_t q(float v) { return static_cast<int32_t>(std::lround(v / QUANTUM)); }
+
+    template <typename Map>
+    static size_t prune(Map& map) {
+        size_t dropped = 0;
+        for (auto it = map.begin(); it != map.end();) {
+            if (it->second->GetRefCount() <= 1) {
+                it = map.erase(it);
+                ++dropped;
+            } else {
+                ++it;
+            }
+        }
+        return dropped;
+    }
+
+    template <typename Make>
+    JPH::RefConst<JPH::Shape> get_or_create(const Key& key, Make&& make) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = shapes_.find(key);
+        if (it != shapes_.end()) {
+            ++hits_;
+            return it->second;
+        }
+        ++misses_;
+        auto shape = make();
+        shapes_.emplace(key, shape);
+        return shape;
+    }
+};
@@ -0,0 +1,147 @@
+#include "shape_cook.hpp"
+#include "mapped_file.hpp"
+#include "physics_handles.hpp"
+#include <Jolt/Core/StreamIn.h>
+#include <Jolt/Core/StreamOut.h>
+#include <Jolt/Physics/Collision/Shape/BoxShape.h>
+#include <Jolt/Physics/Collision/Shape/CapsuleShape.h>
+#include <Jolt/Physics/Collision/Shape/HeightFieldShape.h>
+#include <Jolt/Physics/Collision/Shape/MeshShape.h>
+#include <Jolt/Physics/Collision/Shape/SphereShape.h>
+#include <Jolt/Physics/Collision/Shape/StaticCompoundShape.h>
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// Jolt streams over our own buffers, so cooking and restoring copy nothing
+// through iostreams.
+class VectorStreamOut final : public JPH::StreamOut {
+public:
+    explicit VectorStreamOut(std::vector<uint8_t>& out) : out_(out) {}
+    void WriteBytes(const void* data, size_t bytes) override {
+        const auto* p = static_cast<const uint8_t*>(data);
+        out_.insert(out_.end(), p, p + bytes);
+    }
+    bool IsFailed() const override { return false; }
+
+private:
+    std::vector<uint8_t>& out_;
+};
+
+class MemoryStreamIn final : public JPH::StreamIn {
+public:
+    MemoryStreamIn(const uint8_t* data, size_t size) : p_(data), end_(data + size) {}
+    void ReadBytes(void* out, size_t bytes) override {
+        if (bytes > static_cast<size_t>(end_ - p_)) {
+            failed_ = true;
+            std::memset(out, 0, bytes);
+            p_ = end_;
+            return;
+        }
+        std::memcpy(out, p_, bytes);
+        p_ += bytes;
+    }
+    bool IsEOF()    const override { return p_ == end_; }
+    bool IsFailed() const override { return failed_; }
+
+private:
+    const uint8_t* p_;
+    const uint8_t* end_;
+    bool           failed_ = false;
+};
+
+constexpr uint32_t k_version = JPH_VERSION_ID;
+
+JPH::RefConst<JPH::Shape> child_shape(const ShapeDesc::Child& c) {
+    switch (c.type) {
+        case ShapeDesc::Child::Type::Sphere:  return new JPH::SphereShape(c.size.x);
+        case ShapeDesc::Child::Type::Capsule: return new JPH::CapsuleShape(c.size.x, c.size.y);
+        default:                              return new JPH::BoxShape(MathBridge::ToJolt(c.size));
+    }
+}
+
+JPH::RefConst<JPH::Shape> finish(const JPH::ShapeSettings::ShapeResult& result, std::string* error) {
+    if (result.HasError()) {
+        if (error) *error = result.GetError().c_str();
+        return nullptr;
+    }
+    return result.Get();
+}
+
+} // namespace
+
+JPH::RefConst<JPH::Shape> ShapeCook::build(const ShapeDesc& d, std::string* error) {
+    switch (d.kind) {
+        case ShapeDesc::Kind::Compound: {
+            JPH::StaticCompoundShapeSettings settings;
+            for (const auto& c : d.children)
+                settings.AddShape(MathBridge::ToJolt(c.position), MathBridge::ToJolt(c.rotation), child_shape(c));
+            return finish(settings.Create(), error);
+        }
+        case ShapeDesc::Kind::Mesh: {
+            JPH::VertexList vertices;
+            vertices.reserve(d.vertices.size() / 3);
+            for (size_t i = 0; i < d.vertices.size(); i += 3)
+                vertices.push_back(JPH::Float3(d.vertices[i], d.vertices[i + 1], d.vertices[i + 2]));
+            JPH::IndexedTriangleList triangles;
+            triangles.reserve(d.triangles.size() / 3);
+            for (size_t i = 0; i < d.triangles.size(); i += 3)
+                triangles.push_back(JPH::IndexedTriangle(d.triangles[i], d.triangles[i + 1], d.triangles[i + 2]));
+            JPH::MeshShapeSettings settings(std::move(vertices), std::move(triangles));
+            return finish(settings.Create(), error);
+        }
+        case ShapeDesc::Kind::HeightField: {
+            JPH::HeightFieldShapeSettings settings(d.heights.data(), MathBridge::ToJolt(d.offset),
+                                                   MathBridge::ToJolt(d.scale), d.samples);
+            return finish(settings.Create(), error);
+        }
+    }
+    if (error) *error = "unknown shape kind";
+    return nullptr;
+}
+
+void ShapeCook::save(const JPH::Shape& shape, std::vector<uint8_t>& out) {
+    out.clear();
+    out.insert(out.end(), MAGIC, MAGIC + 4);
+    const auto* v = reinterpret_cast<const uint8_t*>(&k_version);
+    out.insert(out.end(), v, v + sizeof(k_version));
+
+    VectorStreamOut stream(out);
+    JPH::Shape::ShapeToIDMap    shapes;
+    JPH::Shape::MaterialToIDMap materials;
+    shape.SaveWithChildren(stream, shapes, materials);
+}
+
+JPH::RefConst<JPH::Shape> ShapeCook::restore(const void* data, size_t size) {
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    if (!bytes || size < 8 || std::memcmp(bytes, MAGIC, 4) != 0) return nullptr;
+    uint32_t version;
+    std::memcpy(&version, bytes + 4, sizeof(version));
+    if (version != k_version) return nullptr;
+
+    MemoryStreamIn stream(bytes + 8, size - 8);
+    JPH::Shape::IDToShapeMap    shapes;
+    JPH::Shape::IDToMaterialMap materials;
+    const JPH::Shape::ShapeResult result = JPH::Shape::sRestoreWithChildren(stream, shapes, materials);
+    if (result.HasError() || stream.IsFailed()) return nullptr;
+    return result.Get();
+}
+
+JPH::RefConst<JPH::Shape> ShapeCook::load(const std::string& dir, const std::string& name) {
+    const std::string base = dir + "/" + name;
+    if (const MappedFile cooked(base + ".jshape"); cooked) {
+        if (auto shape = restore(cooked.data(), cooked.size())) return shape;
+        std::cerr << "ShapeCook: '" << name << ".jshape' is stale or corrupt; building from JSON." << std::endl;
+    }
+
+    ShapeDesc   desc;
+    std::string error;
+    if (!ShapeDesc::read_file(base + ".json", desc, &error)) {
+        std::cerr << "ShapeCook: no usable '" << name << "' in " << dir << " (" << error << ")." << std::endl;
+        return nullptr;
+    }
+    auto shape = build(desc, &error);
+    if (!shape) std::cerr << "ShapeCook: '" << name << "' failed to build: " << error << std::endl;
+    return shape;
+}
@@ -0,0 +1,43 @@
+#pragma once
+#include "shape_desc.hpp"
+#include <Jolt/Jolt.h>
+#include <Jolt/Physics/Collision/Shape/Shape.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// ShapeCook — builds ShapeDesc assets into Jolt shapes and (de)serialises
+// them as cooked ".jshape" files.
+//
+// A cooked file is an 8-byte header { "JSHP", JPH_VERSION_ID }, followed by
+// Shape::SaveWithChildren output. That is each shape's SaveBinaryState, with
+// compound children deduplicated. A file written by a different Jolt build
+// (version or feature flags, e.g. double precision) fails the header check.
+// Restoring it skips the build work entirely: there is no BVH construction
+// for meshes, no block min/max for height fields, and no child tree for
+// compounds.
+//
+// load() is what the runtime calls (through PhysicsContext::named_shape). It
+// prefers <dir>/<name>.jshape and falls back to building <dir>/<name>.json,
+// so freshly authored shapes work before they are cooked.
+// ---------------------------------------------------------------------------
+
+namespace ShapeCook {
+
+inline constexpr char MAGIC[4] = {'J', 'S', 'H', 'P'};
+
+// Builds the Jolt shape. nullptr, with `error` set, if Jolt rejects it.
+JPH::RefConst<JPH::Shape> build(const ShapeDesc& desc, std::string* error = nullptr);
+
+// Cooked image of `shape` (replaces `out`).
+void save(const JPH::Shape& shape, std::vector<uint8_t>& out);
+
+// nullptr if the image is truncated, from another Jolt build, or corrupt.
+JPH::RefConst<JPH::Shape> restore(const void* data, size_t size);
+
+// Cooked file, else built from the JSON source; nullptr (logged) if neither.
+JPH::RefConst<JPH::Shape> load(const std::string& dir, const std::string& name);
+
+} // namespace ShapeCook
@@ -0,0 +1,92 @@
+#include "shape_desc.hpp"
+#include <nlohmann/json.hpp>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+using json = nlohmann::json;
+
+static ecs::Vec3 parse_vec3(const json& j) {
+    return {j[0].get<float>(), j[1].get<float>(), j[2].get<float>()};
+}
+
+static ShapeDesc::Child parse_child(const json& c) {
+    ShapeDesc::Child child;
+    if (c.contains("box")) {
+        child.type = ShapeDesc::Child::Type::Box;
+        child.size = parse_vec3(c.at("box"));
+    } else if (c.contains("sphere")) {
+        child.type = ShapeDesc::Child::Type::Sphere;
+        child.size = {c.at("sphere").get<float>(), 0.0f, 0.0f};
+    } else if (c.contains("capsule")) {
+        child.type = ShapeDesc::Child::Type::Capsule;
+        child.size = {c.at("capsule")[0].get<float>(), c.at("capsule")[1].get<float>(), 0.0f};
+    } else {
+        throw std::runtime_error("compound child needs box, sphere or capsule");
+    }
+    if (child.size.x <= 0.0f || (child.type != ShapeDesc::Child::Type::Sphere && child.size.y <= 0.0f)
+        || (child.type == ShapeDesc::Child::Type::Box && child.size.z <= 0.0f))
+        throw std::runtime_error("compound child sizes must be positive");
+    if (c.contains("position")) child.position = parse_vec3(c.at("position"));
+    if (c.contains("rotation")) {
+        const auto& r = c.at("rotation");
+        child.rotation = {r[0].get<float>(), r[1].get<float>(), r[2].get<float>(), r[3].get<float>()};
+    }
+    return child;
+}
+
+bool ShapeDesc::parse(const json& j, ShapeDesc& out, std::string* error) {
+    try {
+        ShapeDesc d;
+        if (j.contains("compound")) {
+            d.kind = Kind::Compound;
+            for (const auto& c : j.at("compound")) d.children.push_back(parse_child(c));
+            if (d.children.empty()) throw std::runtime_error("compound has no children");
+        } else if (j.contains("mesh")) {
+            d.kind = Kind::Mesh;
+            const auto& m = j.at("mesh");
+            d.vertices  = m.at("vertices").get<std::vector<float>>();
+            d.triangles = m.at("triangles").get<std::vector<uint32_t>>();
+            if (d.vertices.size() % 3 || d.triangles.size() % 3 || d.triangles.empty())
+                throw std::runtime_error("mesh needs xyz vertices and index triples");
+            const size_t vertex_count = d.vertices.size() / 3;
+            for (uint32_t i : d.triangles)
+                if (i >= vertex_count) throw std::runtime_error("mesh index out of range");
+        } else if (j.contains("heightfield")) {
+            d.kind = Kind::HeightField;
+            const auto& h = j.at("heightfield");
+            d.samples = h.at("samples").get<uint32_t>();
+            d.heights = h.at("heights").get<std::vector<float>>();
+            if (h.contains("offset")) d.offset = parse_vec3(h.at("offset"));
+            if (h.contains("scale"))  d.scale  = parse_vec3(h.at("scale"));
+            if (d.samples < 2 || d.heights.size() != size_t(d.samples) * d.samples)
+                throw std::runtime_error("heightfield needs samples >= 2 and samples^2 heights");
+        } else {
+            throw std::runtime_error("expected compound, mesh or heightfield");
+        }
+        out = std::move(d);
+        return true;
+    } catch (const std::exception& e) {
+        if (error) *error = e.what();
+        return false;
+    }
+}
+
+bool ShapeDesc::read_string(const std::string& json_str, ShapeDesc& out, std::string* error) {
+    const json j = json::parse(json_str, nullptr, /*allow_exceptions=*/false);
+    if (j.is_discarded()) {
+        if (error) *error = "malformed JSON";
+        return false;
+    }
+    return parse(j, out, error);
+}
+
+bool ShapeDesc::read_file(const std::string& path, ShapeDesc& out, std::string* error) {
+    std::ifstream file(path);
+    if (!file.is_open()) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    const std::string content(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>{});
+    return read_string(content, out, error);
+}
@@ -0,0 +1,55 @@
+#pragma once
+#include <ecs/ecs.hpp>
+#include <nlohmann/json_fwd.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// ShapeDesc — authored description of a collision shape asset.
+//
+// Compound, triangle-mesh and height-field colliders are too large to spell
+// out per entity. Each one lives in its own file (resources/shapes/<name>.json),
+// and entities reference it by name with ShapeCollider. shape_cook
+// (tools/shape_cook) builds the Jolt shape offline and writes <name>.jshape.
+// The runtime restores that file. It builds from the JSON only when no
+// usable cooked file exists (shape_cook.hpp).
+//
+//   { "compound":    [ { "box": [hx, hy, hz], "position": [x, y, z], "rotation": [x, y, z, w] },
+//                      { "sphere": r, ... }, { "capsule": [half_height, radius], ... } ] }
+//   { "mesh":        { "vertices": [x, y, z, ...], "triangles": [i, j, k, ...] } }
+//   { "heightfield": { "samples": n, "heights": [n * n floats, row-major],
+//                      "offset": [x, y, z], "scale": [x, y, z] } }
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+struct ShapeDesc {
+    enum class Kind : uint8_t { Compound, Mesh, HeightField };
+
+    struct Child {
+        enum class Type : uint8_t { Box, Sphere, Capsule };
+        Type      type = Type::Box;
+        ecs::Vec3 size = {0.5f, 0.5f, 0.5f}; // box: half extents; sphere: x = radius; capsule: x = half height, y = radius
+        ecs::Vec3 position{};
+        ecs::Quat rotation = {0, 0, 0, 1};
+    };
+
+    Kind kind = Kind::Compound;
+
+    std::vector<Child> children;      // Compound
+
+    std::vector<float>    vertices;   // Mesh: x, y, z per vertex
+    std::vector<uint32_t> triangles;  // Mesh: three vertex indices per triangle
+
+    uint32_t           samples = 0;   // HeightField: samples per side
+    std::vector<float> heights;       // HeightField: samples * samples, row-major
+    ecs::Vec3          offset{};
+    ecs::Vec3          scale = {1, 1, 1};
+
+    // Decode and validate one shape file's root object. On failure `out` is
+    // untouched and `error` (if given) says why.
+    static bool parse(const nlohmann::json& j, ShapeDesc& out, std::string* error = nullptr);
+    static bool read_string(const std::string& json, ShapeDesc& out, std::string* error = nullptr);
+    static bool read_file(const std::string& path, ShapeDesc& out, std::string* error = nullptr);
+};
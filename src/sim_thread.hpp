@@ -0,0 +1,81 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+// ---------------------------------------------------------------------------
+// SimThread — one dedicated thread that runs one job at a time.
+//
+// run() hands it a job and returns at once; wait() blocks until that job has
+// finished. main.cpp's pipelined mode runs each frame's simulation on it
+// while the main thread, which owns the window, the GL context and input,
+// draws the previous frame (RFC-0045). PhysicsContext owns one for the async
+// fixed step (RFC-0046). Calling run() while a job is still running first
+// waits for it.
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+class SimThread {
+public:
+    SimThread() : thread_([this] { loop(); }) {}
+
+    ~SimThread() {
+        {
+            std::lock_guard<std::mutex> lock(m_);
+            stop_ = true;
+        }
+        cv_.notify_all();
+        thread_.join();
+    }
+
+    SimThread(const SimThread&)            = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    void run(std::function<void()> job) {
+        std::unique_lock<std::mutex> lock(m_);
+        done_cv_.wait(lock, [this] { return !busy_; });
+        job_  = std::move(job);
+        busy_ = true;
+        lock.unlock();
+        cv_.notify_one();
+    }
+
+    void wait() {
+        std::unique_lock<std::mutex> lock(m_);
+        done_cv_.wait(lock, [this] { return !busy_; });
+    }
+
+    bool busy() const {
+        std::lock_guard<std::mutex> lock(m_);
+        return busy_;
+    }
+
+private:
+    mutable std::mutex      m_;
+    std::condition_variable cv_;      // job posted or stop
+    std::condition_variable done_cv_; // job finished
+    std::function<void()>   job_;
+    bool                    busy_ = false;
+    bool                    stop_ = false;
+    std::thread             thread_; // last: starts after the state above exists
+
+    void loop() {
+        std::unique_lock<std::mutex> lock(m_);
+        for (;;) {
+            cv_.wait(lock, [this] { return busy_ || stop_; });
+            if (busy_) {
+                auto job = std::move(job_);
+                lock.unlock();
+                job();
+                lock.lock();
+                busy_ = false;
+                done_cv_.notify_all();
+                continue;
+            }
+            return; // stop_ with nothing queued
+        }
+    }
+};
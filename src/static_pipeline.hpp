@@ -0,0 +1,158 @@
+#pragma once
+#include "deferred_commands.hpp"
+#include "frame_profiler.hpp"
+#include "pipeline.hpp"
+#include "pipeline_step.hpp"
+#include <ecs/ecs.hpp>
+#include <array>
+#include <cstddef>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace ecs {
+
+/**
+ * @brief A Pipeline whose systems are fixed at compile time: a list of step
+ * types (pipeline_step.hpp) in execution order.
+ *
+ * Each phase is a fold over the steps of that phase, so every call is a
+ * direct call to Step::run that the compiler can inline. There is no
+ * std::function and no per-system allocation. It has the same entry points
+ * as Pipeline (update, pre_update, logic, step_physics, step_fixed, render),
+ * the same deferred flushes and command lanes (lane i + 1 for the i-th
+ * step), and the same FrameProfiler entries when a profiler exists.
+ *
+ * The list is checked at compile time:
+ *   - steps are grouped by phase, in phase order (Pre-Update, Logic,
+ *     Physics, Render), so the list reads as the frame does,
+ *   - no step appears twice,
+ *   - every step a step lists in `after` that is also in the list comes
+ *     before it (ARCH-0013's ordering rules), and is in an earlier phase or
+ *     shares data with it.
+ *
+ * It runs serially on the calling thread. Threading, and systems chosen at
+ * runtime (flags, captured state), stay with the dynamic Pipeline. Modules
+ * still install their resources and hooks through a Pipeline; mirrors()
+ * confirms a StaticPipeline lists the same systems as the one they filled.
+ */
+template <PipelineStep... Steps>
+class StaticPipeline {
+    static constexpr size_t N = sizeof...(Steps);
+    using List = std::tuple<Steps...>;
+    template <size_t I> using At = std::tuple_element_t<I, List>;
+
+    static constexpr std::array<int, N> phases{Steps::phase...};
+
+    static constexpr bool sorted() {
+        for (size_t i = 0; i < N; ++i) {
+            if (phases[i] < FrameProfiler::PreUpdate || phases[i] >= FrameProfiler::PhaseCount) return false;
+            if (i > 0 && phases[i] < phases[i - 1]) return false;
+        }
+        return true;
+    }
+
+    template <typename S> static constexpr size_t index_of() {
+        constexpr bool same[] = {std::is_same_v<S, Steps>..., false};
+        for (size_t i = 0; i < N; ++i)
+            if (same[i]) return i;
+        return N;
+    }
+    template <typename S> static constexpr size_t count_of() { return (size_t{std::is_same_v<S, Steps>} + ... + 0); }
+
+    // Each listed predecessor that is present comes earlier (StepAfterEnforced
+    // covers the conflict).
+    template <size_t I, typename... As> static constexpr bool after_holds(TypeList<As...>) {
+        return ((index_of<As>() == N || index_of<As>() < I) && ...);
+    }
+    template <size_t... I> static constexpr bool ordered(std::index_sequence<I...>) {
+        return (after_holds<I>(typename StepAfter<At<I>>::type{}) && ...);
+    }
+
+    static_assert(sorted(), "StaticPipeline: list steps by phase (Pre-Update, Logic, Physics, Render)");
+    static_assert(((count_of<Steps>() == 1) && ...), "StaticPipeline: a step is listed twice");
+    static_assert(ordered(std::index_sequence_for<Steps...>{}),
+                  "StaticPipeline: a step is listed before a step it must run after");
+    static_assert((StepAfterEnforced<Steps>::value && ...),
+                  "StaticPipeline: a step listed in `after` shares no data with its follower, so Pipeline may reorder them");
+
+public:
+    static constexpr size_t size() { return N; }
+
+    // Main thread, while no phase runs.
+    void update(World& world, float dt) {
+        pre_update(world, dt);
+        logic(world, dt);
+    }
+
+    void pre_update(World& world, float dt) {
+        if (auto* prof = world.try_resource<FrameProfiler>()) prof->begin_frame();
+        run<FrameProfiler::PreUpdate>(world, dt);
+    }
+
+    void logic(World& world, float dt) {
+        run<FrameProfiler::Logic>(world, dt);
+        Pipeline::flush_deferred(world, flush_slot_);
+        Pipeline::flush_deferred(world, flush_slot_);
+    }
+
+    void step_physics(World& world, float dt) { run<FrameProfiler::Physics>(world, dt); }
+
+    int step_fixed(World& world, float frame_dt) {
+        return Pipeline::run_fixed(world, frame_dt, [&](float dt) { step_physics(world, dt); });
+    }
+
+    void render(World& world) { run<FrameProfiler::Render>(world, 0.0f); }
+
+    // Whether `pipeline` holds exactly these steps' names, phase by phase, in
+    // this order.
+    static bool mirrors(const Pipeline& pipeline) {
+        for (int p = FrameProfiler::PreUpdate; p < FrameProfiler::PhaseCount; ++p) {
+            std::vector<std::string> mine;
+            ((Steps::phase == p ? (void)mine.emplace_back(Steps::name) : void()), ...);
+            if (mine != pipeline.names(p)) return false;
+        }
+        return true;
+    }
+
+private:
+    std::array<int, N> slots_      = make_slots(); // FrameProfiler slots, resolved on first timed call
+    int                flush_slot_ = -1;
+
+    static constexpr std::array<int, N> make_slots() {
+        std::array<int, N> s{};
+        for (int& v : s) v = -1;
+        return s;
+    }
+
+    template <int P> void run(World& world, float dt) {
+        DeferredCommands& cmds = DeferredCommands::of(world);
+        cmds.reserve(N + 1); // lane 0 is for code outside any step
+        [&]<size_t... I>(std::index_sequence<I...>) {
+            (call<P, I>(world, dt, cmds), ...);
+        }(std::index_sequence_for<Steps...>{});
+    }
+
+    template <int P, size_t I> void call(World& world, float dt, DeferredCommands& cmds) {
+        using S = At<I>;
+        if constexpr (S::phase == P) {
+            const DeferredCommands::Scope lane(&cmds.lane(I + 1));
+            if (!world.try_resource<FrameProfiler>()) {
+                S::run(world, dt);
+                return;
+            }
+            const auto t0 = FrameProfiler::Clock::now();
+            S::run(world, dt);
+            const auto t1 = FrameProfiler::Clock::now();
+            // Re-fetch: the step may have added resources.
+            if (auto* prof = world.try_resource<FrameProfiler>()) {
+                if (slots_[I] < 0) slots_[I] = prof->slot(S::name, S::phase);
+                prof->record(slots_[I], t0, t1);
+            }
+        }
+    }
+};
+
+} // namespace ecs
@@ -0,0 +1,146 @@
+#include "stress_scene.hpp"
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <cmath>
+
+using json = nlohmann::json;
+
+namespace {
+
+constexpr float k_pi             = 3.14159265358979f;
+constexpr float k_platform_pitch = 8.0f; // grid cell per static platform, m
+constexpr float k_stack_pitch    = 3.0f; // grid cell per stack, m
+
+// xorshift32: the same stream on every platform, unlike <random>'s
+// distributions.
+struct Rng {
+    uint32_t state;
+    explicit Rng(uint32_t seed) : state(seed ? seed : 0x9E3779B9u) {}
+    uint32_t next() {
+        state ^= state << 13;
+        state ^= state >> 17;
+        state ^= state << 5;
+        return state;
+    }
+    float range(float lo, float hi) {
+        return lo + (hi - lo) * static_cast<float>(next() >> 8) * (1.0f / 16777216.0f);
+    }
+};
+
+int grid_side(int cells) {
+    return std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(cells)))));
+}
+
+json vec3(float x, float y, float z) { return json::array({x, y, z}); }
+
+json yaw(float radians) {
+    return json::array({0.0f, std::sin(radians * 0.5f), 0.0f, std::cos(radians * 0.5f)});
+}
+
+} // namespace
+
+namespace StressScene {
+
+uint32_t body_budget(const Params& p) {
+    return static_cast<uint32_t>(std::max(0, p.platforms) + std::max(0, p.bodies) + p.builder_pool + 64);
+}
+
+std::string generate(const Params& p) {
+    const int platforms  = std::max(0, p.platforms);
+    const int bodies     = std::max(0, p.bodies);
+    const int characters = std::max(0, p.characters);
+    const int height     = std::max(1, p.stack_height);
+    const int stacks     = (bodies + height - 1) / height;
+
+    Rng rng(p.seed);
+    json entities = json::array();
+    float reach = 0.0f; // furthest x / z used, for the ground
+
+    // Static platforms: a jittered grid centred on the origin.
+    const int   platform_side = grid_side(platforms);
+    const float platform_half = platforms ? platform_side * k_platform_pitch * 0.5f : 0.0f;
+    for (int i = 0; i < platforms; ++i) {
+        const float x  = -platform_half + (static_cast<float>(i % platform_side) + 0.5f) * k_platform_pitch
+                       + rng.range(-1.5f, 1.5f);
+        const float z  = -platform_half + (static_cast<float>(i / platform_side) + 0.5f) * k_platform_pitch
+                       + rng.range(-1.5f, 1.5f);
+        const float sx = rng.range(2.0f, 6.0f), sy = rng.range(0.5f, 1.5f), sz = rng.range(2.0f, 6.0f);
+        const float y  = rng.range(0.5f, 8.0f);
+        entities.push_back({
+            {"_name", "Platform " + std::to_string(i)},
+            {"transform", {{"position", vec3(x, y, z)}, {"rotation", yaw(rng.range(0.0f, k_pi))},
+                           {"scale", vec3(sx, sy, sz)}}},
+            {"mesh", {{"shape", "Box"}, {"color", {0.51, 0.51, 0.51, 1.0}}}},
+            {"box_collider", {{"half_extents", vec3(sx * 0.5f, sy * 0.5f, sz * 0.5f)}}},
+            {"rigid_body", {{"type", "Static"}}},
+            {"tags", json::array({"World"})},
+        });
+    }
+    reach = platform_half + 4.5f;
+
+    // Dynamic stacks east of the platforms, resting on the ground's top
+    // face (y = -0.5); spheres are every n-th stack, spread evenly.
+    const int   stack_side = grid_side(stacks);
+    const float stack_x0   = platform_half + 10.0f;
+    const float stack_half = stack_side * k_stack_pitch * 0.5f;
+    const float share      = std::clamp(p.sphere_share, 0.0f, 1.0f);
+    for (int s = 0, placed = 0; s < stacks; ++s) {
+        const bool  sphere = std::floor((s + 1) * share) > std::floor(s * share);
+        const float x = stack_x0 + (static_cast<float>(s % stack_side) + 0.5f) * k_stack_pitch;
+        const float z = -stack_half + (static_cast<float>(s / stack_side) + 0.5f) * k_stack_pitch;
+        const json  color = sphere ? json::array({0.0, 0.459, 0.173, 1.0}) : json::array({0.0, 0.322, 0.675, 1.0});
+        for (int k = 0; k < height && placed < bodies; ++k, ++placed) {
+            json e = {
+                {"_name", "Stack " + std::to_string(s) + "/" + std::to_string(k)},
+                {"transform", {{"position", vec3(x, static_cast<float>(k) * 1.01f, z)}}},
+                {"mesh", {{"shape", sphere ? "Sphere" : "Box"}, {"color", color}}},
+                {"rigid_body", {{"type", "Dynamic"}}},
+                {"tags", json::array({"World"})},
+            };
+            if (sphere) e["sphere_collider"] = {{"radius", 0.5}};
+            else        e["box_collider"]    = {{"half_extents", vec3(0.5f, 0.5f, 0.5f)}};
+            entities.push_back(std::move(e));
+        }
+    }
+    if (stacks) reach = std::max({reach, stack_x0 + stack_side * k_stack_pitch, stack_half});
+
+    // Characters: a ring south of the platforms, about 1.5 m apart.
+    const float ring_z = -(platform_half + 6.0f);
+    const float ring_r = std::max(2.0f, static_cast<float>(characters) * 1.5f / (2.0f * k_pi));
+    for (int c = 0; c < characters; ++c) {
+        const float a = 2.0f * k_pi * static_cast<float>(c) / static_cast<float>(characters);
+        const bool  player = c == 0;
+        entities.push_back({
+            {"_name", player ? std::string("Player") : "Character " + std::to_string(c)},
+            {"transform", {{"position", vec3(ring_r * std::cos(a), 2.0f, ring_z + ring_r * std::sin(a))}}},
+            {"mesh", {{"shape", "Capsule"}, {"color", player ? json::array({0.902, 0.161, 0.216, 1.0})
+                                                             : json::array({1.0, 0.796, 0.0, 1.0})}}},
+            {"character", json::object()},
+            {"tags", player ? json::array({"Player", "World"}) : json::array({"World"})},
+        });
+    }
+    if (characters) reach = std::max(reach, -ring_z + ring_r + 2.0f);
+
+    const float ground = std::max(50.0f, std::ceil(reach + 10.0f));
+    entities.insert(entities.begin(), json{
+        {"_name", "Ground"},
+        {"transform", {{"position", vec3(0.0f, -1.0f, 0.0f)}, {"scale", vec3(ground * 2.0f, 1.0f, ground * 2.0f)}}},
+        {"mesh", {{"shape", "Box"}, {"color", {0.314, 0.314, 0.314, 1.0}}}},
+        {"box_collider", {{"half_extents", vec3(ground, 0.5f, ground)}}},
+        {"rigid_body", {{"type", "Static"}}},
+        {"tags", json::array({"World"})},
+    });
+
+    // Jolt preallocates from these (PhysicsConfig); the temp allocator
+    // grows with the dynamic body count.
+    const uint32_t total = body_budget(p);
+    json physics = {
+        {"max_bodies",              total},
+        {"max_body_pairs",          total * 4},
+        {"max_contact_constraints", total * 4},
+        {"temp_allocator_mb",       10 + bodies / 500},
+    };
+    return json{{"physics", physics}, {"entities", entities}}.dump();
+}
+
+} // namespace StressScene
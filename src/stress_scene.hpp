@@ -0,0 +1,48 @@
+#pragma once
+#include "platform_pool.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ---------------------------------------------------------------------------
+// StressScene — parameterised, reproducible scale workloads (RFC-0058).
+//
+// generate() writes a scene JSON (the format SceneLoader reads) with:
+//
+//   - a ground slab sized to hold everything below,
+//   - `platforms` static boxes of varied size, height and yaw, on a
+//     jittered grid around the origin,
+//   - `bodies` dynamic bodies as stacks of `stack_height`, on a grid beside
+//     the platforms; `sphere_share` of the stacks are spheres, which topple,
+//   - `characters` characters in a ring; the first is the Player,
+//   - a "physics" block sizing Jolt for all of it plus `builder_pool`
+//     builder platforms (PlatformPool capacity, planted by the bench).
+//
+// Positions come from a fixed xorshift stream seeded by `seed`, not from
+// <random>'s distributions, so a given Params gives the same scene on every
+// compiler and OS. The bench generates its default scene with this, and
+// `bench --write-scene` saves one to disk.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+namespace StressScene {
+
+struct Params {
+    int      platforms    = 0;
+    int      bodies       = 500;
+    int      stack_height = 8;
+    float    sphere_share = 0.0f; // fraction of stacks made of spheres, 0..1
+    int      characters   = 1;    // the first is the Player; 0 = no player
+    size_t   builder_pool = PlatformPool::DEFAULT_CAPACITY;
+    uint32_t seed         = 1;
+};
+
+// Bodies the scene asks Jolt for: statics, dynamics and the builder pool,
+// plus headroom. Characters are CharacterVirtuals, which take no body.
+uint32_t body_budget(const Params& p);
+
+// The scene as a JSON string. Counts below zero are treated as zero.
+std::string generate(const Params& p);
+
+} // namespace StressScene
@@ -0,0 +1,58 @@
+#pragma once
+#include <algorithm>
+#include <typeindex>
+#include <typeinfo>
+#include <vector>
+
+namespace ecs {
+
+/**
+ * @brief The component and resource types a system touches, declared when it
+ * is added to the Pipeline.
+ *
+ * Two systems conflict if either writes a type the other reads or writes, or
+ * if either is exclusive. Pipeline orders conflicting systems of a phase by
+ * registration order and lets the rest run concurrently (see pipeline.hpp).
+ *
+ * Types are keys only, never instantiated: components (`WorldTransform`),
+ * resources (`MainCamera`, `Events<JumpEvent>`), or the tags below for shared
+ * state that has no type of its own.
+ *
+ * A system declared without an Access is exclusive: it runs alone, after
+ * everything registered before it and before everything registered after.
+ * Anything that makes structural changes directly (create, add, remove,
+ * destroy, set_resource) must stay exclusive. Queue them on the system's
+ * own lane, DeferredCommands::local(world) (deferred_commands.hpp), which
+ * needs no declaration, or on world.deferred() with
+ * `write<Access::Deferred>()`.
+ *
+ * Zero engine dependencies — safe to include in any target.
+ */
+struct Access {
+    struct Deferred {}; ///< world.deferred() — the shared command buffer (not a system's own CommandLane)
+
+    std::vector<std::type_index> reads;
+    std::vector<std::type_index> writes;
+    bool exclusive   = false;
+    bool main_thread = false; ///< Raylib / GLFW / audio calls: run on the Pipeline's caller
+
+    template <typename... Ts> Access& read()  { (reads.emplace_back(typeid(Ts)), ...);  return *this; }
+    template <typename... Ts> Access& write() { (writes.emplace_back(typeid(Ts)), ...); return *this; }
+    Access& on_main_thread() { main_thread = true; return *this; }
+
+    static Access all() { Access a; a.exclusive = true; return a; }
+
+    bool conflicts(const Access& o) const {
+        if (exclusive || o.exclusive) return true;
+        return overlaps(writes, o.writes) || overlaps(writes, o.reads) || overlaps(reads, o.writes);
+    }
+
+private:
+    static bool overlaps(const std::vector<std::type_index>& a, const std::vector<std::type_index>& b) {
+        return std::any_of(a.begin(), a.end(), [&](const std::type_index& t) {
+            return std::find(b.begin(), b.end(), t) != b.end();
+        });
+    }
+};
+
+} // namespace ecs
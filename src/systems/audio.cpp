@@ -1,21 +1,56 @@
 #include "audio.hpp"
 #include "../audio_resource.hpp"
+#include "../components.hpp"
 #include "../events.hpp"
 #include <raylib.h>
 
-void AudioSystem::Update(ecs::World& world, float /*dt*/) {
+using namespace ecs;
+
+namespace {
+
+// Where an event's entity is heard from. Entities without a transform (or
+// already destroyed) are heard at the listener.
+void submit_at(World& world, VoicePool& pool, AudioClip clip, Entity e) {
+    if (const auto* wt = world.try_get<WorldTransform>(e))
+        pool.submit(int(clip), {wt->matrix.m[12], wt->matrix.m[13], wt->matrix.m[14]});
+    else
+        pool.submit(int(clip));
+}
+
+} // namespace
+
+void AudioSystem::Update(World& world, float /*dt*/) {
     auto* audio = world.try_resource<AudioResource>();
     if (!audio) return;
+    VoicePool& pool = audio->pool;
+
+    VoicePool::Listener listener;
+    if (const auto* cam = world.try_resource<MainCamera>()) {
+        listener.position = cam->lerp_pos;
+        listener.right    = cam->view_right;
+    }
+    pool.begin(listener);
+    for (size_t v = 0; v < pool.voices(); ++v) pool.set_playing(v, IsSoundPlaying(audio->voices[v]));
 
     if (const auto* evts = world.try_resource<Events<JumpEvent>>()) {
-        for (const auto& ev : evts->read()) {
-            Sound& s = (ev.jump_number == 1) ? audio->snd_jump : audio->snd_jump2;
-            PlaySound(s);
-        }
+        for (const auto& ev : evts->read())
+            submit_at(world, pool, ev.jump_number == 1 ? AudioClip::Jump : AudioClip::Jump2, ev.entity);
     }
 
     if (const auto* evts = world.try_resource<Events<LandEvent>>()) {
-        if (!evts->empty())
-            PlaySound(audio->snd_land);
+        for (const auto& ev : evts->read()) submit_at(world, pool, AudioClip::Land, ev.entity);
+    }
+
+    pool.mix(audio->commands);
+    for (const VoicePool::Command& c : audio->commands) {
+        Sound& s = audio->voices[c.voice];
+        if (c.type == VoicePool::Command::Type::Stop) {
+            StopSound(s);
+            continue;
+        }
+        SetSoundVolume(s, c.volume);
+        // Raylib pans 1 = left, 0 = right.
+        SetSoundPan(s, 0.5f - 0.5f * c.pan);
+        PlaySound(s);
     }
 }
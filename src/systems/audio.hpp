@@ -2,7 +2,8 @@
 #include <ecs/ecs.hpp>
 
 // ---------------------------------------------------------------------------
-// AudioSystem — Logic-phase system; consumes JumpEvent and LandEvent.
+// AudioSystem — Logic-phase system; consumes JumpEvent and LandEvent through
+// AudioResource's VoicePool (RFC-0055).
 //
 // No Register() — no lifecycle hooks. AudioResource is loaded explicitly in
 // main.cpp (same pattern as AssetResource).
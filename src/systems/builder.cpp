@@ -1,23 +1,97 @@
 #include "builder.hpp"
 #include "../components.hpp"
-#include "../physics_context.hpp"
-#include <Jolt/Physics/Collision/RayCast.h>
-#include <Jolt/Physics/Collision/CastResult.h>
+#include "../culling.hpp"
+#include "../deferred_commands.hpp"
+#include "../fixed_time.hpp"
+#include "../physics_query.hpp"
+#include "../platform_pool.hpp"
+#include "../transform_dirty.hpp"
 #include <algorithm>
-#include <raylib.h>
 
 using namespace ecs;
 
-// Accepts only static (NON_MOVING) bodies for the platform placement raycast.
-struct StaticOnlyLayerFilter final : public JPH::ObjectLayerFilter {
-    bool ShouldCollide(JPH::ObjectLayer inLayer) const override {
-        return inLayer == Layers::NON_MOVING;
+// Spawn geometry. Character radius = 0.4; platform half-height = 0.25.
+// Default spawn: platform top at feet, so center = feet - half_h.
+static constexpr ecs::Vec3 k_platform_size   = {4.0f, 0.5f, 4.0f};
+static constexpr float     k_char_radius     = 0.4f;
+static constexpr float     k_platform_half_h = 0.25f;
+
+static ecs::LocalTransform platform_transform(const ecs::Vec3& pos) {
+    return ecs::LocalTransform{pos, {0,0,0,1}, k_platform_size};
+}
+
+static void spawn_platform(World& world, const ecs::Vec3& feet, const QueryHit* ground) {
+    float spawn_y = feet.y - k_platform_half_h;
+    // If static geometry lies within the platform volume, snap on top of it.
+    if (ground && ground->hit) spawn_y = std::max(spawn_y, ground->point.y + k_platform_half_h);
+    const ecs::Vec3 pos = {feet.x, spawn_y, feet.z};
+
+    // Pooled: move an existing platform body (RFC-0042). Its new pose
+    // reaches Jolt through PhysicsTeleport at the next commit.
+    if (auto* pool = world.try_resource<PlatformPool>()) {
+        if (auto slot = pool->acquire(world)) {
+            if (auto* lt = world.try_get<LocalTransform>(*slot)) *lt = platform_transform(pos);
+            if (auto* dirty = world.try_resource<TransformDirty>()) dirty->mark(*slot);
+            if (!world.has<PhysicsTeleport>(*slot)) DeferredCommands::local(world).add(*slot, PhysicsTeleport{});
+            // A moved static keeps its WorldTag, so rebuild the render grid.
+            if (auto* culling = world.try_resource<RenderCulling>()) {
+                const auto* ft = world.try_resource<FixedTime>();
+                culling->mark_dirty(ft ? ft->total_steps : 0);
+            }
+            return;
+        }
     }
-};
 
-void PlatformBuilderSystem::Update(World& world) {
-    float dt = GetFrameTime();
+    const ecs::Vec3 size = k_platform_size;
+    DeferredCommands::local(world).create_with(
+        platform_transform(pos),
+        ecs::WorldTransform{},
+        MeshRenderer{ShapeType::Box, Colors::Maroon},
+        BoxCollider{{size.x * 0.5f, size.y * 0.5f, size.z * 0.5f}},
+        RigidBodyConfig{BodyType::Static},
+        WorldTag{}
+    );
+}
+
+size_t PlatformBuilderSystem::FillPool(World& world) {
+    auto* pool = world.try_resource<PlatformPool>();
+    if (!pool) return 0;
+
+    // Keep live slots (nothing was unloaded), replace dead ones. Parked
+    // platforms are spaced out so that their broadphase boxes don't stack.
+    std::vector<Entity> slots = pool->slots();
+    slots.resize(pool->capacity());
+    size_t created = 0;
+    const ecs::Vec3 size = k_platform_size;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        if (world.alive(slots[i])) continue;
+        const ecs::Vec3 park = {PlatformPool::PARK.x + static_cast<float>(i) * size.x * 2.0f,
+                                PlatformPool::PARK.y, PlatformPool::PARK.z};
+        slots[i] = world.create_with(
+            platform_transform(park),
+            ecs::WorldTransform{},
+            MeshRenderer{ShapeType::Box, Colors::Maroon},
+            BoxCollider{{size.x * 0.5f, size.y * 0.5f, size.z * 0.5f}},
+            RigidBodyConfig{BodyType::Static},
+            WorldTag{}
+        );
+        ++created;
+    }
+    if (created) pool->assign(std::move(slots));
+    return created;
+}
+
+void PlatformBuilderSystem::Update(World& world, float dt) {
+    auto* query = world.try_resource<PhysicsQuery>();
+
     world.each<PlayerTag, WorldTransform, PlayerInput, PlayerState>([&](Entity, PlayerTag&, WorldTransform& wt, PlayerInput& input, PlayerState& state) {
+        // A probe submitted on an earlier frame has been answered (or its
+        // batch has gone): place the platform.
+        if (state.build_probe.valid() && (!query || query->status(state.build_probe) != QueryStatus::Pending)) {
+            spawn_platform(world, state.build_feet, query ? query->hit(state.build_probe) : nullptr);
+            state.build_probe = {};
+        }
+
         // Update cooldown
         if (state.build_cooldown > 0) {
             state.build_cooldown -= dt;
@@ -28,56 +102,22 @@ void PlatformBuilderSystem::Update(World& world) {
         bool trigger_pressed = trigger_is_down && !state.trigger_was_down;
         state.trigger_was_down = trigger_is_down;
 
-        if (trigger_pressed && state.build_cooldown <= 0) {
+        if (trigger_pressed && state.build_cooldown <= 0 && !state.build_probe.valid()) {
             state.build_cooldown = 0.25f; // Responsive cooldown
 
             // Position: beneath player
-            ecs::Vec3 player_pos = { wt.matrix.m[12], wt.matrix.m[13], wt.matrix.m[14] };
-            ecs::Vec3 size = { 4.0f, 0.5f, 4.0f };
-
-            // Character radius = 0.4; platform half-height = 0.25.
-            // Default spawn: platform top at feet, so center = feet - half_h.
-            constexpr float k_char_radius    = 0.4f;
-            constexpr float k_platform_half_h = 0.25f;
-            float feet_y  = player_pos.y - k_char_radius;
-            float spawn_y = feet_y - k_platform_half_h;
-
-            // Cast a short ray downward from the feet to detect static geometry
-            // within the platform volume. If we'd overlap it, snap on top.
-            auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
-            if (ctx_ptr && *ctx_ptr) {
-                auto& ctx = **ctx_ptr;
-                JPH::RRayCast ray{
-                    JPH::RVec3(player_pos.x, feet_y, player_pos.z),
-                    JPH::Vec3(0.f, -(size.y + 0.01f), 0.f) // down by full platform height + epsilon
-                };
-                JPH::RayCastResult result;
-                // MOVING layer sees all broadphase buckets; StaticOnlyLayerFilter
-                // then narrows hits to NON_MOVING (static) bodies only.
-                JPH::DefaultBroadPhaseLayerFilter bp_filter(
-                    ctx.object_vs_broadphase_layer_filter, Layers::MOVING);
-                StaticOnlyLayerFilter obj_filter;
-                JPH::BodyFilter body_filter;
-
-                if (ctx.physics_system->GetNarrowPhaseQuery().CastRay(
-                        ray, result, bp_filter, obj_filter, body_filter)) {
-                    // result.mFraction is in [0,1] along the ray direction
-                    float surface_top  = feet_y + result.mFraction * ray.mDirection.GetY();
-                    float surface_based = surface_top + k_platform_half_h;
-                    spawn_y = std::max(spawn_y, surface_based);
-                }
+            const ecs::Vec3 feet = { wt.matrix.m[12], wt.matrix.m[13] - k_char_radius, wt.matrix.m[14] };
+            if (!query) {
+                spawn_platform(world, feet, nullptr);
+                return;
             }
 
-            ecs::Vec3 spawn_pos = { player_pos.x, spawn_y, player_pos.z };
-
-            world.deferred().create_with(
-                ecs::LocalTransform{spawn_pos, {0,0,0,1}, size},
-                ecs::WorldTransform{},
-                MeshRenderer{ShapeType::Box, Colors::Maroon},
-                BoxCollider{{size.x * 0.5f, size.y * 0.5f, size.z * 0.5f}},
-                RigidBodyConfig{BodyType::Static},
-                WorldTag{}
-            );
+            // Cast a short ray downward from the feet (full platform height +
+            // epsilon) for static geometry. PhysicsQuerySystem answers it
+            // before CharMotor; the platform spawns next frame.
+            state.build_feet  = feet;
+            state.build_probe = query->ray(feet, {0.0f, -(k_platform_size.y + 0.01f), 0.0f},
+                                           QueryLayers::StaticOnly);
         }
     });
 }
@@ -1,7 +1,13 @@
 #pragma once
 #include <ecs/ecs.hpp>
+#include <cstddef>
 
 class PlatformBuilderSystem {
 public:
-    static void Update(ecs::World& world);
+    static void Update(ecs::World& world, float dt);
+
+    // Creates the PlatformPool's parked platforms that don't exist (all of
+    // them after a load). Main thread, before the body commit. Returns how
+    // many were created.
+    static size_t FillPool(ecs::World& world);
 };
@@ -36,7 +36,7 @@ void CameraSystem::Update(World& world, float dt) {
     if (record.keys_pressed[KEY_X]) zoom_delta++;
     if (record.keys_pressed[KEY_Z]) zoom_delta--;
 
-    for (const auto& gp : record.gamepads) {
+    for (const auto& gp : record.active_gamepads()) {
         if (gp.buttons_pressed[GAMEPAD_BUTTON_RIGHT_FACE_LEFT]) toggle_follow = true;
         if (gp.buttons_pressed[GAMEPAD_BUTTON_LEFT_TRIGGER_1])  zoom_delta--;
         if (gp.buttons_pressed[GAMEPAD_BUTTON_RIGHT_TRIGGER_1]) zoom_delta++;
@@ -2,10 +2,16 @@
 #include "../components.hpp"
 #include "../physics_handles.hpp"
 #include "../physics_context.hpp"
+#include "../character_islands.hpp"
+#include "../each_optional.hpp"
+#include "../transform_batch.hpp"
 #include <Jolt/Physics/Collision/Shape/CapsuleShape.h>
 #include <Jolt/Physics/Collision/Shape/RotatedTranslatedShape.h>
 #include <ecs/modules/transform.hpp>
 #include <ecs/integration/glm.hpp>
+#include <algorithm>
+#include <memory>
+#include <vector>
 
 using namespace ecs;
 
@@ -42,69 +48,167 @@ void CharacterMotorSystem::Register(World& world) {
         });
 }
 
+namespace {
+
+// One character's components, gathered on the main thread so jobs never
+// touch World lookups.
+struct MotorWork {
+    JPH::CharacterVirtual* ch;
+    CharacterIntent*       intent;
+    CharacterState*        state;
+    WorldTransform*        wt;
+    LocalTransform*        lt;     // may be null
+};
+
+void step_character(const MotorWork& w, float dt, PhysicsContext& ctx, JPH::TempAllocator& temp) {
+    auto* ch = w.ch;
+    JPH::Vec3 current_vel = ch->GetLinearVelocity();
+
+    // --- Horizontal Movement ---
+    JPH::Vec3 move_dir   = MathBridge::ToJolt(w.intent->move_dir);
+    bool      on_ground  = (w.state->mode == CharacterState::Mode::Grounded);
+    float     accel      = on_ground ? 15.0f : 5.0f;
+
+    JPH::Vec3 target_vel     = move_dir * 10.0f;
+    JPH::Vec3 horizontal_vel = {current_vel.GetX(), 0.0f, current_vel.GetZ()};
+    horizontal_vel += (target_vel - horizontal_vel) * accel * dt;
+
+    // --- Vertical Movement ---
+    float vertical_vel = current_vel.GetY();
+
+    if (w.state->jump_impulse > 0.0f) {
+        vertical_vel = w.state->jump_impulse;
+    } else if (!on_ground) {
+        float gravity = (vertical_vel < 0.0f) ? -40.0f : -25.0f;
+        vertical_vel += gravity * dt;
+    } else {
+        vertical_vel = 0.0f;
+    }
+
+    JPH::Vec3 new_vel = horizontal_vel;
+    new_vel.SetY(vertical_vel);
+    ch->SetLinearVelocity(new_vel);
+
+    // --- Rotation (face direction of travel) ---
+    if (horizontal_vel.LengthSq() > 0.1f) {
+        JPH::Vec3 look_dir   = horizontal_vel.Normalized();
+        float     angle      = atan2f(look_dir.GetX(), look_dir.GetZ());
+        JPH::Quat target_rot = JPH::Quat::sRotation(JPH::Vec3::sAxisY(), angle);
+        ch->SetRotation(
+            ch->GetRotation().SLERP(target_rot, 10.0f * dt).Normalized());
+    }
+
+    // --- Extended Update (steps the character through the world) ---
+    JPH::DefaultBroadPhaseLayerFilter bp_filter(
+        ctx.object_vs_broadphase_layer_filter, ctx.character_layer);
+    JPH::DefaultObjectLayerFilter obj_filter(
+        ctx.object_layer_pair_filter, ctx.character_layer);
+    JPH::BodyFilter  body_filter;
+    JPH::ShapeFilter shape_filter;
+    JPH::CharacterVirtual::ExtendedUpdateSettings ext_settings;
+
+    ch->ExtendedUpdate(dt, {0, -9.81f, 0}, ext_settings,
+                       bp_filter, obj_filter, body_filter, shape_filter, temp);
+
+    // --- Sync Jolt position back to ECS transforms ---
+    // (WorldTransform is composed for all characters afterwards.)
+    if (w.lt) {
+        w.lt->position = MathBridge::FromJolt(ch->GetPosition());
+        w.lt->rotation = MathBridge::FromJolt(ch->GetRotation());
+    }
+}
+
+// The motor's per-frame arrays, kept as a private resource so each World
+// has its own and steady-state frames stay allocation-free.
+struct MotorScratch {
+    std::vector<MotorWork> work;
+    std::vector<ecs::Vec3> positions;
+    CharacterIslands       islands;
+    TransformBatch         batch;
+};
+
+// Main thread, after every character has been stepped.
+void compose_world_transforms(const std::vector<MotorWork>& work, TransformBatch& batch) {
+    batch.clear();
+    for (const auto& w : work)
+        if (w.lt) batch.push(w.lt->position, w.lt->rotation, w.lt->scale, &w.wt->matrix);
+    batch.compose();
+}
+
+// Margin added to the largest capsule when grouping (covers one tick of
+// travel at any speed the motor produces).
+constexpr float ISLAND_MARGIN = 1.0f;
+
+} // namespace
+
 void CharacterMotorSystem::Update(World& world, float dt) {
     auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
     if (!ctx_ptr || !*ctx_ptr) return;
     auto& ctx = **ctx_ptr;
 
-    world.each<CharacterHandle, CharacterIntent, CharacterState, WorldTransform>(
-        [&](Entity e, CharacterHandle& h, CharacterIntent& intent,
-            CharacterState& state, WorldTransform& wt) {
-            auto* ch = h.character.get();
-            JPH::Vec3 current_vel = ch->GetLinearVelocity();
-
-            // --- Horizontal Movement ---
-            JPH::Vec3 move_dir   = MathBridge::ToJolt(intent.move_dir);
-            bool      on_ground  = (state.mode == CharacterState::Mode::Grounded);
-            float     accel      = on_ground ? 15.0f : 5.0f;
-
-            JPH::Vec3 target_vel     = move_dir * 10.0f;
-            JPH::Vec3 horizontal_vel = {current_vel.GetX(), 0.0f, current_vel.GetZ()};
-            horizontal_vel += (target_vel - horizontal_vel) * accel * dt;
-
-            // --- Vertical Movement ---
-            float vertical_vel = current_vel.GetY();
-
-            if (state.jump_impulse > 0.0f) {
-                vertical_vel = state.jump_impulse;
-            } else if (!on_ground) {
-                float gravity = (vertical_vel < 0.0f) ? -40.0f : -25.0f;
-                vertical_vel += gravity * dt;
-            } else {
-                vertical_vel = 0.0f;
-            }
-
-            JPH::Vec3 new_vel = horizontal_vel;
-            new_vel.SetY(vertical_vel);
-            ch->SetLinearVelocity(new_vel);
-
-            // --- Rotation (face direction of travel) ---
-            if (horizontal_vel.LengthSq() > 0.1f) {
-                JPH::Vec3 look_dir   = horizontal_vel.Normalized();
-                float     angle      = atan2f(look_dir.GetX(), look_dir.GetZ());
-                JPH::Quat target_rot = JPH::Quat::sRotation(JPH::Vec3::sAxisY(), angle);
-                ch->SetRotation(
-                    ch->GetRotation().SLERP(target_rot, 10.0f * dt).Normalized());
-            }
+    // 1. Gather (main thread).
+    MotorScratch* scratch_ptr = world.try_resource<MotorScratch>();
+    if (!scratch_ptr) {
+        world.set_resource(MotorScratch{});
+        scratch_ptr = world.try_resource<MotorScratch>();
+    }
+    auto& work      = scratch_ptr->work;
+    auto& positions = scratch_ptr->positions;
+    auto& islands   = scratch_ptr->islands;
+    auto& batch     = scratch_ptr->batch;
+    work.clear();
+    positions.clear();
+    float max_extent = 0.0f;
+
+    each_optional<LocalTransform, CharacterHandle, CharacterIntent, CharacterState, WorldTransform>(world,
+        [&](Entity, CharacterHandle& h, CharacterIntent& intent,
+            CharacterState& state, WorldTransform& wt, LocalTransform* lt) {
+            if (!h.character) return;
+            work.push_back({h.character.get(), &intent, &state, &wt, lt});
+            positions.push_back(MathBridge::FromJolt(h.character->GetPosition()));
+        });
+    if (work.empty()) return;
+    world.each<CharacterHandle, CharacterControllerConfig>(
+        [&](Entity, CharacterHandle& h, CharacterControllerConfig& cfg) {
+            if (h.character) max_extent = std::max(max_extent, cfg.height + 2.0f * cfg.radius);
+        });
 
-            // --- Extended Update (steps the character through the world) ---
-            JPH::DefaultBroadPhaseLayerFilter bp_filter(
-                ctx.object_vs_broadphase_layer_filter, Layers::MOVING);
-            JPH::DefaultObjectLayerFilter obj_filter(
-                ctx.object_layer_pair_filter, Layers::MOVING);
-            JPH::BodyFilter  body_filter;
-            JPH::ShapeFilter shape_filter;
-            JPH::CharacterVirtual::ExtendedUpdateSettings ext_settings;
-
-            ch->ExtendedUpdate(dt, {0, -9.81f, 0}, ext_settings,
-                               bp_filter, obj_filter, body_filter, shape_filter,
-                               *ctx.temp_allocator);
-
-            // --- Sync Jolt position back to ECS transforms ---
-            if (auto* lt = world.try_get<LocalTransform>(e)) {
-                lt->position = MathBridge::FromJolt(ch->GetPosition());
-                lt->rotation = MathBridge::FromJolt(ch->GetRotation());
-                wt.matrix    = mat4_compose(lt->position, lt->rotation, lt->scale);
-            }
+    // 2. Islands: characters in reach share a job and a collision set, so
+    //    they see each other without racing on each other's pose.
+    const size_t groups = islands.build(positions, max_extent + ISLAND_MARGIN);
+    while (ctx.character_groups.size() < groups)
+        ctx.character_groups.push_back(std::make_unique<JPH::CharacterVsCharacterCollisionSimple>());
+    for (size_t g = 0; g < groups; ++g) ctx.character_groups[g]->mCharacters.clear();
+    for (size_t i = 0; i < work.size(); ++i) {
+        auto* set = ctx.character_groups[islands.group_of(i)].get();
+        set->Add(work[i].ch);
+        work[i].ch->SetCharacterVsCharacterCollision(set);
+    }
+
+    // 3. Step. A single island runs inline on the shared allocator; otherwise
+    //    islands are dealt round-robin to at most one job per thread, each
+    //    with its own temp allocator.
+    if (groups == 1) {
+        for (const auto& w : work) step_character(w, dt, ctx, *ctx.temp_allocator);
+        compose_world_transforms(work, batch);
+        return;
+    }
+
+    const size_t jobs = std::min<size_t>(groups, static_cast<size_t>(std::max(1, ctx.job_system->GetMaxConcurrency())));
+    while (ctx.character_temp.size() < jobs)
+        ctx.character_temp.push_back(std::make_unique<JPH::TempAllocatorImpl>(
+            static_cast<JPH::uint>(ctx.config.character_temp_bytes)));
+
+    JPH::JobSystem::Barrier* barrier = ctx.job_system->CreateBarrier();
+    for (size_t j = 0; j < jobs; ++j) {
+        JPH::JobHandle handle = ctx.job_system->CreateJob("CharacterMotor", JPH::Color::sGreen, [&, j]() {
+            JPH::TempAllocator& temp = *ctx.character_temp[j];
+            for (size_t i = 0; i < work.size(); ++i)
+                if (islands.group_of(i) % jobs == j) step_character(work[i], dt, ctx, temp);
         });
+        barrier->AddJob(handle);
+    }
+    ctx.job_system->WaitForJobs(barrier);
+    ctx.job_system->DestroyBarrier(barrier);
+    compose_world_transforms(work, batch);
 }
@@ -4,6 +4,10 @@
 // Applies CharacterIntent + CharacterState to Jolt: velocity, rotation,
 // ExtendedUpdate, and transform sync back to ECS.
 // Must run last in the Logic phase, immediately before PhysicsSystem.
+//
+// Characters are grouped into islands of mutual reach (character_islands.hpp).
+// Islands are stepped in parallel on PhysicsContext::job_system, and
+// characters in one island collide with each other (RFC-0024).
 class CharacterMotorSystem {
 public:
     static void Register(ecs::World& world);
@@ -1,10 +1,14 @@
 #include "debug.hpp"
 #include "../debug_panel.hpp"
+#include "../frame_profiler.hpp"
+#include "../gpu_timer.hpp"
 #include <raylib.h>
-#include <string>
+#include <rlgl.h>
+#include <algorithm>
+#include <cstdint>
 
 static constexpr int   PAD      = 8;
-static constexpr int   PANEL_W  = 230;
+static constexpr int   PANEL_W  = 260;
 static constexpr int   ROW_H    = 15;
 static constexpr int   FONT_SM  = 10;
 static constexpr int   FONT_MD  = 11;
@@ -16,14 +20,124 @@ static constexpr Color C_HEADER = {210, 190, 80,  255};
 static constexpr Color C_LABEL  = {180, 180, 180, 255};
 static constexpr Color C_VALUE  = {255, 255, 255, 255};
 
-void DebugSystem::Update(ecs::World& world, float /*dt*/) {
+static constexpr int   TRACE_FRAMES = 120;
+static constexpr const char* TRACE_PATH = "profile_trace.json";
+
+// Frame graph: one column per FrameProfiler::HISTORY frame, newest at the
+// right, stacked by phase; the rest of the frame (vsync, waiting) in gray.
+static constexpr int   COL_W    = 2;
+static constexpr int   GRAPH_W  = FrameProfiler::HISTORY * COL_W;
+static constexpr int   GRAPH_H  = 90;
+static constexpr float GRAPH_MS = 1000.0f / 30.0f;   // full height
+static constexpr int   HIST_BINS = 40;               // 1 ms each; last bin is 39+ ms
+static constexpr int   HIST_H    = 40;
+static constexpr int   HIST_OVER = 17;               // first bin past the 60 Hz budget
+static constexpr Color C_PHASE[FrameProfiler::PhaseCount] = {
+    {90,  160, 230, 255},   // Pre-Update
+    {100, 200, 110, 255},   // Logic
+    {230, 150, 60,  255},   // Physics
+    {170, 110, 220, 255},   // Render
+};
+static constexpr Color C_JOLT   = {255, 205, 140, 255}; // Jolt's share of Physics
+static constexpr Color C_IDLE   = {70,  70,  70,  255};
+static constexpr Color C_STEPS  = {230, 70,  70,  255}; // catch-up frame (> 1 fixed step)
+static constexpr Color C_BUDGET = {120, 120, 120, 160};
+
+static int ms_to_px(float ms, int height, float full_ms) {
+    return std::min(height, static_cast<int>(ms / full_ms * static_cast<float>(height) + 0.5f));
+}
+
+// Draws the frame graph and histogram with its top-left at (ox, oy).
+static void DrawFrameGraph(FrameProfiler& prof, int ox, int oy) {
+    const int jolt = prof.find("Jolt Step", FrameProfiler::Physics);
+    const int w    = GRAPH_W + 2 * PAD;
+    const int h    = PAD + ROW_H + GRAPH_H + PAD + ROW_H + HIST_H + ROW_H + PAD;
+    DrawRectangle(ox, oy, w, h, BG);
+    DrawRectangleLines(ox, oy, w, h, DIVIDER);
+
+    // --- Legend ---
+    int cy = oy + PAD;
+    int lx = ox + PAD;
+    for (int p = 0; p < FrameProfiler::PhaseCount; ++p) {
+        DrawRectangle(lx, cy + 2, 6, 6, C_PHASE[p]);
+        DrawText(FrameProfiler::phase_name(p), lx + 9, cy, FONT_SM, C_LABEL);
+        lx += 9 + MeasureText(FrameProfiler::phase_name(p), FONT_SM) + 8;
+    }
+    DrawRectangle(lx, cy + 2, 6, 6, C_JOLT);
+    DrawText("Jolt", lx + 9, cy, FONT_SM, C_LABEL);
+    cy += ROW_H;
+
+    // --- Rolling graph ---
+    const int gx = ox + PAD, base = cy + GRAPH_H;
+    for (int ago = 0; ago < prof.frames(); ++ago) {
+        const int x = gx + GRAPH_W - (ago + 1) * COL_W;
+        int y = base;
+        float stacked = 0.0f;
+        for (int p = 0; p < FrameProfiler::PhaseCount; ++p) {
+            const float ms = prof.phase_ms(p, ago);
+            const int   y1 = base - ms_to_px(stacked + ms, GRAPH_H, GRAPH_MS);
+            DrawRectangle(x, y1, COL_W, y - y1, C_PHASE[p]);
+            if (p == FrameProfiler::Physics && jolt >= 0) {
+                const int yj = base - ms_to_px(stacked + prof.system_ms(prof.systems()[jolt], ago), GRAPH_H, GRAPH_MS);
+                DrawRectangle(x, yj, COL_W, y - yj, C_JOLT);
+            }
+            stacked += ms;
+            y = y1;
+        }
+        const int top = base - ms_to_px(prof.frame_ms(ago), GRAPH_H, GRAPH_MS);
+        if (top < y) DrawRectangle(x, top, COL_W, y - top, C_IDLE);
+        if (prof.steps(ago) > 1) DrawRectangle(x, cy, COL_W, 3, C_STEPS);
+    }
+    const int y60 = base - ms_to_px(1000.0f / 60.0f, GRAPH_H, GRAPH_MS);
+    DrawLine(gx, y60, gx + GRAPH_W, y60, C_BUDGET);
+    DrawText("16.7", gx + 2, y60 - FONT_SM, FONT_SM, C_BUDGET);
+    DrawText("33.3", gx + 2, cy, FONT_SM, C_BUDGET);
+    cy = base + PAD;
+
+    // --- Histogram over FrameProfiler::FRAME_HISTORY frames (lows: Profiler rows) ---
+    DrawText("Frame times", gx, cy, FONT_SM, C_LABEL);
+    cy += ROW_H;
+
+    uint32_t bins[HIST_BINS];
+    prof.histogram(bins, HIST_BINS, 1.0f);
+    const uint32_t peak = *std::max_element(bins, bins + HIST_BINS);
+    const int      bw   = GRAPH_W / HIST_BINS;
+    for (int b = 0; b < HIST_BINS && peak; ++b) {
+        const int bh = static_cast<int>(static_cast<float>(bins[b]) / static_cast<float>(peak) * HIST_H + 0.5f);
+        DrawRectangle(gx + b * bw, cy + HIST_H - bh, bw - 1, bh, b >= HIST_OVER ? C_STEPS : C_PHASE[FrameProfiler::PreUpdate]);
+    }
+    cy += HIST_H;
+    DrawText("0", gx, cy + 2, FONT_SM, C_LABEL);
+    DrawText("16", gx + 16 * bw, cy + 2, FONT_SM, C_LABEL);
+    DrawText("39+ ms", gx + GRAPH_W - MeasureText("39+ ms", FONT_SM), cy + 2, FONT_SM, C_LABEL);
+}
+
+void DebugSystem::Refresh(ecs::World& world, float /*dt*/) {
     auto* panel = world.try_resource<DebugPanel>();
     if (!panel) return;
 
     if (IsKeyPressed(KEY_F3)) panel->visible = !panel->visible;
-    if (!panel->visible) return;
+    if (IsKeyPressed(KEY_F4)) {
+        if (auto* prof = world.try_resource<FrameProfiler>())
+            prof->start_capture(TRACE_FRAMES, TRACE_PATH);
+    }
+    if (!panel->visible) {
+        panel->invalidate(); // show current values, not stale ones, next time
+        return;
+    }
+    panel->refresh(GetFrameTime());
+}
 
-    const auto& sections = panel->sections();
+void DebugSystem::Update(ecs::World& world, float dt) {
+    Refresh(world, dt);
+    if (auto* panel = world.try_resource<DebugPanel>())
+        Draw(*panel, world.try_resource<FrameProfiler>(), world.try_resource<GpuTimer>());
+}
+
+void DebugSystem::Draw(const DebugPanel& panel, FrameProfiler* prof, GpuTimer* gpu) {
+    if (!panel.visible) return;
+    if (gpu) gpu->begin(GpuTimer::Overlay);
+    const auto& sections = panel.sections();
 
     // --- Compute panel height ---
     int rows_total = 0;
@@ -54,10 +168,16 @@ void DebugSystem::Update(ecs::World& world, float /*dt*/) {
         cy += ROW_H;
 
         for (const auto& row : sec.rows) {
-            std::string val = row.fn();
-            DrawText(row.label.c_str(), ox + PAD + 4, cy, FONT_SM, C_LABEL);
-            DrawText(val.c_str(),       ox + PAD + 4 + LABEL_W, cy, FONT_SM, C_VALUE);
+            DrawText(row.label.c_str(),   ox + PAD + 4, cy, FONT_SM, C_LABEL);
+            DrawText(row.value.c_str(),   ox + PAD + 4 + LABEL_W, cy, FONT_SM, C_VALUE);
             cy += ROW_H;
         }
     }
+
+    if (prof) DrawFrameGraph(*prof, ox + PANEL_W + 10, oy);
+
+    if (gpu) {
+        rlDrawRenderBatchActive(); // the 2D draws above are still batched
+        gpu->end(GpuTimer::Overlay);
+    }
 }
@@ -1,14 +1,25 @@
 #pragma once
+#include "../debug_panel.hpp"
+#include "../frame_profiler.hpp"
+#include "../gpu_timer.hpp"
 #include <ecs/ecs.hpp>
 
 // ---------------------------------------------------------------------------
 // DebugSystem — Render-phase system; drives the debug overlay.
 //
+// Update() is Refresh() (F3 / F4, panel refresh; reads the World) then
+// Draw() (panel and, given a FrameProfiler, the frame graph; no World). The
+// pipelined mode calls them separately (RFC-0045). Given a GpuTimer, Draw()
+// times the overlay on the GPU (RFC-0049).
+//
 // No Register() — no lifecycle hooks.
-// Toggle visibility with F3.
+// Toggle visibility with F3. F4 captures a 120-frame Chrome trace of the
+// FrameProfiler to profile_trace.json.
 // ---------------------------------------------------------------------------
 
 class DebugSystem {
 public:
     static void Update(ecs::World& world, float dt);
+    static void Refresh(ecs::World& world, float dt);
+    static void Draw(const DebugPanel& panel, FrameProfiler* profiler, GpuTimer* gpu = nullptr);
 };
@@ -1,17 +1,17 @@
 #include "input_gather.hpp"
+#include "../input_events.hpp"
 #include "../input_state.hpp"
 #include <raylib.h>
-#include <string>
+#include <cstring>
+#include <memory>
 
-static bool IsRealGamepad(int i) {
-    if (!IsGamepadAvailable(i)) return false;
+namespace {
 
-    const char* name = GetGamepadName(i);
-    int axis_count = GetGamepadAxisCount(i);
-    if (axis_count < 4) return false;
+bool IsRealGamepad(int i) {
+    if (GetGamepadAxisCount(i) < 4) return false;
 
+    const char* name = GetGamepadName(i);
     if (!name) return false;
-    std::string n = name;
     const char* blacklist[] = {
         "Keyboard", "Mouse", "Trackpad", "Touchpad", 
         "SMC", "Accelerometer", "Mic", "Headset", 
@@ -20,11 +20,42 @@ static bool IsRealGamepad(int i) {
     };
 
     for (const char* b : blacklist) {
-        if (n.find(b) != std::string::npos) return false;
+        if (std::strstr(name, b)) return false;
     }
     return true;
 }
 
+// IsRealGamepad per slot, redone only when the slot's availability changes
+// (connect / disconnect). Private world resource of InputGatherSystem.
+struct GamepadSlots {
+    bool available[InputRecord::MAX_GAMEPADS] = {false};
+    bool real[InputRecord::MAX_GAMEPADS]      = {false};
+    int  axis_count[InputRecord::MAX_GAMEPADS] = {0};
+};
+
+// Raylib as poll_keys' backend.
+struct RaylibKeys {
+    int  pop() const            { return GetKeyPressed(); }
+    bool down(int key) const    { return IsKeyDown(key); }
+    bool pressed(int key) const { return IsKeyPressed(key); }
+};
+
+// Polling backend: keyboard from Raylib's key queue (poll_keys), mouse
+// buttons by slot.
+void PollButtons(InputRecord& input) {
+    RaylibKeys keys;
+    poll_keys(input, keys);
+
+    // Mouse buttons
+    for (int i = 0; i < 8; i++) {
+        input.mouse_buttons[i] = IsMouseButtonDown(i);
+        input.mouse_buttons_pressed[i] = IsMouseButtonPressed(i);
+    }
+    input.event_count = 0;
+}
+
+} // namespace
+
 void InputGatherSystem::Update(ecs::World& world) {
     InputRecord* input_ptr = world.try_resource<InputRecord>();
     if (!input_ptr) {
@@ -33,39 +64,53 @@ void InputGatherSystem::Update(ecs::World& world) {
     }
     auto& input = *input_ptr;
 
-    // 1. Keyboard
-    for (int i = 0; i < 512; i++) {
-        input.keys_down[i] = IsKeyDown(i);
-        input.keys_pressed[i] = IsKeyPressed(i);
+    GamepadSlots* slots_ptr = world.try_resource<GamepadSlots>();
+    if (!slots_ptr) {
+        world.set_resource(GamepadSlots{});
+        slots_ptr = world.try_resource<GamepadSlots>();
     }
+    auto& slots = *slots_ptr;
 
-    // 2. Mouse
-    input.mouse_pos = GetMousePosition();
-    input.mouse_delta = GetMouseDelta();
-    input.mouse_wheel = GetMouseWheelMove();
-    for (int i = 0; i < 8; i++) {
-        input.mouse_buttons[i] = IsMouseButtonDown(i);
-        input.mouse_buttons_pressed[i] = IsMouseButtonPressed(i);
+    // 1. Keyboard and mouse buttons. With the event backend installed, both
+    //    come from its queue and nothing is polled.
+    auto* events = world.try_resource<std::shared_ptr<InputEventQueue>>();
+    if (events && *events) {
+        apply_events(input, (*events)->events(), GetTime());
+        (*events)->clear();
+    } else {
+        PollButtons(input);
+        input.time = GetTime();
     }
 
+    // 2. Mouse position and wheel
+    const Vector2 mouse_pos = GetMousePosition();
+    const Vector2 mouse_delta = GetMouseDelta();
+    input.mouse_pos = {mouse_pos.x, mouse_pos.y};
+    input.mouse_delta = {mouse_delta.x, mouse_delta.y};
+    input.mouse_wheel = GetMouseWheelMove();
+
     // 3. Gamepads
-    input.gamepads.clear();
-    for (int i = 0; i < 16; i++) {
-        if (IsRealGamepad(i)) {
-            GamepadState gp;
-            gp.id = i;
-            gp.connected = true;
-            
-            int axis_count = GetGamepadAxisCount(i);
-            for (int a = 0; a < 8 && a < axis_count; a++) {
-                gp.axes[a] = GetGamepadAxisMovement(i, a);
-            }
-
-            for (int b = 0; b < 32; b++) {
-                gp.buttons[b] = IsGamepadButtonDown(i, b);
-                gp.buttons_pressed[b] = IsGamepadButtonPressed(i, b);
-            }
-            input.gamepads.push_back(gp);
+    input.gamepad_count = 0;
+    for (int i = 0; i < static_cast<int>(InputRecord::MAX_GAMEPADS); i++) {
+        const bool available = IsGamepadAvailable(i);
+        if (available != slots.available[i]) {
+            slots.available[i]  = available;
+            slots.real[i]       = available && IsRealGamepad(i);
+            slots.axis_count[i] = slots.real[i] ? GetGamepadAxisCount(i) : 0;
+        }
+        if (!slots.real[i]) continue;
+
+        GamepadState& gp = input.gamepads[input.gamepad_count++];
+        gp.id = i;
+        gp.connected = true;
+
+        for (int a = 0; a < 8; a++) {
+            gp.axes[a] = a < slots.axis_count[i] ? GetGamepadAxisMovement(i, a) : 0.0f;
+        }
+
+        for (int b = 0; b < 32; b++) {
+            gp.buttons[b] = IsGamepadButtonDown(i, b);
+            gp.buttons_pressed[b] = IsGamepadButtonPressed(i, b);
         }
     }
 }
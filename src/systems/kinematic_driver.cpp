@@ -0,0 +1,43 @@
+#include "kinematic_driver.hpp"
+#include "physics.hpp"
+#include "../components.hpp"
+#include "../kinematic_target.hpp"
+#include "../physics_context.hpp"
+#include "../physics_handles.hpp"
+#include "../transform_dirty.hpp"
+#include <Jolt/Physics/Body/BodyLock.h>
+#include <memory>
+
+using namespace ecs;
+
+void KinematicDriverSystem::Update(World& world, float dt) {
+    auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+    if (!ctx_ptr || !*ctx_ptr || dt <= 0.0f) return;
+    auto& ctx = **ctx_ptr;
+
+    // Bodies spawned this frame must be in the broadphase before they can
+    // be activated.
+    PhysicsSystem::CommitPendingBodies(world, false);
+
+    float span = dt;
+    for (const PhysicsContext::StepRequest& r : ctx.step_queue) span += r.dt;
+
+    auto* dirty = world.try_resource<TransformDirty>();
+    const JPH::BodyLockInterfaceNoLock& bodies = ctx.physics_system->GetBodyLockInterfaceNoLock();
+    ctx.kinematic_wake.clear();
+    world.each<KinematicTarget, RigidBodyHandle, LocalTransform>([&](Entity e, KinematicTarget& target,
+                                                                     RigidBodyHandle& h, LocalTransform& lt) {
+        const KinematicTarget::Action action = target.step(lt);
+        if (action == KinematicTarget::Action::Skip) return;
+        JPH::Body* body = bodies.TryGetBody(h.id);
+        if (!body || !body->IsKinematic() || !body->IsInBroadPhase()) return;
+
+        body->MoveKinematic(MathBridge::ToJolt(lt.position), MathBridge::ToJolt(lt.rotation), span);
+        if (action == KinematicTarget::Action::Move) {
+            if (!body->IsActive()) ctx.kinematic_wake.push_back(h.id);
+            if (dirty) dirty->mark(e);
+        }
+    });
+    if (!ctx.kinematic_wake.empty())
+        ctx.GetBodyInterface().ActivateBodies(ctx.kinematic_wake.data(), static_cast<int>(ctx.kinematic_wake.size()));
+}
@@ -0,0 +1,23 @@
+#pragma once
+#include <ecs/ecs.hpp>
+
+// ---------------------------------------------------------------------------
+// KinematicDriverSystem — moves kinematic bodies to their LocalTransform.
+//
+// Runs in the Physics phase just before PhysicsSystem, once per fixed step.
+// Each body with a KinematicTarget (kinematic_target.hpp) whose target
+// changed gets MoveKinematic, which sets the velocity that reaches the
+// target by the end of the step, so characters and dynamic bodies ride it.
+// Unchanged bodies are skipped. No step is running, so the bodies are
+// written through Jolt's no-lock interface, and the ones that were asleep
+// are woken in one ActivateBodies batch. Moved entities are marked in
+// TransformDirty for rendering.
+//
+// With PhysicsConfig::async_step the queued steps have not run yet, so the
+// move spans every step queued this frame as well as the current one.
+// ---------------------------------------------------------------------------
+
+class KinematicDriverSystem {
+public:
+    static void Update(ecs::World& world, float dt);
+};
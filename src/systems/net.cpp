@@ -0,0 +1,112 @@
+#include "net.hpp"
+#include "../components.hpp"
+#include "../fixed_time.hpp"
+#include "../net_session.hpp"
+#include "../transform_batch.hpp"
+#include <ecs/modules/transform.hpp>
+#include <algorithm>
+#include <memory>
+
+using namespace ecs;
+
+namespace {
+
+NetReplication::Entry entry_of(Entity e, const WorldTransform& wt) {
+    const Mat4& m = wt.matrix;
+    return {e.index, NetReplication::quantize({m.m[12], m.m[13], m.m[14]}, NetReplication::rotation_of(m))};
+}
+
+// Server ids are entity indices: map them to this World's replicable
+// entities, which are the same ones when both sides loaded the same scene.
+void map_entities(World& world, NetClientSession& s) {
+    s.entities.clear();
+    world.each<LocalTransform, TransformHistory>(
+        [&](Entity e, LocalTransform&, TransformHistory&) { s.entities[e.index] = e; });
+    world.each<LocalTransform, CharacterControllerConfig>(
+        [&](Entity e, LocalTransform&, CharacterControllerConfig&) { s.entities[e.index] = e; });
+}
+
+} // namespace
+
+void NetServerSystem::Update(World& world, float /*dt*/) {
+    auto* ptr = world.try_resource<std::shared_ptr<NetServerSession>>();
+    if (!ptr || !*ptr) return;
+    NetServerSession& s = **ptr;
+
+    UdpSocket::Address from;
+    size_t size = 0;
+    while (s.socket.receive(from, s.buffer.data(), s.buffer.size(), size))
+        s.server.receive(from.key(), s.buffer.data(), size);
+
+    // A folded call covers several fixed steps; ticks count steps, so the
+    // client's playback clock runs at the fixed rate either way.
+    const auto* ft = world.try_resource<FixedTime>();
+    s.tick += ft ? static_cast<uint32_t>(std::max(1, ft->collision_steps)) : 1u;
+    if (s.server.peers() == 0) {
+        s.replicated = 0;
+        return;
+    }
+
+    NetReplication::Snapshot snap;
+    snap.tick = s.tick;
+    snap.entries.reserve(s.replicated);
+    world.each<WorldTransform, TransformHistory>(
+        [&](Entity e, WorldTransform& wt, TransformHistory&) { snap.entries.push_back(entry_of(e, wt)); });
+    world.each<WorldTransform, CharacterControllerConfig>(
+        [&](Entity e, WorldTransform& wt, CharacterControllerConfig&) { snap.entries.push_back(entry_of(e, wt)); });
+    std::sort(snap.entries.begin(), snap.entries.end(),
+              [](const NetReplication::Entry& a, const NetReplication::Entry& b) { return a.id < b.id; });
+    s.replicated = snap.entries.size();
+
+    s.server.broadcast(std::move(snap), [&s](uint64_t peer, const std::vector<uint8_t>& bytes) {
+        s.socket.send(UdpSocket::Address::from_key(peer), bytes.data(), bytes.size());
+    });
+}
+
+void NetClientSystem::Update(World& world, float dt) {
+    auto* ptr = world.try_resource<std::shared_ptr<NetClientSession>>();
+    if (!ptr || !*ptr) return;
+    NetClientSession& s = **ptr;
+
+    UdpSocket::Address from;
+    size_t size = 0;
+    while (s.socket.receive(from, s.buffer.data(), s.buffer.size(), size))
+        if (from.key() == s.server.key()) s.client.receive(s.buffer.data(), size);
+
+    // One ack a frame: it also joins, and keeps the server from timing
+    // this client out while nothing arrives.
+    NetReplication::encode_ack(s.client.newest(), s.ack);
+    s.socket.send(s.server, s.ack.data(), s.ack.size());
+
+    const auto* ft = world.try_resource<FixedTime>();
+    const float ticks = ft && ft->fixed_dt > 0.0f ? dt / ft->fixed_dt : dt * 60.0f;
+    s.applied = 0;
+    if (!s.client.sample(ticks, s.poses)) return;
+
+    // Matrices are composed together after the walk (transform_batch.hpp),
+    // so this frame's Logic and Render see the new poses.
+    s.batch.clear();
+    bool mapped = false;
+    s.unmapped = 0;
+    for (const NetReplication::Pose& pose : s.poses) {
+        auto it = s.entities.find(pose.id);
+        if ((it == s.entities.end() || !world.alive(it->second)) && !mapped) {
+            map_entities(world, s);
+            mapped = true;
+            it = s.entities.find(pose.id);
+        }
+        auto* lt = it != s.entities.end() ? world.try_get<LocalTransform>(it->second) : nullptr;
+        auto* wt = lt ? world.try_get<WorldTransform>(it->second) : nullptr;
+        if (!wt) {
+            ++s.unmapped;
+            continue;
+        }
+        lt->position = pose.position;
+        lt->rotation = pose.rotation;
+        if (auto* hist = world.try_get<TransformHistory>(it->second))
+            *hist = TransformHistory{pose.position, pose.rotation};
+        s.batch.push(lt->position, lt->rotation, lt->scale, &wt->matrix);
+    }
+    s.batch.compose();
+    s.applied = s.batch.size();
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <ecs/ecs.hpp>
+
+// ---------------------------------------------------------------------------
+// NetServerSystem — Physics phase, after "Physics", once per fixed step.
+// Reads the acks waiting on the socket, quantises the WorldTransform of
+// every dynamic body (TransformHistory) and character
+// (CharacterControllerConfig) into the tick's snapshot, and sends each
+// client its delta. Nothing is gathered while no client is connected.
+//
+// NetClientSystem — Pre-Update. Assembles the snapshots waiting on the
+// socket, acks the newest, and writes the interpolated poses into
+// LocalTransform (and TransformHistory, so the render blend is a no-op)
+// and composes their WorldTransform, as PhysicsSystem does.
+//
+// Both operate on their NetServerSession / NetClientSession resource
+// (net_session.hpp) and return at once without it (RFC-0057).
+// ---------------------------------------------------------------------------
+
+class NetServerSystem {
+public:
+    static void Update(ecs::World& world, float dt);
+};
+
+class NetClientSystem {
+public:
+    static void Update(ecs::World& world, float dt);
+};
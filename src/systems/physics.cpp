@@ -1,13 +1,45 @@
 #include "physics.hpp"
 #include "../components.hpp"
+#include "../deferred_commands.hpp"
+#include "../events.hpp"
+#include "../fixed_time.hpp"
+#include "../frame_arena.hpp"
+#include "../frame_profiler.hpp"
+#include "../kinematic_target.hpp"
 #include "../physics_handles.hpp"
 #include "../physics_context.hpp"
 #include <ecs/modules/transform.hpp>
 #include <ecs/integration/glm.hpp>
+#include <algorithm>
+#include <iostream>
 #include <memory>
+#include <vector>
 
 using namespace ecs;
 
+// Destroys the bodies whose entities are gone: pending_removes as one
+// RemoveBodies / DestroyBodies batch, and pending_discards (never added) by
+// dropping them from the add lists in one pass. Runs before any body is
+// created, so a reset frees the old scene's bodies before the new scene's
+// take their place and never needs room for both.
+static void destroy_pending(PhysicsContext& ctx) {
+    JPH::BodyInterface& bi = ctx.GetBodyInterface();
+    if (!ctx.pending_removes.empty()) {
+        const int n = static_cast<int>(ctx.pending_removes.size());
+        bi.RemoveBodies(ctx.pending_removes.data(), n);
+        bi.DestroyBodies(ctx.pending_removes.data(), n);
+        ctx.pending_removes.clear();
+    }
+    if (!ctx.pending_discards.empty()) {
+        auto& gone = ctx.pending_discards;
+        std::sort(gone.begin(), gone.end());
+        for (auto* adds : {&ctx.pending_adds, &ctx.pending_adds_asleep})
+            std::erase_if(*adds, [&](JPH::BodyID id) { return std::binary_search(gone.begin(), gone.end(), id); });
+        bi.DestroyBodies(gone.data(), static_cast<int>(gone.size()));
+        gone.clear();
+    }
+}
+
 void PhysicsSystem::Register(World& world) {
     world.on_add<RigidBodyConfig>([&](World& w, Entity e, RigidBodyConfig& cfg) {
         if (w.has<RigidBodyHandle>(e)) return;
@@ -16,16 +48,18 @@ void PhysicsSystem::Register(World& world) {
         if (!ctx_ptr || !*ctx_ptr) return;
         auto& ctx = **ctx_ptr;
 
+        destroy_pending(ctx); // an unload's bodies go before a load's arrive
         JPH::BodyInterface& bi = ctx.GetBodyInterface();
 
         JPH::RefConst<JPH::Shape> shape;
         if (auto* box = w.try_get<BoxCollider>(e)) {
-            shape = new JPH::BoxShape(MathBridge::ToJolt(box->half_extents));
+            shape = ctx.shapes.box(MathBridge::ToJolt(box->half_extents));
         } else if (auto* sphere = w.try_get<SphereCollider>(e)) {
-            shape = new JPH::SphereShape(sphere->radius);
-        } else {
-            shape = new JPH::BoxShape(JPH::Vec3(0.5f, 0.5f, 0.5f));
+            shape = ctx.shapes.sphere(sphere->radius);
+        } else if (auto* asset = w.try_get<ShapeCollider>(e)) {
+            shape = ctx.named_shape(asset->shape); // logs why if it is missing
         }
+        if (!shape) shape = ctx.shapes.box(JPH::Vec3(0.5f, 0.5f, 0.5f));
 
         JPH::Vec3 pos = JPH::Vec3::sZero();
         JPH::Quat rot = JPH::Quat::sIdentity();
@@ -41,51 +75,280 @@ void PhysicsSystem::Register(World& world) {
         JPH::EMotionType motion = JPH::EMotionType::Dynamic;
         if (cfg.type == BodyType::Static) motion = JPH::EMotionType::Static;
         if (cfg.type == BodyType::Kinematic) motion = JPH::EMotionType::Kinematic;
+        const JPH::EShapeSubType sub = shape->GetSubType();
+        if (motion == JPH::EMotionType::Dynamic
+            && (sub == JPH::EShapeSubType::Mesh || sub == JPH::EShapeSubType::HeightField)) {
+            std::cerr << "PhysicsSystem: mesh / height-field shapes cannot be Dynamic; making it Kinematic."
+                      << std::endl;
+            motion = JPH::EMotionType::Kinematic;
+        }
 
         JPH::ObjectLayer layer = (cfg.type == BodyType::Static) ? Layers::NON_MOVING : Layers::MOVING;
+        if (!cfg.layer.empty()) {
+            const uint32_t named = ctx.config.layers.find(cfg.layer);
+            if (named != PhysicsLayers::INVALID) layer = static_cast<JPH::ObjectLayer>(named);
+            else std::cerr << "PhysicsSystem: unknown layer \"" << cfg.layer << "\"; using "
+                           << ctx.config.layers.name(layer) << "." << std::endl;
+        }
 
         JPH::BodyCreationSettings settings(shape, pos, rot, motion, layer);
         settings.mRestitution = cfg.restitution;
         settings.mFriction = cfg.friction;
         settings.mIsSensor = cfg.sensor;
-        
+        settings.mUserData = BodyUserData::FromEntity(e);
+        settings.mAllowSleeping = cfg.allow_sleeping;
+        settings.mLinearDamping = cfg.linear_damping;
+        settings.mAngularDamping = cfg.angular_damping;
+        if (motion == JPH::EMotionType::Dynamic && cfg.motion_quality == MotionQuality::LinearCast)
+            settings.mMotionQuality = JPH::EMotionQuality::LinearCast;
+        if (motion == JPH::EMotionType::Dynamic && cfg.mass > 0.0f) {
+            // Inertia still comes from the shape, scaled to the given mass.
+            settings.mOverrideMassProperties = JPH::EOverrideMassProperties::CalculateInertia;
+            settings.mMassPropertiesOverride.mMass = cfg.mass;
+        }
+
+        // Created now, added to the broadphase in the next batch commit.
         JPH::Body* body = bi.CreateBody(settings);
-        bi.AddBody(body->GetID(), JPH::EActivation::Activate);
+        if (!body) {
+            // Body limit reached (PhysicsConfig::max_bodies). The entity stays
+            // without a RigidBodyHandle rather than crashing.
+            if (ctx.failed_body_creates++ == 0)
+                std::cerr << "PhysicsSystem: body limit reached (max_bodies="
+                          << ctx.config.max_bodies << "); raise it in the scene's physics block."
+                          << std::endl;
+            return;
+        }
+        if (motion == JPH::EMotionType::Dynamic && cfg.motion_quality == MotionQuality::Auto)
+            ctx.auto_ccd.push_back({body->GetID(), shape->GetInnerRadius(), false});
+        const bool asleep = motion == JPH::EMotionType::Static || cfg.start_asleep;
+        (asleep ? ctx.pending_adds_asleep : ctx.pending_adds).push_back(body->GetID());
 
         w.add(e, RigidBodyHandle{body->GetID()});
+        if (cfg.type == BodyType::Dynamic)
+            w.add(e, TransformHistory{MathBridge::FromJolt(pos), MathBridge::FromJolt(rot)});
+        if (motion == JPH::EMotionType::Kinematic)
+            w.add(e, KinematicTarget{MathBridge::FromJolt(pos), MathBridge::FromJolt(rot)});
     });
 
     world.on_remove<RigidBodyHandle>([&](World& w, Entity, RigidBodyHandle& h) {
         auto* ctx_ptr = w.try_resource<std::shared_ptr<PhysicsContext>>();
         if (!ctx_ptr || !*ctx_ptr) return;
-        JPH::BodyInterface& bi = (*ctx_ptr)->GetBodyInterface();
-        bi.RemoveBody(h.id);
-        bi.DestroyBody(h.id);
+        auto& ctx = **ctx_ptr;
+
+        // Never committed: still in an add list, which destroy_pending
+        // prunes for every such body at once.
+        if (!ctx.GetBodyInterface().IsAdded(h.id)) {
+            ctx.pending_discards.push_back(h.id);
+            return;
+        }
+        ctx.pending_removes.push_back(h.id);
     });
 }
 
-void PhysicsSystem::Update(World& world, float dt) {
+void PhysicsSystem::CommitPendingBodies(World& world, bool optimize_broadphase) {
     auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
     if (!ctx_ptr || !*ctx_ptr) return;
     auto& ctx = **ctx_ptr;
 
-    ctx.physics_system->Update(dt, 1, ctx.temp_allocator, ctx.job_system);
+    JPH::BodyInterface& bi = ctx.GetBodyInterface();
+
+    destroy_pending(ctx);
+
+    // Prepare builds the broadphase sub-tree without locking; Finalize
+    // links it in. Prepare may reorder the array, which is fine here.
+    auto add_batch = [&](std::vector<JPH::BodyID>& ids, JPH::EActivation activation) {
+        if (ids.empty()) return;
+        const int n = static_cast<int>(ids.size());
+        JPH::BodyInterface::AddState state = bi.AddBodiesPrepare(ids.data(), n);
+        bi.AddBodiesFinalize(ids.data(), n, state, activation);
+        ids.clear();
+    };
+    add_batch(ctx.pending_adds, JPH::EActivation::Activate);
+    add_batch(ctx.pending_adds_asleep, JPH::EActivation::DontActivate);
 
+    // Hot-reloaded transforms (SceneLoader::reload): move the existing body
+    // or character in place and restart it from rest.
+    auto teleported = frame_vector<Entity>(world);
+    world.each<PhysicsTeleport, LocalTransform>([&](Entity e, PhysicsTeleport&, LocalTransform& lt) {
+        const JPH::Vec3 pos = MathBridge::ToJolt(lt.position);
+        const JPH::Quat rot = MathBridge::ToJolt(lt.rotation);
+        if (auto* h = world.try_get<RigidBodyHandle>(e)) {
+            const bool is_static = bi.GetMotionType(h->id) == JPH::EMotionType::Static;
+            bi.SetPositionAndRotation(h->id, pos, rot,
+                                      is_static ? JPH::EActivation::DontActivate : JPH::EActivation::Activate);
+            if (!is_static)
+                bi.SetLinearAndAngularVelocity(h->id, JPH::Vec3::sZero(), JPH::Vec3::sZero());
+            if (auto* target = world.try_get<KinematicTarget>(e))
+                *target = KinematicTarget{lt.position, lt.rotation}; // arrived, not moving
+        }
+        if (auto* ch = world.try_get<CharacterHandle>(e)) {
+            ch->character->SetPosition(pos);
+            ch->character->SetRotation(rot);
+            ch->character->SetLinearVelocity(JPH::Vec3::sZero());
+        }
+        if (auto* hist = world.try_get<TransformHistory>(e)) *hist = TransformHistory{lt.position, lt.rotation};
+        teleported.push_back(e);
+    });
+    for (Entity e : teleported) world.remove<PhysicsTeleport>(e);
+    if (!teleported.empty()) DeferredCommands::of(world).note_edits(teleported.size()); // same count, new archetype
+
+    if (optimize_broadphase) ctx.physics_system->OptimizeBroadPhase();
+}
+
+// MotionQuality::Auto: switches each such body to LinearCast or back for
+// the next step from how far it moved in the last collision step (dt). Touches
+// no ECS state; no step may be running. Mode changes are rare, so the
+// locking BodyInterface call per change is fine.
+static void update_auto_ccd(PhysicsContext& ctx, float dt) {
+    if (ctx.auto_ccd.empty()) return;
+    const JPH::BodyLockInterfaceNoLock& bodies = ctx.physics_system->GetBodyLockInterfaceNoLock();
     JPH::BodyInterface& bi = ctx.GetBodyInterface();
-    
-    world.each<RigidBodyHandle, WorldTransform, RigidBodyConfig>(
-        [&](Entity e, RigidBodyHandle& h, WorldTransform& wt, RigidBodyConfig& cfg) {
-            if (cfg.type == BodyType::Dynamic) {
-                JPH::RVec3 pos;
-                JPH::Quat rot;
-                bi.GetPositionAndRotation(h.id, pos, rot);
-
-                wt.matrix = mat4_compose(MathBridge::FromJolt(pos), MathBridge::FromJolt(rot), {1,1,1});
-                
-                if (auto* lt = world.try_get<LocalTransform>(e)) {
-                     lt->position = MathBridge::FromJolt(pos);
-                     lt->rotation = MathBridge::FromJolt(rot);
-                }
-            }
-        });
+    uint32_t casting = 0;
+    for (size_t i = 0; i < ctx.auto_ccd.size();) {
+        PhysicsContext::AutoCcdBody& b = ctx.auto_ccd[i];
+        const JPH::Body* body = bodies.TryGetBody(b.id);
+        if (!body) { // destroyed: swap-pop
+            b = ctx.auto_ccd.back();
+            ctx.auto_ccd.pop_back();
+            continue;
+        }
+        const float travel = body->IsActive() ? body->GetLinearVelocity().Length() * dt : 0.0f;
+        const bool  cast   = ctx.config.wants_linear_cast(b.casting, travel, b.inner_radius);
+        if (cast != b.casting) {
+            bi.SetMotionQuality(b.id, cast ? JPH::EMotionQuality::LinearCast : JPH::EMotionQuality::Discrete);
+            b.casting = cast;
+        }
+        casting += cast ? 1u : 0u;
+        ++i;
+    }
+    ctx.auto_ccd_casting = casting;
+}
+
+// Reads the contact records and the poses of the bodies that moved out of
+// Jolt into the context. Touches no ECS state, so it may run on the async
+// step thread; no step may be running.
+static void gather_step(PhysicsContext& ctx) {
+    ctx.contact_recorder->drain(ctx.contact_scratch);
+
+    // Only bodies Jolt simulated can have moved. Walk its active list (plus
+    // bodies that fell asleep, whose final pose still needs writing) instead
+    // of every RigidBodyHandle in the world. No step running: the no-lock
+    // interface is safe here.
+    const JPH::BodyLockInterfaceNoLock& bodies = ctx.physics_system->GetBodyLockInterfaceNoLock();
+    auto take = [&](const JPH::BodyID& id, bool settled) {
+        const JPH::Body* body = bodies.TryGetBody(id);
+        if (!body || !body->IsDynamic()) return;
+        ctx.step_poses.push_back({BodyUserData::ToEntity(body->GetUserData()),
+                                  MathBridge::FromJolt(body->GetPosition()),
+                                  MathBridge::FromJolt(body->GetRotation()), settled});
+    };
+    ctx.physics_system->GetActiveBodies(JPH::EBodyType::RigidBody, ctx.active_scratch);
+    for (const JPH::BodyID& id : ctx.active_scratch) take(id, false);
+
+    ctx.deactivation_recorder.drain(ctx.deactivated_scratch);
+    for (const JPH::BodyID& id : ctx.deactivated_scratch) take(id, true);
+
+    ctx.body_counts = ctx.physics_system->GetBodyStats();
+}
+
+// Writes what gather_step() collected into the ECS. Main thread.
+static void apply_step(World& world, PhysicsContext& ctx) {
+    // Stats first: the merge below consumes the contact records.
+    ctx.stats_scratch.clear();
+    for (const JPH::BodyID& id : ctx.active_scratch) ctx.stats_scratch.push_back(id.GetIndexAndSequenceNumber());
+    ctx.islands.build(ctx.stats_scratch, ctx.contact_scratch, ctx.stats);
+    ctx.stats.bodies         = ctx.body_counts.mNumBodies;
+    ctx.stats.active_bodies  = static_cast<uint32_t>(ctx.active_scratch.size());
+    ctx.stats.fell_asleep    = static_cast<uint32_t>(ctx.deactivated_scratch.size());
+    ctx.stats.dynamic_bodies = ctx.body_counts.mNumBodiesDynamic;
+    ctx.stats.dynamic_asleep = ctx.body_counts.mNumBodiesDynamic - ctx.body_counts.mNumActiveBodiesDynamic;
+    ctx.stats.auto_ccd       = static_cast<uint32_t>(ctx.auto_ccd.size());
+    ctx.stats.auto_ccd_cast  = ctx.auto_ccd_casting;
+
+    // Contacts recorded on the job threads during the step become events.
+    ctx.contact_tracker.merge(world, ctx.contact_scratch,
+                              world.try_resource<Events<ContactEvent>>(),
+                              world.try_resource<Events<TriggerEvent>>());
+
+    ctx.transform_batch.clear();
+    for (const PhysicsContext::BodyPose& p : ctx.step_poses) {
+        if (!world.alive(p.entity)) continue;
+
+        // Matrices are composed together after the walk (transform_batch.hpp).
+        if (auto* wt = world.try_get<WorldTransform>(p.entity))
+            ctx.transform_batch.push(p.position, p.rotation, &wt->matrix);
+
+        if (auto* lt = world.try_get<LocalTransform>(p.entity)) {
+            // A body that just went to sleep has stopped: collapse the
+            // history so render interpolation doesn't blend toward it.
+            if (auto* hist = world.try_get<TransformHistory>(p.entity))
+                *hist = p.settled ? TransformHistory{p.position, p.rotation}
+                                  : TransformHistory{lt->position, lt->rotation};
+            lt->position = p.position;
+            lt->rotation = p.rotation;
+        }
+    }
+    ctx.step_poses.clear();
+    ctx.transform_batch.compose();
+}
+
+void PhysicsSystem::Update(World& world, float dt) {
+    auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+    if (!ctx_ptr || !*ctx_ptr) return;
+    auto& ctx = **ctx_ptr;
+
+    // Bodies spawned since the last step (deferred platforms, scene loads
+    // without an explicit commit) enter the broadphase as one batch.
+    CommitPendingBodies(world, false);
+
+    // Pipeline::step_fixed may fold several fixed steps into this call.
+    int collision_steps = 1;
+    if (auto* ft = world.try_resource<FixedTime>()) collision_steps = std::max(1, ft->collision_steps);
+
+    if (ctx.step_thread) {
+        ctx.step_queue.push_back({dt, collision_steps});
+        return;
+    }
+
+    // Jolt's own share of the "Physics" system, for the overlay's frame graph.
+    const auto step_t0 = FrameProfiler::Clock::now();
+    ctx.physics_system->Update(dt, collision_steps, ctx.temp_allocator, ctx.job_system);
+    if (auto* prof = world.try_resource<FrameProfiler>())
+        prof->record_nested(prof->slot("Jolt Step", FrameProfiler::Physics), step_t0, FrameProfiler::Clock::now());
+
+    update_auto_ccd(ctx, dt / static_cast<float>(collision_steps));
+    gather_step(ctx);
+    apply_step(world, ctx);
+}
+
+void PhysicsSystem::KickQueued(World& world) {
+    auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+    if (!ctx_ptr || !*ctx_ptr) return;
+    auto& ctx = **ctx_ptr;
+    if (!ctx.step_thread || ctx.step_in_flight || ctx.step_queue.empty()) return;
+
+    ctx.step_in_flight = true;
+    ctx.step_thread->run([&ctx] {
+        ctx.step_t0 = FrameProfiler::Clock::now();
+        for (const PhysicsContext::StepRequest& r : ctx.step_queue)
+            ctx.physics_system->Update(r.dt, r.collision_steps, ctx.temp_allocator, ctx.job_system);
+        ctx.step_t1 = FrameProfiler::Clock::now();
+        const PhysicsContext::StepRequest& last = ctx.step_queue.back();
+        update_auto_ccd(ctx, last.dt / static_cast<float>(last.collision_steps));
+        ctx.step_queue.clear();
+        gather_step(ctx);
+    });
+}
+
+void PhysicsSystem::JoinQueued(World& world) {
+    auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+    if (!ctx_ptr || !*ctx_ptr) return;
+    auto& ctx = **ctx_ptr;
+    if (!ctx.step_in_flight) return;
+
+    ctx.step_thread->wait();
+    ctx.step_in_flight = false;
+    if (auto* prof = world.try_resource<FrameProfiler>())
+        prof->record_nested(prof->slot("Jolt Step", FrameProfiler::Physics), ctx.step_t0, ctx.step_t1);
+    apply_step(world, ctx);
 }
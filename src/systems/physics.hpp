@@ -1,8 +1,29 @@
 #pragma once
 #include <ecs/ecs.hpp>
 
+// ---------------------------------------------------------------------------
+// PhysicsSystem — rigid body lifecycle and the Jolt step.
+//
+// Register() installs the RigidBodyConfig / RigidBodyHandle hooks. Bodies
+// are created in the hook but only enter the broadphase when
+// CommitPendingBodies() runs (also at the start of every Update), so a
+// scene load or deferred flush inserts its bodies as a single batch.
+//
+// With PhysicsConfig::async_step, Update() commits bodies and queues the
+// step instead of running it. KickQueued() runs the queued steps on the
+// context's step thread and reads the results out of Jolt there;
+// JoinQueued() waits for it and writes poses and contact events into the
+// ECS. Both are no-ops in the default synchronous mode (RFC-0046).
+// ---------------------------------------------------------------------------
+
 class PhysicsSystem {
 public:
     static void Register(ecs::World& world);
     static void Update(ecs::World& world, float dt);
+    static void KickQueued(ecs::World& world);
+    static void JoinQueued(ecs::World& world);
+
+    // Batch-remove pending removals and batch-add pending bodies. Pass
+    // optimize_broadphase after bulk loads to rebuild the broadphase tree.
+    static void CommitPendingBodies(ecs::World& world, bool optimize_broadphase);
 };
@@ -0,0 +1,188 @@
+#include "physics_query.hpp"
+#include "../components.hpp"
+#include "../physics_context.hpp"
+#include "../physics_handles.hpp"
+#include "../physics_query.hpp"
+#include <Jolt/Physics/Body/BodyFilter.h>
+#include <Jolt/Physics/Body/BodyLock.h>
+#include <Jolt/Physics/Collision/CastResult.h>
+#include <Jolt/Physics/Collision/CollideShape.h>
+#include <Jolt/Physics/Collision/CollisionCollectorImpl.h>
+#include <Jolt/Physics/Collision/RayCast.h>
+#include <Jolt/Physics/Collision/ShapeCast.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+using namespace ecs;
+
+namespace {
+
+const JPH::ObjectLayerFilter     k_all_layers{};
+const StaticOnlyLayerFilter      k_static_only{};
+const MovingOnlyLayerFilter      k_moving_only{};
+
+const JPH::ObjectLayerFilter& layer_filter(QueryLayers layers) {
+    switch (layers) {
+        case QueryLayers::StaticOnly: return k_static_only;
+        case QueryLayers::MovingOnly: return k_moving_only;
+        default:                      return k_all_layers;
+    }
+}
+
+// Collects up to `max` distinct bodies, then stops the query early.
+class BodyCollector final : public JPH::CollideShapeCollector {
+public:
+    BodyCollector(JPH::BodyID* out, uint32_t max) : out_(out), max_(max) {}
+
+    void AddHit(const JPH::CollideShapeResult& r) override {
+        if (std::find(out_, out_ + count_, r.mBodyID2) != out_ + count_) return;
+        out_[count_++] = r.mBodyID2;
+        if (count_ == max_) ForceEarlyOut();
+    }
+
+    uint32_t count() const { return count_; }
+
+private:
+    JPH::BodyID* out_;
+    uint32_t     max_;
+    uint32_t     count_ = 0;
+};
+
+// Everything a job needs, resolved on the main thread.
+struct QueryBatch {
+    PhysicsContext*                                  ctx;
+    std::vector<PhysicsQuery::Slot>*                 slots;
+    Entity*                                          hits;
+    const std::vector<JPH::RefConst<JPH::Shape>>*    shapes;
+    const std::vector<JPH::BodyID>*                  ignore;
+    std::vector<JPH::BodyID>*                        overlap_ids; // same layout as hits
+    const JPH::BroadPhaseLayerFilter*                broad_phase;
+};
+
+// Point + entity; the surface normal too when `sub` names the hit sub-shape
+// (ray casts; shape casts take theirs from the penetration axis).
+void fill_hit(const JPH::BodyLockInterface& bli, const JPH::BodyID& id, const JPH::SubShapeID* sub,
+              const JPH::RVec3& point, QueryHit& out) {
+    out.hit   = true;
+    out.point = MathBridge::FromJolt(point);
+    JPH::BodyLockRead lock(bli, id);
+    if (!lock.Succeeded()) return;
+    const JPH::Body& body = lock.GetBody();
+    out.entity = BodyUserData::ToEntity(body.GetUserData());
+    if (sub) out.normal = MathBridge::FromJolt(body.GetWorldSpaceSurfaceNormal(*sub, point));
+}
+
+void run_query(const QueryBatch& b, size_t i) {
+    auto& slot = (*b.slots)[i];
+    const auto& r = slot.request;
+    const JPH::NarrowPhaseQuery&   nq  = b.ctx->physics_system->GetNarrowPhaseQueryNoLock();
+    const JPH::BodyLockInterface&  bli = b.ctx->physics_system->GetBodyLockInterfaceNoLock();
+    const JPH::ObjectLayerFilter&  obj = layer_filter(r.layers);
+
+    const JPH::BodyID&            ignore_id = (*b.ignore)[i];
+    const JPH::IgnoreSingleBodyFilter ignore_filter(ignore_id);
+    const JPH::BodyFilter         no_filter;
+    const JPH::BodyFilter&        body = ignore_id.IsInvalid() ? no_filter : ignore_filter;
+
+    const JPH::RVec3 origin = JPH::RVec3(MathBridge::ToJolt(r.origin));
+    const JPH::Vec3  dir    = MathBridge::ToJolt(r.direction);
+
+    switch (r.kind) {
+        case PhysicsQuery::Request::Kind::Ray: {
+            const JPH::RRayCast  ray{origin, dir};
+            JPH::RayCastResult   result;
+            if (nq.CastRay(ray, result, *b.broad_phase, obj, body)) {
+                slot.result.fraction = result.mFraction;
+                fill_hit(bli, result.mBodyID, &result.mSubShapeID2, ray.GetPointOnRay(result.mFraction), slot.result);
+            }
+            break;
+        }
+        case PhysicsQuery::Request::Kind::Cast: {
+            const JPH::RShapeCast cast((*b.shapes)[i], JPH::Vec3::sReplicate(1.0f),
+                                       JPH::RMat44::sTranslation(origin), dir);
+            JPH::ShapeCastSettings settings;
+            JPH::ClosestHitCollisionCollector<JPH::CastShapeCollector> collector;
+            nq.CastShape(cast, settings, JPH::RVec3::sZero(), collector, *b.broad_phase, obj, body);
+            if (collector.HadHit()) {
+                const auto& h = collector.mHit;
+                slot.result.fraction = h.mFraction;
+                slot.result.normal   = MathBridge::FromJolt(-h.mPenetrationAxis.NormalizedOr(JPH::Vec3::sAxisY()));
+                fill_hit(bli, h.mBodyID2, nullptr, JPH::RVec3(h.mContactPointOn2), slot.result);
+            }
+            break;
+        }
+        case PhysicsQuery::Request::Kind::Overlap: {
+            JPH::BodyID* ids = b.overlap_ids->data() + r.first_hit;
+            BodyCollector collector(ids, r.max_hits);
+            JPH::CollideShapeSettings settings;
+            if (r.max_hits > 0)
+                nq.CollideShape((*b.shapes)[i], JPH::Vec3::sReplicate(1.0f), JPH::RMat44::sTranslation(origin),
+                                settings, JPH::RVec3::sZero(), collector, *b.broad_phase, obj, body);
+            Entity*  out = b.hits + r.first_hit;
+            uint32_t n   = 0;
+            for (uint32_t k = 0; k < collector.count(); ++k) {
+                JPH::BodyLockRead lock(bli, ids[k]);
+                if (lock.Succeeded()) out[n++] = BodyUserData::ToEntity(lock.GetBody().GetUserData());
+            }
+            std::sort(out, out + n, [](const Entity& x, const Entity& y) {
+                return x.index != y.index ? x.index < y.index : x.generation < y.generation;
+            });
+            slot.hit_count = n;
+            break;
+        }
+    }
+}
+
+} // namespace
+
+void PhysicsQuerySystem::Update(World& world) {
+    auto* query   = world.try_resource<PhysicsQuery>();
+    auto* ctx_ptr = world.try_resource<std::shared_ptr<PhysicsContext>>();
+    if (!query) return;
+    auto& slots = query->begin_execute();
+    if (slots.empty() || !ctx_ptr || !*ctx_ptr) return; // no physics: every query misses
+    auto& ctx = **ctx_ptr;
+
+    // 1. Main thread: shapes from the ShapeCache and the bodies to ignore,
+    //    so jobs touch neither the World nor the cache.
+    auto& shapes = ctx.query_shapes;
+    auto& ignore = ctx.query_ignore;
+    shapes.assign(slots.size(), nullptr);
+    ignore.assign(slots.size(), JPH::BodyID());
+    size_t overlap_capacity = 0;
+    for (size_t i = 0; i < slots.size(); ++i) {
+        const auto& r = slots[i].request;
+        if (r.kind != PhysicsQuery::Request::Kind::Ray)
+            shapes[i] = r.shape == QueryShape::Box ? ctx.shapes.box(MathBridge::ToJolt(r.extents))
+                                                   : ctx.shapes.sphere(r.extents.x);
+        if (r.kind == PhysicsQuery::Request::Kind::Overlap)
+            overlap_capacity = std::max<size_t>(overlap_capacity, r.first_hit + r.max_hits);
+        if (world.alive(r.ignore))
+            if (auto* h = world.try_get<RigidBodyHandle>(r.ignore)) ignore[i] = h->id;
+    }
+    ctx.query_overlap_ids.resize(overlap_capacity);
+
+    // Every broadphase bucket (the layer table may keep any layer out of
+    // MOVING's); the object layer filter narrows.
+    const JPH::BroadPhaseLayerFilter broad_phase;
+    const QueryBatch batch{&ctx, &slots, query->hit_buffer(), &shapes, &ignore, &ctx.query_overlap_ids, &broad_phase};
+
+    // 2. Execute: inline for one batch, otherwise one Jolt job per BATCH.
+    const size_t batches = (slots.size() + BATCH - 1) / BATCH;
+    if (batches == 1) {
+        for (size_t i = 0; i < slots.size(); ++i) run_query(batch, i);
+        return;
+    }
+
+    JPH::JobSystem::Barrier* barrier = ctx.job_system->CreateBarrier();
+    for (size_t j = 0; j < batches; ++j) {
+        JPH::JobHandle handle = ctx.job_system->CreateJob("PhysicsQuery", JPH::Color::sCyan, [&batch, j]() {
+            const size_t end = std::min(batch.slots->size(), (j + 1) * BATCH);
+            for (size_t i = j * BATCH; i < end; ++i) run_query(batch, i);
+        });
+        barrier->AddJob(handle);
+    }
+    ctx.job_system->WaitForJobs(barrier);
+    ctx.job_system->DestroyBarrier(barrier);
+}
@@ -0,0 +1,19 @@
+#pragma once
+#include <ecs/ecs.hpp>
+
+// ---------------------------------------------------------------------------
+// PhysicsQuerySystem — Logic-phase executor for the PhysicsQuery resource.
+//
+// Runs every request submitted since its last call (see physics_query.hpp)
+// against Jolt's narrow phase: inline for a handful, otherwise in batches
+// of BATCH requests, one Jolt job each. It is installed without an Access,
+// so it runs alone; nothing adds, removes or moves bodies meanwhile, and the
+// queries use the lock-free NarrowPhaseQuery (no body locks per query).
+// ---------------------------------------------------------------------------
+
+class PhysicsQuerySystem {
+public:
+    static constexpr size_t BATCH = 32; // requests per job
+
+    static void Update(ecs::World& world);
+};
@@ -1,6 +1,7 @@
 #include "player_input.hpp"
 #include "../components.hpp"
 #include "../input_state.hpp"
+#include <raylib.h>
 #include <cmath>
 #include <algorithm>
 
@@ -16,6 +17,7 @@ void PlayerInputSystem::Update(World& world) {
         input.move_input = {0, 0};
         input.look_input = {0, 0};
         input.jump = false;
+        input.jump_age = 0.0f;
         input.plant_platform = false;
         input.trigger_val = 0.0f;
 
@@ -26,6 +28,13 @@ void PlayerInputSystem::Update(World& world) {
         if (record.keys_down[KEY_D]) input.move_input.x += 1.0f;
         
         if (record.keys_pressed[KEY_SPACE]) input.jump = true;
+        // The event backend also says when: the first Space press this frame.
+        for (const InputEvent& ev : record.frame_events()) {
+            if (ev.kind == InputEvent::Kind::KeyDown && ev.code == KEY_SPACE) {
+                input.jump_age = static_cast<float>(std::max(0.0, record.time - ev.time));
+                break;
+            }
+        }
         
         if (record.keys_pressed[KEY_E] || record.mouse_buttons_pressed[MOUSE_BUTTON_LEFT]) {
             input.plant_platform = true;
@@ -34,7 +43,7 @@ void PlayerInputSystem::Update(World& world) {
 
         // 2. Gamepad Input
         const float deadzone = 0.15f;
-        for (const auto& gp : record.gamepads) {
+        for (const auto& gp : record.active_gamepads()) {
             float lx = gp.axes[GAMEPAD_AXIS_LEFT_X];
             float ly = gp.axes[GAMEPAD_AXIS_LEFT_Y];
             float rx = gp.axes[GAMEPAD_AXIS_RIGHT_X];
@@ -2,92 +2,264 @@
 #include "../components.hpp"
 #include "../physics_handles.hpp"
 #include "../assets.hpp"
+#include "../culling.hpp"
+#include "../each_optional.hpp"
+#include "../instance_batch.hpp"
+#include "../kinematic_target.hpp"
+#include "../fixed_time.hpp"
 #include "../physics_context.hpp"
+#include "../render_lod.hpp"
+#include "../render_snapshot.hpp"
 #include <raylib.h>
 #include <raymath.h>
 #include <rlgl.h>
 #include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
 
 using namespace ecs;
 
-// Convert our engine Color4 to Raylib's Color at draw time.
-static inline Color to_raylib(const Color4& c) {
-    return Color{
-        static_cast<unsigned char>(c.r * 255.0f),
-        static_cast<unsigned char>(c.g * 255.0f),
-        static_cast<unsigned char>(c.b * 255.0f),
-        static_cast<unsigned char>(c.a * 255.0f),
+// ecs::Mat4 is a column-major float[16]; Raylib's Matrix names its fields
+// by row (m0, m4, m8, m12 first), so the copy goes field by field.
+static inline Matrix to_raylib(const Mat4& a) {
+    const float* m = a.m;
+    return Matrix{
+        m[0], m[4], m[8],  m[12],
+        m[1], m[5], m[9],  m[13],
+        m[2], m[6], m[10], m[14],
+        m[3], m[7], m[11], m[15],
     };
 }
 
-void RenderSystem::Update(World& world) {
-    auto* assets = world.try_resource<AssetResource>();
-    if (!assets) return;
+// Frustum depth range; matches rlgl's default projection clip distances.
+static constexpr float CULL_NEAR = 0.01f;
+static constexpr float CULL_FAR  = 1000.0f;
 
-    BeginDrawing();
-    ClearBackground({35, 35, 40, 255});
+// DrawGrid(slices, spacing) restricted to the part of the y = 0 plane inside
+// `view` (the frustum's bounds). Same colours as Raylib's DrawGrid.
+static void DrawGridClipped(int slices, float spacing, const Aabb& view) {
+    if (view.min.y > 0.0f || view.max.y < 0.0f) return; // ground plane out of view
+    const float half = static_cast<float>(slices / 2) * spacing;
+    const float x0 = std::max(-half, view.min.x), x1 = std::min(half, view.max.x);
+    const float z0 = std::max(-half, view.min.z), z1 = std::min(half, view.max.z);
+    if (x0 > x1 || z0 > z1) return;
 
-    // 1. Build Camera3D from MainCamera data and collect player position
-    Camera3D camera = {};
-    Vector3  player_pos  = {0, 0, 0};
-    bool     follow_mode = false;
-
-    if (auto* cam = world.try_resource<MainCamera>()) {
-        camera.position   = {cam->lerp_pos.x,    cam->lerp_pos.y,    cam->lerp_pos.z};
-        camera.target     = {cam->lerp_target.x,  cam->lerp_target.y, cam->lerp_target.z};
-        camera.up         = {0, 1, 0};
-        camera.fovy       = 45.0f;
-        camera.projection = CAMERA_PERSPECTIVE;
-        follow_mode = cam->follow_mode;
+    rlBegin(RL_LINES);
+    for (int i = static_cast<int>(std::ceil(x0 / spacing)); i <= static_cast<int>(std::floor(x1 / spacing)); ++i) {
+        if (i == 0) rlColor3f(0.5f, 0.5f, 0.5f); else rlColor3f(0.75f, 0.75f, 0.75f);
+        rlVertex3f(static_cast<float>(i) * spacing, 0.0f, z0);
+        rlVertex3f(static_cast<float>(i) * spacing, 0.0f, z1);
     }
+    for (int i = static_cast<int>(std::ceil(z0 / spacing)); i <= static_cast<int>(std::floor(z1 / spacing)); ++i) {
+        if (i == 0) rlColor3f(0.5f, 0.5f, 0.5f); else rlColor3f(0.75f, 0.75f, 0.75f);
+        rlVertex3f(x0, 0.0f, static_cast<float>(i) * spacing);
+        rlVertex3f(x1, 0.0f, static_cast<float>(i) * spacing);
+    }
+    rlEnd();
+}
+
+void RenderSystem::Register(World& world) {
+    // Any WorldTag change (scene load/unload, builder platforms) invalidates
+    // the static grid; RenderSystem::Update rebuilds it lazily.
+    auto mark = [](World& w) {
+        auto* culling = w.try_resource<RenderCulling>();
+        if (!culling) return;
+        const auto* ft = w.try_resource<FixedTime>();
+        culling->mark_dirty(ft ? ft->total_steps : 0);
+    };
+    world.on_add<WorldTag>([mark](World& w, Entity, WorldTag&) { mark(w); });
+    world.on_remove<WorldTag>([mark](World& w, Entity, WorldTag&) { mark(w); });
+}
 
+void RenderSystem::Capture(World& world, RenderSnapshot& out, float aspect) {
+    // 1. Camera and player position
+    auto* cam = world.try_resource<MainCamera>();
+    out.has_camera = cam != nullptr;
+    if (cam) {
+        out.camera_pos    = cam->lerp_pos;
+        out.camera_target = cam->lerp_target;
+    }
+    out.player_pos = {0, 0, 0};
     world.single<PlayerTag, WorldTransform>([&](Entity, PlayerTag&, WorldTransform& wt) {
-        player_pos = {wt.matrix.m[12], wt.matrix.m[13], wt.matrix.m[14]};
+        out.player_pos = {wt.matrix.m[12], wt.matrix.m[13], wt.matrix.m[14]};
     });
 
-    // 2. Update Shader Uniforms
-    SetShaderValue(assets->lighting_shader, assets->playerPosLoc,
-                   &player_pos, SHADER_UNIFORM_VEC3);
+    // Fixed-step interpolation factor (1 = draw the latest physics pose).
+    const auto* fixed = world.try_resource<FixedTime>();
+    const float alpha = fixed ? fixed->alpha : 1.0f;
+
+    // 2. Cull against the camera frustum and bucket survivors by shape and
+    //    LOD level; colour rides in the instance matrix.
+    Frustum frustum;
+    const bool cull = out.has_camera;
+    if (cull) {
+        frustum = Frustum::look_at(out.camera_pos, out.camera_target, {0, 1, 0},
+                                   out.fovy, aspect, CULL_NEAR, CULL_FAR);
+        out.view = frustum.bounds();
+    }
+
+    InstanceBatch& batch = out.batch;
+    batch.clear();
+    uint32_t tested = 0;
+
+    // Without a camera there is no distance to judge; everything is level 0.
+    auto* lod = out.has_camera ? world.try_resource<RenderLod>() : nullptr;
+    auto level = [&](const Aabb& bounds) { return lod ? lod->select(bounds, out.camera_pos) : 0; };
+
+    auto submit = [&](ShapeType shape, const Mat4& model, const Color4& color) {
+        ++tested;
+        const Aabb bounds = Culling::transform_bounds(model, Culling::local_bounds(shape));
+        if (cull && !frustum.intersects(bounds)) return;
+        batch.add(shape, model, color, level(bounds));
+    };
+
+    // Dynamic bodies: blend the previous and current physics poses.
+    each_optional<LocalTransform, WorldTransform, MeshRenderer, TransformHistory>(world,
+        [&](Entity, WorldTransform& wt, MeshRenderer& mesh, TransformHistory& hist, LocalTransform* lt) {
+            Mat4 model = wt.matrix;
+            if (alpha < 1.0f && lt) model = interpolate_pose(hist, *lt, alpha);
+            submit(mesh.shape_type, model, mesh.color);
+        });
+
+    // Characters move outside the rigid-body sync; test them directly too.
+    world.each<WorldTransform, MeshRenderer, CharacterHandle>(
+        World::Exclude<TransformHistory>{},
+        [&](Entity, WorldTransform& wt, MeshRenderer& mesh, CharacterHandle&) {
+            submit(mesh.shape_type, wt.matrix, mesh.color);
+        });
+
+    // Kinematic bodies have no TransformHistory but move every step; they
+    // stay out of the grid and draw at their current pose.
+    world.each<WorldTransform, MeshRenderer, KinematicTarget>(
+        World::Exclude<TransformHistory>{},
+        [&](Entity, WorldTransform& wt, MeshRenderer& mesh, KinematicTarget&) {
+            submit(mesh.shape_type, wt.matrix, mesh.color);
+        });
+
+    // Statics: served from the grid, rebuilt after WorldTag changes once
+    // transforms have propagated. Until then they are tested one by one.
+    auto* culling = world.try_resource<RenderCulling>();
+    if (culling && culling->ready_to_rebuild(fixed != nullptr, fixed ? fixed->total_steps : 0))
+        culling->rebuild<CharacterHandle>(world);
+
+    if (culling && !culling->statics_dirty && cull) {
+        tested += static_cast<uint32_t>(culling->statics.size());
+        culling->statics.query(frustum, [&](const StaticGrid::Item& item) {
+            batch.add(item.shape, item.model, item.color, level(item.bounds));
+        });
+    } else {
+        RenderCulling::each_static<CharacterHandle>(world, [&](Entity, WorldTransform& wt, MeshRenderer& mesh) {
+            submit(mesh.shape_type, wt.matrix, mesh.color);
+        });
+    }
+
+    if (culling) {
+        culling->visible = static_cast<uint32_t>(batch.size());
+        culling->culled  = tested - culling->visible;
+    }
+    if (auto* stats = world.try_resource<RenderLod>()) {
+        for (size_t i = 0; i < RenderLod::LEVELS; ++i)
+            stats->counts[i] = static_cast<uint32_t>(batch.level_size(static_cast<int>(i)));
+    }
+
+    // 3. Orientation gizmo on the player
+    out.has_gizmo = false;
+    world.single<PlayerTag, WorldTransform, CharacterHandle>(
+        [&](Entity, PlayerTag&, WorldTransform& wt, CharacterHandle& h) {
+            auto& ch = h.character;
+            if (!ch) return;
+            const JPH::Quat rot   = ch->GetRotation();
+            const JPH::Vec3 fwd   = rot * JPH::Vec3::sAxisZ() * 1.5f;
+            const JPH::Vec3 right = rot * JPH::Vec3::sAxisX();
+            const JPH::Vec3 up    = rot * JPH::Vec3::sAxisY();
+            out.has_gizmo    = true;
+            out.gizmo_origin = {wt.matrix.m[12], wt.matrix.m[13] + 1.0f, wt.matrix.m[14]};
+            out.gizmo_axes   = {ecs::Vec3{fwd.GetX(),   fwd.GetY(),   fwd.GetZ()},
+                                ecs::Vec3{right.GetX(), right.GetY(), right.GetZ()},
+                                ecs::Vec3{up.GetX(),    up.GetY(),    up.GetZ()}};
+        });
+}
+
+void RenderSystem::Draw(const RenderSnapshot& snap, AssetResource& assets, GpuTimer* gpu) {
+    BeginDrawing();
+    ClearBackground({35, 35, 40, 255});
+    if (gpu) gpu->begin(GpuTimer::Scene);
+
+    Camera3D camera = {};
+    camera.position   = {snap.camera_pos.x,    snap.camera_pos.y,    snap.camera_pos.z};
+    camera.target     = {snap.camera_target.x, snap.camera_target.y, snap.camera_target.z};
+    camera.up         = {0, 1, 0};
+    camera.fovy       = snap.fovy;
+    camera.projection = CAMERA_PERSPECTIVE;
+
+    // Shader uniforms (both lighting programs share the fragment stage).
+    // set_uniform() skips values the program already holds, so only
+    // playerPos is normally re-sent.
+    assets.stats = {};
+    const Vector3 player_pos = {snap.player_pos.x, snap.player_pos.y, snap.player_pos.z};
     float radius    = 0.7f;
     float intensity = 0.5f;
-    SetShaderValue(assets->lighting_shader, assets->shadowRadiusLoc,    &radius,    SHADER_UNIFORM_FLOAT);
-    SetShaderValue(assets->lighting_shader, assets->shadowIntensityLoc, &intensity, SHADER_UNIFORM_FLOAT);
+    assets.set_uniform(assets.lighting_shader, assets.playerPosLoc,       &player_pos, SHADER_UNIFORM_VEC3);
+    assets.set_uniform(assets.lighting_shader, assets.shadowRadiusLoc,    &radius,     SHADER_UNIFORM_FLOAT);
+    assets.set_uniform(assets.lighting_shader, assets.shadowIntensityLoc, &intensity, SHADER_UNIFORM_FLOAT);
+    assets.set_uniform(assets.instanced_shader, assets.instPlayerPosLoc,       &player_pos, SHADER_UNIFORM_VEC3);
+    assets.set_uniform(assets.instanced_shader, assets.instShadowRadiusLoc,    &radius,     SHADER_UNIFORM_FLOAT);
+    assets.set_uniform(assets.instanced_shader, assets.instShadowIntensityLoc, &intensity, SHADER_UNIFORM_FLOAT);
+
+    // Queue every non-empty bucket, then draw them grouped by program.
+    assets.draws.clear();
+    for (ShapeType shape : {ShapeType::Box, ShapeType::Sphere, ShapeType::Capsule})
+        for (int lod = 0; lod < static_cast<int>(InstanceBatch::LOD_COUNT); ++lod)
+            if (!snap.batch.bucket(shape, lod).empty())
+                assets.draws.push(assets.instanced_material.shader.id, shape, lod);
+    assets.stats.shader_changes = assets.draws.sort();
 
-    // 3. Render Scene
+    // Render Scene — one DrawMeshInstanced per non-empty (shape, level)
+    // bucket.
     BeginMode3D(camera);
-        DrawGrid(100, 2.0f);
-        BeginShaderMode(assets->lighting_shader);
-        world.each<WorldTransform, MeshRenderer>(
-            [&](Entity e, WorldTransform& wt, MeshRenderer& mesh) {
-                rlPushMatrix();
-                rlMultMatrixf((float*)&wt.matrix);
-                Color col = to_raylib(mesh.color);
-                switch (mesh.shape_type) {
-                    case ShapeType::Box:     DrawCube({0,0,0}, 1.0f, 1.0f, 1.0f, col); break;
-                    case ShapeType::Sphere:  DrawSphere({0,0,0}, 0.5f, col);            break;
-                    case ShapeType::Capsule: DrawCapsule({0,0,0}, {0, 1.8f, 0}, 0.4f, 8, 8, col); break;
-                }
-                rlPopMatrix();
-
-                // Draw orientation gizmo on the player
-                if (world.has<PlayerTag>(e)) {
-                    auto* h_ptr = world.try_get<CharacterHandle>(e);
-                    if (!h_ptr) return;
-                    auto& ch = h_ptr->character;
-
-                    Vector3 pos = {wt.matrix.m[12], wt.matrix.m[13] + 1.0f, wt.matrix.m[14]};
-
-                    JPH::Vec3 j_fwd   = ch->GetRotation() * JPH::Vec3::sAxisZ();
-                    JPH::Vec3 j_right = ch->GetRotation() * JPH::Vec3::sAxisX();
-                    JPH::Vec3 j_up    = ch->GetRotation() * JPH::Vec3::sAxisY();
-
-                    DrawLine3D(pos, Vector3Add(pos, {j_fwd.GetX()*1.5f,   j_fwd.GetY()*1.5f,   j_fwd.GetZ()*1.5f}),   RED);
-                    DrawLine3D(pos, Vector3Add(pos, {j_right.GetX()*1.0f, j_right.GetY()*1.0f, j_right.GetZ()*1.0f}), BLUE);
-                    DrawLine3D(pos, Vector3Add(pos, {j_up.GetX()*1.0f,    j_up.GetY()*1.0f,    j_up.GetZ()*1.0f}),    GREEN);
-                }
-            });
-        EndShaderMode();
-    EndMode3D();
+        if (snap.has_camera) DrawGridClipped(100, 2.0f, snap.view);
+        else                 DrawGrid(100, 2.0f);
+        for (const DrawQueue::Command& cmd : assets.draws.commands()) {
+            const auto& instances = snap.batch.bucket(cmd.shape, cmd.lod);
+            assets.upload.resize(instances.size());
+            for (size_t i = 0; i < instances.size(); ++i) assets.upload[i] = to_raylib(instances[i]);
+            const Mesh& mesh = assets.mesh_for(cmd.shape, cmd.lod);
+            DrawMeshInstanced(mesh, assets.instanced_material,
+                              assets.upload.data(), static_cast<int>(instances.size()));
+            ++assets.stats.draw_calls;
+            assets.stats.instances += static_cast<uint32_t>(instances.size());
+            assets.stats.vertices  += static_cast<uint64_t>(mesh.vertexCount) * instances.size();
+        }
+
+        if (snap.has_gizmo) {
+            const Vector3 pos = {snap.gizmo_origin.x, snap.gizmo_origin.y, snap.gizmo_origin.z};
+            const Color colors[3] = {RED, BLUE, GREEN};
+            for (int i = 0; i < 3; ++i) {
+                const ecs::Vec3& a = snap.gizmo_axes[i];
+                DrawLine3D(pos, Vector3Add(pos, {a.x, a.y, a.z}), colors[i]);
+            }
+        }
+    EndMode3D(); // flushes rlgl's batch (grid, gizmo lines)
+    if (gpu) gpu->end(GpuTimer::Scene);
+}
+
+void RenderSystem::Update(World& world) {
+    auto* assets = world.try_resource<AssetResource>();
+    if (!assets) return;
+    auto* buffer_ptr = world.try_resource<std::shared_ptr<RenderSnapshotBuffer>>();
+    if (!buffer_ptr || !*buffer_ptr) return;
+
+    RenderSnapshotBuffer& buffer = **buffer_ptr;
+    buffer.aspect = static_cast<float>(GetScreenWidth()) / static_cast<float>(std::max(1, GetScreenHeight()));
+    Capture(world, buffer.write(), buffer.aspect);
+    buffer.publish();
+    Draw(buffer.read(), *assets, world.try_resource<GpuTimer>());
+}
 
+void RenderSystem::Present(World& world) {
+    // Matches the early-out in Update(): no BeginDrawing without assets.
+    if (!world.try_resource<AssetResource>()) return;
     EndDrawing();
+    if (auto* gpu = world.try_resource<GpuTimer>()) gpu->end_frame();
 }
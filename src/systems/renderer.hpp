@@ -1,7 +1,32 @@
 #pragma once
+#include "../assets.hpp"
+#include "../gpu_timer.hpp"
+#include "../render_snapshot.hpp"
 #include <ecs/ecs.hpp>
 
+// ---------------------------------------------------------------------------
+// RenderSystem — Render-phase systems for the 3D scene.
+//
+// Update() opens the frame (BeginDrawing) and draws the world. Present()
+// closes it (EndDrawing, which also blocks on the frame-rate cap), so 2D
+// overlays registered between the two draw into the same frame and the
+// profiler can report vsync wait separately from draw cost.
+//
+// Update() is Capture() then Draw(), through the RenderSnapshotBuffer
+// resource. Capture() reads the World: it culls against the MainCamera
+// frustum (RFC-0023) and fills a RenderSnapshot. Draw() issues the GL calls
+// from the snapshot alone and opens the frame. The pipelined mode runs the
+// two on different threads (RFC-0045). Given a GpuTimer, Draw() times the
+// scene pass on the GPU (RFC-0049).
+// Register() installs the WorldTag hooks that invalidate the static grid in
+// the RenderCulling resource.
+// ---------------------------------------------------------------------------
+
 class RenderSystem {
 public:
+    static void Register(ecs::World& world);
     static void Update(ecs::World& world);
+    static void Capture(ecs::World& world, RenderSnapshot& out, float aspect);
+    static void Draw(const RenderSnapshot& snapshot, AssetResource& assets, GpuTimer* gpu = nullptr);
+    static void Present(ecs::World& world);
 };
@@ -0,0 +1,145 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// TaskPool — a small work-stealing thread pool for ecs::Pipeline.
+//
+// Each worker owns a deque: it pushes and pops its own work at the back and,
+// when empty, steals from the front of the others'. Tasks pushed from a
+// non-worker thread are dealt round-robin. The thread that calls run_until()
+// (the main thread) helps by stealing too, and is the only one that runs
+// tasks pushed with push_main() — Raylib, GLFW and audio calls stay on it.
+//
+// Tasks are plain {function pointer, context, index} triples so pushing one
+// never allocates beyond the deques' own growth.
+//
+// Zero engine dependencies — safe to include in any target.
+// ---------------------------------------------------------------------------
+
+class TaskPool {
+public:
+    struct Task {
+        void   (*fn)(void*, uint32_t) = nullptr;
+        void*    ctx   = nullptr;
+        uint32_t index = 0;
+    };
+
+    explicit TaskPool(size_t workers) : workers_(workers) {
+        for (size_t i = 0; i <= workers; ++i) queues_.push_back(std::make_unique<Queue>());
+        threads_.reserve(workers);
+        for (size_t i = 0; i < workers; ++i) threads_.emplace_back([this, i] { work(i); });
+    }
+
+    ~TaskPool() {
+        {
+            std::lock_guard<std::mutex> lock(sleep_m_);
+            stop_ = true;
+        }
+        sleep_cv_.notify_all();
+        for (auto& t : threads_) t.join();
+    }
+
+    TaskPool(const TaskPool&)            = delete;
+    TaskPool& operator=(const TaskPool&) = delete;
+
+    size_t workers() const { return workers_; }
+
+    // Queues a task any thread may run.
+    void push(Task t) {
+        if (workers_ == 0) { push_main(t); return; }
+        const size_t q = (tls_pool_ == this) ? tls_index_ : next_.fetch_add(1, std::memory_order_relaxed) % workers_;
+        queued_.fetch_add(1, std::memory_order_release); // before the push, so a thief never underflows it
+        {
+            std::lock_guard<std::mutex> lock(queues_[q]->m);
+            queues_[q]->tasks.push_back(t);
+        }
+        {
+            std::lock_guard<std::mutex> lock(sleep_m_); // pairs with the sleeper's check
+        }
+        sleep_cv_.notify_one();
+    }
+
+    // Queues a task only run_until()'s caller runs.
+    void push_main(Task t) {
+        std::lock_guard<std::mutex> lock(queues_.back()->m);
+        queues_.back()->tasks.push_back(t);
+    }
+
+    // Runs main and stolen tasks on the calling thread until done() is true.
+    template <typename Done>
+    void run_until(Done&& done) {
+        while (!done()) {
+            Task t;
+            if (pop(*queues_.back(), t, /*back=*/false) || steal(workers_, t)) t.fn(t.ctx, t.index);
+            else std::this_thread::yield();
+        }
+    }
+
+private:
+    struct Queue {
+        std::mutex       m;
+        std::deque<Task> tasks;
+    };
+
+    const size_t                        workers_;
+    std::vector<std::unique_ptr<Queue>> queues_; // one per worker, then the main queue
+    std::vector<std::thread>            threads_;
+    std::atomic<size_t>                 next_{0};
+    std::atomic<size_t>                 queued_{0}; // tasks in worker queues
+    std::mutex                          sleep_m_;
+    std::condition_variable             sleep_cv_;
+    bool                                stop_ = false;
+
+    static inline thread_local TaskPool* tls_pool_  = nullptr;
+    static inline thread_local size_t    tls_index_ = 0;
+
+    bool pop(Queue& q, Task& out, bool back) {
+        std::lock_guard<std::mutex> lock(q.m);
+        if (q.tasks.empty()) return false;
+        if (back) { out = q.tasks.back();  q.tasks.pop_back(); }
+        else      { out = q.tasks.front(); q.tasks.pop_front(); }
+        return true;
+    }
+
+    // Steals from the front of any worker queue but `self`.
+    bool steal(size_t self, Task& out) {
+        const size_t n = workers_;
+        if (n == 0) return false;
+        for (size_t k = 1; k <= n; ++k) {
+            const size_t q = (self + k) % n;
+            if (q != self && pop(*queues_[q], out, /*back=*/false)) {
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void work(size_t index) {
+        tls_pool_  = this;
+        tls_index_ = index;
+        for (;;) {
+            Task t;
+            if (pop(*queues_[index], t, /*back=*/true)) {
+                queued_.fetch_sub(1, std::memory_order_relaxed);
+                t.fn(t.ctx, t.index);
+                continue;
+            }
+            if (steal(index, t)) {
+                t.fn(t.ctx, t.index);
+                continue;
+            }
+            std::unique_lock<std::mutex> lock(sleep_m_);
+            sleep_cv_.wait(lock, [&] { return stop_ || queued_.load(std::memory_order_acquire) > 0; });
+            if (stop_) return;
+        }
+    }
+};
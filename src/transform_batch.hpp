@@ -0,0 +1,135 @@
+#pragma once
+#include <ecs/ecs.hpp>
+#include <cstddef>
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <xmmintrin.h>
+#define TRANSFORM_BATCH_SSE 1
+#endif
+
+// ---------------------------------------------------------------------------
+// TransformBatch — composes many WorldTransform matrices in one pass.
+//
+// Callers push (position, rotation[, scale], destination) while they walk
+// their bodies, and compose() then builds every matrix from the
+// structure-of-arrays copy. With SSE (every x86-64 build) four matrices are
+// built per iteration: the nine rotation terms are computed lane-wise and
+// each 4×4 block is transposed straight into the four destinations. The
+// remainder, and non-x86 builds, use the same formula one at a time.
+//
+// The formula is ecs::mat4_compose's (column-major, translation in m[12..14]).
+// Results agree with it to float rounding. push() keeps the destination
+// pointer, so nothing may add or remove components between push() and
+// compose(). The arrays are reused: after the first frame, clear() + push()
+// doesn't allocate.
+//
+// PhysicsSystem (active-body sync, PhysicsContext::transform_batch) and
+// CharacterMotorSystem (after all characters are stepped, in its MotorScratch
+// resource) each own one per World.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+class TransformBatch {
+public:
+    void clear() {
+        for (auto* v : {&px_, &py_, &pz_, &qx_, &qy_, &qz_, &qw_, &sx_, &sy_, &sz_}) v->clear();
+        out_.clear();
+    }
+
+    void push(const ecs::Vec3& p, const ecs::Quat& q, ecs::Mat4* out) { push(p, q, {1.0f, 1.0f, 1.0f}, out); }
+
+    void push(const ecs::Vec3& p, const ecs::Quat& q, const ecs::Vec3& s, ecs::Mat4* out) {
+        px_.push_back(p.x); py_.push_back(p.y); pz_.push_back(p.z);
+        qx_.push_back(q.x); qy_.push_back(q.y); qz_.push_back(q.z); qw_.push_back(q.w);
+        sx_.push_back(s.x); sy_.push_back(s.y); sz_.push_back(s.z);
+        out_.push_back(out);
+    }
+
+    size_t size() const { return out_.size(); }
+
+    // Writes every pushed destination. The batch stays filled.
+    void compose() const {
+        const size_t n = out_.size();
+        size_t i = 0;
+#ifdef TRANSFORM_BATCH_SSE
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 two = _mm_set1_ps(2.0f);
+        for (; i + 4 <= n; i += 4) {
+            const __m128 x = _mm_loadu_ps(&qx_[i]), y = _mm_loadu_ps(&qy_[i]);
+            const __m128 z = _mm_loadu_ps(&qz_[i]), w = _mm_loadu_ps(&qw_[i]);
+            const __m128 sx = _mm_loadu_ps(&sx_[i]), sy = _mm_loadu_ps(&sy_[i]), sz = _mm_loadu_ps(&sz_[i]);
+            const __m128 xx = _mm_mul_ps(x, x), yy = _mm_mul_ps(y, y), zz = _mm_mul_ps(z, z);
+            const __m128 xy = _mm_mul_ps(x, y), xz = _mm_mul_ps(x, z), yz = _mm_mul_ps(y, z);
+            const __m128 xw = _mm_mul_ps(x, w), yw = _mm_mul_ps(y, w), zw = _mm_mul_ps(z, w);
+
+            __m128 c0 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz))), sx);
+            __m128 c1 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xy, zw)), sx);
+            __m128 c2 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xz, yw)), sx);
+            __m128 c3 = _mm_setzero_ps();
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            _mm_storeu_ps(&out_[i + 0]->m[0], c0);
+            _mm_storeu_ps(&out_[i + 1]->m[0], c1);
+            _mm_storeu_ps(&out_[i + 2]->m[0], c2);
+            _mm_storeu_ps(&out_[i + 3]->m[0], c3);
+
+            c0 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(xy, zw)), sy);
+            c1 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz))), sy);
+            c2 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(yz, xw)), sy);
+            c3 = _mm_setzero_ps();
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            _mm_storeu_ps(&out_[i + 0]->m[4], c0);
+            _mm_storeu_ps(&out_[i + 1]->m[4], c1);
+            _mm_storeu_ps(&out_[i + 2]->m[4], c2);
+            _mm_storeu_ps(&out_[i + 3]->m[4], c3);
+
+            c0 = _mm_mul_ps(_mm_mul_ps(two, _mm_add_ps(xz, yw)), sz);
+            c1 = _mm_mul_ps(_mm_mul_ps(two, _mm_sub_ps(yz, xw)), sz);
+            c2 = _mm_mul_ps(_mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy))), sz);
+            c3 = _mm_setzero_ps();
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            _mm_storeu_ps(&out_[i + 0]->m[8], c0);
+            _mm_storeu_ps(&out_[i + 1]->m[8], c1);
+            _mm_storeu_ps(&out_[i + 2]->m[8], c2);
+            _mm_storeu_ps(&out_[i + 3]->m[8], c3);
+
+            c0 = _mm_loadu_ps(&px_[i]);
+            c1 = _mm_loadu_ps(&py_[i]);
+            c2 = _mm_loadu_ps(&pz_[i]);
+            c3 = one;
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+            _mm_storeu_ps(&out_[i + 0]->m[12], c0);
+            _mm_storeu_ps(&out_[i + 1]->m[12], c1);
+            _mm_storeu_ps(&out_[i + 2]->m[12], c2);
+            _mm_storeu_ps(&out_[i + 3]->m[12], c3);
+        }
+#endif
+        for (; i < n; ++i) compose_one(i);
+    }
+
+private:
+    std::vector<float> px_, py_, pz_, qx_, qy_, qz_, qw_, sx_, sy_, sz_;
+    std::vector<ecs::Mat4*> out_;
+
+    void compose_one(size_t i) const {
+        const float x = qx_[i], y = qy_[i], z = qz_[i], w = qw_[i];
+        float* m = out_[i]->m;
+        m[0]  = (1 - 2 * (y * y + z * z)) * sx_[i];
+        m[1]  = (2 * (x * y + z * w)) * sx_[i];
+        m[2]  = (2 * (x * z - y * w)) * sx_[i];
+        m[3]  = 0;
+        m[4]  = (2 * (x * y - z * w)) * sy_[i];
+        m[5]  = (1 - 2 * (x * x + z * z)) * sy_[i];
+        m[6]  = (2 * (y * z + x * w)) * sy_[i];
+        m[7]  = 0;
+        m[8]  = (2 * (x * z + y * w)) * sz_[i];
+        m[9]  = (2 * (y * z - x * w)) * sz_[i];
+        m[10] = (1 - 2 * (x * x + y * y)) * sz_[i];
+        m[11] = 0;
+        m[12] = px_[i];
+        m[13] = py_[i];
+        m[14] = pz_[i];
+        m[15] = 1;
+    }
+};
@@ -0,0 +1,90 @@
+#pragma once
+#include <ecs/ecs.hpp>
+#include <ecs/modules/hierarchy.hpp>
+#include <ecs/modules/transform.hpp>
+#include <ecs/modules/transform_propagation.hpp>
+#include <cstddef>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// TransformDirty — entities whose WorldTransform is stale, and the
+// once-per-frame propagation that refreshes them.
+//
+// Most moving roots never need propagation: PhysicsSystem and
+// CharacterMotorSystem write WorldTransform themselves (transform_batch.hpp),
+// and statics never move. A LocalTransform written anywhere else must be
+// marked:
+// - new entities: PhysicsModule's on_add<WorldTransform> hook marks them.
+// - builder pool placements, hot-reload moves: their writers mark them.
+// - kinematic bodies: KinematicDriverSystem marks the ones it moves.
+// - anything bulk or unknown: mark_all().
+//
+// propagate_dirty() runs once per rendered frame (the first Render system,
+// see PhysicsModule). A marked root without children gets its matrix from
+// its own LocalTransform. A marked entity that is part of a hierarchy
+// (Parent or Children), or mark_all(), falls back to one full
+// ecs::propagate_transforms pass, so subtrees stay correct. Nothing marked
+// costs nothing.
+//
+// World resource, created by PhysicsModule. mark() is not synchronised: a
+// Logic system that marks declares write<TransformDirty>.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+class TransformDirty {
+public:
+    void mark(ecs::Entity e) { entities_.push_back(e); }
+    void mark_all() { all_ = true; }
+
+    bool   all()     const { return all_; }
+    size_t pending() const { return entities_.size(); }
+
+    // Recomputes what was marked and clears the marks.
+    void propagate(ecs::World& world) {
+        last_composed_ = 0;
+        last_full_     = all_;
+        if (!all_) {
+            for (ecs::Entity e : entities_) {
+                if (!world.alive(e)) continue;
+                if (world.has<ecs::Parent>(e) || world.has<ecs::Children>(e)) {
+                    last_full_ = true;
+                    break;
+                }
+            }
+        }
+
+        if (last_full_) {
+            ecs::propagate_transforms(world);
+            last_composed_ = world.count<ecs::WorldTransform>();
+        } else {
+            for (ecs::Entity e : entities_) {
+                if (!world.alive(e)) continue;
+                auto* lt = world.try_get<ecs::LocalTransform>(e);
+                auto* wt = world.try_get<ecs::WorldTransform>(e);
+                if (!lt || !wt) continue;
+                wt->matrix = ecs::mat4_compose(lt->position, lt->rotation, lt->scale);
+                ++last_composed_;
+            }
+        }
+        entities_.clear();
+        all_ = false;
+    }
+
+    // Last propagate(): matrices recomputed, and whether it needed the full
+    // pass.
+    size_t last_composed() const { return last_composed_; }
+    bool   last_full()     const { return last_full_; }
+
+private:
+    std::vector<ecs::Entity> entities_;
+    bool   all_           = true; // nothing has been propagated yet
+    size_t last_composed_ = 0;
+    bool   last_full_     = false;
+};
+
+// The world's TransformDirty, or a full pass without one.
+inline void propagate_dirty(ecs::World& world) {
+    if (auto* dirty = world.try_resource<TransformDirty>()) dirty->propagate(world);
+    else ecs::propagate_transforms(world);
+}
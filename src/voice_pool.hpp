@@ -0,0 +1,207 @@
+#pragma once
+#include <ecs/ecs.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ---------------------------------------------------------------------------
+// VoicePool — bounded sound playback: per-frame event coalescing, distance
+// attenuation and culling, and priority stealing over a fixed set of voices.
+//
+// Every clip owns ALIASES voices (AudioResource backs each with a Raylib
+// LoadSoundAlias of the clip, so they share its sample data), and at most
+// max_voices play at once across all clips. Each frame:
+//
+//   1. begin(listener), then set_playing(voice, IsSoundPlaying(alias)) for
+//      every voice.
+//   2. submit(clip, position) per event. A clip's requests in one frame are
+//      coalesced into the loudest of them, so a hundred characters landing
+//      together start one voice, not a hundred.
+//   3. mix(out) turns the coalesced requests into Commands for the caller to
+//      apply in order: Stop a voice (it was stolen), Play a voice at volume
+//      and pan.
+//
+// Gain is 1 within min_distance of the listener, falls linearly to 0 at
+// max_distance, and is scaled by the clip's volume; requests at or below
+// CULL_GAIN are culled. A request's score is priority × gain. Without a
+// free alias of its clip, or with max_voices already playing, it steals the
+// lowest-scoring playing voice if that scored less, and is dropped
+// otherwise. Pan is -1 (left) to 1 (right) along the listener's right.
+//
+// Part of AudioResource. Counters are the last mix()'s.
+//
+// No Jolt or Raylib dependency — compilable in the headless test target.
+// ---------------------------------------------------------------------------
+
+class VoicePool {
+public:
+    static constexpr size_t MAX_CLIPS = 8;
+    static constexpr size_t ALIASES   = 4; // voices per clip
+    static constexpr float  CULL_GAIN = 0.01f;
+
+    struct Clip {
+        float priority = 1.0f;
+        float volume   = 1.0f;
+    };
+
+    struct Listener {
+        ecs::Vec3 position = {0, 0, 0};
+        ecs::Vec3 right    = {1, 0, 0}; // unit
+    };
+
+    struct Command {
+        enum class Type : uint8_t { Stop, Play };
+        Type   type   = Type::Play;
+        size_t voice  = 0; // clip * ALIASES + alias
+        float  volume = 1.0f;
+        float  pan    = 0.0f;
+    };
+
+    size_t max_voices   = 12;
+    float  min_distance = 3.0f;  // m
+    float  max_distance = 40.0f; // m
+
+    // Registers a clip; returns its id, or -1 when MAX_CLIPS are in use.
+    int add_clip(Clip clip) {
+        if (clips_ >= MAX_CLIPS) return -1;
+        info_[clips_] = clip;
+        return static_cast<int>(clips_++);
+    }
+
+    size_t clips()  const { return clips_; }
+    size_t voices() const { return clips_ * ALIASES; }
+
+    void begin(const Listener& listener) {
+        listener_ = listener;
+        for (Pending& p : pending_) p = {};
+        coalesced_ = culled_ = stolen_ = dropped_ = 0;
+    }
+
+    void set_playing(size_t voice, bool playing) {
+        if (voice < voices()) voices_[voice].playing = playing;
+    }
+
+    // Positional request. Unknown clips are ignored.
+    void submit(int clip, const ecs::Vec3& position) {
+        if (clip < 0 || static_cast<size_t>(clip) >= clips_) return;
+        const ecs::Vec3 d = {position.x - listener_.position.x, position.y - listener_.position.y,
+                             position.z - listener_.position.z};
+        const float dist = std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+        const float pan  = dist > 1e-4f
+                               ? std::clamp((d.x * listener_.right.x + d.y * listener_.right.y +
+                                             d.z * listener_.right.z) / dist, -1.0f, 1.0f)
+                               : 0.0f;
+        offer(clip, attenuation(dist) * info_[clip].volume, pan);
+    }
+
+    // Request heard at full gain wherever the listener is.
+    void submit(int clip) {
+        if (clip < 0 || static_cast<size_t>(clip) >= clips_) return;
+        offer(clip, info_[clip].volume, 0.0f);
+    }
+
+    // Linear rolloff: 1 inside min_distance, 0 from max_distance.
+    float attenuation(float distance) const {
+        if (distance <= min_distance) return 1.0f;
+        if (distance >= max_distance) return 0.0f;
+        return (max_distance - distance) / (max_distance - min_distance);
+    }
+
+    void mix(std::vector<Command>& out) {
+        out.clear();
+        requests_.clear();
+        for (size_t c = 0; c < clips_; ++c) {
+            const Pending& p = pending_[c];
+            if (p.count == 0) continue;
+            coalesced_ += p.count - 1;
+            if (p.gain <= CULL_GAIN) {
+                ++culled_;
+                continue;
+            }
+            requests_.push_back({c, p.gain, p.pan, info_[c].priority * p.gain});
+        }
+        // Highest score first, so a full pool keeps the requests that matter.
+        std::sort(requests_.begin(), requests_.end(),
+                  [](const Request& a, const Request& b) { return a.score > b.score; });
+
+        size_t active = 0;
+        for (size_t v = 0; v < voices(); ++v) active += voices_[v].playing ? 1 : 0;
+
+        for (const Request& r : requests_) {
+            const size_t first = r.clip * ALIASES;
+            size_t slot = NONE;
+            for (size_t v = first; v < first + ALIASES && slot == NONE; ++v)
+                if (!voices_[v].playing) slot = v;
+
+            // No free alias: the clip's weakest voice restarts. Pool full:
+            // the weakest voice anywhere makes room.
+            if (slot == NONE || active >= max_voices) {
+                const size_t victim = slot == NONE ? weakest(first, first + ALIASES) : weakest(0, voices());
+                if (victim == NONE || voices_[victim].score >= r.score) {
+                    ++dropped_;
+                    continue;
+                }
+                voices_[victim].playing = false;
+                --active;
+                ++stolen_;
+                out.push_back({Command::Type::Stop, victim, 0.0f, 0.0f});
+                if (slot == NONE) slot = victim;
+            }
+
+            voices_[slot] = {true, r.score};
+            ++active;
+            out.push_back({Command::Type::Play, slot, r.gain, r.pan});
+        }
+        playing_ = active;
+    }
+
+    size_t playing()   const { return playing_; }
+    size_t coalesced() const { return coalesced_; } // requests merged into a louder one
+    size_t culled()    const { return culled_; }    // out of earshot
+    size_t stolen()    const { return stolen_; }    // voices cut for a higher score
+    size_t dropped()   const { return dropped_; }   // requests lost to higher scores
+
+private:
+    static constexpr size_t NONE = ~size_t(0);
+
+    struct Voice {
+        bool  playing = false;
+        float score   = 0.0f; // when it started
+    };
+    struct Pending {
+        uint32_t count = 0;
+        float    gain  = 0.0f;
+        float    pan   = 0.0f;
+    };
+    struct Request {
+        size_t clip;
+        float  gain, pan, score;
+    };
+
+    std::array<Clip, MAX_CLIPS>            info_{};
+    std::array<Pending, MAX_CLIPS>         pending_{};
+    std::array<Voice, MAX_CLIPS * ALIASES> voices_{};
+    std::vector<Request>                   requests_;
+    Listener                               listener_;
+    size_t clips_     = 0;
+    size_t playing_   = 0;
+    size_t coalesced_ = 0, culled_ = 0, stolen_ = 0, dropped_ = 0;
+
+    void offer(int clip, float gain, float pan) {
+        Pending& p = pending_[clip];
+        if (p.count++ == 0 || gain > p.gain) {
+            p.gain = gain;
+            p.pan  = pan;
+        }
+    }
+
+    size_t weakest(size_t from, size_t to) const {
+        size_t best = NONE;
+        for (size_t v = from; v < to; ++v)
+            if (voices_[v].playing && (best == NONE || voices_[v].score < voices_[best].score)) best = v;
+        return best;
+    }
+};
@@ -3,10 +3,76 @@
 #include "../src/math_util.hpp"
 #include "../src/systems/character_state.hpp"
 #include "../src/events.hpp"
+#include "../src/contact_events.hpp"
 #include "../src/scene.hpp"
+#include "../src/shape_desc.hpp"
+#include "../src/component_snapshot.hpp"
+#include "../src/input_events.hpp"
+#include "../src/input_replay.hpp"
 #include "../src/debug_panel.hpp"
+#include "../src/deferred_commands.hpp"
+#include "../src/fixed_time.hpp"
+#include "../src/frame_profiler.hpp"
+#include "../src/character_islands.hpp"
+#include "../src/culling.hpp"
+#include "../src/instance_batch.hpp"
+#include "../src/render_lod.hpp"
+#include "../src/render_state.hpp"
+#include "../src/gpu_timer.hpp"
+#include "../src/scene_async.hpp"
+#include "../src/scene_chunks.hpp"
+#include "../src/pipeline.hpp"
+#include "../src/physics_layers.hpp"
+#include "../src/physics_query.hpp"
+#include "../src/physics_stats.hpp"
+#include "../src/platform_pool.hpp"
+#include "../src/transform_batch.hpp"
+#include "../src/transform_dirty.hpp"
+#include "../src/each_optional.hpp"
+#include "../src/frame_arena.hpp"
+#include "../src/kinematic_target.hpp"
+#include "../src/render_snapshot.hpp"
+#include "../src/sim_thread.hpp"
+#include "../src/voice_pool.hpp"
+#include "../src/asset_cache.hpp"
+#include "../src/net_replication.hpp"
+#include "../src/stress_scene.hpp"
+#include "../src/static_pipeline.hpp"
 #include <ecs/ecs.hpp>
 #include <ecs/modules/transform.hpp>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <bitset>
+#include <cctype>
+#include <cstdlib>
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+// Counts this thread's heap allocations, so a test can check that a hot path
+// reuses its storage. The array and sized forms route through these. The
+// nothrow form is replaced too: the library's own would not use malloc, and
+// its blocks (std::stable_sort's buffer) would reach free() below.
+static thread_local uint64_t g_thread_allocs = 0;
+void* operator new(size_t n) {
+    ++g_thread_allocs;
+    if (void* p = std::malloc(n ? n : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(size_t n, const std::nothrow_t&) noexcept {
+    ++g_thread_allocs;
+    return std::malloc(n ? n : 1);
+}
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
 
 // components.hpp and character_state.hpp are now free of engine-library
 // dependencies (RFC-0008), so apply_state can be exercised without linking
@@ -217,6 +283,270 @@ TEST_CASE("Events — multiple sends accumulate in order", "[events]") {
     for (int i = 0; i < 5; ++i) CHECK(v[i].value == i);
 }
 
+TEST_CASE("Events — a full queue drops and counts further sends", "[events]") {
+    Events<TestEvent> queue(3);
+    for (int i = 0; i < 5; ++i) queue.send({i});
+
+    REQUIRE(queue.read().size() == 3);
+    CHECK(queue.read()[2].value == 2);
+    CHECK(queue.dropped() == 2);
+
+    queue.flush();
+    queue.send({9});
+    REQUIRE(queue.read().size() == 1);
+    CHECK(queue.read()[0].value == 9);
+}
+
+TEST_CASE("Events — buffered mode reads the previous frame's events", "[events]") {
+    Events<TestEvent> queue(8, EventMode::Buffered);
+
+    queue.send({1});           // e.g. sent during Physics
+    CHECK(queue.empty());      // not readable until the next flush
+    queue.flush();             // next frame starts
+    queue.send({2});
+    REQUIRE(queue.read().size() == 1);
+    CHECK(queue.read()[0].value == 1);
+
+    queue.flush();
+    REQUIRE(queue.read().size() == 1);
+    CHECK(queue.read()[0].value == 2);  // {1} was read once and is gone
+
+    queue.flush();
+    CHECK(queue.empty());
+}
+
+TEST_CASE("EventRegistry — flush_all flushes every registered queue", "[events]") {
+    struct OtherEvent { float x; };
+    ecs::World    world;
+    EventRegistry registry;
+    auto& frame    = registry.register_queue<TestEvent>(world);
+    auto& buffered = registry.register_queue<OtherEvent>(world, 4, EventMode::Buffered);
+    CHECK(&registry.register_queue<TestEvent>(world) == &frame); // idempotent
+    CHECK(registry.size() == 2);
+    CHECK(&world.resource<Events<TestEvent>>() == &frame);
+
+    frame.send({1});
+    buffered.send({2.0f});
+    registry.flush_all();
+    CHECK(frame.empty());
+    REQUIRE(buffered.read().size() == 1);
+    registry.flush_all();
+    CHECK(buffered.empty());
+}
+
+// ---------------------------------------------------------------------------
+// PhysicsQuery — request / result lifecycle (the Jolt executor is not headless)
+// ---------------------------------------------------------------------------
+
+TEST_CASE("PhysicsQuery — results are Done for one batch, then Expired", "[query]") {
+    PhysicsQuery q;
+    CHECK(q.status(PhysicsQuery::Id{}) == QueryStatus::Expired);
+
+    auto a = q.ray({0, 1, 0}, {0, -2, 0}, QueryLayers::StaticOnly);
+    auto b = q.cast(QueryShape::Sphere, {0.5f, 0, 0}, {0, 1, 0}, {0, -2, 0});
+    CHECK(a.valid());
+    CHECK(q.status(a) == QueryStatus::Pending);
+    CHECK(q.hit(a) == nullptr);
+    CHECK(q.pending() == 2);
+
+    auto& slots = q.begin_execute();     // what PhysicsQuerySystem does
+    REQUIRE(slots.size() == 2);
+    CHECK(slots[a.index].request.kind   == PhysicsQuery::Request::Kind::Ray);
+    CHECK(slots[a.index].request.layers == QueryLayers::StaticOnly);
+    CHECK(slots[b.index].request.kind   == PhysicsQuery::Request::Kind::Cast);
+    slots[a.index].result.hit      = true;
+    slots[a.index].result.fraction = 0.25f;
+
+    auto late = q.ray({0, 0, 0}, {1, 0, 0});   // after the executor: next batch
+    CHECK(q.status(late) == QueryStatus::Pending);
+    REQUIRE(q.status(a) == QueryStatus::Done);
+    CHECK(q.hit(a)->hit);
+    CHECK(q.hit(a)->fraction == 0.25f);
+    CHECK_FALSE(q.hit(b)->hit);
+
+    q.begin_execute();
+    CHECK(q.status(a) == QueryStatus::Expired);
+    CHECK(q.hit(a) == nullptr);
+    CHECK(q.status(late) == QueryStatus::Done);
+}
+
+TEST_CASE("PhysicsQuery — overlap results come back per request", "[query]") {
+    ecs::World world;
+    auto e1 = world.create();
+    auto e2 = world.create();
+
+    PhysicsQuery q;
+    auto a = q.overlap(QueryShape::Box, {1, 1, 1}, {0, 0, 0}, QueryLayers::All, {}, 4);
+    auto b = q.overlap(QueryShape::Sphere, {2, 0, 0}, {5, 0, 0}, QueryLayers::MovingOnly, {}, 2);
+
+    auto& slots = q.begin_execute();
+    CHECK(slots[b.index].request.first_hit == 4);   // regions don't overlap
+    ecs::Entity* out = q.hit_buffer();
+    out[slots[a.index].request.first_hit] = e1;
+    slots[a.index].hit_count = 1;
+    out[slots[b.index].request.first_hit]     = e1;
+    out[slots[b.index].request.first_hit + 1] = e2;
+    slots[b.index].hit_count = 2;
+
+    auto ra = q.overlaps(a);
+    REQUIRE(ra.size() == 1);
+    CHECK(*ra.begin() == e1);
+    std::vector<ecs::Entity> rb(q.overlaps(b).begin(), q.overlaps(b).end());
+    CHECK(rb == std::vector<ecs::Entity>{e1, e2});
+
+    q.begin_execute();
+    CHECK(q.overlaps(a).empty());
+}
+
+// ---------------------------------------------------------------------------
+// Contact events — PerThreadBuffer / ContactTracker
+// ---------------------------------------------------------------------------
+
+TEST_CASE("PerThreadBuffer — pushes from many threads all drain", "[contacts]") {
+    PerThreadBuffer<int> buffer(2); // 4 threads: two share the overflow slot
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&buffer, t] { for (int i = 0; i < 1000; ++i) buffer.push(t * 1000 + i); });
+    for (auto& t : threads) t.join();
+
+    std::vector<int> out;
+    buffer.drain(out);
+    REQUIRE(out.size() == 4000);
+    std::sort(out.begin(), out.end());
+    std::vector<int> expected(4000);
+    for (int i = 0; i < 4000; ++i) expected[i] = i;
+    CHECK(out == expected);
+
+    out.clear();
+    buffer.drain(out);
+    CHECK(out.empty());
+}
+
+namespace {
+ContactRecord contact(ContactRecord::Type type, uint32_t ba, uint32_t bb, ecs::Entity a, ecs::Entity b,
+                      bool sensor = false) {
+    ContactRecord r;
+    r.type        = type;
+    r.body_a      = ba;
+    r.body_b      = bb;
+    r.sensor      = sensor;
+    r.a_is_sensor = sensor;
+    if (type != ContactRecord::Type::Removed) { r.a = a; r.b = b; r.depth = 0.01f; }
+    return r;
+}
+} // namespace
+
+TEST_CASE("ContactTracker — one event per body pair per step", "[contacts]") {
+    using T = ContactRecord::Type;
+    ecs::World world;
+    const ecs::Entity a = world.create(), b = world.create();
+    Events<ContactEvent> contacts(64);
+    ContactTracker tracker;
+    std::vector<ContactRecord> recs;
+
+    // Two sub-shape pairs of the same bodies start touching.
+    recs = {contact(T::Added, 1, 2, a, b), contact(T::Added, 1, 2, a, b)};
+    tracker.merge(world, recs, &contacts, nullptr);
+    REQUIRE(contacts.read().size() == 1);
+    CHECK(contacts.read()[0].type == ContactEvent::Type::Added);
+    CHECK(contacts.read()[0].a == a);
+    CHECK(recs.empty());
+
+    contacts.flush();
+    recs = {contact(T::Persisted, 1, 2, a, b), contact(T::Removed, 1, 2, a, b)}; // one sub-shape left
+    tracker.merge(world, recs, &contacts, nullptr);
+    REQUIRE(contacts.read().size() == 1);
+    CHECK(contacts.read()[0].type == ContactEvent::Type::Persisted);
+
+    contacts.flush();
+    recs = {contact(T::Removed, 1, 2, a, b)};
+    tracker.merge(world, recs, &contacts, nullptr);
+    REQUIRE(contacts.read().size() == 1);
+    CHECK(contacts.read()[0].type == ContactEvent::Type::Removed);
+    CHECK(contacts.read()[0].b == b);
+    CHECK(tracker.open_pairs() == 0);
+}
+
+TEST_CASE("ContactTracker — sensors emit enter and exit, even within one step", "[contacts]") {
+    using T = ContactRecord::Type;
+    ecs::World world;
+    const ecs::Entity zone = world.create(), crate = world.create();
+    Events<ContactEvent> contacts(16);
+    Events<TriggerEvent> triggers(16);
+    ContactTracker tracker;
+
+    // Folded sub-steps: entered and left during one Update, callbacks in any order.
+    std::vector<ContactRecord> recs = {contact(T::Removed, 3, 4, zone, crate, true),
+                                       contact(T::Added, 3, 4, zone, crate, true)};
+    tracker.merge(world, recs, &contacts, &triggers);
+    CHECK(contacts.read().empty());
+    REQUIRE(triggers.read().size() == 2);
+    CHECK(triggers.read()[0].type == TriggerEvent::Type::Enter);
+    CHECK(triggers.read()[0].sensor == zone);
+    CHECK(triggers.read()[0].other == crate);
+    CHECK(triggers.read()[1].type == TriggerEvent::Type::Exit);
+    CHECK(tracker.open_pairs() == 0);
+}
+
+TEST_CASE("ContactTracker — pairs with a destroyed entity are closed", "[contacts]") {
+    using T = ContactRecord::Type;
+    ecs::World world;
+    const ecs::Entity zone = world.create(), crate = world.create();
+    Events<TriggerEvent> triggers(16);
+    ContactTracker tracker;
+
+    std::vector<ContactRecord> recs = {contact(T::Added, 3, 4, zone, crate, true)};
+    tracker.merge(world, recs, nullptr, &triggers);
+    REQUIRE(tracker.open_pairs() == 1);
+
+    triggers.flush();
+    world.destroy(crate);
+    tracker.merge(world, recs, nullptr, &triggers); // no records this step
+    REQUIRE(triggers.read().size() == 1);
+    CHECK(triggers.read()[0].type == TriggerEvent::Type::Exit);
+    CHECK(tracker.open_pairs() == 0);
+}
+
+TEST_CASE("BodyIslands — awake bodies in contact share an island", "[contacts]") {
+    using T = ContactRecord::Type;
+    const ecs::Entity none{};
+    // 1-2-3 chained, 4 alone, 9 is static (not in the active list).
+    std::vector<uint32_t> active = {3, 1, 4, 2};
+    std::vector<ContactRecord> recs = {
+        contact(T::Added, 1, 2, none, none),     contact(T::Persisted, 2, 3, none, none),
+        contact(T::Persisted, 2, 3, none, none), // second sub-shape pair
+        contact(T::Persisted, 3, 9, none, none), contact(T::Persisted, 4, 9, none, none),
+        contact(T::Removed, 1, 4, none, none),
+    };
+    BodyIslands islands;
+    PhysicsStats stats;
+    islands.build(active, recs, stats);
+    CHECK(stats.islands == 2);        // the floor does not join 1-2-3 with 4
+    CHECK(stats.largest_island == 3);
+    CHECK(stats.contact_pairs == 4);  // 1-2, 2-3, 3-9, 4-9
+    CHECK(stats.sensor_pairs == 0);
+    CHECK(recs.size() == 6);          // records are left for the tracker
+}
+
+TEST_CASE("BodyIslands — sensors and sleeping bodies join nothing", "[contacts]") {
+    using T = ContactRecord::Type;
+    const ecs::Entity none{};
+    std::vector<ContactRecord> recs = {contact(T::Added, 1, 2, none, none, true),
+                                       contact(T::Persisted, 5, 6, none, none)};
+    BodyIslands islands;
+    PhysicsStats stats;
+    islands.build({1, 2}, recs, stats);
+    CHECK(stats.islands == 2);
+    CHECK(stats.largest_island == 1);
+    CHECK(stats.contact_pairs == 1);
+    CHECK(stats.sensor_pairs == 1);
+
+    islands.build({}, {}, stats); // everything asleep
+    CHECK(stats.islands == 0);
+    CHECK(stats.largest_island == 0);
+    CHECK(stats.contact_pairs == 0);
+}
+
 // ---------------------------------------------------------------------------
 // SceneLoader
 // ---------------------------------------------------------------------------
@@ -293,56 +623,3036 @@ TEST_CASE("SceneLoader — player entity gets PlayerInput and PlayerState", "[sc
     CHECK(player_count == 1);
 }
 
+TEST_CASE("SceneLoader — streaming skips non-entity keys around the array", "[scene]") {
+    ecs::World world;
+    REQUIRE(SceneLoader::load_from_string(world, R"({
+      "physics": { "max_bodies": 64, "nested": [[1, 2], {"entities": []}] },
+      "entities": [
+        { "transform": { "position": [7, 8, 9] }, "tags": ["World"],
+          "box_collider": { "half_extents": [1, 2, 3] } }
+      ],
+      "notes": ["ignored", { "entities": [ { "tags": ["World"] } ] }]
+    })"));
+    CHECK(world.count() == 1);
+    world.each<ecs::LocalTransform, BoxCollider>([&](ecs::Entity, ecs::LocalTransform& lt, BoxCollider& box) {
+        CHECK_THAT(lt.position.y,      Catch::Matchers::WithinAbs(8.0f, 1e-6f));
+        CHECK_THAT(box.half_extents.z, Catch::Matchers::WithinAbs(3.0f, 1e-6f));
+    });
+}
+
+TEST_CASE("SceneLoader — failed stream rolls back spawned entities", "[scene]") {
+    ecs::World world;
+    // Second entity has an unknown shape: the first was already spawned.
+    CHECK_FALSE(SceneLoader::load_from_string(world, R"({ "entities": [
+      { "tags": ["World"] },
+      { "mesh": { "shape": "Torus" } }
+    ]})"));
+    CHECK(world.count() == 0);
+
+    // Truncated after the first entity.
+    CHECK_FALSE(SceneLoader::load_from_string(world, R"({ "entities": [ { "tags": ["World"] }, )"));
+    CHECK(world.count() == 0);
+
+    // No entities array at all.
+    CHECK_FALSE(SceneLoader::load_from_string(world, R"({ "physics": {} })"));
+}
+
+static const char* NAMED_SCENE = R"({ "entities": [
+  { "_name": "Ground", "transform": { "position": [0, 0, 0] }, "box_collider": { "half_extents": [10, 0.5, 10] },
+    "rigid_body": { "type": "Static" }, "mesh": { "shape": "Box" }, "tags": ["World"] },
+  { "_name": "Crate", "transform": { "position": [1, 5, 0] }, "box_collider": { "half_extents": [0.5, 0.5, 0.5] },
+    "rigid_body": { "type": "Dynamic" }, "tags": ["World"] },
+  { "_name": "Lamp", "transform": { "position": [3, 1, 0] }, "tags": ["World"] },
+  { "transform": { "position": [9, 9, 9] }, "tags": ["World"] }
+]})";
+
+static ecs::Entity find_at(ecs::World& world, float x) {
+    ecs::Entity found{};
+    world.each<ecs::LocalTransform>([&](ecs::Entity e, ecs::LocalTransform& lt) {
+        if (lt.position.x == x) found = e;
+    });
+    return found;
+}
+
+TEST_CASE("SceneLoader — reload of an identical scene changes nothing", "[scene]") {
+    ecs::World world;
+    REQUIRE(SceneLoader::load_from_string(world, NAMED_SCENE));
+    const ecs::Entity lamp = find_at(world, 3.0f);
+
+    SceneReloadStats stats;
+    REQUIRE(SceneLoader::reload_from_string(world, NAMED_SCENE, &stats));
+    CHECK(stats.unchanged == 3);
+    CHECK(stats.added == 1);    // the unnamed entity is always replaced
+    CHECK(stats.removed == 1);
+    CHECK(stats.updated == 0);
+    CHECK(stats.respawned == 0);
+    CHECK(world.count() == 4);
+    CHECK(world.alive(lamp));
+}
+
+TEST_CASE("SceneLoader — reload diffs entities by name", "[scene]") {
+    ecs::World world;
+    REQUIRE(SceneLoader::load_from_string(world, NAMED_SCENE));
+    const ecs::Entity ground = find_at(world, 0.0f);
+    const ecs::Entity lamp   = find_at(world, 3.0f);
+
+    SceneReloadStats stats;
+    REQUIRE(SceneLoader::reload_from_string(world, R"({ "entities": [
+      { "_name": "Ground", "transform": { "position": [0, -1, 0] }, "box_collider": { "half_extents": [10, 0.5, 10] },
+        "rigid_body": { "type": "Static" }, "mesh": { "shape": "Box" }, "tags": ["World"] },
+      { "_name": "Lamp", "transform": { "position": [3, 1, 0] }, "box_collider": { "half_extents": [1, 1, 1] },
+        "tags": ["World"] },
+      { "_name": "Sign", "transform": { "position": [5, 0, 0] }, "tags": ["World"] }
+    ]})", &stats));
+
+    CHECK(stats.updated == 1);    // Ground moved
+    CHECK(stats.respawned == 1);  // Lamp gained a collider
+    CHECK(stats.added == 1);      // Sign
+    CHECK(stats.removed == 2);    // Crate and the unnamed entity
+    CHECK(world.count() == 3);
+
+    // Moved in place: same entity, new transform, teleport requested for its body.
+    REQUIRE(world.alive(ground));
+    CHECK_THAT(world.get<ecs::LocalTransform>(ground).position.y, Catch::Matchers::WithinAbs(-1.0f, 1e-6f));
+    CHECK(world.has<PhysicsTeleport>(ground));
+
+    CHECK_FALSE(world.alive(lamp));
+    const ecs::Entity new_lamp = find_at(world, 3.0f);
+    CHECK(world.has<BoxCollider>(new_lamp));
+}
+
+TEST_CASE("SceneLoader — failed reload leaves the world untouched", "[scene]") {
+    ecs::World world;
+    REQUIRE(SceneLoader::load_from_string(world, NAMED_SCENE));
+    CHECK_FALSE(SceneLoader::reload_from_string(world, R"({ "entities": [ { "_name": "Ground" )"));
+    CHECK(world.count() == 4);
+
+    // The index survives, so a later good reload still diffs.
+    SceneReloadStats stats;
+    REQUIRE(SceneLoader::reload_from_string(world, NAMED_SCENE, &stats));
+    CHECK(stats.unchanged == 3);
+}
+
+TEST_CASE("SceneLoader — baked scenes are indexed for reload", "[scene]") {
+    std::vector<uint8_t> image;
+    REQUIRE(SceneLoader::bake_from_string(NAMED_SCENE, image));
+    ecs::World world;
+    REQUIRE(SceneLoader::load_binary_from_memory(world, image.data(), image.size()));
+
+    SceneReloadStats stats;
+    REQUIRE(SceneLoader::reload_from_string(world, NAMED_SCENE, &stats));
+    CHECK(stats.unchanged == 3);
+    CHECK(world.count() == 4);
+}
+
+// Writes `json` to a temp file for the async loader, which reads from disk.
+static std::string write_temp_scene(const char* name, const std::string& json) {
+    const auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream(path) << json;
+    return path.string();
+}
+
+// Drives the loader like the pipeline does: pump in Pre-Update, flush after Logic.
+static int pump_until_done(AsyncSceneLoader& loader, ecs::World& world, size_t budget) {
+    for (int frame = 1; frame < 10000; ++frame) {
+        const bool done = loader.pump(world, budget);
+        world.deferred().flush(world);
+        if (done || loader.state() == AsyncSceneLoader::State::Failed) return frame;
+        std::this_thread::yield();
+    }
+    return -1;
+}
+
+TEST_CASE("AsyncSceneLoader — commits the scene over several frames", "[scene]") {
+    const std::string path = write_temp_scene("async_named_scene.json", NAMED_SCENE);
+    ecs::World world;
+    AsyncSceneLoader loader;
+    size_t prepared = 0;
+    loader.start(path, [&](const SceneEntityDesc&) { ++prepared; });
+    CHECK(loader.busy());
+
+    size_t max_step = 0, last = 0;
+    for (int frame = 0; frame < 10000; ++frame) {
+        const bool done = loader.pump(world, 1);
+        world.deferred().flush(world);
+        max_step = std::max(max_step, world.count() - last);
+        last     = world.count();
+        if (done) break;
+        std::this_thread::yield();
+    }
+    CHECK(loader.state() == AsyncSceneLoader::State::Idle);
+    CHECK(prepared == 4);
+    CHECK(world.count() == 4);
+    CHECK(max_step == 1);              // budget of one entity per frame
+    CHECK(world.count<WorldTag>() == 4);
+    CHECK(loader.progress() == 1.0f);
+
+    // Indexed like a synchronous load.
+    SceneReloadStats stats;
+    REQUIRE(SceneLoader::reload_from_string(world, NAMED_SCENE, &stats));
+    CHECK(stats.unchanged == 3);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("AsyncSceneLoader — bad file fails without spawning", "[scene]") {
+    const std::string path = write_temp_scene("async_bad_scene.json", R"({ "entities": [ { "tags": ["World"] }, )");
+    ecs::World world;
+    AsyncSceneLoader loader;
+    loader.start(path);
+    CHECK(pump_until_done(loader, world, 64) > 0);
+    CHECK(loader.state() == AsyncSceneLoader::State::Failed);
+    CHECK(world.count() == 0);
+
+    loader.start((std::filesystem::temp_directory_path() / "async_missing_scene.json").string());
+    pump_until_done(loader, world, 64);
+    CHECK(loader.state() == AsyncSceneLoader::State::Failed);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("AsyncSceneLoader — cancel drops uncommitted entities", "[scene]") {
+    const std::string path = write_temp_scene("async_cancel_scene.json", NAMED_SCENE);
+    ecs::World world;
+    AsyncSceneLoader loader;
+    loader.start(path);
+    while (loader.state() == AsyncSceneLoader::State::Parsing) std::this_thread::yield();
+    loader.pump(world, 1);
+    world.deferred().flush(world);
+    loader.cancel();
+    CHECK(loader.state() == AsyncSceneLoader::State::Idle);
+    CHECK_FALSE(loader.pump(world, 64));
+    CHECK(world.count() == 1);
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("AsyncSceneLoader — a streamed reset keeps the player and re-poses it", "[scene]") {
+    const char* scene = R"({ "entities": [
+      { "_name": "Ground", "transform": { "position": [0, 0, 0] },
+        "box_collider": { "half_extents": [50, 0.5, 50] }, "tags": ["World"] },
+      { "_name": "Player", "transform": { "position": [0, 2, 0] },
+        "character": { "height": 1.8, "radius": 0.4 }, "tags": ["Player", "World"] },
+      { "_name": "Crate", "transform": { "position": [3, 1, 0] }, "tags": ["World"] } ]})";
+    const std::string path = write_temp_scene("async_reset_scene.json", scene);
+    ecs::World world;
+    REQUIRE(SceneLoader::load_from_string(world, scene));
+    ecs::Entity player{};
+    world.each<PlayerTag>([&](ecs::Entity e, PlayerTag&) { player = e; });
+    world.get<ecs::LocalTransform>(player).position = {9, 9, 9};
+    world.get<PlayerInput>(player).jump = true;
+
+    SceneLoader::unload(world, true);
+    CHECK(world.count<WorldTag>() == 1);
+    CHECK(world.count<PlayerTag>() == 1);
+
+    AsyncSceneLoader loader;
+    loader.start(path, {}, player);
+    size_t players_min = 1, players_max = 1;
+    for (int frame = 0; frame < 10000; ++frame) {
+        const bool done = loader.pump(world, 1);
+        world.deferred().flush(world);
+        players_min = std::min(players_min, world.count<PlayerTag>());
+        players_max = std::max(players_max, world.count<PlayerTag>());
+        if (done) break;
+        std::this_thread::yield();
+    }
+    CHECK(loader.state() == AsyncSceneLoader::State::Idle);
+    CHECK(players_min == 1); // a player on every frame, never two
+    CHECK(players_max == 1);
+    CHECK(world.alive(player));
+    CHECK(world.count<WorldTag>() == 3);
+    CHECK(world.get<ecs::LocalTransform>(player).position.y == 2.0f);
+    CHECK(world.has<PhysicsTeleport>(player));
+    CHECK_FALSE(world.get<PlayerInput>(player).jump);
+    CHECK(world.resource<SceneIndex>().named.at("Player").entity == player);
+
+    // Without a kept player the scene spawns its own, as before.
+    SceneLoader::unload(world);
+    CHECK(world.count() == 0);
+    loader.start(path);
+    pump_until_done(loader, world, 64);
+    CHECK(world.count<PlayerTag>() == 1);
+    std::filesystem::remove(path);
+}
+
+// A row of small crates every 20 m along +X, a ground wider than a cell and a player.
+static std::string chunked_scene(int crates) {
+    std::string s = R"({ "entities": [
+      { "_name": "Ground", "transform": { "position": [0, 0, 0] },
+        "box_collider": { "half_extents": [500, 0.5, 500] }, "tags": ["World"] },
+      { "_name": "Player", "transform": { "position": [0, 2, 0] }, "tags": ["Player", "World"] })";
+    for (int i = 0; i < crates; ++i)
+        s += R"(, { "transform": { "position": [)" + std::to_string(i * 20 + 10) +
+             R"(, 1, 5] }, "box_collider": { "half_extents": [0.5, 0.5, 0.5] }, "tags": ["World"] })";
+    return s + "]}";
+}
+
+TEST_CASE("SceneChunks — only cells near the player are live", "[scene]") {
+    ecs::World world;
+    ChunkConfig cfg;
+    cfg.cell_size = 20.0f; cfg.load_radius = 30.0f; cfg.unload_radius = 50.0f; cfg.budget = 1000;
+    REQUIRE(SceneChunks::load_from_string(world, chunked_scene(50), cfg));
+    CHECK(world.count() == 2);                 // ground and player are resident
+
+    auto& chunks = world.resource<SceneChunks>();
+    CHECK(chunks.cell_count() == 50);
+    chunks.update(world, 0.0f, 0.0f);
+    CHECK(chunks.live() == 2);                 // cells [0,20) and [20,40) in x
+    CHECK(world.count() == 4);
+
+    // Walk to x = 500: the old cells go, the new ones come, and the total stays bounded.
+    chunks.update(world, 500.0f, 0.0f);
+    CHECK(chunks.live() == 4);                 // x cells 480..540
+    CHECK(world.count() == 6);
+}
+
+TEST_CASE("SceneChunks — hysteresis keeps cells between the two radii", "[scene]") {
+    ecs::World world;
+    ChunkConfig cfg;
+    cfg.cell_size = 20.0f; cfg.load_radius = 30.0f; cfg.unload_radius = 50.0f; cfg.budget = 1000;
+    REQUIRE(SceneChunks::load_from_string(world, chunked_scene(10), cfg));
+    auto& chunks = world.resource<SceneChunks>();
+
+    chunks.update(world, 60.0f, 0.0f);         // cells with x in [20, 100)
+    CHECK(chunks.live() == 4);
+    chunks.update(world, 100.0f, 0.0f);        // cell [40,60) is 40 m away: kept
+    CHECK(world.alive(find_at(world, 50.0f)));
+    CHECK_FALSE(world.alive(find_at(world, 30.0f)));
+    chunks.update(world, 120.0f, 0.0f);        // 60 m away: dropped
+    CHECK_FALSE(world.alive(find_at(world, 50.0f)));
+    chunks.update(world, 100.0f, 0.0f);        // back to 40 m: beyond the load radius, stays out
+    CHECK_FALSE(world.alive(find_at(world, 50.0f)));
+}
+
+TEST_CASE("SceneChunks — spawns and destroys respect the per-frame budget", "[scene]") {
+    ecs::World world;
+    ChunkConfig cfg;
+    cfg.cell_size = 20.0f; cfg.load_radius = 100.0f; cfg.unload_radius = 120.0f; cfg.budget = 3;
+    REQUIRE(SceneChunks::load_from_string(world, chunked_scene(20), cfg));
+    auto& chunks = world.resource<SceneChunks>();
+
+    CHECK(chunks.update(world, 0.0f, 0.0f) == 3);
+    CHECK(chunks.update(world, 0.0f, 0.0f) == 3);   // 6 cells start within 100 m
+    CHECK(chunks.update(world, 0.0f, 0.0f) == 0);
+    CHECK(chunks.live() == 6);
+
+    for (int frame = 0; frame < 20; ++frame) chunks.update(world, 1000.0f, 0.0f);
+    CHECK(chunks.live() == 0);
+    CHECK(world.count() == 2);
+
+    SceneLoader::unload(world);
+    CHECK_FALSE(world.has_resource<SceneChunks>());
+}
+
+TEST_CASE("SceneChunks — live streamed entities are in the SceneIndex", "[scene]") {
+    ecs::World world;
+    ChunkConfig cfg;
+    cfg.cell_size = 20.0f; cfg.load_radius = 30.0f; cfg.unload_radius = 50.0f; cfg.budget = 1000;
+    REQUIRE(SceneChunks::load_from_string(world, chunked_scene(10), cfg));
+    auto& index  = world.resource<SceneIndex>();
+    auto& chunks = world.resource<SceneChunks>();
+    CHECK(index.named.size() == 2);            // Ground and Player
+    CHECK(index.unnamed.empty());
+
+    chunks.update(world, 0.0f, 0.0f);
+    REQUIRE(index.unnamed.size() == 2);
+    CHECK(world.alive(index.unnamed[0]));
+    CHECK(world.alive(index.unnamed[1]));
+
+    // Streaming out and back in keeps one record per live entity.
+    for (int lap = 0; lap < 3; ++lap) {
+        chunks.update(world, 1000.0f, 0.0f);
+        CHECK(index.unnamed.empty());
+        chunks.update(world, 0.0f, 0.0f);
+        CHECK(index.unnamed.size() == 2);
+    }
+
+    chunks.clear(world);
+    CHECK(index.unnamed.empty());
+    CHECK(index.named.size() == 2);
+}
+
+TEST_CASE("SceneLoader — baked scene matches the JSON load", "[scene]") {
+    std::vector<uint8_t> image;
+    REQUIRE(SceneLoader::bake_from_string(MINIMAL_SCENE, image));
+
+    ecs::World world;
+    REQUIRE(SceneLoader::load_binary_from_memory(world, image.data(), image.size()));
+    CHECK(world.count() == 2);
+    CHECK(world.count<WorldTag>() == 2);
+    CHECK(world.count<PlayerInput>() == 1);
+
+    bool found_static = false;
+    world.each<ecs::LocalTransform, BoxCollider, RigidBodyConfig, MeshRenderer>([&](ecs::Entity,
+            ecs::LocalTransform& lt, BoxCollider& box, RigidBodyConfig& rb, MeshRenderer& mr) {
+        CHECK_THAT(lt.position.z,      Catch::Matchers::WithinAbs(3.0f, 1e-6f));
+        CHECK_THAT(lt.scale.y,         Catch::Matchers::WithinAbs(5.0f, 1e-6f));
+        CHECK_THAT(lt.rotation.w,      Catch::Matchers::WithinAbs(1.0f, 1e-6f));
+        CHECK_THAT(box.half_extents.y, Catch::Matchers::WithinAbs(2.5f, 1e-6f));
+        CHECK(rb.type == BodyType::Static);
+        CHECK(mr.shape_type == ShapeType::Box);
+        CHECK_THAT(mr.color.r,         Catch::Matchers::WithinAbs(0.5f, 1e-6f));
+        found_static = true;
+    });
+    CHECK(found_static);
+
+    bool found_player = false;
+    world.each<CharacterControllerConfig, PlayerTag, MeshRenderer>([&](ecs::Entity,
+            CharacterControllerConfig& cfg, PlayerTag&, MeshRenderer& mr) {
+        CHECK_THAT(cfg.mass, Catch::Matchers::WithinAbs(80.0f, 1e-6f));
+        CHECK(mr.shape_type == ShapeType::Capsule);
+        found_player = true;
+    });
+    CHECK(found_player);
+}
+
+TEST_CASE("SceneLoader — corrupt baked scene spawns nothing", "[scene]") {
+    std::vector<uint8_t> image;
+    REQUIRE(SceneLoader::bake_from_string(MINIMAL_SCENE, image));
+
+    ecs::World world;
+    CHECK_FALSE(SceneLoader::load_binary_from_memory(world, image.data(), 8));
+    CHECK_FALSE(SceneLoader::load_binary_from_memory(world, image.data(), image.size() - 8));
+
+    std::vector<uint8_t> bad_magic = image;
+    bad_magic[0] = 'X';
+    CHECK_FALSE(SceneLoader::load_binary_from_memory(world, bad_magic.data(), bad_magic.size()));
+    CHECK(world.count() == 0);
+
+    CHECK_FALSE(SceneLoader::bake_from_string("{bad json", image));
+}
+
+TEST_CASE("PhysicsConfig — scene without physics block keeps defaults", "[scene]") {
+    PhysicsConfig cfg;
+    REQUIRE(SceneLoader::physics_config_from_string(MINIMAL_SCENE, cfg));
+    CHECK(cfg.max_bodies == 1024);
+    CHECK(cfg.max_body_pairs == 1024);
+    CHECK(cfg.max_contact_constraints == 1024);
+    CHECK(cfg.temp_allocator_bytes == 10u * 1024 * 1024);
+    CHECK(cfg.worker_threads == -1);
+}
+
+TEST_CASE("PhysicsConfig — physics block overrides only given keys", "[scene]") {
+    PhysicsConfig cfg;
+    REQUIRE(SceneLoader::physics_config_from_string(R"({
+        "physics": { "max_bodies": 20000, "temp_allocator_mb": 32, "worker_threads": 3,
+                     "character_temp_mb": 0.5 },
+        "entities": []
+    })", cfg));
+    CHECK(cfg.max_bodies == 20000);
+    CHECK(cfg.temp_allocator_bytes == 32u * 1024 * 1024);
+    CHECK(cfg.character_temp_bytes == 512u * 1024);
+    CHECK(cfg.worker_threads == 3);
+    CHECK(cfg.max_body_pairs == 1024); // untouched
+}
+
+TEST_CASE("PhysicsConfig — standalone config file uses the root object", "[scene]") {
+    PhysicsConfig cfg;
+    REQUIRE(SceneLoader::physics_config_from_string(R"({ "max_contact_constraints": 4096 })", cfg));
+    CHECK(cfg.max_contact_constraints == 4096);
+}
+
+TEST_CASE("PhysicsConfig — malformed JSON returns false and leaves config", "[scene]") {
+    PhysicsConfig cfg;
+    cfg.max_bodies = 77;
+    CHECK_FALSE(SceneLoader::physics_config_from_string("{ bad json", cfg));
+    CHECK_FALSE(SceneLoader::physics_config_from_string(R"({"physics": {"max_bodies": "many"}})", cfg));
+    CHECK(cfg.max_bodies == 77);
+}
+
+TEST_CASE("PhysicsConfig — fixed-step settings", "[scene]") {
+    PhysicsConfig cfg;
+    REQUIRE(SceneLoader::physics_config_from_string(
+        R"({"physics": {"fixed_hz": 30, "max_steps_per_frame": 2, "fold_substeps": true}})", cfg));
+    CHECK(cfg.fixed_hz == 30.0f);
+    CHECK(cfg.max_steps_per_frame == 2);
+    CHECK(cfg.fold_substeps);
+    CHECK_FALSE(SceneLoader::physics_config_from_string(R"({"physics": {"fixed_hz": 0}})", cfg));
+    CHECK(cfg.fixed_hz == 30.0f);
+}
+
+TEST_CASE("PhysicsConfig — async_step is off unless the scene asks", "[scene]") {
+    PhysicsConfig cfg;
+    CHECK_FALSE(cfg.async_step);
+    REQUIRE(SceneLoader::physics_config_from_string(R"({"physics": {"fixed_hz": 30}})", cfg));
+    CHECK_FALSE(cfg.async_step);
+    REQUIRE(SceneLoader::physics_config_from_string(R"({"physics": {"async_step": true}})", cfg));
+    CHECK(cfg.async_step);
+    CHECK(cfg.fixed_hz == 30.0f); // other fields keep their earlier values
+}
+
+TEST_CASE("PhysicsConfig — sleep settings", "[scene]") {
+    PhysicsConfig cfg;
+    CHECK(cfg.allow_sleeping);
+    REQUIRE(SceneLoader::physics_config_from_string(
+        R"({"physics": {"time_before_sleep": 0.2, "sleep_velocity": 0.05}})", cfg));
+    CHECK_THAT(cfg.time_before_sleep, Catch::Matchers::WithinAbs(0.2f, 1e-6f));
+    CHECK_THAT(cfg.sleep_velocity, Catch::Matchers::WithinAbs(0.05f, 1e-6f));
+    CHECK(cfg.allow_sleeping);
+}
+
+TEST_CASE("PhysicsConfig — auto motion quality promotes fast bodies with hysteresis", "[scene]") {
+    PhysicsConfig cfg; // promote above 0.5 × radius per step, demote below 0.25 ×
+    const float r = 0.2f;
+    CHECK_FALSE(cfg.wants_linear_cast(false, 0.09f, r));
+    CHECK(cfg.wants_linear_cast(false, 0.11f, r));
+    CHECK(cfg.wants_linear_cast(true, 0.06f, r));       // slowing, still above the demote line
+    CHECK_FALSE(cfg.wants_linear_cast(true, 0.04f, r));
+    CHECK_FALSE(cfg.wants_linear_cast(true, 0.0f, r));  // asleep
+
+    REQUIRE(SceneLoader::physics_config_from_string(R"({"physics": {"ccd_promote": 1.0}})", cfg));
+    CHECK_FALSE(cfg.wants_linear_cast(false, 0.15f, r));
+}
+
+TEST_CASE("PhysicsConfig — worker count never underflows", "[scene]") {
+    PhysicsConfig cfg;
+    CHECK(cfg.resolved_worker_threads(0) == 1); // hardware_concurrency() unknown
+    CHECK(cfg.resolved_worker_threads(1) == 1);
+    CHECK(cfg.resolved_worker_threads(8) == 7);
+    cfg.worker_threads = 0;                     // explicit: run jobs inline
+    CHECK(cfg.resolved_worker_threads(8) == 0);
+}
+
 // ---------------------------------------------------------------------------
-// DebugPanel
+// PhysicsLayers — layer table and collision matrix
 // ---------------------------------------------------------------------------
 
-TEST_CASE("DebugPanel — watch creates section and row", "[debug]") {
-    DebugPanel panel;
-    panel.watch("Engine", "FPS", []() { return std::string("60"); });
+TEST_CASE("PhysicsLayers — default table keeps Static/Moving and separates debris", "[layers]") {
+    PhysicsLayers layers;
+    REQUIRE(layers.valid());
+    const uint32_t stat = PhysicsLayers::STATIC, mov = PhysicsLayers::MOVING;
+    const uint32_t debris = layers.find("Debris"), sensor = layers.find("Sensor");
+    REQUIRE(debris != PhysicsLayers::INVALID);
+    REQUIRE(sensor != PhysicsLayers::INVALID);
+
+    // The original two-layer behaviour.
+    CHECK(layers.collides(mov, mov));
+    CHECK(layers.collides(stat, mov));
+    CHECK_FALSE(layers.collides(stat, stat));
+    CHECK(layers.collides_broadphase(mov, layers.broadphase(stat)));
+    CHECK_FALSE(layers.collides_broadphase(stat, layers.broadphase(stat)));
+
+    // New layers stay out of themselves, symmetrically.
+    CHECK_FALSE(layers.collides(debris, debris));
+    CHECK_FALSE(layers.collides(sensor, sensor));
+    CHECK_FALSE(layers.collides(sensor, stat));
+    CHECK(layers.collides(debris, mov) == layers.collides(mov, debris));
+    CHECK_FALSE(layers.collides_broadphase(debris, layers.broadphase(debris)));
+    CHECK(layers.collides_broadphase(debris, layers.broadphase(stat)));
+
+    CHECK(layers.find("Nope") == PhysicsLayers::INVALID);
+    CHECK(layers.add_layer("Debris", 0) == PhysicsLayers::INVALID);  // duplicate
+}
 
-    REQUIRE(panel.sections().size() == 1);
-    CHECK(panel.sections()[0].title == "Engine");
-    REQUIRE(panel.sections()[0].rows.size() == 1);
-    CHECK(panel.sections()[0].rows[0].label == "FPS");
-    CHECK(panel.sections()[0].rows[0].fn() == "60");
+TEST_CASE("PhysicsConfig — layers block replaces the table", "[layers]") {
+    PhysicsConfig cfg;
+    REQUIRE(SceneLoader::physics_config_from_string(R"({"physics": {"layers": {
+        "broadphase": ["NON_MOVING", "MOVING"],
+        "objects": [
+            {"name": "Static", "broadphase": "NON_MOVING", "collides": ["Moving", "Shard"]},
+            {"name": "Moving", "broadphase": "MOVING",     "collides": ["Moving"]},
+            {"name": "Shard",  "broadphase": "MOVING"}
+        ]}}})", cfg));
+    REQUIRE(cfg.layers.layer_count() == 3);
+    CHECK(cfg.layers.broadphase_count() == 2);
+    const uint32_t shard = cfg.layers.find("Shard");
+    CHECK(cfg.layers.collides(shard, PhysicsLayers::STATIC));   // listed on Static's side only
+    CHECK_FALSE(cfg.layers.collides(shard, PhysicsLayers::MOVING));
+    CHECK(cfg.layers.find("Debris") == PhysicsLayers::INVALID);
+
+    // Unknown references, or a table without Static / Moving first, are rejected.
+    CHECK_FALSE(SceneLoader::physics_config_from_string(R"({"layers": {"broadphase": ["A"],
+        "objects": [{"name": "Static", "broadphase": "B"}]}})", cfg));
+    CHECK_FALSE(SceneLoader::physics_config_from_string(R"({"layers": {"broadphase": ["A"],
+        "objects": [{"name": "Moving", "broadphase": "A"}, {"name": "Static", "broadphase": "A"}]}})", cfg));
+    CHECK(cfg.layers.layer_count() == 3);
 }
 
-TEST_CASE("DebugPanel — multiple rows in one section", "[debug]") {
-    DebugPanel panel;
-    panel.watch("Engine", "FPS",        []() { return std::string("60"); });
-    panel.watch("Engine", "Frame Time", []() { return std::string("16 ms"); });
-    panel.watch("Engine", "Entities",   []() { return std::string("15"); });
+TEST_CASE("RigidBodyConfig — layer name survives JSON and bake", "[layers]") {
+    const char* scene = R"({"entities": [
+        {"transform": {"position": [0, 0, 0]}, "box_collider": {"half_extents": [1, 1, 1]},
+         "rigid_body": {"type": "Dynamic", "layer": "Debris"}},
+        {"transform": {"position": [0, 5, 0]}, "rigid_body": {"type": "Static"}}
+    ]})";
+    std::vector<uint8_t> image;
+    REQUIRE(SceneLoader::bake_from_string(scene, image));
+    ecs::World world;
+    REQUIRE(SceneLoader::load_binary_from_memory(world, image.data(), image.size()));
 
-    REQUIRE(panel.sections().size() == 1);
-    CHECK(panel.sections()[0].rows.size() == 3);
-    CHECK(panel.sections()[0].rows[1].label == "Frame Time");
-    CHECK(panel.sections()[0].rows[2].fn() == "15");
+    int debris = 0, unnamed = 0;
+    world.each<RigidBodyConfig>([&](ecs::Entity, RigidBodyConfig& rb) {
+        if (rb.layer == "Debris") ++debris;
+        else if (rb.layer.empty()) ++unnamed;
+    });
+    CHECK(debris == 1);
+    CHECK(unnamed == 1);
 }
 
-TEST_CASE("DebugPanel — multiple sections ordered by insertion", "[debug]") {
-    DebugPanel panel;
-    panel.watch("Engine",    "FPS",  []() { return std::string("60"); });
-    panel.watch("Character", "Mode", []() { return std::string("Grounded"); });
+TEST_CASE("RigidBodyConfig — sleep, damping and mass survive JSON and bake", "[scene]") {
+    const char* scene = R"({"entities": [
+        {"transform": {"position": [0, 0, 0]}, "box_collider": {"half_extents": [1, 1, 1]},
+         "rigid_body": {"type": "Dynamic", "mass": 5, "allow_sleeping": false, "start_asleep": true,
+                        "linear_damping": 0.3, "angular_damping": 0.6, "motion_quality": "Auto"}},
+        {"transform": {"position": [0, 5, 0]}, "rigid_body": {"type": "Dynamic"}}
+    ]})";
+    std::vector<uint8_t> image;
+    REQUIRE(SceneLoader::bake_from_string(scene, image));
+    ecs::World world;
+    REQUIRE(SceneLoader::load_binary_from_memory(world, image.data(), image.size()));
+
+    int authored = 0, defaults = 0;
+    world.each<RigidBodyConfig>([&](ecs::Entity, RigidBodyConfig& rb) {
+        if (rb.mass > 0.0f) {
+            ++authored;
+            CHECK_THAT(rb.mass, Catch::Matchers::WithinAbs(5.0f, 1e-6f));
+            CHECK_FALSE(rb.allow_sleeping);
+            CHECK(rb.start_asleep);
+            CHECK_THAT(rb.linear_damping, Catch::Matchers::WithinAbs(0.3f, 1e-6f));
+            CHECK_THAT(rb.angular_damping, Catch::Matchers::WithinAbs(0.6f, 1e-6f));
+            CHECK(rb.motion_quality == MotionQuality::Auto);
+        } else {
+            ++defaults; // mass from the shape, sleeps normally
+            CHECK(rb.allow_sleeping);
+            CHECK_FALSE(rb.start_asleep);
+            CHECK_THAT(rb.linear_damping, Catch::Matchers::WithinAbs(0.05f, 1e-6f));
+            CHECK(rb.motion_quality == MotionQuality::Discrete);
+        }
+    });
+    CHECK(authored == 1);
+    CHECK(defaults == 1);
 
-    REQUIRE(panel.sections().size() == 2);
-    CHECK(panel.sections()[0].title == "Engine");
-    CHECK(panel.sections()[1].title == "Character");
+    std::vector<uint8_t> bad;
+    CHECK_FALSE(SceneLoader::bake_from_string(
+        R"({"entities": [{"rigid_body": {"type": "Dynamic", "motion_quality": "Swept"}}]})", bad));
 }
 
-TEST_CASE("DebugPanel — provider is called and returns current value", "[debug]") {
-    int counter = 0;
-    DebugPanel panel;
-    panel.watch("Test", "Count", [&counter]() { return std::to_string(counter); });
+// ---------------------------------------------------------------------------
+// ShapeDesc — compound / mesh / height-field shape assets
+// ---------------------------------------------------------------------------
 
-    CHECK(panel.sections()[0].rows[0].fn() == "0");
-    counter = 42;
-    CHECK(panel.sections()[0].rows[0].fn() == "42");
+TEST_CASE("ShapeDesc — decodes compound, mesh and height-field assets", "[shapes]") {
+    ShapeDesc compound;
+    REQUIRE(ShapeDesc::read_string(R"({"compound": [
+        {"box": [1, 0.5, 2], "position": [0, 1, 0]},
+        {"sphere": 0.75, "position": [3, 0, 0], "rotation": [0, 0.7071068, 0, 0.7071068]},
+        {"capsule": [1.0, 0.3]}
+    ]})", compound));
+    CHECK(compound.kind == ShapeDesc::Kind::Compound);
+    REQUIRE(compound.children.size() == 3);
+    CHECK(compound.children[0].type == ShapeDesc::Child::Type::Box);
+    CHECK(compound.children[0].position.y == 1.0f);
+    CHECK(compound.children[1].type == ShapeDesc::Child::Type::Sphere);
+    CHECK(compound.children[1].size.x == 0.75f);
+    CHECK_THAT(compound.children[1].rotation.w, Catch::Matchers::WithinAbs(0.7071068f, 1e-6f));
+    CHECK(compound.children[2].type == ShapeDesc::Child::Type::Capsule);
+    CHECK(compound.children[2].rotation.w == 1.0f);
+
+    ShapeDesc mesh;
+    REQUIRE(ShapeDesc::read_string(R"({"mesh": {
+        "vertices": [0,0,0, 1,0,0, 0,0,1, 1,0,1], "triangles": [0,2,1, 1,2,3]}})", mesh));
+    CHECK(mesh.kind == ShapeDesc::Kind::Mesh);
+    CHECK(mesh.vertices.size() == 12);
+    CHECK(mesh.triangles.size() == 6);
+
+    ShapeDesc field;
+    REQUIRE(ShapeDesc::read_string(R"({"heightfield": {"samples": 2, "heights": [0, 1, 2, 3],
+        "offset": [-5, 0, -5], "scale": [10, 1, 10]}})", field));
+    CHECK(field.kind == ShapeDesc::Kind::HeightField);
+    CHECK(field.samples == 2);
+    CHECK(field.scale.x == 10.0f);
 }
 
-TEST_CASE("DebugPanel — visible defaults to false, toggle works", "[debug]") {
-    DebugPanel panel;
-    CHECK_FALSE(panel.visible);
-    panel.visible = true;
-    CHECK(panel.visible);
+TEST_CASE("ShapeDesc — rejects malformed assets and leaves the output", "[shapes]") {
+    ShapeDesc d;
+    d.samples = 99;
+    std::string error;
+    CHECK_FALSE(ShapeDesc::read_string("{ bad", d, &error));
+    CHECK_FALSE(ShapeDesc::read_string(R"({"compound": []})", d, &error));
+    CHECK_FALSE(ShapeDesc::read_string(R"({"compound": [{"box": [1, 0, 1]}]})", d, &error));
+    CHECK_FALSE(ShapeDesc::read_string(R"({"mesh": {"vertices": [0,0,0, 1,0,0], "triangles": [0,1,2]}})", d, &error));
+    CHECK(error == "mesh index out of range");
+    CHECK_FALSE(ShapeDesc::read_string(R"({"heightfield": {"samples": 3, "heights": [0, 1, 2, 3]}})", d, &error));
+    CHECK_FALSE(ShapeDesc::read_string(R"({"cylinder": {}})", d, &error));
+    CHECK(d.samples == 99);
+    CHECK_FALSE(ShapeDesc::read_file("no/such/shape.json", d, &error));
+}
+
+TEST_CASE("ShapeCollider — asset name survives JSON, bake and reload diffing", "[shapes]") {
+    const char* scene = R"({"entities": [
+        {"_name": "Steps", "transform": {"position": [0, 0, 0]},
+         "shape_collider": {"shape": "steps"}, "rigid_body": {"type": "Static"}, "tags": ["World"]}
+    ]})";
+    std::vector<uint8_t> image;
+    REQUIRE(SceneLoader::bake_from_string(scene, image));
+    ecs::World world;
+    REQUIRE(SceneLoader::load_binary_from_memory(world, image.data(), image.size()));
+    int found = 0;
+    world.each<ShapeCollider, RigidBodyConfig>([&](ecs::Entity, ShapeCollider& c, RigidBodyConfig&) {
+        CHECK(c.shape == "steps");
+        ++found;
+    });
+    CHECK(found == 1);
+
+    SceneReloadStats stats;
+    REQUIRE(SceneLoader::reload_from_string(world, scene, &stats));
+    CHECK(stats.unchanged == 1);
+    std::string renamed = scene;
+    renamed.replace(renamed.find("\"steps\""), 7, "\"ramp\"");
+    REQUIRE(SceneLoader::reload_from_string(world, renamed, &stats));
+    CHECK(stats.respawned == 1);
+}
+
+// ---------------------------------------------------------------------------
+// ComponentSnapshot — ECS half of PhysicsSnapshot
+// ---------------------------------------------------------------------------
+
+TEST_CASE("ComponentSnapshot — restore writes captured values back in place", "[snapshot]") {
+    ecs::World world;
+    ecs::Entity a = world.create_with(ecs::LocalTransform{{1, 2, 3}, {0, 0, 0, 1}, {1, 1, 1}},
+                                      CharacterState{CharacterState::Mode::Grounded, 0, 0.0f, 0.0f});
+    ecs::Entity b = world.create_with(ecs::LocalTransform{{4, 5, 6}, {0, 0, 0, 1}, {1, 1, 1}});
+
+    ComponentSnapshot<ecs::LocalTransform, CharacterState> snap;
+    snap.capture(world);
+    CHECK(snap.size() == 3);
+    CHECK(snap.count<ecs::LocalTransform>() == 2);
+
+    world.get<ecs::LocalTransform>(a).position = {9, 9, 9};
+    world.get<CharacterState>(a).mode          = CharacterState::Mode::Airborne;
+    world.get<CharacterState>(a).jump_count    = 2;
+    world.get<ecs::LocalTransform>(b).position = {7, 7, 7};
+
+    CHECK(snap.restore(world) == 3);
+    CHECK(world.get<ecs::LocalTransform>(a).position.x == 1.0f);
+    CHECK(world.get<CharacterState>(a).mode == CharacterState::Mode::Grounded);
+    CHECK(world.get<CharacterState>(a).jump_count == 0);
+    CHECK(world.get<ecs::LocalTransform>(b).position.z == 6.0f);
+
+    // A snapshot can be restored any number of times.
+    world.get<ecs::LocalTransform>(b).position = {7, 7, 7};
+    CHECK(snap.restore(world) == 3);
+    CHECK(world.get<ecs::LocalTransform>(b).position.z == 6.0f);
+}
+
+TEST_CASE("ComponentSnapshot — dead entities and removed components are skipped", "[snapshot]") {
+    ecs::World world;
+    ecs::Entity a = world.create_with(ecs::LocalTransform{}, CharacterState{});
+    ecs::Entity b = world.create_with(ecs::LocalTransform{});
+
+    ComponentSnapshot<ecs::LocalTransform, CharacterState> snap;
+    snap.capture(world);
+
+    world.destroy(b);
+    world.remove<CharacterState>(a);
+    ecs::Entity c = world.create_with(ecs::LocalTransform{{5, 5, 5}, {0, 0, 0, 1}, {1, 1, 1}});
+
+    CHECK(snap.restore(world) == 1);                 // only a's transform
+    CHECK_FALSE(world.has<CharacterState>(a));       // nothing is re-added
+    CHECK(world.get<ecs::LocalTransform>(c).position.x == 5.0f);
+
+    snap.clear();
+    CHECK(snap.size() == 0);
+    CHECK(snap.restore(world) == 0);
+}
+
+// ---------------------------------------------------------------------------
+// InputReplay — delta-coded input recordings
+// ---------------------------------------------------------------------------
+
+TEST_CASE("InputReplay — frames round-trip and idle frames cost almost nothing", "[replay]") {
+    InputReplay::Recorder rec;
+    std::vector<InputReplay::Frame> frames(4);
+    frames[0].dt = 1.0f / 60.0f;
+    frames[0].input.keys_down[87] = true;          // W held
+    frames[0].input.mouse_delta   = {3.5f, -1.0f};
+    frames[1] = frames[0];                          // nothing changed
+    frames[2] = frames[0];
+    frames[2].input.keys_pressed[32] = true;        // Space
+    frames[2].checksum = 0x1234567890abcdefull;
+    GamepadState pad;
+    pad.id = 2; pad.connected = true;
+    pad.axes[5] = -0.75f;
+    pad.buttons[7] = pad.buttons_pressed[7] = true;
+    frames[2].input.add_gamepad(pad);
+    frames[3].dt = 0.02f;                           // everything released
+
+    const size_t header = rec.bytes();
+    for (const auto& f : frames) rec.write(f);
+    CHECK(rec.frames() == 4);
+
+    // Frame 1 repeats frame 0: a single skip-to-end varint (IMAGE_BYTES < 16384).
+    InputReplay::Recorder idle;
+    idle.write(frames[0]);
+    const size_t after_first = idle.bytes();
+    idle.write(frames[1]);
+    CHECK(idle.bytes() - after_first == 2);
+    CHECK(rec.bytes() - header < 4 * InputReplay::IMAGE_BYTES / 4);
+
+    InputReplay::Player player;
+    REQUIRE(player.load_from_memory(rec.buffer().data(), rec.buffer().size()));
+    InputReplay::Frame got;
+    for (size_t i = 0; i < frames.size(); ++i) {
+        REQUIRE(player.next(got));
+        const auto& want = frames[i];
+        CHECK(got.dt == want.dt);
+        CHECK(got.checksum == want.checksum);
+        CHECK(got.input.keys_down == want.input.keys_down);
+        CHECK(got.input.keys_pressed == want.input.keys_pressed);
+        CHECK(got.input.mouse_delta.x == want.input.mouse_delta.x);
+        REQUIRE(got.input.gamepad_count == want.input.gamepad_count);
+    }
+    CHECK_FALSE(player.next(got));
+    CHECK_FALSE(player.failed());
+
+    player.rewind();
+    for (int i = 0; i < 3; ++i) REQUIRE(player.next(got));
+    REQUIRE(got.input.gamepad_count == 1);
+    CHECK(got.input.gamepads[0].id == 2);
+    CHECK(got.input.gamepads[0].axes[5] == -0.75f);
+    CHECK(got.input.gamepads[0].buttons_pressed[7]);
+    CHECK_FALSE(got.input.gamepads[0].buttons[6]);
+}
+
+TEST_CASE("InputRecord — gamepads live in a fixed array, packed at the front", "[replay]") {
+    InputRecord record;
+    CHECK(record.active_gamepads().empty());
+
+    for (size_t i = 0; i < InputRecord::MAX_GAMEPADS; ++i) {
+        GamepadState gp;
+        gp.id = static_cast<int>(i);
+        gp.connected = true;
+        REQUIRE(record.add_gamepad(gp));
+    }
+    CHECK_FALSE(record.add_gamepad(GamepadState{}));
+    REQUIRE(record.active_gamepads().size() == InputRecord::MAX_GAMEPADS);
+    CHECK(record.active_gamepads().back().id == static_cast<int>(InputRecord::MAX_GAMEPADS) - 1);
+
+    // Only the first InputReplay::MAX_GAMEPADS are recorded.
+    InputReplay::Recorder rec;
+    InputReplay::Frame f;
+    f.input = record;
+    rec.write(f);
+    InputReplay::Player player;
+    REQUIRE(player.load_from_memory(rec.buffer().data(), rec.buffer().size()));
+    REQUIRE(player.next(f));
+    CHECK(f.input.gamepad_count == InputReplay::MAX_GAMEPADS);
+    CHECK(f.input.gamepads[InputReplay::MAX_GAMEPADS].id == -1);
+}
+
+TEST_CASE("InputReplay — bad headers are refused and truncation is reported", "[replay]") {
+    InputReplay::Recorder rec;
+    InputReplay::Frame f;
+    f.input.keys_down[65] = true;
+    f.dt = 0.016f;
+    rec.write(f);
+    std::vector<uint8_t> bytes = rec.buffer();
+
+    InputReplay::Player player;
+    std::string error;
+    std::vector<uint8_t> wrong = bytes;
+    wrong[0] = 'X';
+    CHECK_FALSE(player.load_from_memory(wrong.data(), wrong.size(), &error));
+    CHECK_FALSE(error.empty());
+    CHECK_FALSE(player.load_from_memory(bytes.data(), 3));
+
+    bytes.pop_back();
+    REQUIRE(player.load_from_memory(bytes.data(), bytes.size()));
+    InputReplay::Frame got;
+    CHECK_FALSE(player.next(got));
+    CHECK(player.failed());
+}
+
+TEST_CASE("InputReplay — checksum follows dynamic bodies and the player only", "[replay]") {
+    ecs::World world;
+    ecs::Entity crate = world.create_with(ecs::LocalTransform{{0, 1, 0}, {0, 0, 0, 1}, {1, 1, 1}},
+                                          TransformHistory{});
+    ecs::Entity wall  = world.create_with(ecs::LocalTransform{{5, 0, 0}, {0, 0, 0, 1}, {1, 1, 1}});
+    ecs::Entity hero  = world.create_with(ecs::LocalTransform{{0, 2, 0}, {0, 0, 0, 1}, {1, 1, 1}}, PlayerTag{});
+
+    const uint64_t base = InputReplay::checksum(world);
+    CHECK(InputReplay::checksum(world) == base);
+
+    world.get<ecs::LocalTransform>(wall).position.x = 6.0f;   // static: not covered
+    CHECK(InputReplay::checksum(world) == base);
+
+    world.get<ecs::LocalTransform>(crate).position.y = 0.999f;
+    const uint64_t moved = InputReplay::checksum(world);
+    CHECK(moved != base);
+
+    world.get<ecs::LocalTransform>(hero).rotation = {0, 1, 0, 0};
+    CHECK(InputReplay::checksum(world) != moved);
+}
+
+// ---------------------------------------------------------------------------
+// InputEventQueue — event-driven input backend
+// ---------------------------------------------------------------------------
+
+TEST_CASE("apply_events — keeps sub-frame order: a tap is pressed but not down", "[input]") {
+    InputRecord record;
+    record.keys_down[65] = true; // A held since last frame
+    record.keys_pressed[65] = true;
+
+    InputEventQueue queue;
+    queue.push({InputEvent::Kind::KeyDown, 32, 1.000}); // Space tapped...
+    queue.push({InputEvent::Kind::KeyUp,   32, 1.004}); // ...and released
+    queue.push({InputEvent::Kind::KeyUp,   65, 1.006}); // A released
+    queue.push({InputEvent::Kind::MouseDown, 0, 1.008});
+    queue.push({InputEvent::Kind::KeyDown, 9999, 1.009}); // out of range: ignored
+    apply_events(record, queue.events(), 1.010);
+
+    CHECK(record.keys_pressed[32]);
+    CHECK_FALSE(record.keys_down[32]);
+    CHECK_FALSE(record.keys_down[65]);
+    CHECK_FALSE(record.keys_pressed[65]); // pressed last frame, not this one
+    CHECK(record.mouse_buttons[0]);
+    CHECK(record.mouse_buttons_pressed[0]);
+    CHECK(record.time == 1.010);
+    REQUIRE(record.frame_events().size() == 4);
+    CHECK(record.frame_events()[0].code == 32);
+    CHECK(record.frame_events()[1].kind == InputEvent::Kind::KeyUp);
+
+    // Next frame, no events: held state carries over, presses clear.
+    apply_events(record, {}, 1.026);
+    CHECK(record.mouse_buttons[0]);
+    CHECK_FALSE(record.mouse_buttons_pressed[0]);
+    CHECK(record.frame_events().empty());
+}
+
+TEST_CASE("InputEventQueue — fixed capacity drops and counts overflow", "[input]") {
+    InputEventQueue queue;
+    for (size_t i = 0; i < InputEventQueue::CAPACITY + 3; ++i)
+        queue.push({InputEvent::Kind::KeyDown, static_cast<int16_t>(i % 300), 0.0});
+    CHECK(queue.events().size() == InputEventQueue::CAPACITY);
+    CHECK(queue.dropped() == 3);
+
+    // The record lists at most MAX_EVENTS, but every event updates the bits.
+    InputRecord record;
+    apply_events(record, queue.events(), 0.0);
+    CHECK(record.event_count == InputRecord::MAX_EVENTS);
+    CHECK(record.keys_pressed.count() == InputEventQueue::CAPACITY);
+
+    queue.clear();
+    CHECK(queue.events().empty());
+    CHECK(queue.dropped() == 3);
+}
+
+namespace {
+// Raylib's key queue and key state, for poll_keys: presses past
+// KEY_QUEUE_CAPACITY are dropped, as rcore.c does.
+struct FakeKeys {
+    std::vector<int> presses;
+    std::bitset<512> held, pressed_now;
+    size_t next = 0;
+
+    int pop() {
+        if (next >= std::min(presses.size(), KEY_QUEUE_CAPACITY)) return 0;
+        return presses[next++];
+    }
+    bool down(int key) const    { return held[static_cast<size_t>(key)]; }
+    bool pressed(int key) const { return pressed_now[static_cast<size_t>(key)]; }
+};
+} // namespace
+
+TEST_CASE("poll_keys — presses come from the queue, releases are polled", "[input]") {
+    InputRecord record;
+    FakeKeys keys;
+    keys.presses = {65, 66};
+    keys.held[65] = true;       // 66 was tapped and released within the frame
+    keys.held[90] = true;       // not queued: the queue is not full, so not scanned
+    keys.pressed_now[65] = true;
+    CHECK_FALSE(poll_keys(record, keys));
+    CHECK(record.keys_pressed[65]);
+    CHECK(record.keys_pressed[66]);
+    CHECK(record.keys_down[65]);
+    CHECK_FALSE(record.keys_down[66]);
+    CHECK_FALSE(record.keys_down[90]);
+
+    FakeKeys released;          // next frame: 65 let go
+    CHECK_FALSE(poll_keys(record, released));
+    CHECK_FALSE(record.keys_down[65]);
+    CHECK(record.keys_pressed.none());
+}
+
+TEST_CASE("poll_keys — a full queue falls back to polling every key", "[input]") {
+    InputRecord record;
+    FakeKeys keys;
+    for (int k = 0; k < static_cast<int>(KEY_QUEUE_CAPACITY) + 4; ++k) {
+        keys.presses.push_back(65 + k);
+        keys.held[65 + k] = keys.pressed_now[65 + k] = true;
+    }
+    keys.held[70] = false;      // queued, then released within the frame
+    keys.pressed_now[70] = false;
+    CHECK(poll_keys(record, keys));
+    CHECK(keys.next == KEY_QUEUE_CAPACITY); // presses past it never reached the queue
+    // Every press is seen, including the four the queue dropped.
+    CHECK(record.keys_pressed.count() == KEY_QUEUE_CAPACITY + 4);
+    CHECK(record.keys_down.count() == KEY_QUEUE_CAPACITY + 3);
+    CHECK(record.keys_pressed[70]);
+    CHECK_FALSE(record.keys_down[70]);
+    CHECK(record.keys_down[65 + KEY_QUEUE_CAPACITY + 3]);
+}
+
+// ---------------------------------------------------------------------------
+// PlatformPool — recycled builder platforms
+// ---------------------------------------------------------------------------
+
+TEST_CASE("PlatformPool — parked slots first, then the oldest placement", "[builder]") {
+    ecs::World world;
+    PlatformPool pool(3);
+    CHECK_FALSE(pool.acquire(world)); // not filled yet
+
+    std::vector<ecs::Entity> slots;
+    for (int i = 0; i < 3; ++i) slots.push_back(world.create());
+    pool.assign(slots);
+
+    CHECK(pool.acquire(world) == slots[0]);
+    CHECK(pool.acquire(world) == slots[1]);
+    CHECK(pool.acquire(world) == slots[2]);
+    CHECK(pool.placed() == 3);
+    CHECK(pool.recycled() == 0);
+
+    // At the cap the platform placed longest ago moves.
+    CHECK(pool.acquire(world) == slots[0]);
+    CHECK(pool.recycled() == 1);
+    CHECK(pool.placed() == 3);
+
+    // A snapshot restore parks them all: start from the first slot again.
+    pool.rewind();
+    CHECK(pool.placed() == 0);
+    CHECK(pool.recycled() == 0);
+    CHECK(pool.acquire(world) == slots[0]);
+
+    for (int i = 0; i < 4; ++i) pool.acquire(world);
+    CHECK(pool.recycled() == 2);
+    pool.assign(slots);
+    CHECK(pool.recycled() == 0);
+}
+
+TEST_CASE("PlatformPool — a dead slot (scene unloaded) yields nothing", "[builder]") {
+    ecs::World world;
+    PlatformPool pool(2);
+    const ecs::Entity a = world.create(), b = world.create();
+    pool.assign({a, b});
+
+    world.destroy(a);
+    CHECK_FALSE(pool.acquire(world));
+    CHECK(pool.placed() == 0); // the cursor did not move
+
+    pool.assign({world.create(), b});
+    CHECK(pool.acquire(world).has_value());
+}
+
+
+// ---------------------------------------------------------------------------
+// each_optional
+// ---------------------------------------------------------------------------
+
+TEST_CASE("each_optional — visits every match, with or without the optional", "[pipeline]") {
+    ecs::World world;
+    const ecs::Entity with    = world.create_with(ecs::WorldTransform{}, MeshRenderer{}, ecs::LocalTransform{});
+    const ecs::Entity without = world.create_with(ecs::WorldTransform{}, MeshRenderer{});
+    world.create_with(ecs::LocalTransform{}); // not a match
+    world.get<ecs::LocalTransform>(with).position = {1, 2, 3};
+
+    int visited = 0;
+    each_optional<ecs::LocalTransform, ecs::WorldTransform, MeshRenderer>(world,
+        [&](ecs::Entity e, ecs::WorldTransform&, MeshRenderer&, ecs::LocalTransform* lt) {
+            ++visited;
+            if (e == with) {
+                REQUIRE(lt);
+                CHECK(lt->position.y == 2.0f);
+                lt->position.y = 5.0f; // writes through
+            } else {
+                CHECK(e == without);
+                CHECK(lt == nullptr);
+            }
+        });
+    CHECK(visited == 2);
+    CHECK(world.get<ecs::LocalTransform>(with).position.y == 5.0f);
+}
+
+// ---------------------------------------------------------------------------
+// KinematicTarget
+// ---------------------------------------------------------------------------
+
+TEST_CASE("KinematicTarget — moves on change, stops once, then skips", "[kinematic]") {
+    using A = KinematicTarget::Action;
+    KinematicTarget target{{0, 1, 0}, {0, 0, 0, 1}};
+    ecs::LocalTransform lt;
+    lt.position = {0, 1, 0};
+
+    CHECK(target.step(lt) == A::Skip); // spawn pose: nothing to do
+    lt.position.x = 0.5f;
+    CHECK(target.step(lt) == A::Move);
+    CHECK(target.moving);
+    lt.position.x = 1.0f;
+    CHECK(target.step(lt) == A::Move); // still travelling
+    CHECK(target.step(lt) == A::Stop); // arrived: zero the velocity once
+    CHECK_FALSE(target.moving);
+    CHECK(target.step(lt) == A::Skip);
+
+    lt.rotation = {0, 0.7071068f, 0, 0.7071068f}; // rotation alone counts
+    CHECK(target.step(lt) == A::Move);
+    CHECK(target.rotation.y == lt.rotation.y);
+}
+
+// ---------------------------------------------------------------------------
+// FrameArena
+// ---------------------------------------------------------------------------
+
+TEST_CASE("FrameArena — bumps aligned allocations and reset() reuses them", "[pipeline]") {
+    FrameArena arena(1024);
+    auto* a = static_cast<char*>(arena.allocate(3, 1));
+    void* b = arena.allocate(16, 16);
+    CHECK(reinterpret_cast<uintptr_t>(b) % 16 == 0);
+    CHECK(static_cast<char*>(b) > a);
+    CHECK(arena.used() >= 19);
+
+    const size_t used = arena.used();
+    arena.reset();
+    CHECK(arena.used() == 0);
+    CHECK(arena.last_used() == used);
+    CHECK(arena.allocate(3, 1) == a); // same block, from the start
+    CHECK(arena.grows() == 0);
+}
+
+TEST_CASE("FrameArena — overflow is served, then the block grows on reset()", "[pipeline]") {
+    FrameArena arena(64);
+    void* big = arena.allocate(200, 8);
+    REQUIRE(big);
+    std::memset(big, 0xab, 200); // usable memory, outside the block
+    CHECK(arena.used() >= 200);
+    CHECK(arena.capacity() == 64);
+
+    arena.reset();
+    CHECK(arena.grows() == 1);
+    CHECK(arena.capacity() >= arena.peak());
+
+    arena.allocate(200, 8);
+    arena.reset();
+    CHECK(arena.grows() == 1); // the same frame now fits
+}
+
+TEST_CASE("ArenaVector — lives in the world's arena, or on the heap without one", "[pipeline]") {
+    ecs::World world;
+    auto heap = frame_vector<int>(world);
+    CHECK(heap.get_allocator().arena == nullptr);
+    heap.assign({1, 2, 3});
+    CHECK(heap.size() == 3);
+
+    world.set_resource(std::make_shared<FrameArena>(4096));
+    FrameArena* arena = frame_arena(world);
+    REQUIRE(arena);
+    auto v = frame_vector<int>(world);
+    for (int i = 0; i < 100; ++i) v.push_back(i);
+    CHECK(v.get_allocator().arena == arena);
+    CHECK(v[99] == 99);
+    CHECK(arena->used() >= 100 * sizeof(int));
+}
+
+// ---------------------------------------------------------------------------
+// TransformBatch — batched WorldTransform composition
+// ---------------------------------------------------------------------------
+
+TEST_CASE("TransformBatch — matches mat4_compose for full lanes and the tail", "[transform]") {
+    // 11 = two SIMD iterations plus a scalar tail of three.
+    std::vector<ecs::Mat4> out(11);
+    std::vector<ecs::Vec3> pos, scale;
+    std::vector<ecs::Quat> rot;
+    TransformBatch batch;
+    for (size_t i = 0; i < out.size(); ++i) {
+        const float a = 0.37f * static_cast<float>(i) + 0.1f;
+        // Unit quaternion about a tilted axis, angle a.
+        const float ax = 0.48f, ay = 0.6f, az = 0.64f; // |axis| = 1
+        rot.push_back({ax * std::sin(a * 0.5f), ay * std::sin(a * 0.5f), az * std::sin(a * 0.5f), std::cos(a * 0.5f)});
+        pos.push_back({static_cast<float>(i), -2.0f * static_cast<float>(i), 0.5f});
+        scale.push_back({1.0f + static_cast<float>(i % 3), 1.0f, 0.5f});
+        if (i % 2) batch.push(pos[i], rot[i], scale[i], &out[i]);
+        else       batch.push(pos[i], rot[i], &out[i]);
+    }
+    REQUIRE(batch.size() == out.size());
+    batch.compose();
+
+    for (size_t i = 0; i < out.size(); ++i) {
+        const ecs::Vec3 s = (i % 2) ? scale[i] : ecs::Vec3{1.0f, 1.0f, 1.0f};
+        const ecs::Mat4 want = ecs::mat4_compose(pos[i], rot[i], s);
+        for (int k = 0; k < 16; ++k)
+            CHECK_THAT(out[i].m[k], Catch::Matchers::WithinAbs(want.m[k], 1e-6));
+    }
+
+    // Reused without reallocation; an empty batch writes nothing.
+    batch.clear();
+    CHECK(batch.size() == 0);
+    out[0].m[0] = 42.0f;
+    batch.compose();
+    CHECK(out[0].m[0] == 42.0f);
+}
+
+TEST_CASE("TransformDirty — composes only marked roots", "[transform]") {
+    ecs::World world;
+    const ecs::Entity a = world.create(), b = world.create(), gone = world.create();
+    for (ecs::Entity e : {a, b, gone}) {
+        world.add(e, ecs::LocalTransform{{1.0f, 2.0f, 3.0f}, {0, 0, 0, 1}, {1, 1, 1}});
+        world.add(e, ecs::WorldTransform{});
+    }
+    TransformDirty dirty;
+
+    // The first pass is a full one.
+    CHECK(dirty.all());
+    dirty.propagate(world);
+    CHECK(dirty.last_full());
+    CHECK(dirty.last_composed() == 3);
+    CHECK(world.get<ecs::WorldTransform>(b).matrix.m[13] == 2.0f);
+
+    world.get<ecs::LocalTransform>(a).position = {5.0f, 0.0f, 0.0f};
+    world.get<ecs::LocalTransform>(b).position = {7.0f, 0.0f, 0.0f};
+    dirty.mark(a);
+    dirty.mark(gone);
+    world.destroy(gone);
+    REQUIRE(dirty.pending() == 2);
+    dirty.propagate(world);
+    CHECK_FALSE(dirty.last_full());
+    CHECK(dirty.last_composed() == 1);
+    CHECK(dirty.pending() == 0);
+    CHECK(world.get<ecs::WorldTransform>(a).matrix.m[12] == 5.0f);
+    CHECK(world.get<ecs::WorldTransform>(b).matrix.m[12] == 1.0f); // unmarked: untouched
+
+    // Nothing marked, nothing done.
+    dirty.propagate(world);
+    CHECK(dirty.last_composed() == 0);
+}
+
+TEST_CASE("TransformDirty — a marked hierarchy member falls back to a full pass", "[transform]") {
+    ecs::World world;
+    const ecs::Entity root = world.create(), child = world.create();
+    for (ecs::Entity e : {root, child}) {
+        world.add(e, ecs::LocalTransform{{0.0f, 0.0f, 0.0f}, {0, 0, 0, 1}, {1, 1, 1}});
+        world.add(e, ecs::WorldTransform{});
+    }
+    world.add(child, ecs::Parent{root});
+    world.add(root, ecs::Children{{child}});
+    TransformDirty dirty;
+    dirty.propagate(world);
+
+    world.get<ecs::LocalTransform>(root).position = {4.0f, 0.0f, 0.0f};
+    dirty.mark(root);
+    dirty.propagate(world);
+    CHECK(dirty.last_full());
+    CHECK(world.get<ecs::WorldTransform>(root).matrix.m[12] == 4.0f);
+
+    // mark_all() also forces one.
+    dirty.mark_all();
+    dirty.propagate(world);
+    CHECK(dirty.last_full());
+    CHECK_FALSE(dirty.all());
+}
+
+
+// ---------------------------------------------------------------------------
+// RenderSnapshotBuffer / SimThread — pipelined render
+// ---------------------------------------------------------------------------
+
+TEST_CASE("RenderSnapshotBuffer — read returns the newest published snapshot", "[render]") {
+    RenderSnapshotBuffer buffer;
+    CHECK(buffer.read().frame == 0); // nothing published yet
+
+    buffer.write().player_pos = {1.0f, 0.0f, 0.0f};
+    buffer.publish();
+    buffer.write().player_pos = {2.0f, 0.0f, 0.0f};
+    buffer.publish(); // replaces the unread first one
+
+    const RenderSnapshot& a = buffer.read();
+    CHECK(a.frame == 2);
+    CHECK(a.player_pos.x == 2.0f);
+
+    // Nothing new: the same snapshot again, and the producer's writes don't
+    // reach it.
+    buffer.write().player_pos = {3.0f, 0.0f, 0.0f};
+    const RenderSnapshot& b = buffer.read();
+    CHECK(&b == &a);
+    CHECK(b.player_pos.x == 2.0f);
+
+    buffer.publish();
+    CHECK(buffer.read().player_pos.x == 3.0f);
+    CHECK(buffer.published() == 3);
+}
+
+TEST_CASE("SimThread — run is asynchronous and wait joins the job", "[render]") {
+    SimThread sim;
+    std::atomic<int> ran{0};
+    for (int i = 0; i < 3; ++i) sim.run([&ran] { ran.fetch_add(1); });
+    sim.wait();
+    CHECK(ran.load() == 3);
+    CHECK_FALSE(sim.busy());
+
+    // A producer on the thread, a consumer here, one frame apart.
+    RenderSnapshotBuffer buffer;
+    for (int f = 1; f <= 4; ++f) {
+        sim.wait();
+        const uint64_t shown = buffer.read().frame;
+        CHECK(shown == static_cast<uint64_t>(f - 1));
+        sim.run([&buffer, f] {
+            buffer.write().player_pos = {static_cast<float>(f), 0.0f, 0.0f};
+            buffer.publish();
+        });
+    }
+    sim.wait();
+    CHECK(buffer.read().player_pos.x == 4.0f);
+}
+
+
+// ---------------------------------------------------------------------------
+// DebugPanel
+// ---------------------------------------------------------------------------
+
+TEST_CASE("DebugPanel — watch creates section and row", "[debug]") {
+    DebugPanel panel;
+    panel.watch("Engine", "FPS", [](DebugText& out) { out.set("60"); });
+
+    REQUIRE(panel.sections().size() == 1);
+    CHECK(panel.sections()[0].title == "Engine");
+    REQUIRE(panel.sections()[0].rows.size() == 1);
+    CHECK(panel.sections()[0].rows[0].label == "FPS");
+    panel.refresh(0.016f);
+    CHECK(panel.sections()[0].rows[0].value == "60");
+}
+
+TEST_CASE("DebugPanel — multiple rows in one section", "[debug]") {
+    DebugPanel panel;
+    panel.watch("Engine", "FPS",        [](DebugText& out) { out.set("60"); });
+    panel.watch("Engine", "Frame Time", [](DebugText& out) { out.format("%d ms", 16); });
+    panel.watch("Engine", "Entities",   [](DebugText& out) { out.format("%zu", size_t{15}); });
+
+    REQUIRE(panel.sections().size() == 1);
+    CHECK(panel.sections()[0].rows.size() == 3);
+    CHECK(panel.sections()[0].rows[1].label == "Frame Time");
+    panel.refresh(0.016f);
+    CHECK(panel.sections()[0].rows[1].value == "16 ms");
+    CHECK(panel.sections()[0].rows[2].value == "15");
+}
+
+TEST_CASE("DebugPanel — multiple sections ordered by insertion", "[debug]") {
+    DebugPanel panel;
+    panel.watch("Engine",    "FPS",  [](DebugText& out) { out.set("60"); });
+    panel.watch("Character", "Mode", [](DebugText& out) { out.set("Grounded"); });
+
+    REQUIRE(panel.sections().size() == 2);
+    CHECK(panel.sections()[0].title == "Engine");
+    CHECK(panel.sections()[1].title == "Character");
+}
+
+TEST_CASE("DebugPanel — provider is called and returns current value", "[debug]") {
+    int counter = 0;
+    DebugPanel panel;
+    panel.watch("Test", "Count", [&counter](DebugText& out) { out.format("%d", counter); });
+
+    panel.refresh(0.016f);
+    CHECK(panel.sections()[0].rows[0].value == "0");
+    counter = 42;
+    panel.refresh(0.016f);
+    CHECK(panel.sections()[0].rows[0].value == "42");
+}
+
+TEST_CASE("DebugPanel — rate-limited row caches its value between refreshes", "[debug]") {
+    int calls = 0;
+    DebugPanel panel;
+    panel.watch("Test", "Slow", [&calls](DebugText& out) { out.format("%d", ++calls); }, 4.0f);
+    const auto& row = panel.sections()[0].rows[0];
+
+    panel.refresh(0.1f);            // first refresh always runs
+    CHECK(row.value == "1");
+    panel.refresh(0.1f);
+    panel.refresh(0.1f);            // 0.2 s since the last call: still cached
+    CHECK(row.value == "1");
+    panel.refresh(0.1f);            // 0.3 s >= 0.25 s
+    CHECK(row.value == "2");
+
+    panel.invalidate();             // overlay hidden and shown again
+    panel.refresh(0.0f);
+    CHECK(row.value == "3");
+    CHECK(calls == 3);
+}
+
+TEST_CASE("DebugText — format and set truncate to capacity", "[debug]") {
+    DebugText t;
+    CHECK(t.size() == 0);
+    CHECK(t == "");
+
+    t.format("%.2f ms", 16.666f);
+    CHECK(t == "16.67 ms");
+    CHECK(t.size() == 8);
+
+    const std::string long_text(DebugText::CAPACITY * 2, 'x');
+    t.set(long_text.c_str());
+    CHECK(t.size() == DebugText::CAPACITY - 1);
+    t.format("%s", long_text.c_str());
+    CHECK(t.size() == DebugText::CAPACITY - 1);
+    CHECK(std::string(t.c_str()) == long_text.substr(0, DebugText::CAPACITY - 1));
+}
+
+TEST_CASE("DebugPanel — visible defaults to false, toggle works", "[debug]") {
+    DebugPanel panel;
+    CHECK_FALSE(panel.visible);
+    panel.visible = true;
+    CHECK(panel.visible);
+}
+
+// ---------------------------------------------------------------------------
+// FrameProfiler / Pipeline timing
+// ---------------------------------------------------------------------------
+
+// Builds a [t0, t0 + ms] sample without sleeping.
+static std::pair<FrameProfiler::Clock::time_point, FrameProfiler::Clock::time_point>
+span_ms(float ms) {
+    auto t0 = FrameProfiler::Clock::now();
+    auto t1 = t0 + std::chrono::duration_cast<FrameProfiler::Clock::duration>(
+                       std::chrono::duration<float, std::milli>(ms));
+    return {t0, t1};
+}
+
+TEST_CASE("FrameProfiler — slot is stable per name and phase", "[profiler]") {
+    FrameProfiler prof;
+    int a = prof.slot("Physics", FrameProfiler::Physics);
+    int b = prof.slot("Camera",  FrameProfiler::Logic);
+    CHECK(a != b);
+    CHECK(prof.slot("Physics", FrameProfiler::Physics) == a);
+    CHECK(prof.systems().size() == 2);
+}
+
+TEST_CASE("FrameProfiler — calls within a frame accumulate", "[profiler]") {
+    FrameProfiler prof;
+    int s = prof.slot("Physics", FrameProfiler::Physics);
+    prof.begin_frame();
+    auto [t0, t1] = span_ms(1.0f);
+    prof.record(s, t0, t1);
+    prof.record(s, t0, t1); // second sub-step
+    prof.begin_frame();     // commit
+
+    REQUIRE(prof.frames() == 1);
+    CHECK_THAT(prof.last_ms(prof.systems()[s]), Catch::Matchers::WithinAbs(2.0f, 0.01f));
+    CHECK_THAT(prof.phase_avg_ms(FrameProfiler::Physics), Catch::Matchers::WithinAbs(2.0f, 0.01f));
+    CHECK(prof.systems()[s].total_calls == 2);
+}
+
+TEST_CASE("FrameProfiler — avg and max over history", "[profiler]") {
+    FrameProfiler prof;
+    int s = prof.slot("Render", FrameProfiler::Render);
+    prof.begin_frame();
+    for (float ms : {1.0f, 3.0f}) {
+        auto [t0, t1] = span_ms(ms);
+        prof.record(s, t0, t1);
+        prof.begin_frame();
+    }
+    CHECK(prof.frames() == 2);
+    CHECK_THAT(prof.avg_ms(prof.systems()[s]), Catch::Matchers::WithinAbs(2.0f, 0.01f));
+    CHECK_THAT(prof.max_ms(prof.systems()[s]), Catch::Matchers::WithinAbs(3.0f, 0.01f));
+}
+
+TEST_CASE("FrameProfiler — ring buffer keeps only HISTORY frames", "[profiler]") {
+    FrameProfiler prof;
+    int s = prof.slot("Logic", FrameProfiler::Logic);
+    prof.begin_frame();
+    for (int i = 0; i < FrameProfiler::HISTORY + 10; ++i) {
+        auto [t0, t1] = span_ms(i < 10 ? 100.0f : 1.0f);
+        prof.record(s, t0, t1);
+        prof.begin_frame();
+    }
+    CHECK(prof.frames() == FrameProfiler::HISTORY);
+    // The ten 100 ms frames have been overwritten
+    CHECK_THAT(prof.max_ms(prof.systems()[s]), Catch::Matchers::WithinAbs(1.0f, 0.01f));
+}
+
+TEST_CASE("FrameProfiler — slowest orders by average", "[profiler]") {
+    FrameProfiler prof;
+    int fast = prof.slot("Fast", FrameProfiler::Logic);
+    int slow = prof.slot("Slow", FrameProfiler::Logic);
+    int mid  = prof.slot("Mid",  FrameProfiler::Logic);
+    prof.begin_frame();
+    auto [a0, a1] = span_ms(0.1f); prof.record(fast, a0, a1);
+    auto [b0, b1] = span_ms(5.0f); prof.record(slow, b0, b1);
+    auto [c0, c1] = span_ms(1.0f); prof.record(mid,  c0, c1);
+    prof.begin_frame();
+
+    auto top = prof.slowest(2);
+    REQUIRE(top.size() == 2);
+    CHECK(top[0] == slow);
+    CHECK(top[1] == mid);
+}
+
+TEST_CASE("FrameProfiler — chrome trace contains captured calls", "[profiler]") {
+    FrameProfiler prof;
+    int s = prof.slot("CharMotor", FrameProfiler::Logic);
+    prof.begin_frame();
+    REQUIRE(prof.start_capture(2, ""));
+    auto [t0, t1] = span_ms(0.5f);
+    prof.record(s, t0, t1);
+    CHECK(prof.capturing());
+    CHECK(prof.trace_event_count() == 1);
+
+    std::ostringstream out;
+    prof.write_chrome_trace(out);
+    auto j = nlohmann::json::parse(out.str());
+    REQUIRE(j.contains("traceEvents"));
+    bool found = false;
+    for (const auto& e : j["traceEvents"])
+        if (e["ph"] == "X" && e["name"] == "CharMotor") found = true;
+    CHECK(found);
+}
+
+TEST_CASE("FrameProfiler — reset clears history and totals", "[profiler]") {
+    FrameProfiler prof;
+    int s = prof.slot("Physics", FrameProfiler::Physics);
+    prof.begin_frame();
+    auto [t0, t1] = span_ms(2.0f);
+    prof.record(s, t0, t1);
+    prof.begin_frame();
+    prof.reset();
+    CHECK(prof.frames() == 0);
+    CHECK(prof.systems()[s].total_calls == 0);
+    CHECK(prof.avg_ms(prof.systems()[s]) == 0.0f);
+}
+
+TEST_CASE("FrameProfiler — nested spans and step counts feed the frame graph", "[profiler]") {
+    FrameProfiler prof;
+    int physics = prof.slot("Physics",   FrameProfiler::Physics);
+    int jolt    = prof.slot("Jolt Step", FrameProfiler::Physics);
+    prof.begin_frame();
+    auto [t0, t1] = span_ms(3.0f);
+    auto [j0, j1] = span_ms(2.0f);
+    prof.record(physics, t0, t1);
+    prof.record_nested(jolt, j0, j1);   // inside "Physics": not added to the phase again
+    prof.note_steps(2);
+    prof.begin_frame();
+
+    REQUIRE(prof.frames() == 1);
+    CHECK_THAT(prof.phase_ms(FrameProfiler::Physics, 0), Catch::Matchers::WithinAbs(3.0f, 0.01f));
+    CHECK_THAT(prof.system_ms(prof.systems()[jolt], 0), Catch::Matchers::WithinAbs(2.0f, 0.01f));
+    CHECK(prof.steps(0) == 2);
+    CHECK(prof.find("Jolt Step", FrameProfiler::Physics) == jolt);
+    CHECK(prof.find("Jolt Step", FrameProfiler::Logic) == -1);
+}
+
+TEST_CASE("FrameProfiler — histogram and lows over frame times", "[profiler]") {
+    FrameProfiler prof;
+    auto t = FrameProfiler::Clock::now();
+    auto advance = [&](float ms) {
+        t += std::chrono::duration_cast<FrameProfiler::Clock::duration>(std::chrono::duration<float, std::milli>(ms));
+        prof.begin_frame(t);
+    };
+    prof.begin_frame(t);
+    for (int i = 0; i < 990; ++i) advance(16.0f);
+    for (int i = 0; i < 9; ++i)   advance(30.0f);
+    advance(100.0f);                                   // one hitch
+
+    REQUIRE(prof.long_frames() == 1000);
+    CHECK_THAT(prof.frame_ms(0), Catch::Matchers::WithinAbs(100.0f, 0.01f));
+    CHECK_THAT(prof.low_ms(0.001f), Catch::Matchers::WithinAbs(100.0f, 0.01f)); // worst 1 frame
+    CHECK_THAT(prof.low_ms(0.01f), Catch::Matchers::WithinAbs(37.0f, 0.01f));   // worst 10: 9 x 30 + 100
+
+    uint32_t bins[20];
+    CHECK(prof.histogram(bins, 20, 2.0f) == 1000);
+    CHECK(bins[8] == 990);    // 16 ms
+    CHECK(bins[15] == 9);     // 30 ms
+    CHECK(bins[19] == 1);     // 100 ms lands in the last bin
+}
+
+TEST_CASE("Pipeline — named systems are reported to FrameProfiler", "[profiler]") {
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+    world.set_resource(FrameProfiler{});
+
+    std::vector<std::string> order;
+    pipeline.add_pre_update("Input", [&](ecs::World&, float) { order.push_back("Input"); });
+    pipeline.add_logic("Camera",     [&](ecs::World&, float) { order.push_back("Camera"); });
+    pipeline.add_logic(              [&](ecs::World& w, float) {
+        order.push_back("anon");
+        DeferredCommands::local(w).create_with(WorldTag{}); // so there is something to flush
+    });
+    pipeline.add_physics("Physics",  [&](ecs::World&, float) { order.push_back("Physics"); });
+
+    pipeline.update(world, 1.0f / 60.0f);
+    pipeline.step_physics(world, 1.0f / 60.0f);
+    pipeline.step_physics(world, 1.0f / 60.0f);
+
+    CHECK(order == std::vector<std::string>{"Input", "Camera", "anon", "Physics", "Physics"});
+
+    auto& prof = world.resource<FrameProfiler>();
+    auto find = [&](const std::string& name) -> const FrameProfiler::SystemStats* {
+        for (const auto& s : prof.systems()) if (s.name == name) return &s;
+        return nullptr;
+    };
+    REQUIRE(find("Input"));
+    CHECK(find("Input")->phase == FrameProfiler::PreUpdate);
+    REQUIRE(find("Logic #1"));   // unnamed → "<Phase> #<index>"
+    REQUIRE(find("Physics"));
+    CHECK(find("Physics")->total_calls == 2);
+    REQUIRE(find("Deferred Flush"));
+}
+
+TEST_CASE("Pipeline — runs without a FrameProfiler", "[profiler]") {
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+    int calls = 0;
+    pipeline.add_logic([&](ecs::World&, float) { ++calls; });
+    pipeline.update(world, 0.016f);
+    CHECK(calls == 1);
+}
+
+// ---------------------------------------------------------------------------
+// Pipeline — parallel phases from declared Access
+// ---------------------------------------------------------------------------
+
+namespace {
+struct AccessA {};
+struct AccessB {};
+
+// Spins until `other` is set or 500 ms pass; true if it saw the other system.
+bool rendezvous(std::atomic<bool>& self, std::atomic<bool>& other) {
+    self = true;
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(500);
+    while (!other && std::chrono::steady_clock::now() < deadline) std::this_thread::yield();
+    return other;
+}
+} // namespace
+
+TEST_CASE("Pipeline — conflicting systems keep install order on a threaded pipeline", "[pipeline]") {
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+    pipeline.set_threads(4);
+    CHECK(pipeline.threads() == 4);
+
+    std::mutex               m;
+    std::vector<std::string> order;
+    auto log = [&](const char* s) { std::lock_guard<std::mutex> lock(m); order.push_back(s); };
+
+    pipeline.add_logic("WriteA", ecs::Access{}.write<AccessA>(),  [&](ecs::World&, float) { log("WriteA"); });
+    pipeline.add_logic("ReadA",  ecs::Access{}.read<AccessA>(),   [&](ecs::World&, float) { log("ReadA"); });
+    pipeline.add_logic("Last",                                    [&](ecs::World&, float) { log("Last"); });
+
+    for (int frame = 0; frame < 5; ++frame) {
+        order.clear();
+        pipeline.update(world, 0.016f);
+        CHECK(order == std::vector<std::string>{"WriteA", "ReadA", "Last"});
+    }
+}
+
+TEST_CASE("Pipeline — independent systems overlap once the phase has run serially", "[pipeline]") {
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+    pipeline.set_threads(2);
+
+    std::atomic<bool> armed{false}, a_in{false}, b_in{false}, a_saw{false}, b_saw{false};
+    std::atomic<std::thread::id> main_tid{};
+    pipeline.add_logic("A", ecs::Access{}.write<AccessA>(), [&](ecs::World&, float) {
+        if (armed) a_saw = rendezvous(a_in, b_in);
+    });
+    pipeline.add_logic("B", ecs::Access{}.write<AccessB>().on_main_thread(), [&](ecs::World&, float) {
+        main_tid = std::this_thread::get_id();
+        if (armed) b_saw = rendezvous(b_in, a_in);
+    });
+
+    pipeline.update(world, 0.016f); // first frame: serial
+    armed = true;
+    pipeline.update(world, 0.016f);
+    CHECK(a_saw);
+    CHECK(b_saw);
+    CHECK(main_tid.load() == std::this_thread::get_id());
+}
+
+TEST_CASE("Pipeline — a flushed add or remove runs the next frame serially", "[pipeline]") {
+    struct Planted {};
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+    pipeline.set_threads(2);
+    const ecs::Entity slot = world.create();
+
+    std::atomic<bool> armed{false}, plant{false}, a_in{false}, b_in{false}, a_saw{false};
+    pipeline.add_logic("A", ecs::Access{}.write<AccessA>(), [&](ecs::World& w, float) {
+        if (armed) a_saw = rendezvous(a_in, b_in);
+        if (plant) DeferredCommands::local(w).add(slot, Planted{}); // keeps world.count()
+    });
+    pipeline.add_logic("B", ecs::Access{}.write<AccessB>(), [&](ecs::World&, float) {
+        if (armed) rendezvous(b_in, a_in);
+    });
+    auto frame = [&] {
+        a_in = b_in = a_saw = false;
+        pipeline.update(world, 0.016f);
+        return a_saw.load();
+    };
+
+    pipeline.update(world, 0.016f); // first frame: serial
+    armed = true;
+    CHECK(frame());                 // overlapped
+    plant = true;
+    CHECK(frame());                 // still overlapped; the add lands in the flush
+    plant = false;
+    CHECK(world.has<Planted>(slot));
+    CHECK_FALSE(frame());           // new archetype: serial
+    CHECK(frame());                 // and back to parallel
+
+    DeferredCommands::of(world).note_edits();
+    CHECK_FALSE(frame());
+}
+
+TEST_CASE("Pipeline — deferred main-thread systems run from main_thread_logic", "[pipeline]") {
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+    pipeline.set_threads(2);
+    pipeline.defer_main_thread(true);
+
+    std::vector<std::string> order;
+    std::thread::id          audio_tid{};
+    pipeline.add_logic("State", ecs::Access{}.write<AccessA>(), [&](ecs::World&, float) { order.push_back("State"); });
+    pipeline.add_logic("Audio", ecs::Access{}.read<AccessA>().on_main_thread(), [&](ecs::World&, float) {
+        order.push_back("Audio");
+        audio_tid = std::this_thread::get_id();
+    });
+    pipeline.add_logic("Motor", ecs::Access{}.write<AccessB>(), [&](ecs::World&, float) { order.push_back("Motor"); });
+
+    SimThread sim;
+    for (int frame = 0; frame < 3; ++frame) {
+        order.clear();
+        sim.run([&] { pipeline.logic(world, 0.016f); });
+        sim.wait();
+        CHECK(std::find(order.begin(), order.end(), "Audio") == order.end());
+        pipeline.main_thread_logic(world, 0.016f);
+        CHECK(order.size() == 3);
+        CHECK(order.back() == "Audio");
+        CHECK(audio_tid == std::this_thread::get_id());
+    }
+
+    // Not deferred: main_thread_logic() does nothing, logic() runs it in order.
+    pipeline.defer_main_thread(false);
+    order.clear();
+    pipeline.main_thread_logic(world, 0.016f);
+    CHECK(order.empty());
+    pipeline.logic(world, 0.016f);
+    REQUIRE(order.size() == 3);
+    CHECK(order.front() == "State"); // Audio reads what State writes; Motor may overlap it
+    CHECK(std::find(order.begin(), order.end(), "Audio") != order.end());
+}
+
+TEST_CASE("Pipeline — undeclared systems and serial pipelines never overlap", "[pipeline]") {
+    std::atomic<int> active{0}, peak{0};
+    auto body = [&](ecs::World&, float) {
+        const int now = ++active;
+        int p = peak;
+        while (now > p && !peak.compare_exchange_weak(p, now)) {}
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        --active;
+    };
+
+    SECTION("undeclared systems on a threaded pipeline") {
+        ecs::World    world;
+        ecs::Pipeline pipeline;
+        pipeline.set_threads(4);
+        for (int i = 0; i < 4; ++i) pipeline.add_logic(body);
+        for (int f = 0; f < 3; ++f) pipeline.update(world, 0.016f);
+        CHECK(peak == 1);
+    }
+    SECTION("declared systems on a serial pipeline") {
+        ecs::World    world;
+        ecs::Pipeline pipeline;
+        pipeline.add_logic("A", ecs::Access{}.write<AccessA>(), body);
+        pipeline.add_logic("B", ecs::Access{}.write<AccessB>(), body);
+        for (int f = 0; f < 3; ++f) pipeline.update(world, 0.016f);
+        CHECK(peak == 1);
+    }
+    SECTION("a phase whose entity count changed runs serially") {
+        ecs::World    world;
+        ecs::Pipeline pipeline;
+        pipeline.set_threads(4);
+        pipeline.add_logic("A", ecs::Access{}.write<AccessA>(), body);
+        pipeline.add_logic("B", ecs::Access{}.write<AccessB>(), body);
+        for (int f = 0; f < 3; ++f) {
+            world.create();
+            pipeline.update(world, 0.016f);
+        }
+        CHECK(peak == 1);
+    }
+}
+
+TEST_CASE("Pipeline — parallel phases still report every system to FrameProfiler", "[pipeline]") {
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+    pipeline.set_threads(3);
+    world.set_resource(FrameProfiler{});
+    pipeline.add_logic("A", ecs::Access{}.write<AccessA>(), [](ecs::World&, float) {});
+    pipeline.add_logic("B", ecs::Access{}.write<AccessB>(), [](ecs::World&, float) {});
+    for (int f = 0; f < 4; ++f) pipeline.update(world, 0.016f);
+
+    const auto& systems = world.resource<FrameProfiler>().systems();
+    for (const char* name : {"A", "B"}) {
+        auto it = std::find_if(systems.begin(), systems.end(), [&](const auto& s) { return s.name == name; });
+        REQUIRE(it != systems.end());
+        CHECK(it->total_calls == 4);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// FixedTime / Pipeline::step_fixed
+// ---------------------------------------------------------------------------
+
+TEST_CASE("FixedTime — accumulates until a step is due", "[fixed_time]") {
+    FixedTime ft;
+    ft.fixed_dt = 0.1f;
+    CHECK(ft.advance(0.05f) == 0);
+    CHECK_THAT(ft.alpha, Catch::Matchers::WithinAbs(0.5f, 1e-4f));
+    CHECK(ft.advance(0.06f) == 1);
+    CHECK_THAT(ft.alpha, Catch::Matchers::WithinAbs(0.1f, 1e-4f));
+}
+
+TEST_CASE("FixedTime — hitch is clamped to max_steps and excess dropped", "[fixed_time]") {
+    FixedTime ft;
+    ft.fixed_dt  = 0.1f;
+    ft.max_steps = 3;
+    CHECK(ft.advance(1.05f) == 3); // 10 steps due
+    CHECK_THAT(ft.dropped_seconds, Catch::Matchers::WithinAbs(0.7f, 1e-4f));
+    CHECK_THAT(ft.alpha, Catch::Matchers::WithinAbs(0.5f, 1e-3f));
+    CHECK(ft.advance(0.0f) == 0);  // no deferred backlog
+}
+
+TEST_CASE("FixedTime — negative frame delta is ignored", "[fixed_time]") {
+    FixedTime ft;
+    CHECK(ft.advance(-1.0f) == 0);
+    CHECK(ft.accumulator == 0.0f);
+}
+
+TEST_CASE("interpolate_pose — endpoints and midpoint", "[fixed_time]") {
+    TransformHistory prev{{0, 0, 0}, {0, 0, 0, 1}};
+    ecs::LocalTransform cur;
+    cur.position = {2, 4, 6};
+    cur.rotation = {0, 0, 0, 1};
+    cur.scale    = {1, 1, 1};
+
+    auto m0 = interpolate_pose(prev, cur, 0.0f);
+    auto m1 = interpolate_pose(prev, cur, 1.0f);
+    auto mh = interpolate_pose(prev, cur, 0.5f);
+    CHECK(m0.m[12] == 0.0f);
+    CHECK_THAT(m1.m[13], Catch::Matchers::WithinAbs(4.0f, 1e-5f));
+    CHECK_THAT(mh.m[14], Catch::Matchers::WithinAbs(3.0f, 1e-5f));
+}
+
+TEST_CASE("interpolate_pose — takes the shortest rotation arc", "[fixed_time]") {
+    // q and -q are the same rotation; blending must not pass through zero.
+    TransformHistory prev{{0, 0, 0}, {0, 0, 0, -1}};
+    ecs::LocalTransform cur;
+    cur.rotation = {0, 0, 0, 1};
+    cur.scale    = {1, 1, 1};
+    auto m = interpolate_pose(prev, cur, 0.5f);
+    CHECK_THAT(m.m[0],  Catch::Matchers::WithinAbs(1.0f, 1e-5f)); // identity basis
+    CHECK_THAT(m.m[10], Catch::Matchers::WithinAbs(1.0f, 1e-5f));
+}
+
+TEST_CASE("Pipeline::step_fixed — runs one physics call per due step", "[fixed_time]") {
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+    FixedTime ft;
+    ft.fixed_dt  = 0.1f;
+    ft.max_steps = 8;
+    world.set_resource(ft);
+
+    std::vector<float> dts;
+    pipeline.add_physics("Physics", [&](ecs::World&, float dt) { dts.push_back(dt); });
+
+    CHECK(pipeline.step_fixed(world, 0.35f) == 3);
+    REQUIRE(dts.size() == 3);
+    CHECK(dts[0] == 0.1f);
+}
+
+TEST_CASE("Pipeline::step_fixed — fold_substeps makes one call with N collision steps", "[fixed_time]") {
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+    FixedTime ft;
+    ft.fixed_dt      = 0.1f;
+    ft.fold_substeps = true;
+    world.set_resource(ft);
+
+    std::vector<std::pair<float, int>> calls;
+    pipeline.add_physics("Physics", [&](ecs::World& w, float dt) {
+        calls.push_back({dt, w.resource<FixedTime>().collision_steps});
+    });
+
+    CHECK(pipeline.step_fixed(world, 0.35f) == 3);
+    REQUIRE(calls.size() == 1);
+    CHECK_THAT(calls[0].first, Catch::Matchers::WithinAbs(0.3f, 1e-5f));
+    CHECK(calls[0].second == 3);
+    CHECK(world.resource<FixedTime>().collision_steps == 1); // reset after the call
+}
+
+// ---------------------------------------------------------------------------
+// InstanceBatch
+// ---------------------------------------------------------------------------
+
+TEST_CASE("InstanceBatch — buckets instances by shape", "[render]") {
+    InstanceBatch batch;
+    ecs::Mat4 m;
+    batch.add(ShapeType::Box,     m, Colors::Red);
+    batch.add(ShapeType::Box,     m, Colors::Gold);
+    batch.add(ShapeType::Capsule, m, Colors::White);
+
+    CHECK(batch.bucket(ShapeType::Box).size() == 2);
+    CHECK(batch.bucket(ShapeType::Sphere).empty());
+    CHECK(batch.bucket(ShapeType::Capsule).size() == 1);
+    CHECK(batch.size() == 3);
+}
+
+TEST_CASE("InstanceBatch — colour rides in the bottom row, transform intact", "[render]") {
+    ecs::Mat4 m;
+    m.m[12] = 4.0f; m.m[13] = 5.0f; m.m[14] = 6.0f;
+    const Color4 c{0.25f, 0.5f, 0.75f, 1.0f};
+
+    ecs::Mat4 packed = InstanceBatch::pack(m, c);
+    Color4 out = InstanceBatch::unpack_color(packed);
+    CHECK(out.r == 0.25f);
+    CHECK(out.g == 0.5f);
+    CHECK(out.b == 0.75f);
+    CHECK(out.a == 1.0f);
+    for (int i : {0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14})
+        CHECK(packed.m[i] == m.m[i]);
+}
+
+TEST_CASE("InstanceBatch — clear() keeps bucket capacity", "[render]") {
+    InstanceBatch batch;
+    for (int i = 0; i < 64; ++i) batch.add(ShapeType::Sphere, ecs::Mat4{}, Colors::White);
+    const size_t cap = batch.bucket(ShapeType::Sphere).capacity();
+    batch.clear();
+    CHECK(batch.size() == 0);
+    CHECK(batch.bucket(ShapeType::Sphere).capacity() == cap);
+}
+
+TEST_CASE("InstanceBatch — LOD levels are separate buckets of one shape", "[render]") {
+    InstanceBatch batch;
+    ecs::Mat4 m;
+    batch.add(ShapeType::Sphere, m, Colors::Red);
+    batch.add(ShapeType::Sphere, m, Colors::Red, 2);
+    batch.add(ShapeType::Sphere, m, Colors::Red, 2);
+    batch.add(ShapeType::Capsule, m, Colors::Red, 1);
+    batch.add(ShapeType::Capsule, m, Colors::Red, 7); // clamped to the last level
+
+    CHECK(batch.bucket(ShapeType::Sphere).size() == 1);
+    CHECK(batch.bucket(ShapeType::Sphere, 1).empty());
+    CHECK(batch.bucket(ShapeType::Sphere, 2).size() == 2);
+    CHECK(batch.bucket(ShapeType::Capsule, 1).size() == 1);
+    CHECK(batch.bucket(ShapeType::Capsule, 2).size() == 1);
+    CHECK(batch.level_size(0) == 1);
+    CHECK(batch.level_size(2) == 3);
+    CHECK(batch.size() == 5);
+}
+
+TEST_CASE("InstanceBatch — boxes have one mesh, so every level lands in level 0", "[render]") {
+    InstanceBatch batch;
+    ecs::Mat4 m;
+    batch.add(ShapeType::Box, m, Colors::Red);
+    batch.add(ShapeType::Box, m, Colors::Red, 1);
+    batch.add(ShapeType::Box, m, Colors::Red, 2);
+    CHECK(batch.bucket(ShapeType::Box).size() == 3);
+    CHECK(batch.bucket(ShapeType::Box, 1).empty());
+    CHECK(batch.bucket(ShapeType::Box, 2).empty());
+    CHECK(batch.level_size(0) == 3);
+    CHECK_FALSE(InstanceBatch::has_lods(ShapeType::Box));
+    CHECK(InstanceBatch::has_lods(ShapeType::Sphere));
+}
+
+// ---------------------------------------------------------------------------
+// RenderLod
+// ---------------------------------------------------------------------------
+
+TEST_CASE("RenderLod — coarser levels as projected size shrinks", "[render]") {
+    RenderLod lod;
+    CHECK(lod.select(0.5f, 2.0f)   == 0); // ratio 0.25
+    CHECK(lod.select(0.5f, 20.0f)  == 1); // 0.025
+    CHECK(lod.select(0.5f, 100.0f) == 2); // 0.005
+    CHECK(lod.select(5.0f, 100.0f) == 0); // large objects stay detailed
+    CHECK(lod.select(0.5f, 0.1f)   == 0); // camera inside the bounds
+
+    lod.enabled = false;
+    CHECK(lod.select(0.5f, 100.0f) == 0);
+}
+
+TEST_CASE("RenderLod — bounds are judged from their centre", "[render]") {
+    RenderLod lod;
+    const Aabb unit = {{-0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, 0.5f}}; // radius ~0.87
+    CHECK(lod.select(unit, {0, 0, 5})   == 0);
+    CHECK(lod.select(unit, {0, 0, 30})  == 1);
+    CHECK(lod.select(unit, {0, 0, 100}) == 2);
+
+    Aabb far_box = unit;
+    far_box.min.z += 100.0f; far_box.max.z += 100.0f;
+    CHECK(lod.select(far_box, {0, 0, 95}) == 0);
+}
+
+// ---------------------------------------------------------------------------
+// UniformCache / DrawQueue
+// ---------------------------------------------------------------------------
+
+TEST_CASE("UniformCache — only changed values are uploaded", "[render]") {
+    UniformCache cache;
+    RenderStats  stats;
+    float radius = 0.7f;
+    const float pos[3] = {1.0f, 2.0f, 3.0f};
+
+    CHECK(cache.update(3, 5, &radius, sizeof(radius), &stats));
+    CHECK_FALSE(cache.update(3, 5, &radius, sizeof(radius), &stats));
+    CHECK(cache.update(4, 5, &radius, sizeof(radius), &stats));  // other program
+    CHECK(cache.update(3, 6, pos, sizeof(pos), &stats));         // other location
+    radius = 0.8f;
+    CHECK(cache.update(3, 5, &radius, sizeof(radius), &stats));
+    CHECK_FALSE(cache.update(3, -1, &radius, sizeof(radius), &stats)); // not in the program
+
+    CHECK(stats.uniform_uploads == 4);
+    CHECK(stats.uniform_skipped == 1);
+    CHECK(cache.size() == 3);
+
+    cache.clear();
+    CHECK(cache.update(3, 5, &radius, sizeof(radius)));
+}
+
+TEST_CASE("DrawQueue — sort groups draws by shader program", "[render]") {
+    DrawQueue q;
+    q.push(2, ShapeType::Sphere,  1);
+    q.push(1, ShapeType::Capsule, 0);
+    q.push(2, ShapeType::Box,     0);
+    q.push(1, ShapeType::Box,     2);
+    q.push(2, ShapeType::Sphere,  0);
+
+    CHECK(q.sort() == 2);
+    const auto& c = q.commands();
+    REQUIRE(c.size() == 5);
+    CHECK(c[0].shader == 1); CHECK(c[0].shape == ShapeType::Box);
+    CHECK(c[1].shader == 1); CHECK(c[1].shape == ShapeType::Capsule);
+    CHECK(c[2].shader == 2); CHECK(c[2].shape == ShapeType::Box);
+    CHECK(c[3].shape == ShapeType::Sphere); CHECK(c[3].lod == 0);
+    CHECK(c[4].shape == ShapeType::Sphere); CHECK(c[4].lod == 1);
+
+    q.clear();
+    CHECK(q.sort() == 0);
+}
+
+// ---------------------------------------------------------------------------
+// GpuTimer
+// ---------------------------------------------------------------------------
+
+// Fake query backend: timestamp() stamps the fake GPU clock, which advances
+// 1 ms per stamp; results become ready once `fake_gpu_done` covers the id.
+namespace {
+uint64_t fake_gpu_clock = 0;
+std::array<uint64_t, 64> fake_gpu_stamps{};
+std::array<bool, 64>     fake_gpu_ready{};
+bool                     fake_gpu_done = true;
+
+GpuTimer::Backend fake_gpu_backend() {
+    fake_gpu_clock = 0;
+    fake_gpu_stamps.fill(0);
+    fake_gpu_ready.fill(false);
+    fake_gpu_done = true;
+    GpuTimer::Backend b;
+    b.create    = [](uint32_t* ids, int n) { for (int i = 0; i < n; ++i) ids[i] = static_cast<uint32_t>(i); return true; };
+    b.timestamp = [](uint32_t id) {
+        fake_gpu_clock += 1000000;
+        fake_gpu_stamps[id] = fake_gpu_clock;
+        fake_gpu_ready[id]  = fake_gpu_done;
+    };
+    b.ready    = [](uint32_t id) { return fake_gpu_ready[id]; };
+    b.value_ns = [](uint32_t id) { return fake_gpu_stamps[id]; };
+    return b;
+}
+} // namespace
+
+TEST_CASE("GpuTimer — inactive until init() succeeds", "[render]") {
+    GpuTimer t;
+    t.begin(GpuTimer::Scene);
+    t.end(GpuTimer::Scene);
+    t.end_frame();
+    CHECK_FALSE(t.active());
+    CHECK(t.frames() == 0);
+
+    GpuTimer::Backend none;
+    none.create    = [](uint32_t*, int) { return false; };
+    none.timestamp = [](uint32_t) {};
+    none.ready     = [](uint32_t) { return true; };
+    none.value_ns  = [](uint32_t) -> uint64_t { return 0; };
+    CHECK_FALSE(t.init(none));
+}
+
+TEST_CASE("GpuTimer — resolves each scope once the GPU is done", "[render]") {
+    GpuTimer t;
+    REQUIRE(t.init(fake_gpu_backend()));
+
+    t.begin(GpuTimer::Scene);
+    fake_gpu_clock += 2000000;          // 3 ms between the two stamps
+    t.end(GpuTimer::Scene);
+    t.begin(GpuTimer::Overlay);
+    t.end(GpuTimer::Overlay);           // 1 ms
+    t.end_frame();
+
+    CHECK(t.frames() == 1);
+    CHECK_THAT(t.last_ms(GpuTimer::Scene), Catch::Matchers::WithinAbs(3.0f, 1e-4f));
+    CHECK_THAT(t.last_ms(GpuTimer::Overlay), Catch::Matchers::WithinAbs(1.0f, 1e-4f));
+
+    t.begin(GpuTimer::Scene);
+    t.end(GpuTimer::Scene);             // overlay not drawn this frame
+    t.end_frame();
+    CHECK(t.frames() == 2);
+    CHECK(t.last_ms(GpuTimer::Overlay) == 0.0f);
+    CHECK_THAT(t.avg_ms(GpuTimer::Scene), Catch::Matchers::WithinAbs(2.0f, 1e-4f));
+    CHECK_THAT(t.max_ms(GpuTimer::Scene), Catch::Matchers::WithinAbs(3.0f, 1e-4f));
+}
+
+TEST_CASE("GpuTimer — late results wait; a busy slot drops its frame", "[render]") {
+    GpuTimer t;
+    REQUIRE(t.init(fake_gpu_backend()));
+    fake_gpu_done = false;
+
+    for (int f = 0; f < GpuTimer::LATENCY; ++f) {
+        t.begin(GpuTimer::Scene);
+        t.end(GpuTimer::Scene);
+        t.end_frame();
+    }
+    CHECK(t.frames() == 0);  // nothing ready, the CPU never waited
+    CHECK(t.dropped() == 1); // the slot coming round is still pending
+
+    t.begin(GpuTimer::Scene); // skipped: writes no query
+    t.end(GpuTimer::Scene);
+    fake_gpu_ready.fill(true);
+    t.end_frame();
+    CHECK(t.frames() == GpuTimer::LATENCY);
+    CHECK_THAT(t.last_ms(GpuTimer::Scene), Catch::Matchers::WithinAbs(1.0f, 1e-4f));
+}
+
+// ---------------------------------------------------------------------------
+// Frustum culling
+// ---------------------------------------------------------------------------
+
+static Aabb box_at(float x, float y, float z, float h = 0.5f) {
+    return {{x - h, y - h, z - h}, {x + h, y + h, z + h}};
+}
+
+TEST_CASE("Frustum — keeps boxes ahead, rejects behind and beside", "[culling]") {
+    // Eye at origin looking down -Z, 90° vertical fov, square aspect.
+    Frustum f = Frustum::look_at({0, 0, 0}, {0, 0, -1}, {0, 1, 0}, 90.0f, 1.0f, 0.1f, 100.0f);
+    CHECK(f.intersects(box_at(0, 0, -10)));
+    CHECK_FALSE(f.intersects(box_at(0, 0, 10)));     // behind
+    CHECK_FALSE(f.intersects(box_at(30, 0, -10)));   // right of the 45° edge
+    CHECK_FALSE(f.intersects(box_at(-30, 0, -10)));  // left
+    CHECK_FALSE(f.intersects(box_at(0, 30, -10)));   // above
+    CHECK_FALSE(f.intersects(box_at(0, 0, -200)));   // past far
+    CHECK(f.intersects(box_at(10.2f, 0, -10)));      // straddles the right plane
+}
+
+TEST_CASE("Culling::transform_bounds — translates and scales unit bounds", "[culling]") {
+    ecs::Mat4 m;
+    m.m[0] = 2.0f; m.m[5] = 4.0f; m.m[10] = 1.0f;     // scale (2, 4, 1)
+    m.m[12] = 10.0f; m.m[13] = 1.0f; m.m[14] = -3.0f; // translate
+    Aabb b = Culling::transform_bounds(m, Culling::local_bounds(ShapeType::Box));
+    CHECK_THAT(b.min.x, Catch::Matchers::WithinAbs(9.0f, 1e-5f));
+    CHECK_THAT(b.max.x, Catch::Matchers::WithinAbs(11.0f, 1e-5f));
+    CHECK_THAT(b.min.y, Catch::Matchers::WithinAbs(-1.0f, 1e-5f));
+    CHECK_THAT(b.max.y, Catch::Matchers::WithinAbs(3.0f, 1e-5f));
+    CHECK_THAT(b.max.z, Catch::Matchers::WithinAbs(-2.5f, 1e-5f));
+}
+
+TEST_CASE("StaticGrid — query visits only items inside the frustum", "[culling]") {
+    StaticGrid grid(8.0f);
+    for (int i = -10; i <= 10; ++i) {
+        StaticGrid::Item item;
+        item.bounds = box_at(static_cast<float>(i) * 10.0f, 0, -20);
+        grid.insert(item);
+    }
+    CHECK(grid.size() == 21);
+
+    Frustum f = Frustum::look_at({0, 0, 0}, {0, 0, -1}, {0, 1, 0}, 90.0f, 1.0f, 0.1f, 100.0f);
+    size_t visited = 0;
+    size_t n = grid.query(f, [&](const StaticGrid::Item&) { ++visited; });
+    CHECK(n == visited);
+    CHECK(n == 5); // x in {-20, -10, 0, 10, 20} at depth 20
+
+    grid.clear();
+    CHECK(grid.size() == 0);
+    CHECK(grid.cell_count() == 0);
+}
+
+TEST_CASE("RenderCulling — rebuild waits for a physics step after a change", "[culling]") {
+    RenderCulling c;
+    c.statics_dirty = false;
+    c.mark_dirty(7);
+    CHECK_FALSE(c.ready_to_rebuild(true, 7));
+    CHECK(c.ready_to_rebuild(true, 8));
+    CHECK(c.ready_to_rebuild(false, 0)); // no fixed step → rebuild immediately
+}
+
+TEST_CASE("RenderCulling — kinematic bodies stay out of the grid and draw where they are now", "[culling]") {
+    ecs::World world;
+    auto at = [](float x) {
+        ecs::WorldTransform wt{};
+        wt.matrix.m[0] = wt.matrix.m[5] = wt.matrix.m[10] = wt.matrix.m[15] = 1.0f;
+        wt.matrix.m[12] = x;
+        wt.matrix.m[14] = -20.0f;
+        return wt;
+    };
+    ecs::Entity wall = world.create();
+    world.add(wall, at(0.0f));
+    world.add(wall, MeshRenderer{});
+    ecs::Entity lift = world.create();
+    world.add(lift, at(5.0f));
+    world.add(lift, MeshRenderer{});
+    world.add(lift, KinematicTarget{});
+
+    RenderCulling c;
+    c.rebuild(world);
+    CHECK(c.statics.size() == 1);
+
+    // The lift moves; the grid is not rebuilt (no WorldTag change).
+    world.get<ecs::WorldTransform>(lift) = at(-5.0f);
+
+    // What RenderSystem::Capture submits: grid items plus every kinematic body.
+    Frustum f = Frustum::look_at({0, 0, 0}, {0, 0, -1}, {0, 1, 0}, 90.0f, 1.0f, 0.1f, 100.0f);
+    std::vector<float> drawn_x;
+    c.statics.query(f, [&](const StaticGrid::Item& item) { drawn_x.push_back(item.model.m[12]); });
+    world.each<ecs::WorldTransform, MeshRenderer, KinematicTarget>(
+        ecs::World::Exclude<TransformHistory>{},
+        [&](ecs::Entity, ecs::WorldTransform& wt, MeshRenderer&, KinematicTarget&) { drawn_x.push_back(wt.matrix.m[12]); });
+    std::sort(drawn_x.begin(), drawn_x.end());
+    CHECK(drawn_x == std::vector<float>{-5.0f, 0.0f});
+
+    size_t fallback = 0;
+    RenderCulling::each_static(world, [&](ecs::Entity, ecs::WorldTransform&, MeshRenderer&) { ++fallback; });
+    CHECK(fallback == 1);
+}
+
+// ---------------------------------------------------------------------------
+// CharacterIslands
+// ---------------------------------------------------------------------------
+
+TEST_CASE("CharacterIslands — characters in reach share a group", "[character]") {
+    CharacterIslands islands;
+    std::vector<ecs::Vec3> pos = {
+        {0, 0, 0}, {2, 0, 0},     // pair
+        {50, 0, 0},               // alone
+        {100, 0, 0}, {103, 0, 0}, {106, 0, 0}, // chain: 0-1 and 1-2 in reach
+    };
+    CHECK(islands.build(pos, 3.5f) == 3);
+    CHECK(islands.group_of(0) == islands.group_of(1));
+    CHECK(islands.group_of(2) != islands.group_of(0));
+    CHECK(islands.group_of(3) == islands.group_of(5)); // transitive
+    CHECK(islands.group_of(3) != islands.group_of(2));
+}
+
+TEST_CASE("CharacterIslands — ids are dense and in first-seen order", "[character]") {
+    CharacterIslands islands;
+    std::vector<ecs::Vec3> pos = {{0, 0, 0}, {20, 0, 0}, {40, 0, 0}};
+    CHECK(islands.build(pos, 1.0f) == 3);
+    CHECK(islands.group_of(0) == 0);
+    CHECK(islands.group_of(1) == 1);
+    CHECK(islands.group_of(2) == 2);
+
+    CHECK(islands.build({}, 1.0f) == 0);
+    CHECK(islands.group_count() == 0);
+}
+
+TEST_CASE("CharacterIslands — neighbours across a cell boundary are found", "[character]") {
+    CharacterIslands islands;
+    std::vector<ecs::Vec3> pos = {{-0.1f, 0, 0}, {0.1f, 0, 0}, {3.9f, 0, -0.1f}};
+    CHECK(islands.build(pos, 4.0f) == 1);
+}
+
+TEST_CASE("CharacterIslands — a second build on the same input does not allocate", "[character]") {
+    CharacterIslands islands;
+    std::vector<ecs::Vec3> pos;
+    for (int i = 0; i < 64; ++i) pos.push_back({static_cast<float>(i % 8) * 1.5f, 0, static_cast<float>(i / 8) * 9.0f});
+    const size_t groups = islands.build(pos, 2.0f);
+    CHECK(groups == 8); // one row of eight per group
+
+    const uint64_t before = g_thread_allocs;
+    CHECK(islands.build(pos, 2.0f) == groups);
+    CHECK(g_thread_allocs == before);
+}
+
+// ---------------------------------------------------------------------------
+// VoicePool
+// ---------------------------------------------------------------------------
+
+namespace {
+size_t plays(const std::vector<VoicePool::Command>& cmds) {
+    return static_cast<size_t>(std::count_if(cmds.begin(), cmds.end(), [](const VoicePool::Command& c) {
+        return c.type == VoicePool::Command::Type::Play;
+    }));
+}
+} // namespace
+
+TEST_CASE("VoicePool — a clip's requests in one frame start one voice", "[audio]") {
+    VoicePool pool;
+    const int land = pool.add_clip({});
+    std::vector<VoicePool::Command> out;
+
+    pool.begin({});
+    for (int i = 0; i < 50; ++i) pool.submit(land, {float(i), 0, 0});
+    pool.mix(out);
+    REQUIRE(out.size() == 1);
+    CHECK(out[0].type == VoicePool::Command::Type::Play);
+    CHECK_THAT(out[0].volume, Catch::Matchers::WithinAbs(1.0f, 1e-5f)); // the nearest one is kept
+    CHECK(pool.coalesced() == 49);
+    CHECK(pool.playing() == 1);
+
+    // Still playing next frame: the second request takes another alias.
+    pool.begin({});
+    pool.set_playing(out[0].voice, true);
+    pool.submit(land);
+    pool.mix(out);
+    REQUIRE(out.size() == 1);
+    CHECK(out[0].voice != 0);
+    CHECK(pool.playing() == 2);
+}
+
+TEST_CASE("VoicePool — gain falls off with distance and far requests are culled", "[audio]") {
+    VoicePool pool;
+    pool.min_distance = 2.0f;
+    pool.max_distance = 12.0f;
+    const int jump = pool.add_clip({1.0f, 0.5f});
+    std::vector<VoicePool::Command> out;
+
+    CHECK_THAT(pool.attenuation(1.0f), Catch::Matchers::WithinAbs(1.0f, 1e-5f));
+    CHECK_THAT(pool.attenuation(7.0f), Catch::Matchers::WithinAbs(0.5f, 1e-5f));
+    CHECK_THAT(pool.attenuation(20.0f), Catch::Matchers::WithinAbs(0.0f, 1e-5f));
+
+    pool.begin({{10, 0, 0}, {1, 0, 0}});
+    pool.submit(jump, {10, 0, 5}); // 5 m straight ahead
+    pool.mix(out);
+    REQUIRE(out.size() == 1);
+    CHECK_THAT(out[0].volume, Catch::Matchers::WithinAbs(0.35f, 1e-5f)); // 0.7 × clip volume
+    CHECK_THAT(out[0].pan, Catch::Matchers::WithinAbs(0.0f, 1e-5f));
+
+    pool.begin({{10, 0, 0}, {1, 0, 0}});
+    pool.submit(jump, {10, 0, 30});
+    pool.mix(out);
+    CHECK(out.empty());
+    CHECK(pool.culled() == 1);
+}
+
+TEST_CASE("VoicePool — pan follows the listener's right vector", "[audio]") {
+    VoicePool pool;
+    const int a = pool.add_clip({});
+    const int b = pool.add_clip({});
+    std::vector<VoicePool::Command> out;
+
+    pool.begin({{0, 0, 0}, {0, 0, 1}}); // right is +Z
+    pool.submit(a, {0, 0, 4});
+    pool.submit(b, {0, 0, -4});
+    pool.mix(out);
+    REQUIRE(out.size() == 2);
+    for (const auto& c : out) {
+        if (static_cast<int>(c.voice / VoicePool::ALIASES) == a) CHECK_THAT(c.pan, Catch::Matchers::WithinAbs(1.0f, 1e-5f));
+        else CHECK_THAT(c.pan, Catch::Matchers::WithinAbs(-1.0f, 1e-5f));
+    }
+}
+
+TEST_CASE("VoicePool — a full pool steals its weakest voice or drops the request", "[audio]") {
+    VoicePool pool;
+    pool.max_voices = 2;
+    pool.min_distance = 0.0f;
+    pool.max_distance = 10.0f;
+    const int quiet = pool.add_clip({0.5f, 1.0f});
+    const int loud  = pool.add_clip({2.0f, 1.0f});
+    const int other = pool.add_clip({1.0f, 1.0f});
+    std::vector<VoicePool::Command> out;
+
+    pool.begin({});
+    pool.submit(quiet, {5, 0, 0}); // score 0.25
+    pool.submit(other, {5, 0, 0}); // score 0.5
+    pool.mix(out);
+    REQUIRE(plays(out) == 2);
+    const size_t quiet_voice = out[0].voice / VoicePool::ALIASES == size_t(quiet) ? out[0].voice : out[1].voice;
+    const size_t other_voice = quiet_voice == out[0].voice ? out[1].voice : out[0].voice;
+
+    // The loud clip outscores both: the quiet voice is stopped for it.
+    pool.begin({});
+    pool.set_playing(quiet_voice, true);
+    pool.set_playing(other_voice, true);
+    pool.submit(loud, {5, 0, 0}); // score 1.0
+    pool.mix(out);
+    REQUIRE(out.size() == 2);
+    CHECK(out[0].type == VoicePool::Command::Type::Stop);
+    CHECK(out[0].voice == quiet_voice);
+    CHECK(out[1].type == VoicePool::Command::Type::Play);
+    CHECK(out[1].voice / VoicePool::ALIASES == size_t(loud));
+    CHECK(pool.stolen() == 1);
+    CHECK(pool.playing() == 2);
+
+    // A quieter request than everything playing is dropped.
+    pool.begin({});
+    pool.set_playing(other_voice, true);
+    pool.set_playing(out[1].voice, true);
+    pool.submit(quiet, {9, 0, 0});
+    pool.mix(out);
+    CHECK(out.empty());
+    CHECK(pool.dropped() == 1);
+}
+
+TEST_CASE("VoicePool — a clip with every alias playing restarts its weakest", "[audio]") {
+    VoicePool pool;
+    pool.min_distance = 0.0f;
+    pool.max_distance = 10.0f;
+    const int land = pool.add_clip({});
+    std::vector<VoicePool::Command> out;
+
+    // Fill the clip's aliases frame by frame, each a little louder.
+    for (size_t i = 0; i < VoicePool::ALIASES; ++i) {
+        pool.begin({});
+        for (size_t v = 0; v < i; ++v) pool.set_playing(v, true);
+        pool.submit(land, {8.0f - float(i), 0, 0});
+        pool.mix(out);
+        REQUIRE(plays(out) == 1);
+        CHECK(out[0].voice == i);
+    }
+
+    pool.begin({});
+    for (size_t v = 0; v < VoicePool::ALIASES; ++v) pool.set_playing(v, true);
+    pool.submit(land, {1, 0, 0});
+    pool.mix(out);
+    REQUIRE(out.size() == 2);
+    CHECK(out[0].type == VoicePool::Command::Type::Stop);
+    CHECK(out[0].voice == 0); // the first, farthest one
+    CHECK(out[1].voice == 0);
+}
+
+// ---------------------------------------------------------------------------
+// AssetCache
+// ---------------------------------------------------------------------------
+
+namespace {
+// A text "engine": upload stores the file's contents (uppercased by decode);
+// a file starting with '!' fails to upload.
+struct TextAssets {
+    std::shared_ptr<AssetCache>                  cache = std::make_shared<AssetCache>();
+    std::unordered_map<AssetCache::Id, std::string> live;
+    int kind = -1, released = 0;
+
+    TextAssets() {
+        kind = cache->add_kind({
+            [](AssetCache::Payload& p) {
+                auto upper = std::make_shared<std::string>(p.files[0]);
+                for (char& c : *upper) c = static_cast<char>(std::toupper(static_cast<unsigned char>(c)));
+                p.decoded = upper;
+                return true;
+            },
+            [this](AssetCache::Id id, AssetCache::Payload& p) {
+                if (!p.files[0].empty() && p.files[0][0] == '!') return false;
+                live[id] = *static_cast<std::string*>(p.decoded.get());
+                return true;
+            },
+            [this](AssetCache::Id id) { live.erase(id); ++released; },
+        });
+    }
+    ~TextAssets() { cache->shutdown(); }
+
+    std::string get(const AssetCache::Handle& h) { return live.count(h.id()) ? live[h.id()] : ""; }
+};
+
+std::string write_temp_asset(const char* name, const std::string& text) {
+    const auto path = std::filesystem::temp_directory_path() / name;
+    std::ofstream(path, std::ios::binary) << text;
+    return path.string();
+}
+} // namespace
+
+TEST_CASE("AssetCache — loads off the main thread and shares by path", "[assets]") {
+    const std::string path = write_temp_asset("asset_cache_a.txt", "hello");
+    TextAssets t;
+    AssetCache::Handle a = t.cache->request(t.kind, {path});
+    AssetCache::Handle b = t.cache->request(t.kind, {path});
+    REQUIRE(a);
+    CHECK(a.id() == b.id());
+    CHECK(t.get(a).empty()); // nothing is uploaded outside pump()
+
+    REQUIRE(t.cache->wait(a.id()));
+    CHECK(t.cache->state(a.id()) == AssetCache::State::Ready);
+    CHECK(t.get(a) == "HELLO");
+    CHECK(t.cache->version(a.id()) == 1);
+    CHECK(t.cache->live() == 1);
+    CHECK(t.cache->bytes_read() == 5);
+
+    CHECK_FALSE(t.cache->request(t.kind, {}));
+    CHECK_FALSE(t.cache->request(7, {path}));
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("AssetCache — missing files fail the load", "[assets]") {
+    TextAssets t;
+    auto h = t.cache->request(t.kind, {(std::filesystem::temp_directory_path() / "asset_cache_missing.txt").string()});
+    CHECK_FALSE(t.cache->wait(h.id()));
+    CHECK(t.cache->state(h.id()) == AssetCache::State::Failed);
+    CHECK(t.cache->failed() == 1);
+    CHECK(t.live.empty());
+}
+
+TEST_CASE("AssetCache — the last Handle going releases the asset", "[assets]") {
+    const std::string path = write_temp_asset("asset_cache_b.txt", "x");
+    TextAssets t;
+    AssetCache::Handle a = t.cache->request(t.kind, {path});
+    REQUIRE(t.cache->wait(a.id()));
+    const AssetCache::Id first = a.id();
+
+    AssetCache::Handle copy = a;
+    a.reset();
+    t.cache->pump();
+    CHECK(t.released == 0); // the copy still holds it
+    copy = AssetCache::Handle{};
+    t.cache->pump();
+    CHECK(t.released == 1);
+    CHECK(t.live.empty());
+    CHECK(t.cache->live() == 0);
+
+    // A new request loads it again, under a new id.
+    AssetCache::Handle again = t.cache->request(t.kind, {path});
+    REQUIRE(t.cache->wait(again.id()));
+    CHECK(again.id() != first);
+    CHECK(t.get(again) == "X");
+    std::filesystem::remove(path);
+}
+
+TEST_CASE("AssetCache — changed files reload; a failed reload keeps the old version", "[assets]") {
+    namespace fs = std::filesystem;
+    const std::string path = write_temp_asset("asset_cache_c.txt", "one");
+    TextAssets t;
+    AssetCache::Handle h = t.cache->request(t.kind, {path});
+    REQUIRE(t.cache->wait(h.id()));
+    int uploads = 0;
+    t.cache->on_upload(h.id(), [&] { ++uploads; });
+    CHECK(uploads == 1); // already loaded: runs at once
+    t.cache->watch(0.005f);
+
+    // Rewrites the file with a later timestamp and pumps until the worker
+    // has picked it up.
+    auto edit = [&](const std::string& text, uint32_t version, size_t failed) {
+        const auto stamp = fs::last_write_time(path);
+        std::ofstream(path, std::ios::binary | std::ios::trunc) << text;
+        fs::last_write_time(path, stamp + std::chrono::seconds(2));
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (t.cache->version(h.id()) < version && t.cache->failed() < failed &&
+               std::chrono::steady_clock::now() < deadline) {
+            t.cache->pump();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    };
+
+    edit("two", 2, 1);
+    CHECK(t.cache->version(h.id()) == 2);
+    CHECK(t.get(h) == "TWO");
+    CHECK(t.cache->reloads() == 1);
+    CHECK(uploads == 2);
+
+    edit("!broken", 3, 1);
+    CHECK(t.cache->failed() == 1);
+    CHECK(t.cache->state(h.id()) == AssetCache::State::Ready);
+    CHECK(t.cache->version(h.id()) == 2);
+    CHECK(t.get(h) == "TWO");
+    CHECK(uploads == 2);
+    std::filesystem::remove(path);
+}
+
+// ---------------------------------------------------------------------------
+// NetReplication
+// ---------------------------------------------------------------------------
+
+namespace {
+// `n` entities in a row, ids 1..n; `moved` of them shifted by `dx`.
+NetReplication::Snapshot row_snapshot(uint32_t tick, uint32_t n, uint32_t moved = 0, float dx = 0.0f) {
+    NetReplication::Snapshot snap;
+    snap.tick = tick;
+    for (uint32_t i = 1; i <= n; ++i) {
+        const float x = static_cast<float>(i) + (i <= moved ? dx : 0.0f);
+        snap.entries.push_back({i, NetReplication::quantize({x, 1.0f, -2.0f}, {0, 0, 0, 1})});
+    }
+    return snap;
+}
+
+size_t total_bytes(const std::vector<std::vector<uint8_t>>& fragments) {
+    size_t n = 0;
+    for (const auto& f : fragments) n += f.size();
+    return n;
+}
+
+// Server and client joined by a lossy in-memory link: every `drop`-th
+// server packet is lost (0: none).
+struct NetLink {
+    NetReplication::Server server;
+    NetReplication::Client client;
+    size_t sent = 0, drop = 0;
+
+    void ack() {
+        std::vector<uint8_t> pkt;
+        NetReplication::encode_ack(client.newest(), pkt);
+        server.receive(1, pkt.data(), pkt.size());
+    }
+    void tick(NetReplication::Snapshot snap) {
+        server.broadcast(std::move(snap), [&](uint64_t, const std::vector<uint8_t>& bytes) {
+            if (drop && ++sent % drop == 0) return;
+            client.receive(bytes.data(), bytes.size());
+        });
+    }
+};
+} // namespace
+
+TEST_CASE("NetReplication — quantised poses round-trip within a step", "[net]") {
+    const ecs::Vec3 p = {12.3456f, -0.0004f, 301.0f};
+    const float h = std::sqrt(0.5f);
+    const ecs::Quat rotations[] = {{0, 0, 0, 1}, {0, h, 0, h}, {0.5f, -0.5f, 0.5f, 0.5f}, {0.1f, 0.2f, -0.3f, -0.927f}};
+    for (const ecs::Quat& q0 : rotations) {
+        const float len = std::sqrt(q0.x * q0.x + q0.y * q0.y + q0.z * q0.z + q0.w * q0.w);
+        const ecs::Quat q = {q0.x / len, q0.y / len, q0.z / len, q0.w / len};
+        const NetReplication::QPose qp = NetReplication::quantize(p, q);
+        const ecs::Vec3 bp = NetReplication::dequantize_position(qp);
+        CHECK_THAT(bp.x, Catch::Matchers::WithinAbs(p.x, 0.5f / NetReplication::POS_SCALE));
+        CHECK_THAT(bp.y, Catch::Matchers::WithinAbs(p.y, 0.5f / NetReplication::POS_SCALE));
+        CHECK_THAT(bp.z, Catch::Matchers::WithinAbs(p.z, 0.5f / NetReplication::POS_SCALE));
+        // Same rotation up to sign: |dot| close to 1.
+        const ecs::Quat b = NetReplication::dequantize_rotation(qp.r);
+        CHECK(std::fabs(b.x * q.x + b.y * q.y + b.z * q.z + b.w * q.w) > 0.9999f);
+
+        // The server reads rotations back out of WorldTransform.
+        const ecs::Quat m = NetReplication::rotation_of(ecs::mat4_compose(p, q, {2.0f, 0.5f, 1.0f}));
+        CHECK(std::fabs(m.x * q.x + m.y * q.y + m.z * q.z + m.w * q.w) > 0.99999f);
+    }
+}
+
+TEST_CASE("NetReplication — a delta carries only what moved", "[net]") {
+    const NetReplication::Snapshot base = row_snapshot(1, 2000);
+    std::vector<std::vector<uint8_t>> full, idle, few;
+    REQUIRE(NetReplication::encode(base, nullptr, full));
+    CHECK(full.size() > 1); // split to fit MAX_PACKET
+    for (const auto& f : full) CHECK(f.size() <= NetReplication::MAX_PACKET);
+
+    REQUIRE(NetReplication::encode(row_snapshot(2, 2000), &base, idle));
+    REQUIRE(idle.size() == 1);
+    CHECK(total_bytes(idle) < 32); // just the header
+
+    // 10 bodies moving along one axis: a couple of bytes of position each.
+    REQUIRE(NetReplication::encode(row_snapshot(2, 2000, 10, 0.01f), &base, few));
+    CHECK(total_bytes(few) < total_bytes(idle) + 10 * 6);
+    CHECK(total_bytes(few) * 50 < total_bytes(full));
+}
+
+TEST_CASE("NetReplication — the client rebuilds each tick from its acked baseline", "[net]") {
+    NetLink link;
+    link.ack(); // join
+    link.tick(row_snapshot(1, 300));
+    CHECK(link.client.newest() == 1);
+    CHECK(link.server.full_snapshots() == 1);
+
+    link.ack();
+    NetReplication::Snapshot next = row_snapshot(2, 300, 5, 0.5f);
+    next.entries.erase(next.entries.begin() + 100); // id 101 gone
+    next.entries.push_back({500, NetReplication::quantize({7, 8, 9}, {0, 0, 0, 1})});
+    link.tick(next);
+    REQUIRE(link.client.newest() == 2);
+    CHECK(link.server.full_snapshots() == 1); // a delta against tick 1
+    CHECK(link.server.last_entries() == 5 + 1 + 1);
+
+    const NetReplication::Snapshot* got = link.client.find(2);
+    REQUIRE(got);
+    REQUIRE(got->entries.size() == next.entries.size());
+    for (size_t i = 0; i < next.entries.size(); ++i) {
+        CHECK(got->entries[i].id == next.entries[i].id);
+        CHECK(got->entries[i].pose == next.entries[i].pose);
+    }
+    CHECK(got->find(101) == nullptr);
+}
+
+TEST_CASE("NetReplication — lost packets are skipped, not waited for", "[net]") {
+    NetLink link;
+    link.drop = 4;
+    for (uint32_t t = 1; t <= 60; ++t) {
+        link.ack();
+        link.tick(row_snapshot(t, 200, 200, static_cast<float>(t) * 0.1f)); // full: 2 fragments, delta: 1
+    }
+    // Ticks missing a fragment never assemble; later ones do, against
+    // whatever the client last acked.
+    CHECK(link.client.received() > 5);
+    CHECK(link.client.received() < 60);
+    const NetReplication::Snapshot* last = link.client.find(link.client.newest());
+    REQUIRE(last);
+    const NetReplication::Snapshot want = row_snapshot(last->tick, 200, 200, static_cast<float>(last->tick) * 0.1f);
+    REQUIRE(last->entries.size() == want.entries.size());
+    CHECK(last->entries.back().pose == want.entries.back().pose);
+
+    // Garbage is refused.
+    const uint8_t junk[] = {'P', 'N', NetReplication::VERSION, 1, 0xff};
+    const size_t dropped = link.client.dropped();
+    CHECK_FALSE(link.client.receive(junk, sizeof(junk)));
+    CHECK(link.client.dropped() == dropped + 1);
+}
+
+TEST_CASE("NetReplication — playback interpolates and reports only moving entities", "[net]") {
+    NetLink link;
+    link.ack();
+    std::vector<NetReplication::Pose> out;
+    CHECK_FALSE(link.client.sample(1.0f, out));
+
+    // Entity 1 moves 1 m a tick along x; entity 2 stays put.
+    for (uint32_t t = 1; t <= 10; ++t) {
+        NetReplication::Snapshot snap;
+        snap.tick = t;
+        snap.entries.push_back({1, NetReplication::quantize({static_cast<float>(t), 0, 0}, {0, 0, 0, 1})});
+        snap.entries.push_back({2, NetReplication::quantize({0, 5, 0}, {0, 0, 0, 1})});
+        link.ack();
+        link.tick(snap);
+    }
+    REQUIRE(link.client.newest() == 10);
+
+    // The first sample writes everything, INTERP_DELAY ticks back.
+    REQUIRE(link.client.sample(0.0f, out));
+    CHECK(out.size() == 2);
+    CHECK_THAT(link.client.playback(), Catch::Matchers::WithinAbs(10.0f - NetReplication::INTERP_DELAY, 1e-4));
+
+    // Half a tick on: only the mover, halfway between two snapshots.
+    REQUIRE(link.client.sample(0.5f, out));
+    REQUIRE(out.size() == 1);
+    CHECK(out[0].id == 1);
+    CHECK_THAT(out[0].position.x, Catch::Matchers::WithinAbs(link.client.playback(), 1e-3));
+    CHECK(std::fabs(link.client.playback() - std::floor(link.client.playback())) > 0.1f);
+}
+
+// ---------------------------------------------------------------------------
+// StressScene
+// ---------------------------------------------------------------------------
+
+TEST_CASE("StressScene — generates the requested counts, sized for Jolt", "[stress_scene]") {
+    StressScene::Params p;
+    p.platforms    = 20;
+    p.bodies       = 50;
+    p.stack_height = 8;
+    p.sphere_share = 0.5f;
+    p.characters   = 5;
+    p.builder_pool = 16;
+    const std::string json = StressScene::generate(p);
+
+    std::vector<SceneEntityDesc> descs;
+    REQUIRE(SceneDesc::read_string(json, descs));
+    size_t statics = 0, boxes = 0, spheres = 0, characters = 0, players = 0;
+    float ground = 0, platform_max_x = -1e9f, dynamic_min_x = 1e9f;
+    for (const SceneEntityDesc& d : descs) {
+        if (d.character) ++characters;
+        if (d.player_tag) ++players;
+        if (!d.rigid_body) continue;
+        REQUIRE(d.transform);
+        if (d.name == "Ground") {
+            REQUIRE(d.box_collider);
+            ground = d.box_collider->half_extents.x;
+        } else if (d.rigid_body->type == BodyType::Static) {
+            ++statics;
+            platform_max_x = std::max(platform_max_x, d.transform->position.x);
+        } else {
+            d.sphere_collider ? ++spheres : ++boxes;
+            dynamic_min_x = std::min(dynamic_min_x, d.transform->position.x);
+        }
+    }
+    CHECK(statics == 20);
+    CHECK(boxes + spheres == 50);
+    CHECK(spheres > 0);
+    CHECK(boxes > 0);
+    CHECK(characters == 5);
+    CHECK(players == 1);
+    CHECK(platform_max_x + 3.0f < dynamic_min_x); // stacks clear of the platforms
+
+    // Everything stands on the ground.
+    for (const SceneEntityDesc& d : descs) {
+        REQUIRE(d.transform);
+        CHECK(std::fabs(d.transform->position.x) < ground);
+        CHECK(std::fabs(d.transform->position.z) < ground);
+    }
+
+    PhysicsConfig cfg;
+    REQUIRE(SceneLoader::physics_config_from_string(json, cfg));
+    CHECK(cfg.max_bodies == StressScene::body_budget(p));
+    CHECK(cfg.max_bodies >= descs.size() - characters + p.builder_pool);
+}
+
+TEST_CASE("StressScene — the same params give the same scene", "[stress_scene]") {
+    StressScene::Params p;
+    p.platforms = 10;
+    p.bodies    = 30;
+    CHECK(StressScene::generate(p) == StressScene::generate(p));
+
+    StressScene::Params other = p;
+    other.seed = 2;
+    CHECK(StressScene::generate(other) != StressScene::generate(p));
+
+    // Nothing asked for: just the ground.
+    StressScene::Params empty;
+    empty.bodies     = -3;
+    empty.characters = 0;
+    std::vector<SceneEntityDesc> descs;
+    REQUIRE(SceneDesc::read_string(StressScene::generate(empty), descs));
+    REQUIRE(descs.size() == 1);
+    CHECK(descs[0].name == "Ground");
+}
+
+// ---------------------------------------------------------------------------
+// DeferredCommands — per-system command lanes
+// ---------------------------------------------------------------------------
+
+namespace {
+struct LaneMark { int producer = 0; };
+template<int N> struct LaneAccess {};
+
+// Records every LaneMark as it is added, i.e. in flush order.
+std::vector<int>& watch_marks(ecs::World& world, std::vector<int>& log) {
+    world.on_add<LaneMark>([&log](ecs::World&, ecs::Entity, LaneMark& m) { log.push_back(m.producer); });
+    return log;
+}
+} // namespace
+
+TEST_CASE("DeferredCommands — lanes flush in install order on a threaded pipeline", "[deferred]") {
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+    pipeline.set_threads(4);
+    std::vector<int> log;
+    watch_marks(world, log);
+
+    // Entities up front: adding components keeps the count, so the phase
+    // runs in parallel after its first frame.
+    constexpr int FRAMES = 6, SYSTEMS = 4;
+    std::vector<ecs::Entity> targets;
+    for (int i = 0; i < FRAMES * SYSTEMS; ++i) targets.push_back(world.create());
+
+    int frame = 0;
+    auto producer = [&](int s) {
+        return [&, s](ecs::World& w, float) {
+            // The first system finishes last.
+            if (s == 0) std::this_thread::sleep_for(std::chrono::milliseconds(2));
+            DeferredCommands::local(w).add(targets[frame * SYSTEMS + s], LaneMark{s});
+        };
+    };
+    pipeline.add_logic("P0", ecs::Access{}.write<LaneAccess<0>>(), producer(0));
+    pipeline.add_logic("P1", ecs::Access{}.write<LaneAccess<1>>(), producer(1));
+    pipeline.add_logic("P2", ecs::Access{}.write<LaneAccess<2>>(), producer(2));
+    pipeline.add_logic("P3", ecs::Access{}.write<LaneAccess<3>>(), producer(3));
+
+    for (frame = 0; frame < FRAMES; ++frame) {
+        log.clear();
+        pipeline.update(world, 0.016f);
+        CHECK(log == std::vector<int>{0, 1, 2, 3});
+    }
+    CHECK(DeferredCommands::of(world).queued() == 0);
+    CHECK(DeferredCommands::of(world).lanes() == 1 + SYSTEMS);
+}
+
+TEST_CASE("DeferredCommands — job lanes follow their parent, in job order", "[deferred]") {
+    ecs::World world;
+    std::vector<int> log;
+    watch_marks(world, log);
+
+    // Outside a Pipeline system, local() is lane 0.
+    CommandLane& lane = DeferredCommands::local(world);
+    CHECK(&lane == &DeferredCommands::of(world).lane(0));
+    lane.reserve_jobs(3);
+    CHECK(lane.jobs() == 3);
+
+    std::vector<std::thread> jobs;
+    for (int j = 2; j >= 0; --j)
+        jobs.emplace_back([&, j] { lane.job(static_cast<size_t>(j)).create_with(LaneMark{10 + j}); });
+    lane.create_with(LaneMark{1});
+    for (auto& t : jobs) t.join();
+
+    CHECK(lane.queued() == 4);
+    CHECK(DeferredCommands::of(world).flush(world) == 4);
+    CHECK(log == std::vector<int>{1, 10, 11, 12});
+    CHECK(world.count<LaneMark>() == 4);
+    CHECK(DeferredCommands::of(world).flush(world) == 0);
+
+    // A scope points local() at another lane and restores the previous one.
+    CommandLane other;
+    {
+        const DeferredCommands::Scope scope(&other);
+        CHECK(&DeferredCommands::local(world) == &other);
+    }
+    CHECK(&DeferredCommands::local(world) == &lane);
+}
+
+TEST_CASE("DeferredCommands — the Pipeline skips a flush with nothing queued", "[deferred]") {
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+    world.set_resource(FrameProfiler{});
+    bool spawn = false;
+    pipeline.add_logic("Spawner", ecs::Access{}, [&](ecs::World& w, float) {
+        if (spawn) DeferredCommands::local(w).create_with(WorldTag{});
+    });
+    auto flushes = [&]() -> uint64_t {
+        for (const auto& s : world.resource<FrameProfiler>().systems())
+            if (s.name == "Deferred Flush") return s.total_calls;
+        return 0;
+    };
+
+    pipeline.update(world, 0.016f);
+    CHECK_FALSE(DeferredCommands::shared_pending(world));
+    CHECK(flushes() == 0);
+
+    spawn = true;
+    pipeline.update(world, 0.016f);
+    CHECK(world.count<WorldTag>() == 1);
+    const uint64_t after_spawn = flushes();
+    CHECK(after_spawn >= 1);
+
+    // Hooks queueing during a flush land at the next one.
+    world.on_add<WorldTag>([](ecs::World& w, ecs::Entity e, WorldTag&) {
+        if (!w.has<LaneMark>(e)) DeferredCommands::local(w).add(e, LaneMark{});
+    });
+    pipeline.update(world, 0.016f);
+    CHECK(world.count<WorldTag>() == 2);
+    CHECK(world.count<LaneMark>() == 1); // the second flush of the frame
+}
+
+TEST_CASE("DeferredCommands — flush_all lands the shared buffer and every lane", "[deferred]") {
+    ecs::World world;
+    const ecs::Entity e = world.create();
+    world.deferred().add(e, LaneMark{});
+    DeferredCommands::local(world).create_with(WorldTag{}); // lane 0, outside any system
+    const uint64_t before = DeferredCommands::of(world).edits();
+
+    DeferredCommands::flush_all(world);
+    CHECK(world.has<LaneMark>(e));
+    CHECK(world.count<WorldTag>() == 1);
+    CHECK(DeferredCommands::of(world).queued() == 0);
+    CHECK(DeferredCommands::of(world).edits() == before + 2); // the lane command and the shared flush
+
+    const uint64_t settled = DeferredCommands::of(world).edits();
+    DeferredCommands::flush_all(world);
+    CHECK(DeferredCommands::of(world).edits() == settled);
+}
+
+TEST_CASE("Pipeline — a world.deferred() add runs the next frame serially", "[deferred]") {
+    struct Planted {};
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+    pipeline.set_threads(2);
+    const ecs::Entity slot = world.create();
+
+    std::atomic<bool> armed{false}, plant{false}, a_in{false}, b_in{false}, a_saw{false};
+    pipeline.add_logic("A", ecs::Access{}.write<AccessA>(), [&](ecs::World&, float) {
+        if (armed) a_saw = rendezvous(a_in, b_in);
+    });
+    pipeline.add_logic("B", ecs::Access{}.write<AccessB>(), [&](ecs::World&, float) {
+        if (armed) rendezvous(b_in, a_in);
+    });
+    pipeline.add_pre_update("Planter", [&](ecs::World& w, float) {
+        if (plant.exchange(false)) w.deferred().add(slot, Planted{}); // keeps world.count()
+    });
+    auto frame = [&] {
+        a_in = b_in = a_saw = false;
+        pipeline.update(world, 0.016f);
+        return a_saw.load();
+    };
+
+    pipeline.update(world, 0.016f); // first frame: serial
+    armed = true;
+    CHECK(frame());                 // overlapped
+    plant = true;
+    frame();                        // the add lands in this frame's flush
+    CHECK(world.has<Planted>(slot));
+    CHECK_FALSE(frame());           // new archetype: serial
+    CHECK(frame());                 // and back to parallel
+}
+
+// ---------------------------------------------------------------------------
+// StaticPipeline — compile-time step lists
+// ---------------------------------------------------------------------------
+
+namespace {
+struct StepLog { std::vector<std::string> calls; };
+template<int N> struct StepData {};
+
+struct FirstStep {
+    static constexpr const char* name  = "First";
+    static constexpr int         phase = FrameProfiler::PreUpdate;
+    using writes = ecs::TypeList<StepData<0>>;
+    static void run(ecs::World& w, float) { w.resource<StepLog>().calls.push_back(name); }
+};
+struct ReaderStep {
+    static constexpr const char* name  = "Reader";
+    static constexpr int         phase = FrameProfiler::Logic;
+    using reads  = ecs::TypeList<StepData<0>>;
+    using writes = ecs::TypeList<StepData<1>>;
+    using after  = ecs::TypeList<FirstStep>;
+    static void run(ecs::World& w, float) {
+        w.resource<StepLog>().calls.push_back(name);
+        DeferredCommands::local(w).create_with(LaneMark{1});
+    }
+};
+struct TouchStep {
+    static constexpr const char* name        = "Touch";
+    static constexpr int         phase       = FrameProfiler::Logic;
+    static constexpr bool        main_thread = true;
+    using writes = ecs::TypeList<StepData<2>>;
+    static void run(ecs::World& w, float) { w.resource<StepLog>().calls.push_back(name); }
+};
+struct SimStep {
+    static constexpr const char* name  = "Sim";
+    static constexpr int         phase = FrameProfiler::Physics;
+    static void run(ecs::World& w, float) { w.resource<StepLog>().calls.push_back(name); }
+};
+struct ShowStep {
+    static constexpr const char* name  = "Show";
+    static constexpr int         phase = FrameProfiler::Render;
+    using after = ecs::TypeList<SimStep>;
+    static void run(ecs::World& w, float) { w.resource<StepLog>().calls.push_back(name); }
+};
+
+using TestSteps = ecs::StaticPipeline<FirstStep, ReaderStep, TouchStep, SimStep, ShowStep>;
+
+static_assert(TestSteps::size() == 5);
+static_assert(ecs::step_conflicts<FirstStep, ReaderStep>);
+static_assert(!ecs::step_conflicts<ReaderStep, TouchStep>);
+static_assert(ecs::step_exclusive<SimStep> && !ecs::step_exclusive<TouchStep>);
+static_assert(ecs::StepAfterEnforced<ReaderStep>::value && ecs::StepAfterEnforced<ShowStep>::value);
+} // namespace
+
+TEST_CASE("StaticPipeline — runs its steps by phase, with flushes and profiling", "[static_pipeline]") {
+    ecs::World world;
+    world.set_resource(StepLog{});
+    world.set_resource(FrameProfiler{});
+    TestSteps steps;
+
+    steps.update(world, 0.016f);
+    CHECK(world.resource<StepLog>().calls == std::vector<std::string>{"First", "Reader", "Touch"});
+    CHECK(world.count<LaneMark>() == 1); // Reader's lane, flushed at the end of logic()
+    CHECK(DeferredCommands::of(world).lanes() == 1 + TestSteps::size());
+
+    CHECK(steps.step_fixed(world, FixedTime{}.fixed_dt) == 1);
+    steps.render(world);
+    CHECK(world.resource<StepLog>().calls
+          == std::vector<std::string>{"First", "Reader", "Touch", "Sim", "Show"});
+
+    const auto& prof = world.resource<FrameProfiler>();
+    CHECK(prof.find("First", FrameProfiler::PreUpdate) >= 0);
+    CHECK(prof.find("Reader", FrameProfiler::Logic) >= 0);
+    CHECK(prof.find("Sim", FrameProfiler::Physics) >= 0);
+    CHECK(prof.find("Show", FrameProfiler::Render) >= 0);
+    CHECK(prof.find("Deferred Flush", FrameProfiler::Logic) >= 0);
+}
+
+TEST_CASE("Pipeline::add — a step type brings its name, phase and Access", "[static_pipeline]") {
+    const ecs::Access reader = ecs::step_access<ReaderStep>();
+    CHECK_FALSE(reader.exclusive);
+    CHECK(reader.conflicts(ecs::step_access<FirstStep>()));
+    CHECK_FALSE(reader.conflicts(ecs::step_access<TouchStep>()));
+    CHECK(ecs::step_access<TouchStep>().main_thread);
+    CHECK(ecs::step_access<SimStep>().exclusive);
+
+    ecs::World    world;
+    ecs::Pipeline pipeline;
+    world.set_resource(StepLog{});
+    pipeline.add<FirstStep>();
+    pipeline.add<ReaderStep>();
+    pipeline.add<TouchStep>();
+    pipeline.add<SimStep>();
+    pipeline.add<ShowStep>();
+    CHECK(pipeline.names(FrameProfiler::Logic) == std::vector<std::string>{"Reader", "Touch"});
+    CHECK(TestSteps::mirrors(pipeline));
+    CHECK_FALSE((ecs::StaticPipeline<FirstStep, ReaderStep, SimStep, ShowStep>::mirrors(pipeline)));
+
+    // The dynamic Pipeline runs the same steps in the same order.
+    pipeline.update(world, 0.016f);
+    pipeline.step_fixed(world, FixedTime{}.fixed_dt);
+    pipeline.render(world);
+    CHECK(world.resource<StepLog>().calls
+          == std::vector<std::string>{"First", "Reader", "Touch", "Sim", "Show"});
+    CHECK(world.count<LaneMark>() == 1);
 }
@@ -0,0 +1,25 @@
+// ---------------------------------------------------------------------------
+// scene_bake — offline JSON → .pscn scene baker
+//
+// Converts an authored JSON scene into the packed binary format read by
+// SceneLoader::load_binary (see src/scene_binary.hpp). Run automatically by
+// the demo build for resources/scenes/default.json.
+//
+// Usage:
+//   scene_bake <in.json> <out.pscn>
+// ---------------------------------------------------------------------------
+
+#include "scene.hpp"
+#include <cstdio>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s <in.json> <out.pscn>\n", argv[0]);
+        return 2;
+    }
+    if (!SceneLoader::bake(argv[1], argv[2])) {
+        std::fprintf(stderr, "scene_bake: failed to bake '%s' into '%s'\n", argv[1], argv[2]);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+// ---------------------------------------------------------------------------
+// shape_cook — offline ShapeDesc JSON → cooked Jolt shape (.jshape)
+//
+// Builds a compound / mesh / height-field shape asset with Jolt and writes it
+// in the format ShapeCook::restore reads (see src/shape_cook.hpp). Run
+// automatically by the demo build for every resources/shapes/*.json.
+//
+// Usage:
+//   shape_cook <in.json> <out.jshape>
+// ---------------------------------------------------------------------------
+
+#include "shape_cook.hpp"
+#include "shape_desc.hpp"
+#include <Jolt/Jolt.h>
+#include <Jolt/Core/Factory.h>
+#include <Jolt/RegisterTypes.h>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <vector>
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::fprintf(stderr, "usage: %s <in.json> <out.jshape>\n", argv[0]);
+        return 2;
+    }
+
+    ShapeDesc   desc;
+    std::string error;
+    if (!ShapeDesc::read_file(argv[1], desc, &error)) {
+        std::fprintf(stderr, "shape_cook: '%s': %s\n", argv[1], error.c_str());
+        return 1;
+    }
+
+    JPH::RegisterDefaultAllocator();
+    JPH::Factory::sInstance = new JPH::Factory();
+    JPH::RegisterTypes();
+
+    int status = 0;
+    if (auto shape = ShapeCook::build(desc, &error)) {
+        std::vector<uint8_t> image;
+        ShapeCook::save(*shape, image);
+        std::ofstream out(argv[2], std::ios::binary);
+        out.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+        if (!out.good()) {
+            std::fprintf(stderr, "shape_cook: failed to write '%s'\n", argv[2]);
+            status = 1;
+        }
+    } else {
+        std::fprintf(stderr, "shape_cook: '%s' failed to build: %s\n", argv[1], error.c_str());
+        status = 1;
+    }
+
+    JPH::UnregisterTypes();
+    delete JPH::Factory::sInstance;
+    JPH::Factory::sInstance = nullptr;
+    return status;
+}